@@ -53,16 +53,6 @@ pi0EtaByEta::pi0EtaByEta(const std::string& name, const std::string& filename)
   , outfilename(filename)
 {
   h_mass_eta_lt.fill(nullptr);
-
-  if (runTowByTow)
-  {
-    for (auto& row : h_mass_tbt_lt)
-    {
-      row.fill(nullptr);
-    }
-  }
-
-  clusMix = new std::vector<std::vector<std::vector<CLHEP::Hep3Vector>>>();
 }
 
 pi0EtaByEta::~pi0EtaByEta()
@@ -86,15 +76,12 @@ int pi0EtaByEta::Init(PHCompositeNode* /*unused*/)
   {
     std::string histoname = "h_mass_eta_lt" + std::to_string(i);
     h_mass_eta_lt[i] = new TH1F(histoname.c_str(), "", 50, 0, 0.5);
+  }
 
-    if (runTowByTow)
-    {
-      for (int j = 0; j < 256; j++)
-      {
-        std::string histoname_tbt = "h_mass_tbt_lt_" + std::to_string(i) + "_" + std::to_string(j);
-        h_mass_tbt_lt[i][j] = new TH1F(histoname_tbt.c_str(), "", 50, 0, 0.5);
-      }
-    }
+  // tower by tower inv mass, kept in one bank rather than 24576 histograms
+  if (runTowByTow)
+  {
+    m_mass_tbt.book(96 * 256, 50, 0, 0.5);
   }
 
   // 3D hist to save inv mass for all towers
@@ -134,16 +121,7 @@ int pi0EtaByEta::Init(PHCompositeNode* /*unused*/)
 
   h_pipT_Nclus_mass = new TH3F("h_pipT_Nclus_mass", "", 20, 0, 10, 20, 0, 400, 25, 0, 0.5);
 
-  std::vector<std::vector<CLHEP::Hep3Vector>> temp2 = std::vector<std::vector<CLHEP::Hep3Vector>>();
-  std::vector<CLHEP::Hep3Vector> temp = std::vector<CLHEP::Hep3Vector>();
-  for (int i = 0; i < NBinsVtx; i++)
-  {
-    temp2.push_back(temp);
-  }
-  for (int i = 0; i < NBinsClus; i++)
-  {
-    clusMix->push_back(temp2);
-  }
+  m_clusMix.resize(NBinsClus * NBinsVtx);
 
   return 0;
 }
@@ -443,7 +421,7 @@ int pi0EtaByEta::process_towers(PHCompositeNode* topNode)
 
       if (runTowByTow)
       {
-        h_mass_tbt_lt[lt_eta][lt_phi]->Fill(pi0.M());
+        m_mass_tbt.fill(lt_eta * 256 + lt_phi, pi0.M());
       }  // fill 1D inv mass hist for all towers
 
       h_InvMass_Nclus[nClusBin]->Fill(pi0.M());
@@ -451,15 +429,12 @@ int pi0EtaByEta::process_towers(PHCompositeNode* topNode)
 
     if (doMix)
     {
-      for (const auto& E_vec_cluster2 : clusMix->at(nClusBin)[vtxBin])
+      for (const auto& mixCluster : m_clusMix[nClusBin * NBinsVtx + vtxBin])
       {
-        float clus2E = E_vec_cluster2.mag();
-        float clus2_eta = E_vec_cluster2.pseudoRapidity();
-        float clus2_phi = E_vec_cluster2.phi();
-        float clus2_pt = E_vec_cluster2.perp();
+        float clus2E = mixCluster.e;
 
         TLorentzVector photon2;
-        photon2.SetPtEtaPhiE(clus2_pt, clus2_eta, clus2_phi, clus2E);
+        photon2.SetPtEtaPhiE(mixCluster.pt, mixCluster.eta, mixCluster.phi, clus2E);
 
         if (fabs(clusE - clus2E) / (clusE + clus2E) > maxAlpha)
         {
@@ -484,7 +459,8 @@ int pi0EtaByEta::process_towers(PHCompositeNode* topNode)
 
   if (doMix)
   {
-    clusMix->at(nClusBin)[vtxBin].clear();
+    auto& mixClusters = m_clusMix[nClusBin * NBinsVtx + vtxBin];
+    mixClusters.clear();
 
     for (clusterIter = clusterEnd.first; clusterIter != clusterEnd.second; clusterIter++)
     {
@@ -504,7 +480,7 @@ int pi0EtaByEta::process_towers(PHCompositeNode* topNode)
         continue;
       }
 
-      clusMix->at(nClusBin)[vtxBin].push_back(E_vec_cluster);
+      mixClusters.push_back({static_cast<float>(E_vec_cluster.mag()), static_cast<float>(E_vec_cluster.pseudoRapidity()), static_cast<float>(E_vec_cluster.phi()), clus_pt});
     }
   }
 
@@ -515,6 +491,21 @@ int pi0EtaByEta::End(PHCompositeNode* /*topNode*/)
 {
   outfile->cd();
 
+  // one histogram at a time, the bank stays the only full copy in memory
+  if (runTowByTow)
+  {
+    for (int i = 0; i < 96; i++)
+    {
+      for (int j = 0; j < 256; j++)
+      {
+        std::string histoname_tbt = "h_mass_tbt_lt_" + std::to_string(i) + "_" + std::to_string(j);
+        TH1* h = m_mass_tbt.toTH1(i * 256 + j, histoname_tbt);
+        h->Write();
+        delete h;
+      }
+    }
+  }
+
   outfile->Write();
   outfile->Close();
   delete outfile;
@@ -938,29 +929,26 @@ void pi0EtaByEta::Split3DHist(const std::string& infile, const std::string& out_
     return;
   }
 
+  // Now we will update all the histogram in the output file
+  ofile->cd();
+
   // Loop over ieta and iphi ranges (x and y axis)
+  const int nbinsz = h_ieta_iphi_invmass->GetNbinsZ();
   for (int bineta = 1; bineta <= 96; ++bineta)
   {
     for (int binphi = 1; binphi <= 256; ++binphi)
     {
+      std::string histoname_tbt = "h_mass_tbt_lt_" + std::to_string(bineta - 1) + "_" + std::to_string(binphi - 1);
+      TH1* h = new TH1F(histoname_tbt.c_str(), "", nbinsz, h_ieta_iphi_invmass->GetZaxis()->GetXmin(), h_ieta_iphi_invmass->GetZaxis()->GetXmax());
+
       // Loop over third axis in 3D Hist and then fill it into 1D hist
-      for (int binz = 1; binz <= h_ieta_iphi_invmass->GetNbinsZ(); ++binz)
+      for (int binz = 1; binz <= nbinsz; ++binz)
       {
         float content = h_ieta_iphi_invmass->GetBinContent(bineta, binphi, binz);
-        h_mass_tbt_lt[bineta - 1][binphi - 1]->SetBinContent(binz, content);
+        h->SetBinContent(binz, content);
       }
-    }
-  }
-
-  // Now we will update all the histogram in the output file
-  ofile->cd();
-
-  for (auto& i : h_mass_tbt_lt)
-  {
-    for (auto& j : i)
-    {
-      j->Write();
-      delete j;
+      h->Write();
+      delete h;
     }
   }
 
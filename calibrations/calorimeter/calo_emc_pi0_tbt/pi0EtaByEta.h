@@ -1,9 +1,10 @@
 #ifndef CALOANA_H__
 #define CALOANA_H__
 
+#include <calobase/TowerHistogramBank.h>
+
 #include <fun4all/SubsysReco.h>
 
-//#include <CLHEP/Vector/ThreeVector.h>  // for Hep3Vector
 #include <array>
 #include <string>  // for string
 #include <vector>
@@ -20,11 +21,6 @@ class TF1;
 class TProfile2D;
 class TH3;
 
-namespace CLHEP
-{
-  class Hep3Vector;
-}
-
 class pi0EtaByEta : public SubsysReco
 {
  public:
@@ -147,7 +143,9 @@ class pi0EtaByEta : public SubsysReco
   std::vector<int> m_bbc_side;
 
   std::array<TH1*, 96> h_mass_eta_lt{};
-	std::array<std::array<TH1*, 256>, 96> h_mass_tbt_lt{};
+
+  //! invariant mass for each leading tower, ieta * 256 + iphi. Converted to h_mass_tbt_lt_ieta_iphi histograms in End
+  TowerHistogramBank m_mass_tbt;
 
   int _eventcounter{0};
   int _range{1};
@@ -162,7 +160,17 @@ class pi0EtaByEta : public SubsysReco
   bool runTowByTow{true}; // default set not to run tbt
   bool runTBTCompactMode{true}; // default set to run in compact mode 
 
-  std::vector<std::vector<std::vector<CLHEP::Hep3Vector>>>* clusMix;
+  //! cluster kinematics kept for event mixing
+  struct MixCluster
+  {
+    float e = 0;
+    float eta = 0;
+    float phi = 0;
+    float pt = 0;
+  };
+
+  //! clusters of the previous event in each (cluster multiplicity, vertex) bin, nClusBin * NBinsVtx + vtxBin
+  std::vector<std::vector<MixCluster>> m_clusMix;
   TH1* h_nclus_bin{nullptr};
   const int NBinsClus = 10;
   TH1* h_vtx_bin{nullptr};
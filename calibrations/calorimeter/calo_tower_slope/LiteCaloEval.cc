@@ -73,22 +73,29 @@ int LiteCaloEval::InitRun(PHCompositeNode * /*topNode*/)
 
   cal_output = new TFile(_filename.c_str(), "RECREATE");
 
+  // the tower histograms are booked with the first run only, later runs
+  // start from empty histograms like all other histograms created here
+  const bool towerHistsBooked = m_towerHists.nchannels() > 0;
+  if (towerHistsBooked)
+  {
+    m_towerHists.reset();
+  }
+
   if (calotype == LiteCaloEval::HCALIN)
   {
     hcalin_energy_eta = new TH2F("hcalin_energy_eta", "hcalin energy eta", 100, 0, 10, 24, -0.5, 23.5);
     hcalin_e_eta_phi = new TH3F("hcalin_e_eta_phi", "hcalin e eta phi", 60, 0, 6, 24, -0.5, 23.5, 64, -0.5, 63.5);
 
     /// create tower histos
-    for (int i = 0; i < 24; i++)
+    m_neta = 24;
+    m_nphi = 64;
+    if (!towerHistsBooked)
     {
-      for (int j = 0; j < 64; j++)
-      {
-        std::string hist_name = "hcal_in_eta_" + std::to_string(i) + "_phi_" + std::to_string(j);
-
-        hcal_in_eta_phi[i][j] = new TH1F(hist_name.c_str(), "Hcal_in_energy", 40000, 0, 4);
-        hcal_in_eta_phi[i][j]->SetXTitle("Energy [GeV]");
-      }
+      m_towerHists.book(m_neta * m_nphi, 40000, 0, 4);
     }
+    m_towerHistPrefix = "hcal_in_eta_";
+    m_towerHistInfix = "_phi_";
+    m_towerHistTitle = "Hcal_in_energy";
 
     // create eta slice histos
     for (int i = 0; i < 25; i++)
@@ -114,16 +121,15 @@ int LiteCaloEval::InitRun(PHCompositeNode * /*topNode*/)
     hcalout_e_eta_phi = new TH3F("hcalout_e_eta_phi", "hcalout e eta phi", 100, 0, 10, 24, -0.5, 23.5, 64, -0.5, 63.5);
 
     /// create tower histos
-    for (int i = 0; i < 24; i++)
+    m_neta = 24;
+    m_nphi = 64;
+    if (!towerHistsBooked)
     {
-      for (int j = 0; j < 64; j++)
-      {
-        std::string hist_name = "hcal_out_eta_" + std::to_string(i) + "_phi_" + std::to_string(j);
-
-        hcal_out_eta_phi[i][j] = new TH1F(hist_name.c_str(), "Hcal_out energy", 10000, 0, 10);
-        hcal_out_eta_phi[i][j]->SetXTitle("Energy [GeV]");
-      }
+      m_towerHists.book(m_neta * m_nphi, 10000, 0, 10);
     }
+    m_towerHistPrefix = "hcal_out_eta_";
+    m_towerHistInfix = "_phi_";
+    m_towerHistTitle = "Hcal_out energy";
 
     /// create eta slice histos
     for (int i = 0; i < 25; i++)
@@ -145,16 +151,15 @@ int LiteCaloEval::InitRun(PHCompositeNode * /*topNode*/)
   else if (calotype == LiteCaloEval::CEMC)
   {
     /// create tower histos
-    for (int i = 0; i < 96; i++)
+    m_neta = 96;
+    m_nphi = 256;
+    if (!towerHistsBooked)
     {
-      for (int j = 0; j < 256; j++)
-      {
-        std::string hist_name = "emc_ieta" + std::to_string(i) + "_phi" + std::to_string(j);
-
-        cemc_hist_eta_phi[i][j] = new TH1F(hist_name.c_str(), "Hist_ieta_phi_leaf(e)", 400, 0, 2);
-        cemc_hist_eta_phi[i][j]->SetXTitle("Energy [GeV]");
-      }
+      m_towerHists.book(m_neta * m_nphi, 400, 0, 2);
     }
+    m_towerHistPrefix = "emc_ieta";
+    m_towerHistInfix = "_phi";
+    m_towerHistTitle = "Hist_ieta_phi_leaf(e)";
 
     // create eta slice histos
     for (int i = 0; i < 97; i++)
@@ -341,7 +346,8 @@ int LiteCaloEval::process_event(PHCompositeNode *topNode)
         e *= 0.88 + llet * 0.04 - 0.01 + 0.01 * ppkket;
       }
 
-      cemc_hist_eta_phi[ieta][iphi]->Fill(e);
+      m_fillChannels.push_back(ieta * m_nphi + iphi);
+      m_fillValues.push_back(e);
 
       eta_hist[96]->Fill(e);
 
@@ -367,7 +373,8 @@ int LiteCaloEval::process_event(PHCompositeNode *topNode)
         }
       }
 
-      hcal_out_eta_phi[ieta][iphi]->Fill(e);
+      m_fillChannels.push_back(ieta * m_nphi + iphi);
+      m_fillValues.push_back(e);
 
       hcalout_eta[24]->Fill(e);
 
@@ -393,7 +400,8 @@ int LiteCaloEval::process_event(PHCompositeNode *topNode)
         }
       }
 
-      hcal_in_eta_phi[ieta][iphi]->Fill(e);
+      m_fillChannels.push_back(ieta * m_nphi + iphi);
+      m_fillValues.push_back(e);
 
       hcalin_eta[24]->Fill(e);
 
@@ -411,6 +419,10 @@ int LiteCaloEval::process_event(PHCompositeNode *topNode)
 
   }  // end of for loop
 
+  m_towerHists.fill(m_fillChannels.size(), m_fillChannels.data(), m_fillValues.data());
+  m_fillChannels.clear();
+  m_fillValues.clear();
+
   _ievent++;
 
   return Fun4AllReturnCodes::EVENT_OK;
@@ -423,6 +435,20 @@ int LiteCaloEval::End(PHCompositeNode * /*topNode*/)
 
   std::cout << " writing lite calo file" << std::endl;
 
+  // tower histograms are created one at a time from the bank
+  for (unsigned int i = 0; i < m_neta; i++)
+  {
+    for (unsigned int j = 0; j < m_nphi; j++)
+    {
+      std::string hist_name = m_towerHistPrefix + std::to_string(i) + m_towerHistInfix + std::to_string(j);
+
+      TH1 *h = m_towerHists.toTH1(i * m_nphi + j, hist_name, m_towerHistTitle);
+      h->SetXTitle("Energy [GeV]");
+      h->Write();
+      delete h;
+    }
+  }
+
   cal_output->Write();
 
   return Fun4AllReturnCodes::EVENT_OK;
@@ -4,9 +4,12 @@
 #ifndef CALOTOWERSLOPE_LITECALOEVAL_H
 #define CALOTOWERSLOPE_LITECALOEVAL_H
 
+#include <calobase/TowerHistogramBank.h>
+
 #include <fun4all/SubsysReco.h>
 
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
 class TFile;
@@ -117,6 +120,19 @@ class LiteCaloEval : public SubsysReco
  private:
   TFile *cal_output{nullptr};
 
+  /// tower histograms filled during the run, ieta * nphi + iphi. Written as the
+  /// hcal_in/hcal_out/emc tower histograms in End, which Get_Histos reads back
+  TowerHistogramBank m_towerHists;
+  unsigned int m_nphi{0};
+  unsigned int m_neta{0};
+  std::string m_towerHistPrefix;
+  std::string m_towerHistInfix;
+  std::string m_towerHistTitle;
+
+  /// tower fills of the current event
+  std::vector<unsigned int> m_fillChannels;
+  std::vector<float> m_fillValues;
+
   TH1 *hcal_out_eta_phi[24][64] = {};
   TH1 *hcalout_eta[25] = {};
   TH2 *hcalout_energy_eta{nullptr};
@@ -3,6 +3,7 @@
 #include "AnalyticFieldModel.h"
 #include "ChargeMapReader.h"
 #include "MultiArray.h"  //for TH3 alternative
+#include "PackedVectorArray.h"
 #include "Rossegger.h"
 
 #include <TCanvas.h>
@@ -23,9 +24,40 @@
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <vector>
 
 #define ALMOST_ZERO 0.00001
 
+namespace
+{
+  // the field arrays are indexed (r,phi,z) with z fastest, so a column at fixed (r,phi) is contiguous in each component.
+  // these add scale*(sum over the flat range [i0,i1)) and scale*(single element) into sum[3], without building TVector3s.
+  void add_column(const PackedVectorArray<double> *field, long int i0, long int i1, double scale, double *sum)
+  {
+    double sx = 0;
+    double sy = 0;
+    double sz = 0;
+    for (long int i = i0; i < i1; i++)
+    {
+      sx += field->x[i];
+      sy += field->y[i];
+      sz += field->z[i];
+    }
+    sum[0] += sx * scale;
+    sum[1] += sy * scale;
+    sum[2] += sz * scale;
+    return;
+  }
+
+  void add_element(const PackedVectorArray<double> *field, long int i, double scale, double *sum)
+  {
+    sum[0] += field->x[i] * scale;
+    sum[1] += field->y[i] * scale;
+    sum[2] += field->z[i] * scale;
+    return;
+  }
+}  // namespace
+
 AnnularFieldSim::AnnularFieldSim(float in_innerRadius, float in_outerRadius, float in_outerZ,
                                  int r, int roi_r0, int roi_r1, int /*in_rLowSpacing*/, int /*in_rHighSize*/,
                                  int phi, int roi_phi0, int roi_phi1, int /*in_phiLowSpacing*/, int /*in_phiHighSize*/,
@@ -134,25 +166,13 @@ AnnularFieldSim::AnnularFieldSim(float in_innerRadius, float in_outerRadius, flo
   std::cout << boost::str(boost::format("AnnularFieldSim::AnnularFieldSim calc'd roi variables nr=%d nphi=%d nz=%d") % nr_roi % nphi_roi % nz_roi) << std::endl;
 
   // create an array to hold the SC-induced electric field in the roi with the specified dimensions
-  Efield = new MultiArray<TVector3>(nr_roi, nphi_roi, nz_roi);
-  for (int i = 0; i < Efield->Length(); i++)
-  {
-    Efield->GetFlat(i)->SetXYZ(0, 0, 0);
-  }
+  Efield = new PackedVectorArray<double>(nr_roi, nphi_roi, nz_roi);  // starts zeroed.
 
   // and to hold the external electric fieldmap over the region of interest
-  Eexternal = new MultiArray<TVector3>(nr_roi, nphi_roi, nz_roi);
-  for (int i = 0; i < Eexternal->Length(); i++)
-  {
-    Eexternal->GetFlat(i)->SetXYZ(0, 0, 0);
-  }
+  Eexternal = new PackedVectorArray<double>(nr_roi, nphi_roi, nz_roi);  // starts zeroed.
 
   // ditto the external magnetic fieldmap
-  Bfield = new MultiArray<TVector3>(nr_roi, nphi_roi, nz_roi);
-  for (int i = 0; i < Bfield->Length(); i++)
-  {
-    Bfield->GetFlat(i)->SetXYZ(0, 0, 0);
-  }
+  Bfield = new PackedVectorArray<double>(nr_roi, nphi_roi, nz_roi);  // starts zeroed.
 
   // handle the lookup table construction:
   lookupCase = in_lookupCase;
@@ -164,22 +184,13 @@ AnnularFieldSim::AnnularFieldSim(float in_innerRadius, float in_outerRadius, flo
 
   if (lookupCase == Full3D)
   {
-    std::cout << boost::str(boost::format("AnnularFieldSim::AnnularFieldSim building Epartial (full3D) with  nr_roi=%d nphi_roi=%d nz_roi=%d  =~%2.2fM TVector3 objects") % nr_roi % nphi_roi % nz_roi % (nr_roi * nphi_roi * nz_roi * nr * nphi * nz / (1.0e6))) << std::endl;
+    std::cout << boost::str(boost::format("AnnularFieldSim::AnnularFieldSim building Epartial (full3D) with  nr_roi=%d nphi_roi=%d nz_roi=%d  =~%2.2fM vector elements") % nr_roi % nphi_roi % nz_roi % (nr_roi * nphi_roi * nz_roi * nr * nphi * nz / (1.0e6))) << std::endl;
 
-    Epartial = new MultiArray<TVector3>(nr_roi, nphi_roi, nz_roi, nr, nphi, nz);
-    for (int i = 0; i < Epartial->Length(); i++)
-    {
-      Epartial->GetFlat(i)->SetXYZ(0, 0, 0);
-    }
+    Epartial = new PackedVectorArray<float>(nr_roi, nphi_roi, nz_roi, nr, nphi, nz);  // starts zeroed.
     // and kill the arrays we shouldn't be using:
-    Epartial_highres = new MultiArray<TVector3>(1);
-    Epartial_highres->GetFlat(0)->SetXYZ(0, 0, 0);
-
-    Epartial_lowres = new MultiArray<TVector3>(1);
-    Epartial_lowres->GetFlat(0)->SetXYZ(0, 0, 0);
-
-    Epartial_phislice = new MultiArray<TVector3>(1);
-    Epartial_phislice->GetFlat(0)->SetXYZ(0, 0, 0);
+    Epartial_highres = new PackedVectorArray<float>(1);
+    Epartial_lowres = new PackedVectorArray<float>(1);
+    Epartial_phislice = new PackedVectorArray<float>(1);
     q_lowres = new MultiArray<double>(1);
     *(q_lowres->GetFlat(0)) = 0;
     q_local = new MultiArray<double>(1);
@@ -189,30 +200,18 @@ AnnularFieldSim::AnnularFieldSim(float in_innerRadius, float in_outerRadius, flo
   {
     std::cout << "lookupCase==HybridRes" << std::endl;
     // zero out the other two:
-    Epartial = new MultiArray<TVector3>(1);
-    Epartial->GetFlat(0)->SetXYZ(0, 0, 0);
-
-    Epartial_phislice = new MultiArray<TVector3>(1);
-    Epartial_phislice->GetFlat(0)->SetXYZ(0, 0, 0);
+    Epartial = new PackedVectorArray<float>(1);
+    Epartial_phislice = new PackedVectorArray<float>(1);
   }
   else if (lookupCase == PhiSlice)
   {
     std::cout << "lookupCase==PhiSlice" << std::endl;
 
-    Epartial_phislice = new MultiArray<TVector3>(nr_roi, 1, nz_roi, nr, nphi, nz);
-    for (int i = 0; i < Epartial_phislice->Length(); i++)
-    {
-      Epartial_phislice->GetFlat(i)->SetXYZ(0, 0, 0);
-    }
+    Epartial_phislice = new PackedVectorArray<float>(nr_roi, 1, nz_roi, nr, nphi, nz);  // starts zeroed.
     // zero out the other two:
-    Epartial = new MultiArray<TVector3>(1);
-    Epartial->GetFlat(0)->SetXYZ(0, 0, 0);
-    Epartial_highres = new MultiArray<TVector3>(1);
-    Epartial_highres->GetFlat(0)->SetXYZ(0, 0, 0);
-
-    Epartial_lowres = new MultiArray<TVector3>(1);
-    Epartial_lowres->GetFlat(0)->SetXYZ(0, 0, 0);
-
+    Epartial = new PackedVectorArray<float>(1);
+    Epartial_highres = new PackedVectorArray<float>(1);
+    Epartial_lowres = new PackedVectorArray<float>(1);
     q_lowres = new MultiArray<double>(1);
     *(q_lowres->GetFlat(0)) = 0;
     q_local = new MultiArray<double>(1);
@@ -223,18 +222,10 @@ AnnularFieldSim::AnnularFieldSim(float in_innerRadius, float in_outerRadius, flo
     std::cout << "lookupCase==Analytic (or NoLookup)" << std::endl;
 
     // zero them all out:
-    Epartial_phislice = new MultiArray<TVector3>(1);
-    Epartial_phislice->GetFlat(0)->SetXYZ(0, 0, 0);
-
-    Epartial = new MultiArray<TVector3>(1);
-    Epartial->GetFlat(0)->SetXYZ(0, 0, 0);
-
-    Epartial_highres = new MultiArray<TVector3>(1);
-    Epartial_highres->GetFlat(0)->SetXYZ(0, 0, 0);
-
-    Epartial_lowres = new MultiArray<TVector3>(1);
-    Epartial_lowres->GetFlat(0)->SetXYZ(0, 0, 0);
-
+    Epartial_phislice = new PackedVectorArray<float>(1);
+    Epartial = new PackedVectorArray<float>(1);
+    Epartial_highres = new PackedVectorArray<float>(1);
+    Epartial_lowres = new PackedVectorArray<float>(1);
     q_lowres = new MultiArray<double>(1);
     *(q_lowres->GetFlat(0)) = 0;
     q_local = new MultiArray<double>(1);
@@ -290,6 +281,16 @@ AnnularFieldSim::AnnularFieldSim(float rin, float rout, float dz, int r, int phi
   return;
 }
 
+void AnnularFieldSim::load_rossegger(double epsilon)
+{
+  green = new Rossegger(rmin, rmax, zmax, epsilon);
+  // tabulate the basis functions at our cell centers, in the shifted coordinates we query them with:
+  green->TabulateGrid(nr, rmin + 0.5 * step.Perp(), step.Perp(),
+                      nphi, 0.5 * step.Phi(), step.Phi(),
+                      nz, zmin + 0.5 * step.Z() + green_shift, step.Z());
+  return;
+}
+
 TVector3 AnnularFieldSim::calc_unit_field(TVector3 at, TVector3 from)
 {
   // if(debugFlag()) print_need_cout("%d: AnnularFieldSim::calc_unit_field(at=(r=%f,phi=%f,z=%f))\n",__LINE__,at.Perp(),at.Phi(),at.Z());
@@ -503,7 +504,7 @@ AnnularFieldSim::BoundsCase AnnularFieldSim::GetZindexAndCheckBounds(float pos,
   return InBounds;
 }
 
-TVector3 AnnularFieldSim::analyticFieldIntegral(float zdest, TVector3 start, MultiArray<TVector3> *field)
+TVector3 AnnularFieldSim::analyticFieldIntegral(float zdest, TVector3 start, PackedVectorArray<double> *field)
 {
   // integrates E dz, from the starting point to the selected z position.  The path is assumed to be along z for each step, with adjustments to x and y accumulated after each step.
   // if(debugFlag()) print_need_cout("%d: AnnularFieldSim::fieldIntegral(x=%f,y=%f, z=%f) to z=%f\n\n",__LINE__,start.X(),start.Y(),start.Z(),zdest);
@@ -570,7 +571,7 @@ TVector3 AnnularFieldSim::analyticFieldIntegral(float zdest, TVector3 start, Mul
   return integral;
 }
 
-TVector3 AnnularFieldSim::fieldIntegral(float zdest, const TVector3 &start, MultiArray<TVector3> *field)
+TVector3 AnnularFieldSim::fieldIntegral(float zdest, const TVector3 &start, PackedVectorArray<double> *field)
 {
   // integrates E dz, from the starting point to the selected z position.  The path is assumed to be along z for each step, with adjustments to x and y accumulated after each step.
   // if(debugFlag()) print_need_cout("%d: AnnularFieldSim::fieldIntegral(x=%f,y=%f, z=%f) to z=%f\n\n",__LINE__,start.X(),start.Y(),start.Z(),zdest);
@@ -615,28 +616,25 @@ TVector3 AnnularFieldSim::fieldIntegral(float zdest, const TVector3 &start, Mult
     return start;
   }
 
-  TVector3 fieldInt(0, 0, 0);
+  double fieldInt[3] = {0, 0, 0};
   // print_need_cout("AnnularFieldSim::fieldIntegral requesting (%d,%d,%d)-(%d,%d,%d) (inclusive) cells\n",r,phi,zi,r,phi,zf-1);
-  TVector3 tf;
-  for (int i = zi; i < zf; i++)
-  {  // count the whole cell of the lower end, and skip the whole cell of the high end.
-    tf = field->Get(r - rmin_roi, phi - phimin_roi, i - zmin_roi);
-    // print_need_cout("fieldAt (%d,%d,%d)=(%f,%f,%f) step=%f\n",r,phi,i,tf.X(),tf.Y(),tf.Z(),step.Z());
-    fieldInt += tf * step.Z();
-  }
+  long int base = field->Index(r - rmin_roi, phi - phimin_roi, 0) - zmin_roi;  // flat index of global z bin 0 in this column, so base+iz is global bin iz.
+
+  // count the whole cell of the lower end, and skip the whole cell of the high end.
+  add_column(field, base + zi, base + zf, step.Z(), fieldInt);
 
   // since bins contain their lower bound, but not their upper, I can safely remove the unused portion of the lower cell:
-  fieldInt -= field->Get(r - rmin_roi, phi - phimin_roi, zi - zmin_roi) * (startz - zi * step.Z());  // remove the part of the low end cell we didn't travel through
+  add_element(field, base + zi, -(startz - zi * step.Z()), fieldInt);  // remove the part of the low end cell we didn't travel through
 
   // but only need to add the used portion of the upper cell if we go past the edge of it meaningfully:
   if (endz / step.Z() - zf > ALMOST_ZERO)
   {
     // print_need_cout("endz/step.Z()=%f, zf=%f\n",endz/step.Z(),zf*1.0);
     // if our final step is actually in the next step.
-    fieldInt += field->Get(r - rmin_roi, phi - phimin_roi, zf - zmin_roi) * (endz - zf * step.Z());  // add the part of the high end cell we did travel through
+    add_element(field, base + zf, endz - zf * step.Z(), fieldInt);  // add the part of the high end cell we did travel through
   }
 
-  return dir * fieldInt;
+  return TVector3(dir * fieldInt[0], dir * fieldInt[1], dir * fieldInt[2]);
 }
 
 TVector3 AnnularFieldSim::GetCellCenter(int r, int phi, int z)
@@ -715,7 +713,7 @@ TVector3 AnnularFieldSim::GetWeightedCellCenter(int r, int phi, int z)
   return c;
 }
 
-TVector3 AnnularFieldSim::interpolatedFieldIntegral(float zdest, const TVector3 &start, MultiArray<TVector3> *field)
+TVector3 AnnularFieldSim::interpolatedFieldIntegral(float zdest, const TVector3 &start, PackedVectorArray<double> *field)
 {
   // print_need_cout("AnnularFieldSim::interpolatedFieldIntegral(x=%f,y=%f, z=%f)\n",start.X(),start.Y(),start.Z());
 
@@ -817,7 +815,8 @@ TVector3 AnnularFieldSim::interpolatedFieldIntegral(float zdest, const TVector3
     }
   }
 
-  TVector3 fieldInt(0, 0, 0), partialInt;  // where we'll store integrals as we generate them.
+  double fieldInt[3] = {0, 0, 0};  // where we'll store integrals as we generate them.
+  double partialInt[3];
 
   for (int i = 0; i < 4; i++)
   {
@@ -826,28 +825,30 @@ TVector3 AnnularFieldSim::interpolatedFieldIntegral(float zdest, const TVector3
       // print_need_cout("skipping element r=%d,phi=%d\n",ri[i],pi[i]);
       continue;  // we invalidated this one for some reason.
     }
-    partialInt.SetXYZ(0, 0, 0);
-    for (int j = zi; j < zf; j++)
-    {  // count the whole cell of the lower end, and skip the whole cell of the high end.
+    partialInt[0] = partialInt[1] = partialInt[2] = 0;
+    long int base = field->Index(ri[i] - rmin_roi, pi[i] - phimin_roi, 0) - zmin_roi;  // flat index of global z bin 0 in this column, so base+j is global bin j.
 
-      partialInt += field->Get(ri[i] - rmin_roi, pi[i] - phimin_roi, j - zmin_roi) * step.Z();
-    }
+    // count the whole cell of the lower end, and skip the whole cell of the high end.
+    add_column(field, base + zi, base + zf, step.Z(), partialInt);
     if (startBound != OnLowEdge)
     {
-      partialInt -= field->Get(ri[i] - rmin_roi, pi[i] - phimin_roi, zi - zmin_roi) * (startz - (zi * step.Z() + zmin));  // remove the part of the low end cell we didn't travel through
+      add_element(field, base + zi, -(startz - (zi * step.Z() + zmin)), partialInt);  // remove the part of the low end cell we didn't travel through
       // print_need_cout("removing low end of cell we didn't travel through (zi-zmin_roi=%d, length=%f)\n",zi-zmin_roi, startz-(zi*step.Z()+zmin));
     }
     if ((endz - zmin) / step.Z() - zf > ALMOST_ZERO)
     {
-      partialInt += field->Get(ri[i] - rmin_roi, pi[i] - phimin_roi, zf - zmin_roi) * (endz - (zf * step.Z() + zmin));  // add the part of the high end cell we did travel through
+      add_element(field, base + zf, endz - (zf * step.Z() + zmin), partialInt);  // add the part of the high end cell we did travel through
       // print_need_cout("adding low end of cell we did travel through (zf-zmin_roi=%d, length=%f)\n",zf-zmin_roi, endz-(zf*step.Z()+zmin));
     }
-    // print_need_cout("element r=%d,phi=%d, w=%f partialInt=(%2.2E,%2.2E,%2.2E)\n",ri[i],pi[i],rw[i]*pw[i],partialInt.X(),partialInt.Y(),partialInt.Z());
+    // print_need_cout("element r=%d,phi=%d, w=%f partialInt=(%2.2E,%2.2E,%2.2E)\n",ri[i],pi[i],rw[i]*pw[i],partialInt[0],partialInt[1],partialInt[2]);
 
-    fieldInt += rw[i] * pw[i] * partialInt;
+    double w = rw[i] * pw[i];
+    fieldInt[0] += w * partialInt[0];
+    fieldInt[1] += w * partialInt[1];
+    fieldInt[2] += w * partialInt[2];
   }
 
-  return dir * fieldInt;
+  return TVector3(dir * fieldInt[0], dir * fieldInt[1], dir * fieldInt[2]);
 }
 
 void AnnularFieldSim::load_analytic_spacecharge(float scalefactor = 1)
@@ -982,7 +983,7 @@ void AnnularFieldSim::load3dBfield(const std::string &filename, const std::strin
   return;
 }
 
-void AnnularFieldSim::loadField(MultiArray<TVector3> **field, TTree *source, float *rptr, float *phiptr, float *zptr, float *frptr, float *fphiptr, float *fzptr, float fieldunit, int zsign)
+void AnnularFieldSim::loadField(PackedVectorArray<double> **field, TTree *source, float *rptr, float *phiptr, float *zptr, float *frptr, float *fphiptr, float *fzptr, float fieldunit, int zsign)
 {
   // we're loading a tree of unknown size and spacing -- and possibly uneven spacing -- into our local data.
   // formally, we might want to interpolate or otherwise weight, but for now, carve this into our usual bins, and average, similar to the way we load spacecharge.
@@ -1738,6 +1739,15 @@ void AnnularFieldSim::populate_phislice_lookup()
   TVector3 from(1, 0, 0);
   TVector3 zero(0, 0, 0);
 
+  // if the green's functions are tabulated on our grid, evaluate each z column of sources in one call instead of one calc_unit_field per source:
+  const bool batched = (green != nullptr) && green->IsTabulatedFor(nr, rmin + 0.5 * step.Perp(), step.Perp(), nphi, 0.5 * step.Phi(), step.Phi(), nz, zmin + 0.5 * step.Z() + green_shift, step.Z());
+  std::vector<int> src_r(nz), src_phi(nz), src_z(nz);
+  std::vector<double> src_er(nz), src_ephi(nz), src_ez(nz);
+  if (batched)
+  {
+    std::cout << "using tabulated green's functions" << std::endl;
+  }
+
   int el = 0;
   for (int ifr = rmin_roi; ifr < rmax_roi; ifr++)
   {
@@ -1748,6 +1758,16 @@ void AnnularFieldSim::populate_phislice_lookup()
       {
         for (int iophi = 0; iophi < nphi; iophi++)
         {
+          if (batched)
+          {
+            for (int ioz = 0; ioz < nz; ioz++)
+            {
+              src_r[ioz] = ior;
+              src_phi[ioz] = iophi;
+              src_z[ioz] = ioz;
+            }
+            green->GridFields(ifr, 0, ifz, nz, src_r.data(), src_phi.data(), src_z.data(), src_er.data(), src_ephi.data(), src_ez.data());
+          }
           for (int ioz = 0; ioz < nz; ioz++)
           {
             el++;
@@ -1765,7 +1785,18 @@ void AnnularFieldSim::populate_phislice_lookup()
             }
             else
             {
-              TVector3 unitf = calc_unit_field(at, from);
+              TVector3 unitf;
+              if (batched)
+              {
+                // assembled exactly as calc_unit_field does, including dropping the phi term when source and target share a phi bin:
+                unitf.SetXYZ(-src_er[ioz], (iophi == 0) ? 0 : -src_ephi[ioz], -src_ez[ioz]);
+                unitf = unitf * epsinv;
+                unitf.RotateZ(at.Phi());
+              }
+              else
+              {
+                unitf = calc_unit_field(at, from);
+              }
               if (true)
               {
                 if (!(el % percent))
@@ -1785,7 +1816,68 @@ void AnnularFieldSim::populate_phislice_lookup()
   return;
 }
 
+void AnnularFieldSim::fill_phislice_params(double *params)
+{
+  // the geometry a phislice table depends on.  These are written in the header of a packed table and compared on load.
+  for (int i = 0; i < PackedVectorArray<float>::NPARAMS; i++)
+  {
+    params[i] = 0;
+  }
+  params[0] = rmin;
+  params[1] = rmax;
+  params[2] = zmin;
+  params[3] = zmax;
+  params[4] = rmin_roi;
+  params[5] = rmax_roi;
+  params[6] = zmin_roi;
+  params[7] = zmax_roi;
+  params[8] = nr;
+  params[9] = nphi;
+  params[10] = nz;
+  return;
+}
+
 void AnnularFieldSim::load_phislice_lookup(const std::string &sourcefile)
+{
+  if (!PackedVectorArray<float>::IsPackedFile(sourcefile))
+  {
+    load_phislice_lookup_root(sourcefile);
+    return;
+  }
+
+  std::cout << boost::str(boost::format("mapping packed phislice lookup for (%dx%dx%d)x(%dx%dx%d) grid from %s") % nr_roi % 1 % nz_roi % nr % nphi % nz % sourcefile) << std::endl;
+  double expected[PackedVectorArray<float>::NPARAMS];
+  double found[PackedVectorArray<float>::NPARAMS];
+  fill_phislice_params(expected);
+  PackedVectorArray<float> *table = PackedVectorArray<float>::Load(sourcefile, found);
+  if (!table)
+  {
+    std::cout << "could not load phislice lookup from " << sourcefile << std::endl;
+    exit(1);
+  }
+
+  const std::string names[] = {"rmin", "rmax", "zmin", "zmax", "rmin_roi", "rmax_roi", "zmin_roi", "zmax_roi", "nr", "np", "nz"};
+  bool match = (table->Length() == Epartial_phislice->Length());
+  std::cout << "param\tobj\tfile" << std::endl;
+  for (int i = 0; i < 11; i++)
+  {
+    std::cout << boost::str(boost::format("%s\t%2.2f\t%2.2f") % names[i] % expected[i] % found[i]) << std::endl;
+    match = match && (expected[i] == found[i]);
+  }
+  if (!match)
+  {
+    std::cout << "file parameters do not match fieldsim parameters:" << std::endl;
+    delete table;
+    exit(1);
+  }
+
+  // the packed table holds the field itself in internal units, so unlike the .root version no conversion is needed.
+  delete Epartial_phislice;
+  Epartial_phislice = table;
+  return;
+}
+
+void AnnularFieldSim::load_phislice_lookup_root(const std::string &sourcefile)
 {
   std::cout << boost::str(boost::format("loading phislice  lookup for (%dx%dx%d)x(%dx%dx%d) grid from %s") % nr_roi % 1 % nz_roi % nr % nphi % nz % sourcefile) << std::endl;
   unsigned long long totalelements = nr;  // nr*nphi*nz*nr_roi*nz_roi
@@ -1877,6 +1969,25 @@ void AnnularFieldSim::load_phislice_lookup(const std::string &sourcefile)
 }
 
 void AnnularFieldSim::save_phislice_lookup(const std::string &destfile)
+{
+  const std::string rootext = ".root";
+  if (destfile.size() >= rootext.size() && destfile.compare(destfile.size() - rootext.size(), rootext.size(), rootext) == 0)
+  {
+    save_phislice_lookup_root(destfile);
+    return;
+  }
+
+  std::cout << boost::str(boost::format("saving packed phislice lookup for (%dx%dx%d)x(%dx%dx%d) grid to %s") % nr_roi % 1 % nz_roi % nr % nphi % nz % destfile) << std::endl;
+  double params[PackedVectorArray<float>::NPARAMS];
+  fill_phislice_params(params);
+  if (!Epartial_phislice->Save(destfile, params))
+  {
+    std::cout << "could not save phislice lookup to " << destfile << std::endl;
+  }
+  return;
+}
+
+void AnnularFieldSim::save_phislice_lookup_root(const std::string &destfile)
 {
   std::cout << boost::str(boost::format("saving phislice  lookup for (%dx%dx%d)x(%dx%dx%d) grid to %s") % nr_roi % 1 % nz_roi % nr % nphi % nz % destfile) << std::endl;
   unsigned long long totalelements = nr;  // nr*nphi*nz*nr_roi*nz_roi
@@ -1965,14 +2076,8 @@ void AnnularFieldSim::setFlatFields(float B, float E)
 
   Enominal = E * (V / cm);
   Bnominal = B * Tesla;
-  for (int i = 0; i < Eexternal->Length(); i++)
-  {
-    Eexternal->GetFlat(i)->SetXYZ(0, 0, Enominal);
-  }
-  for (int i = 0; i < Bfield->Length(); i++)
-  {
-    Bfield->GetFlat(i)->SetXYZ(0, 0, Bnominal);
-  }
+  Eexternal->SetAll(0, 0, Enominal);
+  Bfield->SetAll(0, 0, Bnominal);
   UpdateOmegaTau();
   return;
 }
@@ -2418,14 +2523,22 @@ TVector3 AnnularFieldSim::sum_phislice_field_at(int r, int phi, int z)
 
   // unsigned long long el=0;
 
-  TVector3 sum(0, 0, 0);
-  TVector3 unrotatedField(0, 0, 0);
-  TVector3 unitField(0, 0, 0);
+  // the rotation is linear, so rather than rotating every unit field we sum the unrotated components and rotate the total once at the end.
+  // the source indices (ir,phirel,iz) are the fastest three in Epartial_phislice, so they're addressed directly from the start of this target's block.
+  const long int base = Epartial_phislice->Index(r - rmin_roi, 0, z - zmin_roi, 0, 0, 0);
+  const float *ux = Epartial_phislice->x + base;
+  const float *uy = Epartial_phislice->y + base;
+  const float *uz = Epartial_phislice->z + base;
+  double sx = 0;
+  double sy = 0;
+  double sz = 0;
   int phirel;
   for (int ir = 0; ir < nr; ir++)
   {
     for (int iphi = 0; iphi < nphi; iphi++)
     {
+      phirel = FilterPhiIndex(iphi - phi);
+      const long int rowstart = ((long int) ir * nphi + phirel) * nz;
       for (int iz = 0; iz < nz; iz++)
       {
         // sum+=*partial[x][phi][z][ix][iphi][iz] * *q[ix][iphi][iz];
@@ -2433,12 +2546,10 @@ TVector3 AnnularFieldSim::sum_phislice_field_at(int r, int phi, int z)
         {
           continue;  // dont' compute self-to-self field.
         }
-        phirel = FilterPhiIndex(iphi - phi);
-        unitField = Epartial_phislice->Get(r - rmin_roi, 0, z - zmin_roi, ir, phirel, iz);
-        unitField.RotateZ(rotphi);  // previously was rotate by the step.Phi()*phi.    //annoying that I can't rename this to 'rotated field' here without unnecessary overhead.
-
-        sum += unitField * q->GetChargeInBin(ir, iphi, iz);
-        ;
+        double charge = q->GetChargeInBin(ir, iphi, iz);
+        sx += ux[rowstart + iz] * charge;
+        sy += uy[rowstart + iz] * charge;
+        sz += uz[rowstart + iz] * charge;
 
         /*
         if(!(el%percent)) {print_need_cout("summing phislices %d%%:  ",(int)(el/percent));
@@ -2450,6 +2561,8 @@ TVector3 AnnularFieldSim::sum_phislice_field_at(int r, int phi, int z)
       }
     }
   }
+  TVector3 sum(sx, sy, sz);
+  sum.RotateZ(rotphi);  // previously was rotate by the step.Phi()*phi.
   // print_need_cout("summed field at (%d,%d,%d)=(%f,%f,%f)\n",x,y,z,sum.X(),sum.Y(),sum.Z());
   return sum;
 }
@@ -2506,9 +2619,10 @@ TVector3 AnnularFieldSim::swimToInAnalyticSteps(float zdest, TVector3 start, int
 
 TVector3 AnnularFieldSim::swimToInSteps(float zdest, const TVector3 &start, int steps = 1, bool interpolate = false, int *goodToStep = nullptr)
 {
-  int *success = nullptr;
+  int success = 0;  // GetTotalDistortion always writes this, so it can't be a null pointer.
+  int goodsteps = 0;
   TVector3 straightline(start.X(), start.Y(), zdest);
-  TVector3 distortion = GetTotalDistortion(zdest, start, steps, interpolate, goodToStep, success);
+  TVector3 distortion = GetTotalDistortion(zdest, start, steps, interpolate, goodToStep ? goodToStep : &goodsteps, &success);
   return straightline + distortion;
 }
 
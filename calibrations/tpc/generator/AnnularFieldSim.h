@@ -13,6 +13,8 @@ class TTree;
 
 template <class T>
 class MultiArray;
+template <class T>
+class PackedVectorArray;
 
 class AnnularFieldSim
 {
@@ -147,19 +149,15 @@ class AnnularFieldSim
   void loadBfield(const std::string &filename, const std::string &treename);
   void load3dBfield(const std::string &filename, const std::string &treename, int zsign = 1, float scale = 1.0);
 
-  void loadField(MultiArray<TVector3> **field, TTree *source, float *rptr, float *phiptr, float *zptr, float *frptr, float *fphiptr, float *fzptr, float fieldunit, int zsign);
+  void loadField(PackedVectorArray<double> **field, TTree *source, float *rptr, float *phiptr, float *zptr, float *frptr, float *fphiptr, float *fzptr, float fieldunit, int zsign);
 
-  void load_rossegger(double epsilon = 1E-4)
-  {
-    green = new Rossegger(rmin, rmax, zmax, epsilon);
-    return;
-  };
+  void load_rossegger(double epsilon = 1E-4);  // builds the greens functions and tabulates them on our cell grid.
   void borrow_rossegger(Rossegger *ross, float zshift)
   {
     green = ross;
     green_shift = zshift;
     return;
-  };  // get an already-existing rossegger table instead of loading it ourselves.
+  };  // get an already-existing rossegger table instead of loading it ourselves.  Its tabulated basis functions are shared too, and used wherever our shifted cell centers land on its grid.
   void borrow_epartial_from(AnnularFieldSim *sim, float zshift)
   {
     Epartial_phislice = sim->Epartial_phislice;
@@ -176,9 +174,9 @@ class AnnularFieldSim
   TVector3 calc_unit_field(TVector3 at, TVector3 from);
   TVector3 analyticFieldIntegral(float zdest, TVector3 start) { return analyticFieldIntegral(zdest, start, Efield); };
 
-  TVector3 analyticFieldIntegral(float zdest, TVector3 start, MultiArray<TVector3> *field);
+  TVector3 analyticFieldIntegral(float zdest, TVector3 start, PackedVectorArray<double> *field);
   TVector3 interpolatedFieldIntegral(float zdest, TVector3 start) { return interpolatedFieldIntegral(zdest, start, Efield); };
-  TVector3 interpolatedFieldIntegral(float zdest, const TVector3 &start, MultiArray<TVector3> *field);
+  TVector3 interpolatedFieldIntegral(float zdest, const TVector3 &start, PackedVectorArray<double> *field);
   double FilterPhiPos(double phi);         // puts phi in 0<phi<2pi
   int FilterPhiIndex(int phi, int range);  // puts phi in bin range 0<phi<range.  defaults to using nphi for range.
 
@@ -186,7 +184,7 @@ class AnnularFieldSim
   TVector3 GetRoiCellCenter(int r, int phi, int z);
   TVector3 GetGroupCellCenter(int r0, int r1, int phi0, int phi1, int z0, int z1);
   TVector3 GetWeightedCellCenter(int r, int phi, int z);
-  TVector3 fieldIntegral(float zdest, const TVector3 &start, MultiArray<TVector3> *field);
+  TVector3 fieldIntegral(float zdest, const TVector3 &start, PackedVectorArray<double> *field);
   void populate_fieldmap();
   // now handled by setting 'analytic' lookup:  void populate_analytic_fieldmap();
   void populate_lookup();
@@ -195,8 +193,8 @@ class AnnularFieldSim
   void populate_lowres_lookup();
   void populate_phislice_lookup();
 
-  void load_phislice_lookup(const std::string &sourcefile);
-  void save_phislice_lookup(const std::string &destfile);
+  void load_phislice_lookup(const std::string &sourcefile);  // reads either a packed (memory-mapped) table or a legacy .root table
+  void save_phislice_lookup(const std::string &destfile);    // writes a legacy TTree if destfile ends in .root, a packed table otherwise
 
   Rossegger *green;   // stand-alone class to compute greens functions.
   float green_shift;  // how far to offset our position in z when querying our green's functions.
@@ -215,6 +213,10 @@ class AnnularFieldSim
   TVector3 GetTotalDistortion(float zdest, const TVector3 &start, int nsteps, bool interpolate = true, int *goodToStep = 0, int *success = 0);
 
  private:
+  void load_phislice_lookup_root(const std::string &sourcefile);
+  void save_phislice_lookup_root(const std::string &destfile);
+  void fill_phislice_params(double *params);  // geometry stored alongside a packed lookup table, to check it matches on load.
+
   BoundsCase GetRindexAndCheckBounds(float pos, int *r);
   BoundsCase GetPhiIndexAndCheckBounds(float pos, int *phi);
   BoundsCase GetZindexAndCheckBounds(float pos, int *z);
@@ -332,13 +334,14 @@ class AnnularFieldSim
 
   // 3- and 6-dimensional arrays to handle bin and bin-to-bin data
   //
-  MultiArray<TVector3> *Efield;             // total electric field in each f-bin in the roi for given configuration of charge AND external field.
-  MultiArray<TVector3> *Epartial_highres;   // electric field in each f-bin in the roi from charge in a given f-bin or summed bin in the high res region.
-  MultiArray<TVector3> *Epartial_lowres;    // electric field in each l-bin in the roi from charge in a given l-bin anywhere in the volume.
-  MultiArray<TVector3> *Epartial;           // electric field for the old brute-force model.
-  MultiArray<TVector3> *Epartial_phislice;  // electric field in a 2D phi-slice from the full 3D region.
-  MultiArray<TVector3> *Eexternal;          // externally applied electric field in each f-bin in the roi
-  MultiArray<TVector3> *Bfield;             // magnetic field in each f-bin in the roi
+  // fields are kept in double precision, the (much larger) lookup tables in single precision.
+  PackedVectorArray<double> *Efield;            // total electric field in each f-bin in the roi for given configuration of charge AND external field.
+  PackedVectorArray<float> *Epartial_highres;   // electric field in each f-bin in the roi from charge in a given f-bin or summed bin in the high res region.
+  PackedVectorArray<float> *Epartial_lowres;    // electric field in each l-bin in the roi from charge in a given l-bin anywhere in the volume.
+  PackedVectorArray<float> *Epartial;           // electric field for the old brute-force model.
+  PackedVectorArray<float> *Epartial_phislice;  // electric field in a 2D phi-slice from the full 3D region.
+  PackedVectorArray<double> *Eexternal;         // externally applied electric field in each f-bin in the roi
+  PackedVectorArray<double> *Bfield;            // magnetic field in each f-bin in the roi
 
   ChargeMapReader *q;            // //class to read and report charge.
                                  //  MultiArray<double> *q;                    //space charge in each f-bin in the whole volume
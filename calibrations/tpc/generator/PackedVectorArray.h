@@ -0,0 +1,300 @@
+
+#ifndef PACKEDVECTORARRAY_H
+#define PACKEDVECTORARRAY_H
+
+#include <TVector3.h>
+
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>   // for printf, fopen
+#include <cstdlib>  // for calloc
+#include <cstring>  // for memcpy, strncmp
+#include <string>
+
+template <class T>
+class PackedVectorArray
+{
+  // class to hold an up-to-six dimensional array of 3-vectors, indexed exactly like MultiArray.
+  // MultiArray<TVector3> stores a whole TObject per element (vtable, fUniqueID, fBits, three doubles).  Here the three components are kept in three packed arrays of T instead, which is several times smaller and lets loops over the last index (z) run over contiguous memory.
+  // TVector3 is still accepted and returned at the interface so callers that don't care about speed don't need to change.
+  // Tables can be written to a flat binary file with Save() and memory-mapped back with Load(), which avoids a TTree round-trip and lets several processes on one node share the same pages.
+ public:
+  static const int MAX_DIM = 6;
+  static const int NPARAMS = 16;            // number of user doubles stored in the file header, for the caller to check geometry etc.
+  static const long int HEADER_SIZE = 256;  // bytes reserved for the header in the file.  Keeps the data aligned.
+  int dim;
+  int n[6];
+  long int length;
+  T *x;  // the three component arrays, each 'length' long
+  T *y;
+  T *z;
+
+  PackedVectorArray(int a = 0, int b = 0, int c = 0, int d = 0, int e = 0, int f = 0)
+  {
+    int n_[6] = {a, b, c, d, e, f};
+    SetDimensions(n_);
+    block = static_cast<T *>(calloc(3 * length, sizeof(T)));  // unlike MultiArray, T is always arithmetic, so we can zero it.
+    SetComponentPointers(block);
+  }
+  //! delete copy ctor and assignment opertor (cppcheck)
+  explicit PackedVectorArray(const PackedVectorArray &) = delete;
+  PackedVectorArray &operator=(const PackedVectorArray &) = delete;
+
+  ~PackedVectorArray()
+  {
+    if (mapped)
+    {
+      munmap(mapped, mappedSize);
+    }
+    else
+    {
+      free(block);
+    }
+  }
+
+  long int Index(int a = 0, int b = 0, int c = 0, int d = 0, int e = 0, int f = 0) const
+  {  // flat index of an element, without bounds checking.  Matches MultiArray's ordering, so the last used index is the fastest.
+    int n_[6] = {a, b, c, d, e, f};
+    long int index = n_[0];
+    for (int i = 1; i < dim; i++)
+    {
+      index = (index * n[i]) + n_[i];
+    }
+    return index;
+  }
+
+  void Add(int a, int b, int c, const TVector3 &in)
+  {
+    Add(a, b, c, 0, 0, 0, in);
+    return;
+  };
+
+  void Add(int a, int b, int c, int d, int e, int f, const TVector3 &in)
+  {
+    long int index = Index(a, b, c, d, e, f);
+    x[index] += in.X();
+    y[index] += in.Y();
+    z[index] += in.Z();
+    return;
+  }
+
+  TVector3 Get(int a = 0, int b = 0, int c = 0, int d = 0, int e = 0, int f = 0) const
+  {
+    int n_[6] = {a, b, c, d, e, f};
+    for (int i = 0; i < dim; i++)
+    {
+      if (n[i] <= n_[i] || n_[i] < 0)
+      {  // check bounds
+        printf("asking for el %d %d %d %d %d %d.  %dth element is outside of bounds 0<x<%d\n", n_[0], n_[1], n_[2], n_[3], n_[4], n_[5], n_[i], n[i]);
+        assert(false);
+      }
+    }
+    return GetFlat(Index(a, b, c, d, e, f));
+  }
+
+  TVector3 GetFlat(long int a) const
+  {  // get the value at position a in the 1D equivalent.
+    if (a < 0 || a >= length)
+    {
+      printf("tried to seek element %ld of packedvectorarray, but bounds are 0<a<%ld\n", a, length);
+      assert(a >= 0 && a < length);  // check bounds
+    }
+    return TVector3(x[a], y[a], z[a]);
+  }
+
+  int Length() const
+  {
+    return (int) length;
+  }
+
+  void Set(int a, int b, int c, const TVector3 &in)
+  {
+    Set(a, b, c, 0, 0, 0, in);
+    return;
+  };
+
+  void Set(int a, int b, int c, int d, int e, int f, const TVector3 &in)
+  {
+    SetFlat(Index(a, b, c, d, e, f), in.X(), in.Y(), in.Z());
+    return;
+  }
+
+  void SetFlat(long int a, T inx, T iny, T inz)
+  {
+    x[a] = inx;
+    y[a] = iny;
+    z[a] = inz;
+    return;
+  }
+
+  void SetAll(T inx, T iny, T inz)
+  {
+    for (long int i = 0; i < length; i++)
+    {
+      x[i] = inx;
+      y[i] = iny;
+      z[i] = inz;
+    }
+    return;
+  }
+
+  bool Save(const std::string &filename, const double *params = nullptr) const
+  {
+    // writes the header, then the x, y, and z blocks.  'params' is an optional array of NPARAMS doubles the caller can use to describe the table.
+    FileHeader head;
+    memset(&head, 0, sizeof(head));
+    memcpy(head.magic, MAGIC, sizeof(head.magic));
+    head.typesize = sizeof(T);
+    head.dim = dim;
+    for (int i = 0; i < MAX_DIM; i++)
+    {
+      head.n[i] = n[i];
+    }
+    head.length = length;
+    if (params)
+    {
+      memcpy(head.params, params, NPARAMS * sizeof(double));
+    }
+    char padded[HEADER_SIZE] = {0};
+    memcpy(padded, &head, sizeof(head));
+
+    FILE *out = fopen(filename.c_str(), "wb");
+    if (!out)
+    {
+      printf("PackedVectorArray::Save could not open %s for writing\n", filename.c_str());
+      return false;
+    }
+    bool ok = (fwrite(padded, 1, HEADER_SIZE, out) == (size_t) HEADER_SIZE);
+    ok = ok && (fwrite(x, sizeof(T), length, out) == (size_t) length);
+    ok = ok && (fwrite(y, sizeof(T), length, out) == (size_t) length);
+    ok = ok && (fwrite(z, sizeof(T), length, out) == (size_t) length);
+    ok = (fclose(out) == 0) && ok;
+    if (!ok)
+    {
+      printf("PackedVectorArray::Save failed while writing %s\n", filename.c_str());
+    }
+    return ok;
+  }
+
+  static bool IsPackedFile(const std::string &filename)
+  {
+    // checks whether the file starts with our magic word, so callers can fall back to other formats.
+    FILE *in = fopen(filename.c_str(), "rb");
+    if (!in)
+    {
+      return false;
+    }
+    char magic[8];
+    bool isPacked = (fread(magic, 1, sizeof(magic), in) == sizeof(magic)) && (strncmp(magic, MAGIC, sizeof(magic)) == 0);
+    fclose(in);
+    return isPacked;
+  }
+
+  static PackedVectorArray<T> *Load(const std::string &filename, double *params = nullptr)
+  {
+    // maps the file into memory rather than reading it.  The mapping is private, so Set/Add still work on this copy without touching the file, and untouched pages stay shared with any other process that mapped the same table.
+    // returns nullptr if the file can't be mapped or doesn't hold an array of T.
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      printf("PackedVectorArray::Load could not open %s\n", filename.c_str());
+      return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < HEADER_SIZE)
+    {
+      printf("PackedVectorArray::Load: %s is too short to hold a header\n", filename.c_str());
+      close(fd);
+      return nullptr;
+    }
+    void *addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps its own reference to the file.
+    if (addr == MAP_FAILED)
+    {
+      printf("PackedVectorArray::Load could not map %s\n", filename.c_str());
+      return nullptr;
+    }
+
+    FileHeader head;
+    memcpy(&head, addr, sizeof(head));
+    if (strncmp(head.magic, MAGIC, sizeof(head.magic)) != 0 || head.typesize != (int32_t) sizeof(T) || head.dim < 1 || head.dim > MAX_DIM || st.st_size < HEADER_SIZE + 3 * head.length * (long int) sizeof(T))
+    {
+      printf("PackedVectorArray::Load: %s is not a packed array of %d-byte elements, or is truncated\n", filename.c_str(), (int) sizeof(T));
+      munmap(addr, st.st_size);
+      return nullptr;
+    }
+    if (params)
+    {
+      memcpy(params, head.params, NPARAMS * sizeof(double));
+    }
+
+    PackedVectorArray<T> *ret = new PackedVectorArray<T>(head.n, addr, st.st_size);
+    assert(ret->length == head.length);
+    return ret;
+  }
+
+ private:
+  static constexpr const char *MAGIC = "PVARRAY1";
+  struct FileHeader
+  {
+    char magic[8];
+    int32_t typesize;
+    int32_t dim;
+    int32_t n[MAX_DIM];
+    int64_t length;
+    double params[NPARAMS];
+  };
+  static_assert(sizeof(FileHeader) <= HEADER_SIZE, "PackedVectorArray header does not fit in its reserved space");
+
+  T *block = nullptr;      // calloc'd storage for all three components, if we own it
+  void *mapped = nullptr;  // start of the mapping, if we were loaded from a file
+  size_t mappedSize = 0;   // length of the mapping
+
+  PackedVectorArray(const int32_t *n_in, void *addr, size_t size)
+    : mapped(addr)
+    , mappedSize(size)
+  {
+    int n_[6];
+    for (int i = 0; i < MAX_DIM; i++)
+    {
+      n_[i] = n_in[i];
+    }
+    SetDimensions(n_);
+    SetComponentPointers(reinterpret_cast<T *>(static_cast<char *>(addr) + HEADER_SIZE));
+  }
+
+  void SetDimensions(const int *n_)
+  {
+    for (int i = 0; i < MAX_DIM; i++)
+    {
+      n[i] = 0;
+    }
+    length = 1;
+    dim = MAX_DIM;
+    for (int i = 0; i < dim; i++)
+    {
+      if (n_[i] < 1)
+      {
+        dim = i;
+        break;
+      }
+      n[i] = n_[i];
+      length *= n[i];
+    }
+    return;
+  }
+
+  void SetComponentPointers(T *start)
+  {
+    x = start;
+    y = start + length;
+    z = start + 2 * length;
+    return;
+  }
+};
+#endif  // PACKEDVECTORARRAY_H
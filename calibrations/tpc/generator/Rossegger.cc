@@ -801,6 +801,17 @@ double Rossegger::Ez(double r, double phi, double z, double r1, double phi1, dou
     ;
     return 0;
   }
+  int ir, iphi, iz, ir1, iphi1, iz1;
+  if (OnGrid(r, phi, z, &ir, &iphi, &iz) && OnGrid(r1, phi1, z1, &ir1, &iphi1, &iz1))
+  {
+    double G = GridEz(ir, iphi, iz, ir1, iphi1, iz1);
+    if (verbosity)
+    {
+      std::cout << "Ez = " << G << " (tabulated)" << std::endl;
+    }
+    return G;
+  }
+
   // Rossegger Equation 5.64
   double G = 0;
   for (int m = 0; m < NumberOfOrders; m++)
@@ -1007,6 +1018,17 @@ double Rossegger::Er(double r, double phi, double z, double r1, double phi1, dou
     return 0;
   }
 
+  int ir, iphi, iz, ir1, iphi1, iz1;
+  if (OnGrid(r, phi, z, &ir, &iphi, &iz) && OnGrid(r1, phi1, z1, &ir1, &iphi1, &iz1))
+  {
+    double G = GridEr(ir, iphi, iz, ir1, iphi1, iz1);
+    if (verbosity)
+    {
+      std::cout << "Er = " << G << " (tabulated)" << std::endl;
+    }
+    return G;
+  }
+
   double part = 0;
   double G = 0;
   for (int m = 0; m < NumberOfOrders; m++)
@@ -1171,6 +1193,17 @@ double Rossegger::Ephi(double r, double phi, double z, double r1, double phi1, d
     return 0;
   }
 
+  int ir, iphi, iz, ir1, iphi1, iz1;
+  if (OnGrid(r, phi, z, &ir, &iphi, &iz) && OnGrid(r1, phi1, z1, &ir1, &iphi1, &iz1))
+  {
+    double G = GridEphi(ir, iphi, iz, ir1, iphi1, iz1);
+    if (verbosity)
+    {
+      std::cout << "Ephi = " << G << " (tabulated)" << std::endl;
+    }
+    return G;
+  }
+
   double G = 0;
   // Rossegger Eqn. 5.66:
   for (int k = 0; k < NumberOfOrders; k++)
@@ -1320,6 +1353,289 @@ double Rossegger::Ephi_(double r, double phi, double z, double r1, double phi1,
   return G;
 }
 
+void Rossegger::TabulateGrid(int nr, double r0, double dr, int nphi, double phi0, double dphi, int nz, double z0, double dz)
+{
+  // evaluates every factor of Rossegger 5.64-5.66 that depends on only one of the two points, once per grid point.
+  // the Bessel-function calls all happen here, so the field evaluations afterwards are pure arithmetic.
+  std::cout << boost::str(boost::format("Rossegger::TabulateGrid tabulating basis functions on (%dx%dx%d) grid") % nr % nphi % nz) << std::endl;
+  const int nmn = NumberOfOrders * NumberOfOrders;
+
+  tab_nr = nr;
+  tab_nphi = nphi;
+  tab_nz = nz;
+  tab_r0 = r0;
+  tab_dr = dr;
+  tab_phi0 = phi0;
+  tab_dphi = dphi;
+  tab_z0 = z0;
+  tab_dz = dz;
+
+  tab_Rmn.assign(nr * nmn, 0);
+  tab_RmnN.assign(nr * nmn, 0);
+  tab_RPrimeA.assign(nr * nmn, 0);
+  tab_RPrimeB.assign(nr * nmn, 0);
+  tab_Rmn1D.assign(nr * nmn, 0);
+  tab_Rmn2D.assign(nr * nmn, 0);
+  tab_Rnk.assign(nr * nmn, 0);
+  tab_RnkN.assign(nr * nmn, 0);
+  for (int ir = 0; ir < nr; ir++)
+  {
+    double r = r0 + ir * dr;
+    for (int m = 0; m < NumberOfOrders; m++)
+    {
+      for (int n = 0; n < NumberOfOrders; n++)
+      {
+        int i = ir * nmn + m * NumberOfOrders + n;
+        tab_Rmn[i] = Rmn(m, n, r);
+        tab_RmnN[i] = tab_Rmn[i] / N2mn[m][n];
+        tab_RPrimeA[i] = RPrime(m, n, a, r);
+        tab_RPrimeB[i] = RPrime(m, n, b, r);
+        tab_Rmn1D[i] = Rmn1(m, n, r) / bessel_denominator[m][n];
+        tab_Rmn2D[i] = Rmn2(m, n, r) / bessel_denominator[m][n];
+      }
+    }
+    for (int n = 0; n < NumberOfOrders; n++)
+    {
+      for (int k = 0; k < NumberOfOrders; k++)
+      {
+        int i = ir * nmn + n * NumberOfOrders + k;
+        tab_Rnk[i] = Rnk(n, k, r);
+        tab_RnkN[i] = tab_Rnk[i] / N2nk[n][k];
+      }
+    }
+  }
+
+  tab_sinBz.assign(nz * NumberOfOrders, 0);
+  tab_coshBz.assign(nz * nmn, 0);
+  tab_coshBLz.assign(nz * nmn, 0);
+  tab_sinhBz.assign(nz * nmn, 0);
+  tab_sinhBLz.assign(nz * nmn, 0);
+  for (int iz = 0; iz < nz; iz++)
+  {
+    double z = z0 + iz * dz;
+    for (int n = 0; n < NumberOfOrders; n++)
+    {
+      tab_sinBz[iz * NumberOfOrders + n] = sin(BetaN[n] * z);
+    }
+    for (int m = 0; m < NumberOfOrders; m++)
+    {
+      for (int n = 0; n < NumberOfOrders; n++)
+      {
+        int i = iz * nmn + m * NumberOfOrders + n;
+        tab_coshBz[i] = cosh(Betamn[m][n] * z);
+        tab_coshBLz[i] = cosh(Betamn[m][n] * (L - z));
+        tab_sinhBz[i] = sinh(Betamn[m][n] * z) / sinh_Betamn_L[m][n];
+        tab_sinhBLz[i] = sinh(Betamn[m][n] * (L - z)) / sinh_Betamn_L[m][n];
+      }
+    }
+  }
+
+  // the phi dependence is only through |phi-phi1| (plus a sign for Ephi), so it's tabulated by the difference in index:
+  tab_cosMphi.assign(nphi * NumberOfOrders, 0);
+  tab_sinhMunkPhi.assign(nphi * nmn, 0);
+  for (int j = 0; j < nphi; j++)
+  {
+    double delphi = j * dphi;
+    for (int m = 0; m < NumberOfOrders; m++)
+    {
+      tab_cosMphi[j * NumberOfOrders + m] = (2 - ((m == 0) ? 1 : 0)) * cos(m * delphi);
+    }
+    for (int n = 0; n < NumberOfOrders; n++)
+    {
+      for (int k = 0; k < NumberOfOrders; k++)
+      {
+        tab_sinhMunkPhi[j * nmn + n * NumberOfOrders + k] = sinh(Munk[n][k] * (pi - delphi)) / sinh_pi_Munk[n][k];
+      }
+    }
+  }
+  return;
+}
+
+bool Rossegger::IsTabulatedFor(int nr, double r0, double dr, int nphi, double phi0, double dphi, int nz, double z0, double dz) const
+{
+  auto same = [](double x, double y)
+  { return std::abs(x - y) <= 1e-9 * std::max(1.0, std::abs(x)); };
+  return IsTabulated() && nr == tab_nr && nphi == tab_nphi && nz == tab_nz &&
+         same(r0, tab_r0) && same(dr, tab_dr) && same(phi0, tab_phi0) && same(dphi, tab_dphi) && same(z0, tab_z0) && same(dz, tab_dz);
+}
+
+bool Rossegger::GridIndex(double v, double v0, double dv, int nv, int *index) const
+{
+  double x = (v - v0) / dv;
+  int i = std::lround(x);
+  if (i < 0 || i >= nv || std::abs(x - i) > 1e-4)
+  {
+    return false;
+  }
+  *index = i;
+  return true;
+}
+
+bool Rossegger::OnGrid(double r, double phi, double z, int *ir, int *iphi, int *iz) const
+{
+  return IsTabulated() && GridIndex(r, tab_r0, tab_dr, tab_nr, ir) && GridIndex(phi, tab_phi0, tab_dphi, tab_nphi, iphi) && GridIndex(z, tab_z0, tab_dz, tab_nz, iz);
+}
+
+double Rossegger::GridEz(int ir, int iphi, int iz, int ir1, int iphi1, int iz1)
+{
+  // Rossegger Equation 5.64, with every factor read from the tables
+  const int nmn = NumberOfOrders * NumberOfOrders;
+  const double *R = &tab_Rmn[ir * nmn];
+  const double *R1 = &tab_RmnN[ir1 * nmn];
+  const double *cosm = &tab_cosMphi[std::abs(iphi - iphi1) * NumberOfOrders];
+  const bool below = (iz < iz1);  // z<z1
+  const double *Z = below ? &tab_coshBz[iz * nmn] : &tab_coshBLz[iz * nmn];
+  const double *Z1 = below ? &tab_sinhBLz[iz1 * nmn] : &tab_sinhBz[iz1 * nmn];
+  double G = 0;
+  for (int m = 0; m < NumberOfOrders; m++)
+  {
+    double Gm = 0;
+    for (int n = 0; n < NumberOfOrders; n++)
+    {
+      int i = m * NumberOfOrders + n;
+      Gm += R[i] * R1[i] * Z[i] * Z1[i];
+    }
+    G += cosm[m] * Gm;
+  }
+  return (below ? G : -G) / (2.0 * pi);
+}
+
+double Rossegger::GridEr(int ir, int iphi, int iz, int ir1, int iphi1, int iz1)
+{
+  // Rossegger Equation 5.65, with every factor read from the tables
+  const int nmn = NumberOfOrders * NumberOfOrders;
+  const double *cosm = &tab_cosMphi[std::abs(iphi - iphi1) * NumberOfOrders];
+  const double *sz = &tab_sinBz[iz * NumberOfOrders];
+  const double *sz1 = &tab_sinBz[iz1 * NumberOfOrders];
+  const bool inside = (ir < ir1);  // r<r1
+  const double *R = inside ? &tab_RPrimeA[ir * nmn] : &tab_RPrimeB[ir * nmn];
+  const double *R1 = inside ? &tab_Rmn2D[ir1 * nmn] : &tab_Rmn1D[ir1 * nmn];
+  double G = 0;
+  for (int m = 0; m < NumberOfOrders; m++)
+  {
+    double Gm = 0;
+    for (int n = 0; n < NumberOfOrders; n++)
+    {
+      int i = m * NumberOfOrders + n;
+      Gm += sz[n] * sz1[n] * R[i] * R1[i];
+    }
+    G += cosm[m] * Gm;
+  }
+  return G / (L * pi);
+}
+
+double Rossegger::GridEphi(int ir, int iphi, int iz, int ir1, int iphi1, int iz1)
+{
+  // Rossegger Equation 5.66, with every factor read from the tables
+  const int nmn = NumberOfOrders * NumberOfOrders;
+  const double *sz = &tab_sinBz[iz * NumberOfOrders];
+  const double *sz1 = &tab_sinBz[iz1 * NumberOfOrders];
+  const double *R = &tab_Rnk[ir * nmn];
+  const double *R1 = &tab_RnkN[ir1 * nmn];
+  const double *S = &tab_sinhMunkPhi[std::abs(iphi - iphi1) * nmn];
+  double G = 0;
+  for (int n = 0; n < NumberOfOrders; n++)
+  {
+    double Gn = 0;
+    for (int k = 0; k < NumberOfOrders; k++)
+    {
+      int i = n * NumberOfOrders + k;
+      Gn += R[i] * R1[i] * S[i];
+    }
+    G += sz[n] * sz1[n] * Gn;
+  }
+  // the derivative of cosh(munk(pi-|phi-phi1|)) flips sign with phi-phi1:
+  if (iphi > iphi1)
+  {
+    G = -G;
+  }
+  return G / (L * (tab_r0 + ir * tab_dr));
+}
+
+void Rossegger::GridFields(int ir, int iphi, int iz, int nsrc, const int *ir1, const int *iphi1, const int *iz1, double *er, double *ephi, double *ez)
+{
+  // same sums as GridEz, GridEr and GridEphi, but with everything that depends only on the field point folded together once,
+  // so each source costs one pass over three contiguous NumberOfOrders^2 vectors.
+  const int nmn = NumberOfOrders * NumberOfOrders;
+  double ezBelow[nmn];    // z<z1
+  double ezAbove[nmn];    // z>=z1, sign included
+  double erInside[nmn];   // r<r1
+  double erOutside[nmn];  // r>=r1
+  double ephiT[nmn];
+  for (int m = 0; m < NumberOfOrders; m++)
+  {
+    for (int n = 0; n < NumberOfOrders; n++)
+    {
+      int i = m * NumberOfOrders + n;
+      ezBelow[i] = tab_Rmn[ir * nmn + i] * tab_coshBz[iz * nmn + i];
+      ezAbove[i] = -tab_Rmn[ir * nmn + i] * tab_coshBLz[iz * nmn + i];
+      erInside[i] = tab_RPrimeA[ir * nmn + i] * tab_sinBz[iz * NumberOfOrders + n];
+      erOutside[i] = tab_RPrimeB[ir * nmn + i] * tab_sinBz[iz * NumberOfOrders + n];
+    }
+  }
+  for (int n = 0; n < NumberOfOrders; n++)
+  {
+    for (int k = 0; k < NumberOfOrders; k++)
+    {
+      int i = n * NumberOfOrders + k;
+      ephiT[i] = tab_Rnk[ir * nmn + i] * tab_sinBz[iz * NumberOfOrders + n];
+    }
+  }
+  const double ephiScale = 1.0 / (L * (tab_r0 + ir * tab_dr));
+
+  for (int s = 0; s < nsrc; s++)
+  {
+    const int jr = ir1[s];
+    const int jz = iz1[s];
+    const int dphi = std::abs(iphi - iphi1[s]);
+    const double *cosm = &tab_cosMphi[dphi * NumberOfOrders];
+    const double *sz1 = &tab_sinBz[jz * NumberOfOrders];
+
+    const bool below = (iz < jz);
+    const double *zT = below ? ezBelow : ezAbove;
+    const double *zS = below ? &tab_sinhBLz[jz * nmn] : &tab_sinhBz[jz * nmn];
+    const double *zR = &tab_RmnN[jr * nmn];
+
+    const bool inside = (ir < jr);
+    const double *rT = inside ? erInside : erOutside;
+    const double *rS = inside ? &tab_Rmn2D[jr * nmn] : &tab_Rmn1D[jr * nmn];
+
+    double gz = 0;
+    double gr = 0;
+    for (int m = 0; m < NumberOfOrders; m++)
+    {
+      double pz = 0;
+      double pr = 0;
+      for (int n = 0; n < NumberOfOrders; n++)
+      {
+        int i = m * NumberOfOrders + n;
+        pz += zT[i] * zR[i] * zS[i];
+        pr += rT[i] * rS[i] * sz1[n];
+      }
+      gz += cosm[m] * pz;
+      gr += cosm[m] * pr;
+    }
+    ez[s] = gz / (2.0 * pi);
+    er[s] = gr / (L * pi);
+
+    const double *pR = &tab_RnkN[jr * nmn];
+    const double *pS = &tab_sinhMunkPhi[dphi * nmn];
+    double gp = 0;
+    for (int n = 0; n < NumberOfOrders; n++)
+    {
+      double pn = 0;
+      for (int k = 0; k < NumberOfOrders; k++)
+      {
+        int i = n * NumberOfOrders + k;
+        pn += ephiT[i] * pR[i] * pS[i];
+      }
+      gp += sz1[n] * pn;
+    }
+    ephi[s] = ((iphi > iphi1[s]) ? -gp : gp) * ephiScale;
+  }
+  return;
+}
+
 void Rossegger::SaveZeroes(const std::string &destfile)
 {
   TFile *output = TFile::Open(destfile.c_str(), "RECREATE");
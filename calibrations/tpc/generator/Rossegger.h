@@ -21,6 +21,7 @@
 #include <cstdio>
 #include <map>
 #include <string>
+#include <vector>
 
 class TH2;
 class TH3;
@@ -68,6 +69,15 @@ class Rossegger
   double Er_(double r, double phi, double z, double r1, double phi1, double z1);
   double Ephi_(double r, double phi, double z, double r1, double phi1, double z1);
 
+  // tabulate the radial and axial basis functions at the points r0+i*dr, phi0+j*dphi, z0+k*dz.
+  // after this, Er, Ephi and Ez are dot products of cached vectors whenever both points are on the grid, and fall back to the full calculation otherwise.
+  // the tables live in this object, so every AnnularFieldSim that borrows it shares them.
+  void TabulateGrid(int nr, double r0, double dr, int nphi, double phi0, double dphi, int nz, double z0, double dz);
+  bool IsTabulated() const { return tab_nr > 0; }
+  bool IsTabulatedFor(int nr, double r0, double dr, int nphi, double phi0, double dphi, int nz, double z0, double dz) const;
+  // all three components at grid point (ir,iphi,iz) due to unit charges at each of nsrc grid points (ir1[i],iphi1[i],iz1[i]).  Requires TabulateGrid.
+  void GridFields(int ir, int iphi, int iz, int nsrc, const int *ir1, const int *iphi1, const int *iz1, double *er, double *ephi, double *ez);
+
  protected:
   bool fByFile = false;
   double a = NAN;
@@ -115,6 +125,38 @@ class Rossegger
   double sinh_Betamn_L[NumberOfOrders][NumberOfOrders]{};   // sinh(Betamn[m][n]*L)  as in Rossegger 5.64
   double sinh_pi_Munk[NumberOfOrders][NumberOfOrders]{};    // sinh(pi*Munk[n][k]) as in Rossegger 5.66
 
+  bool GridIndex(double v, double v0, double dv, int nv, int *index) const;  // true if v is (within rounding) the index'th grid point.
+  bool OnGrid(double r, double phi, double z, int *ir, int *iphi, int *iz) const;
+  double GridEz(int ir, int iphi, int iz, int ir1, int iphi1, int iz1);
+  double GridEr(int ir, int iphi, int iz, int ir1, int iphi1, int iz1);
+  double GridEphi(int ir, int iphi, int iz, int ir1, int iphi1, int iz1);
+
+  // tabulated basis functions, filled by TabulateGrid.  Each per-point block is NumberOfOrders*NumberOfOrders long, ordered [m][n] (or [n][k] for the Rnk terms).
+  int tab_nr = 0;
+  int tab_nphi = 0;
+  int tab_nz = 0;
+  double tab_r0 = NAN;
+  double tab_dr = NAN;
+  double tab_phi0 = NAN;
+  double tab_dphi = NAN;
+  double tab_z0 = NAN;
+  double tab_dz = NAN;
+  std::vector<double> tab_Rmn;          // [ir][m][n] Rmn(m,n,r)
+  std::vector<double> tab_RmnN;         // [ir][m][n] Rmn(m,n,r)/N2mn[m][n]
+  std::vector<double> tab_RPrimeA;      // [ir][m][n] RPrime(m,n,a,r)
+  std::vector<double> tab_RPrimeB;      // [ir][m][n] RPrime(m,n,b,r)
+  std::vector<double> tab_Rmn1D;        // [ir][m][n] Rmn1(m,n,r)/bessel_denominator[m][n]
+  std::vector<double> tab_Rmn2D;        // [ir][m][n] Rmn2(m,n,r)/bessel_denominator[m][n]
+  std::vector<double> tab_Rnk;          // [ir][n][k] Rnk(n,k,r)
+  std::vector<double> tab_RnkN;         // [ir][n][k] Rnk(n,k,r)/N2nk[n][k]
+  std::vector<double> tab_sinBz;        // [iz][n] sin(BetaN[n]*z)
+  std::vector<double> tab_coshBz;       // [iz][m][n] cosh(Betamn*z)
+  std::vector<double> tab_coshBLz;      // [iz][m][n] cosh(Betamn*(L-z))
+  std::vector<double> tab_sinhBz;       // [iz][m][n] sinh(Betamn*z)/sinh(Betamn*L)
+  std::vector<double> tab_sinhBLz;      // [iz][m][n] sinh(Betamn*(L-z))/sinh(Betamn*L)
+  std::vector<double> tab_cosMphi;      // [|dphi index|][m] (2-delta_m0)*cos(m*dphi)
+  std::vector<double> tab_sinhMunkPhi;  // [|dphi index|][n][k] sinh(Munk*(pi-|dphi|))/sinh(pi*Munk)
+
   TH2 *Tags = nullptr;
   std::map<std::string, TH3 *> Grid;
 };
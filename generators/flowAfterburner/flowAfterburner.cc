@@ -15,10 +15,6 @@
 
 #include <phool/phool.h>
 
-#include <gsl/gsl_errno.h>
-#include <gsl/gsl_math.h>
-#include <gsl/gsl_roots.h>
-
 #include <HepMC/GenEvent.h>
 #include <HepMC/GenParticle.h>  // for GenParticle
 #include <HepMC/GenRanges.h>
@@ -30,10 +26,12 @@
 #include <CLHEP/Random/RandFlat.h>
 #include <CLHEP/Vector/LorentzVector.h>
 
+#include <array>
 #include <cmath>
 #include <cstdlib>  // for exit
 #include <iostream>
 #include <map>  // for map
+#include <vector>
 
 namespace CLHEP
 {
@@ -59,40 +57,99 @@ struct loaderObj
 
 loaderObj loader;
 
+float psi_n[6], v1, v2, v3, v4, v5, v6;
+
+// the shifted azimuth x of a particle with initial azimuth phi_0 is the root of
+// x + 2 sum_n vn/n sin(n (x - psi_n)) - phi_0
 double
-vn_func(double x, void *params)
+vn_func(double x, double phi_0, const float *vn)
 {
-  float *par_float = (float *) params;
-  float phi_0 = par_float[0];
-  float *vn = par_float + 1;
-  float *psi_n = vn + 6;
-  double val =
-      x + 2 * (vn[0] * sin(1 * (x - psi_n[0])) / 1.0 +
-               vn[1] * sin(2 * (x - psi_n[1])) / 2.0 +
-               vn[2] * sin(3 * (x - psi_n[2])) / 3.0 +
-               vn[3] * sin(4 * (x - psi_n[3])) / 4.0 +
-               vn[4] * sin(5 * (x - psi_n[4])) / 5.0 +
-               vn[5] * sin(6 * (x - psi_n[5])) / 6.0);
+  double val = x;
+  for (int n = 0; n < 6; ++n)
+  {
+    val += 2 * vn[n] * sin((n + 1) * (x - psi_n[n])) / (n + 1);
+  }
   return val - phi_0;
 }
 
 double
-vn_func_derivative(double x, void *params)
+vn_func_derivative(double x, const float *vn)
 {
-  float *par_float = (float *) params;
-  float *vn = par_float + 1;
-  float *psi_n = vn + 6;
-  double val =
-      1 + 2 * (vn[0] * cos(1 * (x - psi_n[0])) / 1.0 +
-               vn[1] * cos(2 * (x - psi_n[1])) / 2.0 +
-               vn[2] * cos(3 * (x - psi_n[2])) / 3.0 +
-               vn[3] * cos(4 * (x - psi_n[3])) / 4.0 +
-               vn[4] * cos(5 * (x - psi_n[4])) / 5.0 +
-               vn[5] * cos(6 * (x - psi_n[5])) / 6.0);
+  double val = 1;
+  for (int n = 0; n < 6; ++n)
+  {
+    val += 2 * vn[n] * cos((n + 1) * (x - psi_n[n]));
+  }
   return val;
 }
 
-float psi_n[6], v1, v2, v3, v4, v5, v6;
+// Solve for the shifted azimuth of all particles at once. All particles
+// take a Newton step per iteration, starting from phi_0. Each keeps the
+// bracket [-2pi, 2pi] used by the former gsl brent solver, shrunk at every
+// step, and falls back to bisection when the Newton step leaves it.
+// Particles which do not converge keep their azimuth (converged = 0)
+void SolveFlowAngles(const std::vector<double> &phi_0,
+                     const std::vector<std::array<float, 6>> &vn,
+                     std::vector<double> &phi,
+                     std::vector<char> &converged)
+{
+  const double tolerance = 1e-7;
+  const int max_iter = 100;
+
+  const size_t n = phi_0.size();
+  phi = phi_0;
+  converged.assign(n, 0);
+  std::vector<double> x_lo(n, -2 * M_PI);
+  std::vector<double> x_hi(n, 2 * M_PI);
+
+  size_t nactive = n;
+  for (int iter = 0; iter < max_iter && nactive > 0; ++iter)
+  {
+    nactive = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (converged[i])
+      {
+        continue;
+      }
+
+      const double x = phi[i];
+      const double f = vn_func(x, phi_0[i], vn[i].data());
+      if (f == 0)
+      {
+        converged[i] = 1;
+        continue;
+      }
+
+      // the function increases through the root
+      if (f < 0)
+      {
+        x_lo[i] = x;
+      }
+      else
+      {
+        x_hi[i] = x;
+      }
+
+      const double df = vn_func_derivative(x, vn[i].data());
+      double next = x - f / df;
+      if (!(df > 0) || next <= x_lo[i] || next >= x_hi[i])
+      {
+        next = 0.5 * (x_lo[i] + x_hi[i]);
+      }
+
+      phi[i] = next;
+      if (std::fabs(next - x) < tolerance)
+      {
+        converged[i] = 1;
+      }
+      else
+      {
+        ++nactive;
+      }
+    }
+  }
+}
 
 void MoveDescendantsToParent(HepMC::GenParticle *parent,
                              double phishift)
@@ -205,20 +262,9 @@ void custom_vn(double /*b*/, double /*eta*/, double /*pt*/)
   v6 = 0.0015;
 }
 
-double
-AddFlowToParent(HepMC::GenEvent *event, HepMC::GenParticle *parent)
+// set v1 ... v6 for a particle
+void SetFlowCoefficients(double b, double eta, double pt)
 {
-  CLHEP::HepLorentzVector momentum(parent->momentum().px(),
-                                   parent->momentum().py(),
-                                   parent->momentum().pz(),
-                                   parent->momentum().e());
-  double pt = momentum.perp();
-  double eta = momentum.pseudoRapidity();
-  double phi_0 = momentum.phi();
-
-  HepMC::HeavyIon *hi = event->heavy_ion();
-  double b = hi->impact_parameter();
-
   v1 = 0, v2 = 0, v3 = 0, v4 = 0, v5 = 0, v6 = 0;
 
   // Call the appropriate function to set the vn values
@@ -234,62 +280,6 @@ AddFlowToParent(HepMC::GenEvent *event, HepMC::GenParticle *parent)
   {
     custom_vn(b, eta, pt);
   }
-
-  double phishift = 0;
-
-  const gsl_root_fsolver_type *T = gsl_root_fsolver_brent;
-  gsl_root_fsolver *s = gsl_root_fsolver_alloc(T);
-  double x_lo = -2 * M_PI, x_hi = 2 * M_PI;
-  float params[13];
-  for (float &param : params)
-  {
-    param = 0;
-  }
-  gsl_function F;
-  F.function = &vn_func;
-  F.params = &params;
-  gsl_root_fsolver_set(s, &F, x_lo, x_hi);
-  int iter = 0;
-  params[0] = phi_0;
-  params[1] = v1;
-  params[2] = v2;
-  params[3] = v3;
-  params[4] = v4;
-  params[5] = v5;
-  params[6] = v6;
-  params[7] = psi_n[0];
-  params[8] = psi_n[1];
-  params[9] = psi_n[2];
-  params[10] = psi_n[3];
-  params[11] = psi_n[4];
-  params[12] = psi_n[5];
-  int status;
-  double phi;
-  do
-  {
-    iter++;
-    gsl_root_fsolver_iterate(s);
-    phi = gsl_root_fsolver_root(s);
-    x_lo = gsl_root_fsolver_x_lower(s);
-    x_hi = gsl_root_fsolver_x_upper(s);
-    status = gsl_root_test_interval(x_lo, x_hi, 0, 0.00001);
-  } while (status == GSL_CONTINUE && iter < 1000);
-  gsl_root_fsolver_free(s);
-
-  if (iter >= 1000)
-  {
-    return 0;
-  }
-
-  phishift = phi - phi_0;
-
-  if (fabs(phishift) > 1e-7)
-  {
-    momentum.rotateZ(phishift);  // DPM check units * Gaudi::Units::rad);
-    parent->set_momentum(momentum);
-  }
-
-  return phishift;
 }
 
 int flowAfterburner(HepMC::GenEvent *event,
@@ -320,10 +310,16 @@ int flowAfterburner(HepMC::GenEvent *event,
   psi_n[1] = atan2(sin(2 * psi_n[1]), cos(2 * psi_n[1])) / 2.0;
 
   HepMC::GenVertex *mainvtx = event->barcode_to_vertex(-1);
+  const double b = hi->impact_parameter();
 
   // Loop over all children of this vertex
   HepMC::GenVertexParticleRange r(*mainvtx, HepMC::children);
 
+  // particles to shift, with their initial azimuth and flow coefficients
+  std::vector<HepMC::GenParticle *> parents;
+  std::vector<double> phi_0;
+  std::vector<std::array<float, 6>> vn;
+
   for (HepMC::GenVertex::particle_iterator it = r.begin(); it != r.end(); it++)
   {
     // Process particles from main vertex
@@ -352,8 +348,30 @@ int flowAfterburner(HepMC::GenEvent *event,
       continue;
     }
 
+    SetFlowCoefficients(b, momentum.pseudoRapidity(), momentum.perp());
+    parents.push_back(parent);
+    phi_0.push_back(momentum.phi());
+    vn.push_back({v1, v2, v3, v4, v5, v6});
+  }
+
+  std::vector<double> phi;
+  std::vector<char> converged;
+  SolveFlowAngles(phi_0, vn, phi, converged);
+
+  for (size_t i = 0; i < parents.size(); ++i)
+  {
     // Add flow to particles from main vertex
-    double phishift = AddFlowToParent(event, parent);
+    HepMC::GenParticle *parent = parents[i];
+    const double phishift = converged[i] ? phi[i] - phi_0[i] : 0;
+    if (fabs(phishift) > 1e-7)
+    {
+      CLHEP::HepLorentzVector momentum(parent->momentum().px(),
+                                       parent->momentum().py(),
+                                       parent->momentum().pz(),
+                                       parent->momentum().e());
+      momentum.rotateZ(phishift);  // DPM check units * Gaudi::Units::rad);
+      parent->set_momentum(momentum);
+    }
     MoveDescendantsToParent(parent, phishift);
   }
 
@@ -104,7 +104,25 @@ int Fun4AllHepMCInputManager::fileopen(const std::string &filenam)
   {
     theOscarFile.open(fname);
   }
-  else
+  else if (!m_CacheDir.empty())
+  {
+    // binary cache, read instead of the ascii file when available
+    const std::string cachename = HepMCBinaryCache::cacheFileName(m_CacheDir, fname);
+    m_CacheReader.reset(new HepMCBinaryCache::Reader(cachename));
+    if (m_CacheReader->isValid())
+    {
+      if (Verbosity() > 0)
+      {
+        std::cout << Name() << ": reading binary cache " << cachename << std::endl;
+      }
+    }
+    else
+    {
+      m_CacheReader.reset();
+    }
+  }
+
+  if (!m_ReadOscarFlag && !m_CacheReader)
   {
     TString tstr(fname);
     TPRegexp bzip_ext(".bz2$");
@@ -132,6 +150,16 @@ int Fun4AllHepMCInputManager::fileopen(const std::string &filenam)
       // expects normal ascii hepmc file
       ascii_in = new HepMC::IO_GenEvent(fname, std::ios::in);
     }
+
+    // write the binary cache while reading the file
+    if (!m_CacheDir.empty())
+    {
+      m_CacheWriter.reset(new HepMCBinaryCache::Writer(HepMCBinaryCache::cacheFileName(m_CacheDir, fname)));
+      if (!m_CacheWriter->isValid())
+      {
+        m_CacheWriter.reset();
+      }
+    }
   }
 
   recoConsts *rc = recoConsts::instance();
@@ -147,6 +175,12 @@ int Fun4AllHepMCInputManager::fileopen(const std::string &filenam)
   events_thisfile = 0;
   IsOpen(1);
   AddToFileOpened(fname);  // add file to the list of files which were opened
+
+  if (m_ReadAhead > 0 && !m_ReadOscarFlag)
+  {
+    m_ReadAheadStop = false;
+    m_ReadAheadThread = std::thread(&Fun4AllHepMCInputManager::read_ahead_loop, this);
+  }
   return 0;
 }
 
@@ -191,13 +225,13 @@ int Fun4AllHepMCInputManager::run(const int /*nevents*/)
       }
       else
       {
-        evt = ascii_in->read_next_event();
+        evt = read_next_event();
       }
     }
 
     if (!evt)
     {
-      if (Verbosity() > 1)
+      if (Verbosity() > 1 && ascii_in)
       {
         std::cout << "Fun4AllHepMCInputManager::run::" << Name()
                   << ": error type: " << ascii_in->error_type()
@@ -257,6 +291,9 @@ int Fun4AllHepMCInputManager::fileclose()
   }
   else
   {
+    stop_read_ahead();
+    m_CacheReader.reset();
+    m_CacheWriter.reset();
     delete ascii_in;
     ascii_in = nullptr;
   }
@@ -323,12 +360,15 @@ int Fun4AllHepMCInputManager::PushBackEvents(const int i)
   int errorflag = 0;
   while (nevents > 0 && !errorflag)
   {
-    evt = ascii_in->read_next_event();
+    evt = read_next_event();
     if (!evt)
     {
       std::cout << "Error after skipping " << i - nevents << std::endl;
-      std::cout << "error type: " << ascii_in->error_type()
-                << ", rdstate: " << ascii_in->rdstate() << std::endl;
+      if (ascii_in)
+      {
+        std::cout << "error type: " << ascii_in->error_type()
+                  << ", rdstate: " << ascii_in->rdstate() << std::endl;
+      }
       errorflag = -1;
       fileclose();
     }
@@ -435,3 +475,96 @@ int Fun4AllHepMCInputManager::MyCurrentEvent(const unsigned int index) const
   return m_MyEvent.at(index);
 }
 
+
+HepMC::GenEvent *Fun4AllHepMCInputManager::read_next_event()
+{
+  if (!m_ReadAheadThread.joinable())
+  {
+    return read_next_event_from_input();
+  }
+
+  std::unique_lock<std::mutex> lock(m_ReadAheadMutex);
+  m_QueueNotEmpty.wait(lock, [this]
+                       { return !m_Queue.empty(); });
+  HepMC::GenEvent *event = m_Queue.front();
+  if (event)
+  {
+    // the end of input marker stays in the queue, subsequent calls also get nullptr
+    m_Queue.pop_front();
+  }
+  m_QueueNotFull.notify_one();
+  return event;
+}
+
+HepMC::GenEvent *Fun4AllHepMCInputManager::read_next_event_from_input()
+{
+  if (m_CacheReader)
+  {
+    return m_CacheReader->read_next_event();
+  }
+  if (!ascii_in)
+  {
+    return nullptr;
+  }
+
+  HepMC::GenEvent *event = ascii_in->read_next_event();
+  if (m_CacheWriter)
+  {
+    if (event)
+    {
+      m_CacheWriter->write_event(event);
+    }
+    else
+    {
+      // whole file read, the cache can be used by the next jobs
+      m_CacheWriter->commit();
+      m_CacheWriter.reset();
+    }
+  }
+  return event;
+}
+
+void Fun4AllHepMCInputManager::read_ahead_loop()
+{
+  // decompression, parsing and cache writing all happen here.
+  // Only the queue is shared with the main thread
+  while (true)
+  {
+    HepMC::GenEvent *event = read_next_event_from_input();
+
+    std::unique_lock<std::mutex> lock(m_ReadAheadMutex);
+    m_QueueNotFull.wait(lock, [this]
+                        { return m_ReadAheadStop || m_Queue.size() < m_ReadAhead; });
+    if (m_ReadAheadStop)
+    {
+      delete event;
+      return;
+    }
+    m_Queue.push_back(event);
+    m_QueueNotEmpty.notify_one();
+    if (!event)
+    {
+      return;
+    }
+  }
+}
+
+void Fun4AllHepMCInputManager::stop_read_ahead()
+{
+  if (!m_ReadAheadThread.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_ReadAheadMutex);
+    m_ReadAheadStop = true;
+  }
+  m_QueueNotFull.notify_all();
+  m_ReadAheadThread.join();
+
+  for (HepMC::GenEvent *event : m_Queue)
+  {
+    delete event;
+  }
+  m_Queue.clear();
+}
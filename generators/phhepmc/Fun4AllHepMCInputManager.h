@@ -1,6 +1,7 @@
 #ifndef PHHEPMC_FUN4ALLHEPMCINPUTMANAGER_H
 #define PHHEPMC_FUN4ALLHEPMCINPUTMANAGER_H
 
+#include "HepMCBinaryCache.h"
 #include "PHHepMCGenHelper.h"
 
 #include <fun4all/Fun4AllInputManager.h>
@@ -8,8 +9,13 @@
 
 #include <boost/iostreams/filtering_streambuf.hpp>
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 class PHCompositeNode;
@@ -47,6 +53,13 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
   int SkipForThisManager(const int nevents) override { return PushBackEvents(-nevents); }
   int MyCurrentEvent(const unsigned int index = 0) const;
 
+  //! decompress and parse up to nevents ahead in a separate thread. 0 (default) reads on demand
+  void set_read_ahead(const unsigned int nevents) { m_ReadAhead = nevents; }
+
+  //! directory for binary copies of the input files.
+  /*! the copy is written while a file is read for the first time and memory-mapped instead of the ascii file on later reads */
+  void set_binary_cache(const std::string &directory) { m_CacheDir = directory; }
+
  protected:
   HepMC::GenEvent *evt = nullptr;
 
@@ -58,7 +71,20 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
 
   std::string m_HepMCTmpFile;
 
+  //! next event from the read ahead queue, or from the binary cache or ascii input directly
+  HepMC::GenEvent *read_next_event();
+
  private:
+
+  //! next event from the binary cache or the ascii input. Fills the binary cache when enabled
+  HepMC::GenEvent *read_next_event_from_input();
+
+  //! read ahead thread loop
+  void read_ahead_loop();
+
+  //! stop the read ahead thread and delete the queued events
+  void stop_read_ahead();
+
   PHCompositeNode *topNode = nullptr;
 
   // some pointers for use in decompression handling
@@ -75,6 +101,25 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
 
   std::string filename;
   std::string topNodeName;
+
+  //!@name binary cache
+  //@{
+  std::string m_CacheDir;
+  std::unique_ptr<HepMCBinaryCache::Reader> m_CacheReader;
+  std::unique_ptr<HepMCBinaryCache::Writer> m_CacheWriter;
+  //@}
+
+  //!@name read ahead
+  //@{
+  unsigned int m_ReadAhead = 0;
+  std::thread m_ReadAheadThread;
+  std::mutex m_ReadAheadMutex;
+  std::condition_variable m_QueueNotFull;
+  std::condition_variable m_QueueNotEmpty;
+  //! parsed events, nullptr marks the end of the input
+  std::deque<HepMC::GenEvent *> m_Queue;
+  bool m_ReadAheadStop = false;
+  //@}
 };
 
 #endif /* PHHEPMC_FUN4ALLHEPMCINPUTMANAGER_H */
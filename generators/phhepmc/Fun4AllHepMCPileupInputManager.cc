@@ -151,18 +151,18 @@ int Fun4AllHepMCPileupInputManager::run(const int /*nevents*/, const bool skip)
           }
           else
           {
-            evt = ascii_in->read_next_event();
+            evt = read_next_event();
             if (evt && m_SignalEventNumber == evt->event_number())
             {
               delete evt;
-              evt = ascii_in->read_next_event();
+              evt = read_next_event();
             }
           }
         }
 
         if (!evt)
         {
-          if (Verbosity() > 1)
+          if (Verbosity() > 1 && ascii_in)
           {
             std::cout << "error type: " << ascii_in->error_type()
                  << ", rdstate: " << ascii_in->rdstate() << std::endl;
@@ -0,0 +1,588 @@
+#include "HepMCBinaryCache.h"
+
+#include <HepMC/GenCrossSection.h>
+#include <HepMC/GenEvent.h>
+#include <HepMC/GenParticle.h>
+#include <HepMC/GenVertex.h>
+#include <HepMC/HeavyIon.h>
+#include <HepMC/PdfInfo.h>
+#include <HepMC/Polarization.h>
+#include <HepMC/SimpleVector.h>
+#include <HepMC/Units.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace
+{
+  struct FileHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+  };
+
+  struct EventRecord
+  {
+    int32_t event_number;
+    int32_t signal_process_id;
+    int32_t mpi;
+    int32_t momentum_unit;
+    int32_t length_unit;
+    int32_t signal_vertex;  // vertex index + 1, 0 if none
+    int32_t beam1;          // particle index + 1, 0 if none
+    int32_t beam2;
+    int32_t nvertices;
+    int32_t nparticles;
+    int32_t nweights;
+    int32_t nrandom;
+    int32_t has_heavy_ion;
+    int32_t has_pdf_info;
+    int32_t has_cross_section;
+    int32_t reserved;
+    double event_scale;
+    double alphaQCD;
+    double alphaQED;
+  };
+
+  struct HeavyIonRecord
+  {
+    int32_t Ncoll_hard;
+    int32_t Npart_proj;
+    int32_t Npart_targ;
+    int32_t Ncoll;
+    int32_t spectator_neutrons;
+    int32_t spectator_protons;
+    int32_t N_Nwounded_collisions;
+    int32_t Nwounded_N_collisions;
+    int32_t Nwounded_Nwounded_collisions;
+    float impact_parameter;
+    float event_plane_angle;
+    float eccentricity;
+    float sigma_inel_NN;
+    int32_t reserved;
+  };
+
+  struct PdfInfoRecord
+  {
+    int32_t id1;
+    int32_t id2;
+    int32_t pdf_id1;
+    int32_t pdf_id2;
+    double x1;
+    double x2;
+    double scalePDF;
+    double pdf1;
+    double pdf2;
+  };
+
+  struct CrossSectionRecord
+  {
+    double cross_section;
+    double cross_section_error;
+  };
+
+  struct VertexRecord
+  {
+    double x;
+    double y;
+    double z;
+    double t;
+    int32_t id;
+    int32_t barcode;
+  };
+
+  struct ParticleRecord
+  {
+    double px;
+    double py;
+    double pz;
+    double e;
+    double generated_mass;
+    double theta;
+    double phi;
+    int32_t pdg_id;
+    int32_t status;
+    int32_t barcode;
+    int32_t production_vertex;  // vertex index + 1, 0 if none
+    int32_t end_vertex;         // vertex index + 1, 0 if none
+    int32_t reserved;
+  };
+
+  template <class T>
+  void append(std::vector<char> &buffer, const T &value)
+  {
+    const auto offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+  }
+
+  template <class T>
+  T extract(const char *&data)
+  {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return value;
+  }
+}  // namespace
+
+std::string HepMCBinaryCache::cacheFileName(const std::string &directory, const std::string &inputfile)
+{
+  // FNV-1a of the path, size and modification time. Changing the input file changes the cache name
+  uint64_t hash = 14695981039346656037ULL;
+  const auto add = [&hash](const void *data, std::size_t size)
+  {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+  };
+
+  const std::string path = std::filesystem::absolute(inputfile).string();
+  add(path.data(), path.size());
+
+  struct stat st
+  {
+  };
+  if (stat(inputfile.c_str(), &st) == 0)
+  {
+    const int64_t size = st.st_size;
+    const int64_t mtime = st.st_mtime;
+    add(&size, sizeof(size));
+    add(&mtime, sizeof(mtime));
+  }
+
+  std::ostringstream out;
+  out << directory << "/" << std::filesystem::path(inputfile).filename().string() << "-" << std::hex << hash << ".hepmcbin";
+  return out.str();
+}
+
+HepMCBinaryCache::Reader::Reader(const std::string &filename)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return;
+  }
+  struct stat st
+  {
+  };
+  if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(FileHeader)))
+  {
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+    {
+      m_data = static_cast<const char *>(data);
+      m_size = st.st_size;
+      madvise(data, m_size, MADV_SEQUENTIAL);
+    }
+  }
+  // the mapping stays valid after the file is closed
+  close(fd);
+
+  if (!m_data)
+  {
+    return;
+  }
+
+  FileHeader header{};
+  std::memcpy(&header, m_data, sizeof(header));
+  if (std::memcmp(header.magic, m_magic, sizeof(m_magic)) != 0 || header.version != m_version)
+  {
+    std::cout << "HepMCBinaryCache::Reader - " << filename << " has an invalid header, ignored" << std::endl;
+    munmap(const_cast<char *>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    return;
+  }
+  m_offset = sizeof(header);
+}
+
+HepMCBinaryCache::Reader::~Reader()
+{
+  if (m_data)
+  {
+    munmap(const_cast<char *>(m_data), m_size);
+  }
+}
+
+HepMC::GenEvent *HepMCBinaryCache::Reader::read_next_event()
+{
+  if (!m_data || m_offset + sizeof(uint64_t) > m_size)
+  {
+    return nullptr;
+  }
+
+  const char *data = m_data + m_offset;
+  const auto record_size = extract<uint64_t>(data);
+  if (record_size > m_size - m_offset - sizeof(uint64_t))
+  {
+    std::cout << "HepMCBinaryCache::Reader::read_next_event - truncated event record" << std::endl;
+    m_offset = m_size;
+    return nullptr;
+  }
+  m_offset += sizeof(uint64_t) + record_size;
+
+  // the counts and links are only trusted if they describe exactly this record
+  const auto corrupt_record = [this]()
+  {
+    std::cout << "HepMCBinaryCache::Reader::read_next_event - corrupt event record" << std::endl;
+    m_offset = m_size;
+    return nullptr;
+  };
+  if (record_size < sizeof(EventRecord))
+  {
+    return corrupt_record();
+  }
+  const auto record = extract<EventRecord>(data);
+  if (record.nweights < 0 || record.nrandom < 0 || record.nvertices < 0 || record.nparticles < 0 ||
+      record.signal_vertex < 0 || record.signal_vertex > record.nvertices)
+  {
+    return corrupt_record();
+  }
+  const uint64_t expected_size = sizeof(EventRecord) +
+                                 uint64_t(record.nweights) * sizeof(double) +
+                                 uint64_t(record.nrandom) * sizeof(int64_t) +
+                                 (record.has_heavy_ion ? sizeof(HeavyIonRecord) : 0) +
+                                 (record.has_pdf_info ? sizeof(PdfInfoRecord) : 0) +
+                                 (record.has_cross_section ? sizeof(CrossSectionRecord) : 0) +
+                                 uint64_t(record.nvertices) * sizeof(VertexRecord) +
+                                 uint64_t(record.nparticles) * sizeof(ParticleRecord);
+  if (expected_size != record_size)
+  {
+    return corrupt_record();
+  }
+
+  auto evt = new HepMC::GenEvent(
+      static_cast<HepMC::Units::MomentumUnit>(record.momentum_unit),
+      static_cast<HepMC::Units::LengthUnit>(record.length_unit));
+  evt->set_event_number(record.event_number);
+  evt->set_signal_process_id(record.signal_process_id);
+  evt->set_mpi(record.mpi);
+  evt->set_event_scale(record.event_scale);
+  evt->set_alphaQCD(record.alphaQCD);
+  evt->set_alphaQED(record.alphaQED);
+
+  for (int i = 0; i < record.nweights; ++i)
+  {
+    evt->weights().push_back(extract<double>(data));
+  }
+
+  if (record.nrandom > 0)
+  {
+    std::vector<long> random_states(record.nrandom);
+    for (auto &state : random_states)
+    {
+      state = extract<int64_t>(data);
+    }
+    evt->set_random_states(random_states);
+  }
+
+  if (record.has_heavy_ion)
+  {
+    const auto hi = extract<HeavyIonRecord>(data);
+    evt->set_heavy_ion(HepMC::HeavyIon(
+        hi.Ncoll_hard, hi.Npart_proj, hi.Npart_targ, hi.Ncoll,
+        hi.spectator_neutrons, hi.spectator_protons,
+        hi.N_Nwounded_collisions, hi.Nwounded_N_collisions, hi.Nwounded_Nwounded_collisions,
+        hi.impact_parameter, hi.event_plane_angle, hi.eccentricity, hi.sigma_inel_NN));
+  }
+
+  if (record.has_pdf_info)
+  {
+    const auto pdf = extract<PdfInfoRecord>(data);
+    evt->set_pdf_info(HepMC::PdfInfo(
+        pdf.id1, pdf.id2, pdf.x1, pdf.x2, pdf.scalePDF, pdf.pdf1, pdf.pdf2, pdf.pdf_id1, pdf.pdf_id2));
+  }
+
+  if (record.has_cross_section)
+  {
+    const auto xs = extract<CrossSectionRecord>(data);
+    HepMC::GenCrossSection cross_section;
+    cross_section.set_cross_section(xs.cross_section, xs.cross_section_error);
+    evt->set_cross_section(cross_section);
+  }
+
+  // vertices, in index order
+  std::vector<HepMC::GenVertex *> vertices(record.nvertices);
+  for (auto &vertex : vertices)
+  {
+    const auto v = extract<VertexRecord>(data);
+    vertex = new HepMC::GenVertex(HepMC::FourVector(v.x, v.y, v.z, v.t), v.id);
+    vertex->suggest_barcode(v.barcode);
+    evt->add_vertex(vertex);
+  }
+
+  if (record.signal_vertex > 0)
+  {
+    evt->set_signal_process_vertex(vertices[record.signal_vertex - 1]);
+  }
+
+  // particles, attached to their vertices
+  HepMC::GenParticle *beam1 = nullptr;
+  HepMC::GenParticle *beam2 = nullptr;
+  for (int i = 0; i < record.nparticles; ++i)
+  {
+    const auto p = extract<ParticleRecord>(data);
+    if (p.production_vertex < 0 || p.production_vertex > record.nvertices ||
+        p.end_vertex < 0 || p.end_vertex > record.nvertices)
+    {
+      delete evt;
+      return corrupt_record();
+    }
+    auto particle = new HepMC::GenParticle(
+        HepMC::FourVector(p.px, p.py, p.pz, p.e), p.pdg_id, p.status,
+        HepMC::Flow(), HepMC::Polarization(p.theta, p.phi));
+    particle->setGeneratedMass(p.generated_mass);
+    particle->suggest_barcode(p.barcode);
+
+    if (p.production_vertex > 0)
+    {
+      vertices[p.production_vertex - 1]->add_particle_out(particle);
+    }
+    if (p.end_vertex > 0)
+    {
+      vertices[p.end_vertex - 1]->add_particle_in(particle);
+    }
+
+    if (i + 1 == record.beam1)
+    {
+      beam1 = particle;
+    }
+    if (i + 1 == record.beam2)
+    {
+      beam2 = particle;
+    }
+  }
+
+  if (beam1 || beam2)
+  {
+    evt->set_beam_particles(beam1, beam2);
+  }
+
+  return evt;
+}
+
+HepMCBinaryCache::Writer::Writer(const std::string &filename)
+  : m_filename(filename)
+  , m_tmpfilename(filename + ".tmp." + std::to_string(getpid()))
+{
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path(filename).parent_path(), error);
+
+  m_out.open(m_tmpfilename, std::ios::binary | std::ios::trunc);
+  if (!m_out)
+  {
+    std::cout << "HepMCBinaryCache::Writer - could not open " << m_tmpfilename << std::endl;
+    return;
+  }
+
+  FileHeader header{};
+  std::memcpy(header.magic, m_magic, sizeof(m_magic));
+  header.version = m_version;
+  m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+HepMCBinaryCache::Writer::~Writer()
+{
+  if (!m_committed)
+  {
+    m_out.close();
+    std::remove(m_tmpfilename.c_str());
+  }
+}
+
+void HepMCBinaryCache::Writer::write_event(const HepMC::GenEvent *evt)
+{
+  if (!evt || !m_out)
+  {
+    return;
+  }
+
+  // vertex index from barcode, for the particle links
+  std::map<int, int> vertex_index;
+  {
+    int index = 0;
+    for (auto iter = evt->vertices_begin(); iter != evt->vertices_end(); ++iter)
+    {
+      vertex_index.insert(std::make_pair((*iter)->barcode(), ++index));
+    }
+  }
+  const auto get_vertex_index = [&vertex_index](const HepMC::GenVertex *vertex)
+  {
+    if (!vertex)
+    {
+      return 0;
+    }
+    const auto iter = vertex_index.find(vertex->barcode());
+    return iter == vertex_index.end() ? 0 : iter->second;
+  };
+
+  const auto beams = evt->beam_particles();
+
+  EventRecord record{};
+  record.event_number = evt->event_number();
+  record.signal_process_id = evt->signal_process_id();
+  record.mpi = evt->mpi();
+  record.momentum_unit = evt->momentum_unit();
+  record.length_unit = evt->length_unit();
+  record.signal_vertex = get_vertex_index(evt->signal_process_vertex());
+  record.nvertices = evt->vertices_size();
+  record.nparticles = evt->particles_size();
+  record.nweights = evt->weights().size();
+  record.nrandom = evt->random_states().size();
+  record.has_heavy_ion = evt->heavy_ion() ? 1 : 0;
+  record.has_pdf_info = evt->pdf_info() ? 1 : 0;
+  record.has_cross_section = evt->cross_section() ? 1 : 0;
+  record.event_scale = evt->event_scale();
+  record.alphaQCD = evt->alphaQCD();
+  record.alphaQED = evt->alphaQED();
+
+  {
+    int index = 0;
+    for (auto iter = evt->particles_begin(); iter != evt->particles_end(); ++iter)
+    {
+      ++index;
+      if (*iter == beams.first)
+      {
+        record.beam1 = index;
+      }
+      if (*iter == beams.second)
+      {
+        record.beam2 = index;
+      }
+    }
+  }
+
+  m_buffer.clear();
+  append(m_buffer, record);
+
+  for (std::size_t i = 0; i < evt->weights().size(); ++i)
+  {
+    append(m_buffer, evt->weights()[i]);
+  }
+
+  for (const auto state : evt->random_states())
+  {
+    append(m_buffer, static_cast<int64_t>(state));
+  }
+
+  if (const auto hi = evt->heavy_ion())
+  {
+    HeavyIonRecord hirecord{};
+    hirecord.Ncoll_hard = hi->Ncoll_hard();
+    hirecord.Npart_proj = hi->Npart_proj();
+    hirecord.Npart_targ = hi->Npart_targ();
+    hirecord.Ncoll = hi->Ncoll();
+    hirecord.spectator_neutrons = hi->spectator_neutrons();
+    hirecord.spectator_protons = hi->spectator_protons();
+    hirecord.N_Nwounded_collisions = hi->N_Nwounded_collisions();
+    hirecord.Nwounded_N_collisions = hi->Nwounded_N_collisions();
+    hirecord.Nwounded_Nwounded_collisions = hi->Nwounded_Nwounded_collisions();
+    hirecord.impact_parameter = hi->impact_parameter();
+    hirecord.event_plane_angle = hi->event_plane_angle();
+    hirecord.eccentricity = hi->eccentricity();
+    hirecord.sigma_inel_NN = hi->sigma_inel_NN();
+    append(m_buffer, hirecord);
+  }
+
+  if (const auto pdf = evt->pdf_info())
+  {
+    PdfInfoRecord pdfrecord{};
+    pdfrecord.id1 = pdf->id1();
+    pdfrecord.id2 = pdf->id2();
+    pdfrecord.pdf_id1 = pdf->pdf_id1();
+    pdfrecord.pdf_id2 = pdf->pdf_id2();
+    pdfrecord.x1 = pdf->x1();
+    pdfrecord.x2 = pdf->x2();
+    pdfrecord.scalePDF = pdf->scalePDF();
+    pdfrecord.pdf1 = pdf->pdf1();
+    pdfrecord.pdf2 = pdf->pdf2();
+    append(m_buffer, pdfrecord);
+  }
+
+  if (const auto xs = evt->cross_section())
+  {
+    CrossSectionRecord xsrecord{};
+    xsrecord.cross_section = xs->cross_section();
+    xsrecord.cross_section_error = xs->cross_section_error();
+    append(m_buffer, xsrecord);
+  }
+
+  for (auto iter = evt->vertices_begin(); iter != evt->vertices_end(); ++iter)
+  {
+    const auto &position = (*iter)->position();
+    VertexRecord vrecord{};
+    vrecord.x = position.x();
+    vrecord.y = position.y();
+    vrecord.z = position.z();
+    vrecord.t = position.t();
+    vrecord.id = (*iter)->id();
+    vrecord.barcode = (*iter)->barcode();
+    append(m_buffer, vrecord);
+  }
+
+  for (auto iter = evt->particles_begin(); iter != evt->particles_end(); ++iter)
+  {
+    const auto particle = *iter;
+    const auto &momentum = particle->momentum();
+    ParticleRecord precord{};
+    precord.px = momentum.px();
+    precord.py = momentum.py();
+    precord.pz = momentum.pz();
+    precord.e = momentum.e();
+    precord.generated_mass = particle->generated_mass();
+    precord.theta = particle->polarization().theta();
+    precord.phi = particle->polarization().phi();
+    precord.pdg_id = particle->pdg_id();
+    precord.status = particle->status();
+    precord.barcode = particle->barcode();
+    precord.production_vertex = get_vertex_index(particle->production_vertex());
+    precord.end_vertex = get_vertex_index(particle->end_vertex());
+    append(m_buffer, precord);
+  }
+
+  const uint64_t record_size = m_buffer.size();
+  m_out.write(reinterpret_cast<const char *>(&record_size), sizeof(record_size));
+  m_out.write(m_buffer.data(), m_buffer.size());
+}
+
+bool HepMCBinaryCache::Writer::commit()
+{
+  if (m_committed)
+  {
+    return true;
+  }
+
+  m_out.close();
+  if (m_out.fail())
+  {
+    std::cout << "HepMCBinaryCache::Writer::commit - could not write " << m_tmpfilename << std::endl;
+    return false;
+  }
+
+  // the rename is atomic, jobs sharing the cache directory never see a partial file
+  std::error_code error;
+  std::filesystem::rename(m_tmpfilename, m_filename, error);
+  if (error)
+  {
+    std::cout << "HepMCBinaryCache::Writer::commit - could not rename " << m_tmpfilename << " to " << m_filename << ": " << error.message() << std::endl;
+    return false;
+  }
+
+  m_committed = true;
+  std::cout << "HepMCBinaryCache::Writer::commit - wrote " << m_filename << std::endl;
+  return true;
+}
@@ -0,0 +1,85 @@
+#ifndef PHHEPMC_HEPMCBINARYCACHE_H
+#define PHHEPMC_HEPMCBINARYCACHE_H
+
+/*!
+ * \file HepMCBinaryCache.h
+ * \brief compact binary copy of an ascii hepmc file, to skip the text parsing on subsequent reads
+ *
+ * the cache holds, per event, the event header, weights, random states, heavy ion, pdf
+ * and cross section information, and the vertices and particles with their links.
+ * Particle color flow and vertex weights are not stored.
+ * Files are written to a temporary name and only renamed once the input file
+ * has been read completely, so a job stopping early does not leave a truncated cache
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace HepMC
+{
+  class GenEvent;
+}  // namespace HepMC
+
+class HepMCBinaryCache
+{
+ public:
+  //! cache file name in directory for a given input file. Depends on the input file path, size and modification time
+  static std::string cacheFileName(const std::string &directory, const std::string &inputfile);
+
+  //! reads events from an existing cache file through mmap
+  class Reader
+  {
+   public:
+    explicit Reader(const std::string &filename);
+    ~Reader();
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    //! false if the file could not be mapped or has a wrong header
+    bool isValid() const { return m_data != nullptr; }
+
+    //! returns the next event, owned by the caller, or nullptr at the end of the file
+    HepMC::GenEvent *read_next_event();
+
+   private:
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_offset = 0;
+  };
+
+  //! writes events to a new cache file
+  class Writer
+  {
+   public:
+    explicit Writer(const std::string &filename);
+
+    //! removes the temporary file if commit was not called
+    ~Writer();
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    bool isValid() const { return m_out.good(); }
+
+    void write_event(const HepMC::GenEvent *evt);
+
+    //! close and rename the temporary file to the final cache file
+    bool commit();
+
+   private:
+    std::string m_filename;
+    std::string m_tmpfilename;
+    std::ofstream m_out;
+    std::vector<char> m_buffer;
+    bool m_committed = false;
+  };
+
+  static constexpr char m_magic[8] = {'S', 'P', 'H', 'H', 'E', 'P', 'M', 'C'};
+  static constexpr uint32_t m_version = 1;
+};
+
+#endif
@@ -14,6 +14,7 @@
 #include <phool/PHNode.h>          // for PHNode
 #include <phool/PHNodeIterator.h>  // for PHNodeIterator
 #include <phool/PHObject.h>        // for PHObject
+#include <phool/PHSharedStore.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>
 #include <phool/recoConsts.h>
@@ -163,3 +164,24 @@ std::string CDBInterface::getUrl(const std::string &domain, const std::string &f
   }
   return return_url;
 }
+
+std::shared_ptr<const PHSharedStore::Segment> CDBInterface::getSharedPayload(const std::string &domain, const std::function<bool(const std::string &url, std::vector<char> &payload)> &build, const std::string &filename)
+{
+  std::string url = getUrl(domain, filename);
+  if (url.empty())
+  {
+    return nullptr;
+  }
+  std::shared_ptr<const PHSharedStore::Segment> payload = PHSharedStore::instance()->get("CDB-" + domain, PHSharedStore::hashUrl(url), [&](std::vector<char> &buffer)
+                                                                                        { return build(url, buffer); });
+  if (!payload)
+  {
+    std::cout << PHWHERE << " could not build payload of " << domain << " from " << url << std::endl;
+  }
+  else if (Verbosity() > 0)
+  {
+    std::cout << "CDBInterface: payload of " << domain << " from " << url
+              << (payload->isShared() ? " (shared store)" : "") << std::endl;
+  }
+  return payload;
+}
@@ -5,10 +5,15 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <phool/PHSharedStore.h>
+
 #include <cstdint>  // for uint64_t
+#include <functional>
+#include <memory>
 #include <set>
 #include <string>
 #include <tuple>  // for tuple
+#include <vector>
 
 class PHCompositeNode;
 class SphenixClient;
@@ -27,6 +32,11 @@ class CDBInterface : public SubsysReco
 
   std::string getUrl(const std::string &domain, const std::string &filename = "");
 
+  //! flat, read only version of the payload of domain, shared by all jobs on the node
+  //! through the PHSharedStore. build converts the payload at url into the flat layout,
+  //! it is only called by the first job which needs this payload (keyed by its url)
+  std::shared_ptr<const PHSharedStore::Segment> getSharedPayload(const std::string &domain, const std::function<bool(const std::string &url, std::vector<char> &payload)> &build, const std::string &filename = "");
+
  private:
   CDBInterface(const std::string &name = "CDBInterface");
 
@@ -18,6 +18,7 @@
 #include <phool/phool.h>  // for PHWHERE, PHReadOnly, PHRunTree
 #include <phool/phooldefs.h>
 
+#include <TROOT.h>
 #include <TSystem.h>
 
 #pragma GCC diagnostic push
@@ -132,6 +133,8 @@ int Fun4AllDstInputManager::fileopen(const std::string &filenam)
   if (m_IManager->isFunctional())
   {
     IsOpen(1);
+    m_IManager->SetReadCache(m_TreeCacheSize);
+    m_IManager->ReadReport(m_ReadReport);
     events_thisfile = 0;
     setBranches();                // set branch selections
     AddToFileOpened(FileName());  // add file to the list of files which were opened
@@ -632,6 +635,21 @@ void Fun4AllDstInputManager::Print(const std::string &what) const
   return;
 }
 
+void Fun4AllDstInputManager::ImplicitMT(const unsigned int nthreads)
+{
+  if (ROOT::IsImplicitMTEnabled())
+  {
+    std::cout << Name() << ": ROOT implicit multi threading already enabled" << std::endl;
+    return;
+  }
+  ROOT::EnableImplicitMT(nthreads);
+  if (Verbosity() > 0)
+  {
+    std::cout << Name() << ": enabled ROOT implicit multi threading, threads: "
+              << ROOT::GetThreadPoolSize() << std::endl;
+  }
+}
+
 int Fun4AllDstInputManager::PushBackEvents(const int i)
 {
   if (m_IManager)
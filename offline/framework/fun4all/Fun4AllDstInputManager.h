@@ -5,6 +5,7 @@
 
 #include "Fun4AllInputManager.h"
 
+#include <cstdint>
 #include <map>
 #include <string>
 
@@ -28,6 +29,13 @@ class Fun4AllDstInputManager : public Fun4AllInputManager
   void Print(const std::string &what = "ALL") const override;
   int PushBackEvents(const int i) override;
   int HasSyncObject() const override;
+  //! TTreeCache for the selected branches, sized for one cluster of them but at most maxbytes. 0 disables it
+  void TreeCache(const int64_t maxbytes = 100000000) { m_TreeCacheSize = maxbytes; }
+  //! ROOT implicit multi threading, the branches of an entry are read and decompressed in parallel.
+  //! This is process wide, 0 uses all cores
+  void ImplicitMT(const unsigned int nthreads = 0);
+  //! print the per branch read times when closing each file (branches are then read sequentially)
+  void ReadReport(const bool b = true) { m_ReadReport = b; }
 
  protected:
   int ReadNextEventSyncObject();
@@ -49,6 +57,8 @@ class Fun4AllDstInputManager : public Fun4AllInputManager
   int events_thisfile = 0;
   int events_skipped_during_sync = 0;
   int m_HaveSyncObject = 0;
+  int64_t m_TreeCacheSize = 0;
+  bool m_ReadReport = false;
   std::map<const std::string, int> branchread;
   std::string syncbranchname;
   PHCompositeNode *dstNode = nullptr;
@@ -85,6 +85,12 @@ void Fun4AllDstOutputManager::Print(const std::string &what) const
         std::cout << Name() << ": Node " << nodename << " is written out" << std::endl;
       }
     }
+    for (const auto &[nodename, policy] : m_BranchPolicies)
+    {
+      std::cout << Name() << ": Node " << nodename
+                << " compression setting: " << policy.compression
+                << " basket size: " << policy.basketsize << std::endl;
+    }
   }
   // base class print method
   Fun4AllOutputManager::Print(what);
@@ -292,5 +298,11 @@ int Fun4AllDstOutputManager::outfile_open_first_write()
   }
 
   dstOut->SetCompressionSetting(m_CompressionSetting);
+  dstOut->SetAutoFlush(m_AutoFlush);
+  dstOut->WriteReport(m_WriteReport);
+  for (const auto &[nodename, policy] : m_BranchPolicies)
+  {
+    dstOut->SetBranchPolicy(nodename, policy);
+  }
   return 0;
 }
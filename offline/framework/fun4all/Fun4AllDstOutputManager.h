@@ -5,10 +5,13 @@
 
 #include "Fun4AllOutputManager.h"
 
+#include <phool/PHNodeIOManager.h>
+
+#include <cstdint>
+#include <map>
 #include <set>
 #include <string>
 
-class PHNodeIOManager;
 class PHCompositeNode;
 
 class Fun4AllDstOutputManager : public Fun4AllOutputManager
@@ -35,12 +38,24 @@ class Fun4AllDstOutputManager : public Fun4AllOutputManager
   std::string UsedOutFileName() const { return m_UsedOutFileName; }
   void CompressionSetting(const int i) { m_CompressionSetting = i; }
 
+  //! compression setting (100 * algorithm + level) for the branch of a given node, overrides CompressionSetting
+  void NodeCompressionSetting(const std::string &nodename, const int i) { m_BranchPolicies[nodename].compression = i; }
+  //! basket size in bytes for the branch of a given node
+  void NodeBasketSize(const std::string &nodename, const int i) { m_BranchPolicies[nodename].basketsize = i; }
+  //! auto flush (cluster size) of the output tree: > 0 entries, < 0 bytes, 0 keeps the ROOT default
+  void AutoFlush(const int64_t i) { m_AutoFlush = i; }
+  //! print per branch sizes and write time when each output file is closed
+  void WriteReport(const bool b = true) { m_WriteReport = b; }
+
  private:
   int outfile_open_first_write();
   PHNodeIOManager *dstOut{nullptr};
   int m_SaveRunNodeFlag{1};
   int m_SaveDstNodeFlag{1};
   int m_CompressionSetting{505};
+  int64_t m_AutoFlush{0};
+  bool m_WriteReport{false};
+  std::map<std::string, PHNodeIOManager::BranchPolicy> m_BranchPolicies;
   int m_CurrentSegment{0};
   std::string m_FileNameStem;
   std::string m_UsedOutFileName;
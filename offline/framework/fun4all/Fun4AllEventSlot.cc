@@ -0,0 +1,212 @@
+#include "Fun4AllEventSlot.h"
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>
+#include <phool/PHNode.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/PHNodeReset.h>
+#include <phool/PHPointerListIterator.h>
+#include <phool/phool.h>
+
+#include <TClass.h>
+#include <TObject.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+namespace
+{
+  //! top node of a slot, it does not own the nodes shared with the server node tree
+  class SlotTopNode : public PHCompositeNode
+  {
+   public:
+    explicit SlotTopNode(const std::string &nodename)
+      : PHCompositeNode(nodename)
+    {
+    }
+
+    ~SlotTopNode() override
+    {
+      // take the shared nodes out before the base class deletes the subnodes
+      for (size_t i = subNodes.length(); i > 0; --i)
+      {
+        if (m_Shared.find(subNodes[i - 1]) != m_Shared.end())
+        {
+          subNodes.removeAt(i - 1);
+        }
+      }
+    }
+
+    SlotTopNode(const SlotTopNode &) = delete;
+    SlotTopNode &operator=(const SlotTopNode &) = delete;
+
+    //! add a node of the server node tree, without taking ownership or changing its parent
+    void addSharedNode(PHNode *node)
+    {
+      subNodes.append(node);
+      m_Shared.insert(node);
+    }
+
+   private:
+    std::set<PHNode *> m_Shared;
+  };
+
+  //! direct child of a composite node with a given name
+  PHNode *findChild(PHCompositeNode *parent, const std::string &name)
+  {
+    PHNodeIterator nodeiter(parent);
+    PHPointerListIterator<PHNode> iterat(nodeiter.ls());
+    PHNode *thisNode;
+    while ((thisNode = iterat()))
+    {
+      if (thisNode->getName() == name)
+      {
+        return thisNode;
+      }
+    }
+    return nullptr;
+  }
+}  // namespace
+
+Fun4AllEventSlot::Fun4AllEventSlot(const unsigned int index, const std::map<std::string, PHCompositeNode *> &topnodes)
+  : m_Index(index)
+{
+  for (const auto &[name, servertop] : topnodes)
+  {
+    SlotTopNode *slottop = new SlotTopNode(name);
+    PHNodeIterator nodeiter(servertop);
+    PHPointerListIterator<PHNode> iterat(nodeiter.ls());
+    PHNode *thisNode;
+    while ((thisNode = iterat()))
+    {
+      if (thisNode->getName() == "DST" && thisNode->getType() == "PHCompositeNode")
+      {
+        slottop->addNode(new PHCompositeNode("DST"));
+      }
+      else
+      {
+        slottop->addSharedNode(thisNode);
+      }
+    }
+    m_TopNodes[name] = slottop;
+  }
+}
+
+Fun4AllEventSlot::~Fun4AllEventSlot()
+{
+  for (auto &[name, topnode] : m_TopNodes)
+  {
+    delete topnode;
+  }
+}
+
+PHCompositeNode *Fun4AllEventSlot::topNode(const std::string &name) const
+{
+  auto iter = m_TopNodes.find(name);
+  if (iter == m_TopNodes.end())
+  {
+    return nullptr;
+  }
+  return iter->second;
+}
+
+void Fun4AllEventSlot::CopyEvent(const std::map<std::string, PHCompositeNode *> &topnodes)
+{
+  for (const auto &[name, servertop] : topnodes)
+  {
+    PHCompositeNode *slottop = topNode(name);
+    if (!slottop)
+    {
+      std::cout << PHWHERE << " top node " << name << " was added after the event slots were created" << std::endl;
+      exit(1);
+    }
+    PHNode *serverdst = findChild(servertop, "DST");
+    PHNode *slotdst = findChild(slottop, "DST");
+    if (serverdst && slotdst)
+    {
+      CopyNodes(static_cast<PHCompositeNode *>(serverdst), static_cast<PHCompositeNode *>(slotdst), name + "/DST");
+    }
+  }
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void Fun4AllEventSlot::CopyNodes(PHCompositeNode *from, PHCompositeNode *to, const std::string &path)
+{
+  PHNodeIterator nodeiter(from);
+  PHPointerListIterator<PHNode> iterat(nodeiter.ls());
+  PHNode *thisNode;
+  while ((thisNode = iterat()))
+  {
+    const std::string nodepath = path + "/" + thisNode->getName();
+    PHNode *slotNode = findChild(to, thisNode->getName());
+    if (thisNode->getType() == "PHCompositeNode")
+    {
+      if (!slotNode)
+      {
+        slotNode = new PHCompositeNode(thisNode->getName());
+        to->addNode(slotNode);
+      }
+      CopyNodes(static_cast<PHCompositeNode *>(thisNode), static_cast<PHCompositeNode *>(slotNode), nodepath);
+      continue;
+    }
+
+    // only nodes holding a TObject can be copied through the root streamers
+    TObject *object = nullptr;
+    if (thisNode->getType() == "PHIODataNode")
+    {
+      object = static_cast<PHIODataNode<TObject> *>(thisNode)->getData();
+    }
+    if (!object || object->IsA()->GetClassVersion() <= 0)
+    {
+      if (m_Skipped.insert(nodepath).second)
+      {
+        std::cout << PHWHERE << " slot " << m_Index << ": node " << nodepath
+                  << " cannot be copied into event slots, it is only available in the server node tree" << std::endl;
+      }
+      continue;
+    }
+
+    if (!slotNode)
+    {
+      auto *newNode = new PHIODataNode<TObject>(object->Clone(), thisNode->getName(), thisNode->getObjectType());
+      newNode->setResetFlag(thisNode->getResetFlag());
+      // like all DST nodes before the first write, the output managers make the nodes they write persistent
+      newNode->makeTransient();
+      to->addNode(newNode);
+      if (m_Verbosity > 1)
+      {
+        std::cout << "Fun4AllEventSlot: slot " << m_Index << " created node " << nodepath << std::endl;
+      }
+      continue;
+    }
+
+    // stream the server object into the (reset) slot object, like reading it from a file
+    TObject *slotObject = static_cast<PHIODataNode<TObject> *>(slotNode)->getData();
+    m_Buffer.SetWriteMode();
+    m_Buffer.SetBufferOffset(0);
+    m_Buffer.ResetMap();
+    object->Streamer(m_Buffer);
+    m_Buffer.SetReadMode();
+    m_Buffer.SetBufferOffset(0);
+    m_Buffer.ResetMap();
+    slotObject->Streamer(m_Buffer);
+  }
+}
+
+void Fun4AllEventSlot::ResetEvent()
+{
+  PHNodeReset reset;
+  reset.Verbosity(m_Verbosity > 2 ? m_Verbosity - 2 : 0);
+  for (auto &[name, topnode] : m_TopNodes)
+  {
+    PHNodeIterator mainIter(topnode);
+    if (mainIter.cd("DST"))
+    {
+      mainIter.forEach(reset);
+    }
+  }
+  RetCodes.assign(RetCodes.size(), 0);
+  EventBad = 0;
+  ReturnCode = 0;
+}
@@ -0,0 +1,72 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALL_FUN4ALLEVENTSLOT_H
+#define FUN4ALL_FUN4ALLEVENTSLOT_H
+
+#include <TBufferFile.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class PHCompositeNode;
+
+/** One event in flight when Fun4AllServer processes several events concurrently.
+ *
+ *  For every top node of the server the slot has its own top node with
+ *  a private DST subtree. All other nodes (RUN, PAR, ...) are the ones of
+ *  the server node tree, shared by all slots and not owned by the slot.
+ *  The event read by the input managers into the server DST node tree is
+ *  copied into the slot DST with the root streamers, the same way it would
+ *  be read from a DST file. Only nodes holding a TObject (PHIODataNodes) are copied.
+ */
+class Fun4AllEventSlot
+{
+ public:
+  Fun4AllEventSlot(const unsigned int index, const std::map<std::string, PHCompositeNode *> &topnodes);
+  ~Fun4AllEventSlot();
+
+  Fun4AllEventSlot(const Fun4AllEventSlot &) = delete;
+  Fun4AllEventSlot &operator=(const Fun4AllEventSlot &) = delete;
+
+  unsigned int Index() const { return m_Index; }
+
+  //! slot top node corresponding to the server top node of that name
+  PHCompositeNode *topNode(const std::string &name) const;
+
+  //! copy the current event from the DST nodes of the server top nodes
+  void CopyEvent(const std::map<std::string, PHCompositeNode *> &topnodes);
+
+  //! reset the DST nodes of the slot after the event was written
+  void ResetEvent();
+
+  void Verbosity(const int i) { m_Verbosity = i; }
+
+  //! return codes of all modules for this event
+  std::vector<int> RetCodes;
+
+  //! non zero if the event is not to be written
+  int EventBad = 0;
+
+  //! return code to be passed on to the server (ABORTRUN, ABORTPROCESSING)
+  int ReturnCode = 0;
+
+  //! value of the server event counter for this event
+  int EventCounter = 0;
+
+ private:
+  void CopyNodes(PHCompositeNode *from, PHCompositeNode *to, const std::string &path);
+
+  unsigned int m_Index = 0;
+  int m_Verbosity = 0;
+  std::map<std::string, PHCompositeNode *> m_TopNodes;
+
+  //! nodes which could not be copied, to warn only once
+  std::set<std::string> m_Skipped;
+
+  //! streamer buffer reused for all copies
+  TBufferFile m_Buffer{TBuffer::kWrite};
+};
+
+#endif
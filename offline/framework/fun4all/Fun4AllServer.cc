@@ -1,5 +1,6 @@
 #include "Fun4AllServer.h"
 
+#include "Fun4AllEventSlot.h"
 #include "Fun4AllHistoBinDefs.h"
 #include "Fun4AllHistoManager.h"  // for Fun4AllHistoManager
 #include "Fun4AllMemoryTracker.h"
@@ -35,6 +36,7 @@
 #include <iostream>
 #include <memory>  // for allocator_traits<>::value_type
 #include <sstream>
+#include <thread>
 
 //#define FFAMEMTRACKER
 
@@ -64,6 +66,11 @@ Fun4AllServer::~Fun4AllServer()
 {
   Reset();
   delete beginruntimestamp;
+  while (!m_EventSlots.empty())
+  {
+    delete m_EventSlots.back();
+    m_EventSlots.pop_back();
+  }
   while (Subsystems.begin() != Subsystems.end())
   {
     if (Verbosity() >= VERBOSITY_MORE)
@@ -276,6 +283,8 @@ int Fun4AllServer::registerSubsystem(SubsysReco *subsystem, const std::string &t
 
 int Fun4AllServer::unregisterSubsystem(SubsysReco *subsystem)
 {
+  // can be called by modules running in event slots
+  std::lock_guard<std::mutex> lock(m_SlotMutex);
   std::pair<SubsysReco *, PHCompositeNode *> subsyspair(subsystem, 0);
   DeleteSubsystems.push_back(subsyspair);
   unregistersubsystem = 1;
@@ -502,6 +511,24 @@ TNamed *Fun4AllServer::getHisto(const std::string &hname) const
   return (ServerHistoManager->getHisto(hname));
 }
 
+void Fun4AllServer::PrintComplaints() const
+{
+  std::cout << "*******************************************************************************" << std::endl;
+  std::cout << "*******************************************************************************" << std::endl;
+  std::cout << "*******************************************************************************" << std::endl;
+  std::cout << "Now that I have your attention, please fix the following "
+            << ScreamEveryEvent << " problem(s):" << std::endl;
+  std::vector<std::string>::const_iterator viter;
+  for (viter = ComplaintList.begin(); viter != ComplaintList.end(); ++viter)
+  {
+    std::cout << *viter << std::endl;
+  }
+  std::cout << " " << std::endl;
+  std::cout << "*******************************************************************************" << std::endl;
+  std::cout << "*******************************************************************************" << std::endl;
+  std::cout << "*******************************************************************************" << std::endl;
+}
+
 int Fun4AllServer::process_event()
 {
   eventcounter++;
@@ -509,20 +536,7 @@ int Fun4AllServer::process_event()
   int eventbad = 0;
   if (ScreamEveryEvent)
   {
-    std::cout << "*******************************************************************************" << std::endl;
-    std::cout << "*******************************************************************************" << std::endl;
-    std::cout << "*******************************************************************************" << std::endl;
-    std::cout << "Now that I have your attention, please fix the following "
-              << ScreamEveryEvent << " problem(s):" << std::endl;
-    std::vector<std::string>::const_iterator viter;
-    for (viter = ComplaintList.begin(); viter != ComplaintList.end(); ++viter)
-    {
-      std::cout << *viter << std::endl;
-    }
-    std::cout << " " << std::endl;
-    std::cout << "*******************************************************************************" << std::endl;
-    std::cout << "*******************************************************************************" << std::endl;
-    std::cout << "*******************************************************************************" << std::endl;
+    PrintComplaints();
   }
   if (unregistersubsystem)
   {
@@ -668,92 +682,324 @@ int Fun4AllServer::process_event()
   if (!OutputManager.empty() && !eventbad)  // there are registered IO managers and
   // the event is not flagged bad
   {
-    PHNodeIterator iter(TopNode);
-    PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+    WriteEvent(TopNode, &RetCodes);
+  }
+  for (auto &Subsystem : Subsystems)
+  {
+    if (Verbosity() >= VERBOSITY_EVEN_MORE)
+    {
+      std::cout << "Fun4AllServer::process_event Resetting Event " << Subsystem.first->Name() << std::endl;
+    }
+    Subsystem.first->ResetEvent(Subsystem.second);
+  }
+  for (auto &syncman : SyncManagers)
+  {
+    if (Verbosity() >= VERBOSITY_EVEN_MORE)
+    {
+      std::cout << "Fun4AllServer::process_event Resetting Event for Sync Manager " << syncman->Name() << std::endl;
+    }
+    syncman->ResetEvent();
+  }
+  Fun4AllMonitoring::instance()->Snapshot("Event");
+  ResetNodeTree();
+  return 0;
+}
+
+int Fun4AllServer::WriteEvent(PHCompositeNode *topnode, std::vector<int> *retcodes)
+{
+  PHNodeIterator iter(topnode);
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
 
-    if (dstNode)
+  if (dstNode)
+  {
+    // check if we have same number of nodes. After first event is
+    // written out root I/O doesn't permit adding nodes, otherwise
+    // events get out of sync
+    static int first = 1;
+    int newcount = CountOutNodes(dstNode);
+    if (first)
     {
-      // check if we have same number of nodes. After first event is
-      // written out root I/O doesn't permit adding nodes, otherwise
-      // events get out of sync
-      static int first = 1;
-      int newcount = CountOutNodes(dstNode);
-      if (first)
-      {
-        first = 0;
-        OutNodeCount = newcount;      // save number of nodes before first write
-        MakeNodesTransient(dstNode);  // make all nodes transient before 1st write in case someone sneaked a node in at the first event
-      }
+      first = 0;
+      OutNodeCount = newcount;      // save number of nodes before first write
+      MakeNodesTransient(dstNode);  // make all nodes transient before 1st write in case someone sneaked a node in at the first event
+    }
 
-      if (OutNodeCount != newcount)
-      {
-        iter.print();
-        std::cout << PHWHERE << " FATAL: Someone changed the number of Output Nodes on the fly, from " << OutNodeCount << " to " << newcount << std::endl;
-        exit(1);
-      }
-      std::vector<Fun4AllOutputManager *>::iterator iterOutMan;
-      for (iterOutMan = OutputManager.begin(); iterOutMan != OutputManager.end(); ++iterOutMan)
+    if (OutNodeCount != newcount)
+    {
+      iter.print();
+      std::cout << PHWHERE << " FATAL: Someone changed the number of Output Nodes on the fly, from " << OutNodeCount << " to " << newcount << std::endl;
+      exit(1);
+    }
+    std::vector<Fun4AllOutputManager *>::iterator iterOutMan;
+    for (iterOutMan = OutputManager.begin(); iterOutMan != OutputManager.end(); ++iterOutMan)
+    {
+      if (!(*iterOutMan)->DoNotWriteEvent(retcodes))
       {
-        if (!(*iterOutMan)->DoNotWriteEvent(&RetCodes))
+        if (Verbosity() >= VERBOSITY_MORE)
         {
-          if (Verbosity() >= VERBOSITY_MORE)
-          {
-            std::cout << "Writing Event for " << (*iterOutMan)->Name() << std::endl;
-          }
+          std::cout << "Writing Event for " << (*iterOutMan)->Name() << std::endl;
+        }
 #ifdef FFAMEMTRACKER
-          ffamemtracker->Snapshot("Fun4AllServerOutputManager");
-          ffamemtracker->Start((*iterOutMan)->Name(), "OutputManager");
+        ffamemtracker->Snapshot("Fun4AllServerOutputManager");
+        ffamemtracker->Start((*iterOutMan)->Name(), "OutputManager");
 #endif
-          (*iterOutMan)->WriteGeneric(dstNode);
+        (*iterOutMan)->WriteGeneric(dstNode);
 #ifdef FFAMEMTRACKER
-          ffamemtracker->Stop((*iterOutMan)->Name(), "OutputManager");
-          ffamemtracker->Snapshot("Fun4AllServerOutputManager");
+        ffamemtracker->Stop((*iterOutMan)->Name(), "OutputManager");
+        ffamemtracker->Snapshot("Fun4AllServerOutputManager");
 #endif
-          if ((*iterOutMan)->EventsWritten() >= (*iterOutMan)->GetNEvents())
+        if ((*iterOutMan)->EventsWritten() >= (*iterOutMan)->GetNEvents())
+        {
+          if (Verbosity() > 0)
           {
-            if (Verbosity() > 0)
-            {
-              std::cout << PHWHERE << (*iterOutMan)->Name() << " wrote " << (*iterOutMan)->EventsWritten()
-                        << " events, closing " << (*iterOutMan)->OutFileName() << std::endl;
-            }
-            PHNodeIterator nodeiter(TopNode);
-            PHCompositeNode *runNode = dynamic_cast<PHCompositeNode *>(nodeiter.findFirst("PHCompositeNode", "RUN"));
-            MakeNodesTransient(runNode);  // make all nodes transient by default
-            (*iterOutMan)->WriteNode(runNode);
-            (*iterOutMan)->RunAfterClosing();
+            std::cout << PHWHERE << (*iterOutMan)->Name() << " wrote " << (*iterOutMan)->EventsWritten()
+                      << " events, closing " << (*iterOutMan)->OutFileName() << std::endl;
           }
+          PHNodeIterator nodeiter(TopNode);
+          PHCompositeNode *runNode = dynamic_cast<PHCompositeNode *>(nodeiter.findFirst("PHCompositeNode", "RUN"));
+          MakeNodesTransient(runNode);  // make all nodes transient by default
+          (*iterOutMan)->WriteNode(runNode);
+          (*iterOutMan)->RunAfterClosing();
         }
-        else
+      }
+      else
+      {
+        if (Verbosity() >= VERBOSITY_MORE)
         {
-          if (Verbosity() >= VERBOSITY_MORE)
-          {
-            std::cout << "Not Writing Event for " << (*iterOutMan)->Name() << std::endl;
-          }
+          std::cout << "Not Writing Event for " << (*iterOutMan)->Name() << std::endl;
         }
       }
     }
   }
-  for (auto &Subsystem : Subsystems)
+  return 0;
+}
+
+void Fun4AllServer::setEventSlots(const unsigned int n)
+{
+  if (!m_EventSlots.empty())
   {
-    if (Verbosity() >= VERBOSITY_EVEN_MORE)
+    std::cout << PHWHERE << " event slots are already in use, the number of slots cannot be changed" << std::endl;
+    return;
+  }
+  m_NEventSlots = n ? n : 1;
+  if (m_NEventSlots > 1)
+  {
+    // makes gDirectory thread local and protects the root internals
+    ROOT::EnableThreadSafety();
+  }
+}
+
+bool Fun4AllServer::EventSlotsAllowed() const
+{
+  // modules caching node pointers in InitRun would see the reset server node tree
+  bool allowed = true;
+  for (const auto &Subsystem : Subsystems)
+  {
+    if (!Subsystem.first->ThreadSafe())
     {
-      std::cout << "Fun4AllServer::process_event Resetting Event " << Subsystem.first->Name() << std::endl;
+      std::cout << PHWHERE << " module " << Subsystem.first->Name() << " is not thread safe" << std::endl;
+      allowed = false;
     }
-    Subsystem.first->ResetEvent(Subsystem.second);
   }
-  for (auto &syncman : SyncManagers)
+  return allowed;
+}
+
+int Fun4AllServer::QueueEvent()
+{
+  if (m_EventSlots.empty())
   {
-    if (Verbosity() >= VERBOSITY_EVEN_MORE)
+    if (!EventSlotsAllowed())
     {
-      std::cout << "Fun4AllServer::process_event Resetting Event for Sync Manager " << syncman->Name() << std::endl;
+      std::cout << PHWHERE << " not all modules are thread safe, using sequential processing instead of "
+                << m_NEventSlots << " event slots" << std::endl;
+      m_NEventSlots = 1;
+      return process_event();
     }
+    // created with the first event, after all modules created their nodes in InitRun
+    for (unsigned int i = 0; i < m_NEventSlots; i++)
+    {
+      Fun4AllEventSlot *slot = new Fun4AllEventSlot(i, topnodemap);
+      slot->Verbosity(Verbosity());
+      m_EventSlots.push_back(slot);
+    }
+  }
+  // the server event counter is updated when the event is processed
+  m_EventSlots[m_NQueuedEvents]->EventCounter = eventcounter + m_NQueuedEvents + 1;
+  if (ScreamEveryEvent)
+  {
+    PrintComplaints();
+  }
+  m_EventSlots[m_NQueuedEvents]->CopyEvent(topnodemap);
+  m_NQueuedEvents++;
+
+  // the server node tree is free for the next event
+  for (auto &syncman : SyncManagers)
+  {
     syncman->ResetEvent();
   }
-  Fun4AllMonitoring::instance()->Snapshot("Event");
   ResetNodeTree();
+
+  if (m_NQueuedEvents >= m_EventSlots.size())
+  {
+    return ProcessEventSlots();
+  }
   return 0;
 }
 
+int Fun4AllServer::ProcessEventSlots()
+{
+  if (m_NQueuedEvents == 0)
+  {
+    return 0;
+  }
+  if (unregistersubsystem)
+  {
+    unregisterSubsystemsNow();
+  }
+  gROOT->cd(default_Tdirectory.c_str());
+  std::string currdir = gDirectory->GetPath();
+
+  // modules registered after the slots were created
+  if (!EventSlotsAllowed())
+  {
+    std::cout << PHWHERE << " modules which are not thread safe cannot be added while running with "
+              << m_NEventSlots << " event slots" << std::endl;
+    exit(1);
+  }
+  m_StopSlot = m_NQueuedEvents;
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < m_NQueuedEvents; i++)
+  {
+    m_EventSlots[i]->RetCodes.assign(Subsystems.size(), 0);
+    threads.emplace_back(&Fun4AllServer::ProcessSlot, this, m_EventSlots[i]);
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  gROOT->cd(currdir.c_str());
+
+  // bookkeeping, output and reset in event order
+  int iret = 0;
+  for (unsigned int i = 0; i < m_NQueuedEvents; i++)
+  {
+    Fun4AllEventSlot *slot = m_EventSlots[i];
+    if (!iret)
+    {
+      eventcounter = slot->EventCounter;
+      if (slot->ReturnCode)
+      {
+        iret = slot->ReturnCode;
+        retcodesmap[iret]++;
+      }
+      else
+      {
+        if (slot->EventBad)
+        {
+          retcodesmap[Fun4AllReturnCodes::ABORTEVENT]++;
+        }
+        else
+        {
+          retcodesmap[Fun4AllReturnCodes::EVENT_OK]++;
+          if (!OutputManager.empty())
+          {
+            WriteEvent(slot->topNode(TopNode->getName()), &slot->RetCodes);
+          }
+        }
+        if (std::find(slot->RetCodes.begin(), slot->RetCodes.end(),
+                      static_cast<int>(Fun4AllReturnCodes::ABORTEVENT)) == slot->RetCodes.end())
+        {
+          m_NGoodSlotEvents++;
+        }
+        for (auto &Subsystem : Subsystems)
+        {
+          Subsystem.first->ResetEvent(slot->topNode(Subsystem.second->getName()));
+        }
+        Fun4AllMonitoring::instance()->Snapshot("Event");
+      }
+    }
+    slot->ResetEvent();
+  }
+  m_NQueuedEvents = 0;
+  return iret;
+}
+
+void Fun4AllServer::ProcessSlot(Fun4AllEventSlot *slot)
+{
+  for (unsigned int icnt = 0; icnt < Subsystems.size(); icnt++)
+  {
+    SubsysReco *subsys = Subsystems[icnt].first;
+    const std::string &topnodename = Subsystems[icnt].second->getName();
+    if (!slot->EventBad && !slot->ReturnCode && slot->Index() <= m_StopSlot)
+    {
+      std::string newdirname = topnodename + "/" + subsys->Name();
+      if (!gROOT->cd(newdirname.c_str()))
+      {
+        std::cout << PHWHERE << "Unexpected TDirectory Problem cd'ing to "
+                  << topnodename
+                  << " - send e-mail to off-l with your macro" << std::endl;
+        exit(1);
+      }
+      int retcode = 0;
+      try
+      {
+        // the module timers are not thread safe, modules are not timed in event slots
+        retcode = subsys->process_event(slot->topNode(topnodename));
+      }
+      catch (const std::exception &e)
+      {
+        std::cout << PHWHERE << " caught exception thrown during process_event from "
+                  << subsys->Name() << std::endl;
+        std::cout << "error: " << e.what() << std::endl;
+        gSystem->Exit(1);
+      }
+      catch (...)
+      {
+        std::cout << PHWHERE << " caught unknown type exception thrown during process_event from "
+                  << subsys->Name() << std::endl;
+        exit(1);
+      }
+      slot->RetCodes[icnt] = retcode;
+      if (retcode == Fun4AllReturnCodes::DISCARDEVENT)
+      {
+        if (Verbosity() >= VERBOSITY_EVEN_MORE)
+        {
+          std::cout << "Fun4AllServer::Discard Event by " << subsys->Name() << std::endl;
+        }
+      }
+      else if (retcode == Fun4AllReturnCodes::ABORTEVENT)
+      {
+        slot->EventBad = 1;
+        if (Verbosity() >= VERBOSITY_MORE)
+        {
+          std::cout << "Fun4AllServer::Abort Event by " << subsys->Name() << std::endl;
+        }
+      }
+      else if (retcode)
+      {
+        if (retcode == Fun4AllReturnCodes::ABORTRUN || retcode == Fun4AllReturnCodes::ABORTPROCESSING)
+        {
+          std::cout << "Fun4AllServer::" << (retcode == Fun4AllReturnCodes::ABORTRUN ? "Abort Run" : "Abort Processing")
+                    << " by " << subsys->Name() << std::endl;
+          slot->ReturnCode = retcode;
+        }
+        else
+        {
+          std::cout << "Fun4AllServer::Unknown return code: "
+                    << retcode << " from process_event method of "
+                    << subsys->Name() << ", this Run will be aborted" << std::endl;
+          slot->ReturnCode = Fun4AllReturnCodes::ABORTRUN;
+        }
+        slot->EventBad = 1;
+        // later events are not processed any further
+        std::lock_guard<std::mutex> lock(m_SlotMutex);
+        m_StopSlot = std::min(m_StopSlot.load(), slot->Index());
+      }
+    }
+  }
+}
+
 int Fun4AllServer::ResetNodeTree()
 {
   std::vector<std::string> ResetNodeList;
@@ -1438,6 +1684,17 @@ int Fun4AllServer::run(const int nevnts, const bool require_nevents)
         }
       }
     }
+    // events of the previous run still waiting in the event slots are processed before EndRun
+    if (m_NQueuedEvents > 0 && !run_number_forced && currentrun != runnumber)
+    {
+      iret = ProcessEventSlots();
+      icnt_good += m_NGoodSlotEvents;
+      m_NGoodSlotEvents = 0;
+      if (iret)
+      {
+        break;
+      }
+    }
     if (ifirst)
     {
       if (currentrun != runnumber && !run_number_forced)  // use real run if not forced
@@ -1471,7 +1728,22 @@ int Fun4AllServer::run(const int nevnts, const bool require_nevents)
       Verbosity(++iverb);
     }
 
-    iret = process_event();
+    if (m_NEventSlots > 1)
+    {
+      iret = QueueEvent();
+      // the outcome of queued events is only known once they are processed,
+      // do not queue more events than good events are still missing
+      if (!iret && require_nevents && nevnts > 0 && icnt_good + static_cast<int>(m_NQueuedEvents) >= nevnts)
+      {
+        iret = ProcessEventSlots();
+      }
+      icnt_good += m_NGoodSlotEvents;
+      m_NGoodSlotEvents = 0;
+    }
+    else
+    {
+      iret = process_event();
+    }
 
     if (icnt == 0 && Verbosity() > VERBOSITY_QUIET)
     {
@@ -1484,7 +1756,8 @@ int Fun4AllServer::run(const int nevnts, const bool require_nevents)
 
     if (require_nevents)
     {
-      if (std::find(RetCodes.begin(),
+      if (m_NEventSlots <= 1 &&
+          std::find(RetCodes.begin(),
                     RetCodes.end(),
                     static_cast<int>(Fun4AllReturnCodes::ABORTEVENT)) == RetCodes.end())
       {
@@ -1500,6 +1773,16 @@ int Fun4AllServer::run(const int nevnts, const bool require_nevents)
       break;
     }
   }
+  // process the events still waiting in the event slots
+  if (m_NQueuedEvents > 0)
+  {
+    int slotret = ProcessEventSlots();
+    m_NGoodSlotEvents = 0;
+    if (slotret)
+    {
+      iret = slotret;
+    }
+  }
   return iret;
 }
 
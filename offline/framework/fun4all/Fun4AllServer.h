@@ -9,13 +9,16 @@
 
 #include <phool/PHTimer.h>
 
+#include <atomic>
 #include <deque>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>  // for pair
 #include <vector>
 
+class Fun4AllEventSlot;
 class Fun4AllInputManager;
 class Fun4AllMemoryTracker;
 class Fun4AllSyncManager;
@@ -84,6 +87,22 @@ class Fun4AllServer : public Fun4AllBase
   //! run n events (0 means up to end of file)
   int run(const int nevnts = 0, const bool require_nevents = false);
 
+  /*!
+    \brief number of events processed concurrently (default 1, sequential processing)
+    Each event slot has its own DST node tree, RUN and PAR nodes are shared.
+    Events are read one by one and copied into the slots, then the module chain runs
+    on all slots in parallel. Events are written in event order.
+    Modules get the top node of their slot in process_event, node pointers cached
+    in InitRun point to the server node tree which is reset once the event is copied
+    into a slot. This is why slots are only used if all modules are
+    SubsysReco::ThreadSafe() when the first event is read, otherwise the events are
+    processed sequentially. Modules are not timed in event slots. EventCounter() is
+    updated after all slots are processed, it is not the event of a slot during process_event.
+    Must be set before the first event.
+  */
+  void setEventSlots(const unsigned int n);
+  unsigned int getEventSlots() const { return m_NEventSlots; }
+
   /*!
     \brief skip n events (0 means up to the end of file).
     Skip means read, don't process.
@@ -123,6 +142,12 @@ class Fun4AllServer : public Fun4AllBase
   int CountOutNodes(PHCompositeNode *startNode);
   int CountOutNodesRecursive(PHCompositeNode *startNode, const int icount);
   int UpdateEventSelector(Fun4AllOutputManager *manager);
+  int WriteEvent(PHCompositeNode *topnode, std::vector<int> *retcodes);
+  void PrintComplaints() const;
+  int QueueEvent();
+  int ProcessEventSlots();
+  bool EventSlotsAllowed() const;
+  void ProcessSlot(Fun4AllEventSlot *slot);
   int unregisterSubsystemsNow();
   int setRun(const int runnumber);
   static Fun4AllServer *__instance;
@@ -155,6 +180,15 @@ class Fun4AllServer : public Fun4AllBase
   std::vector<Fun4AllSyncManager *> SyncManagers;
   std::map<int, int> retcodesmap;
   std::map<const std::string, PHTimer> timer_map;
+
+  // event slots
+  unsigned int m_NEventSlots = 1;
+  unsigned int m_NQueuedEvents = 0;
+  int m_NGoodSlotEvents = 0;
+  std::vector<Fun4AllEventSlot *> m_EventSlots;
+  //! slots after this one stop processing (ABORTRUN, ABORTPROCESSING)
+  std::atomic<unsigned int> m_StopSlot = 0;
+  std::mutex m_SlotMutex;
 };
 
 #endif
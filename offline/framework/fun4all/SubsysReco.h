@@ -58,6 +58,15 @@ class SubsysReco : public Fun4AllBase
   /// Clean up after each event.
   virtual int ResetEvent(PHCompositeNode * /*topNode*/) { return 0; }
 
+  /** Called by Fun4AllServer running with several event slots.
+      Return true if process_event() can run concurrently for different events.
+      Such a module must only use nodes found under the topNode it is given
+      (not pointers cached in InitRun) and must not modify its own data members.
+      Event slots are only used if all modules registered when the first event is read
+      are thread safe, modules which are not cannot be registered later on.
+  */
+  virtual bool ThreadSafe() const { return false; }
+
   void Print(const std::string & /*what*/ = "ALL") const override {}
 
  protected:
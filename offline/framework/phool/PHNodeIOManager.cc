@@ -19,14 +19,20 @@
 #include <TROOT.h>
 #include <TSystem.h>
 #include <TTree.h>
+#include <TTreeCache.h>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #include <boost/algorithm/string.hpp>
 #pragma GCC diagnostic pop
 
+#include <boost/io/ios_state.hpp>
+
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -70,6 +76,15 @@ void PHNodeIOManager::closeFile()
     if (accessMode == PHWrite || accessMode == PHUpdate)
     {
       file->Write();
+      // baskets are all written now, the byte counts are final
+      if (m_WriteReport && file->IsOpen())
+      {
+        PrintWriteReport();
+      }
+    }
+    else if (m_ReadReport && tree)
+    {
+      PrintReadReport();
     }
     file->Close();
   }
@@ -102,6 +117,10 @@ bool PHNodeIOManager::setFile(const std::string& f, const std::string& title,
     file->SetCompressionSettings(m_CompressionSetting);
     tree = new TTree(TreeName.c_str(), title.c_str());
     tree->SetMaxTreeSize(900000000000LL);  // set max size to ~900 GB
+    if (m_AutoFlush)
+    {
+      tree->SetAutoFlush(m_AutoFlush);
+    }
     gROOT->cd(currdir.c_str());
     return true;
     break;
@@ -124,6 +143,10 @@ bool PHNodeIOManager::setFile(const std::string& f, const std::string& title,
     }
     file->SetCompressionSettings(m_CompressionSetting);
     tree = new TTree(TreeName.c_str(), title.c_str());
+    if (m_AutoFlush)
+    {
+      tree->SetAutoFlush(m_AutoFlush);
+    }
     gROOT->cd(currdir.c_str());
     return true;
     break;
@@ -145,7 +168,9 @@ bool PHNodeIOManager::write(PHCompositeNode* topNode)
   // be filled.
   if (file && tree)
   {
+    const auto start = std::chrono::steady_clock::now();
     tree->Fill();
+    m_FillTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     eventNumber++;
     return true;
   }
@@ -162,9 +187,20 @@ bool PHNodeIOManager::write(TObject** data, const std::string& path, int buffers
     {
       // the buffersize and splitlevel are set on the first call
       // when the branch is created, the values come from the caller
-      // which is the node which writes itself
-      tree->Branch(path.c_str(), (*data)->ClassName(),
-                   data, buffersize, splitlevel);
+      // which is the node which writes itself, unless a policy
+      // is set for this node
+      const auto policyiter = m_BranchPolicies.find(path.substr(path.rfind(phooldefs::branchpathdelim) + 1));
+      if (policyiter != m_BranchPolicies.end() && policyiter->second.basketsize > 0)
+      {
+        buffersize = policyiter->second.basketsize;
+      }
+      thisBranch = tree->Branch(path.c_str(), (*data)->ClassName(),
+                                data, buffersize, splitlevel);
+      if (thisBranch && policyiter != m_BranchPolicies.end() && policyiter->second.compression >= 0)
+      {
+        // applies to all sub branches
+        thisBranch->SetCompressionSettings(policyiter->second.compression);
+      }
     }
     else
     {
@@ -290,16 +326,22 @@ bool PHNodeIOManager::readEventFromFile(size_t requestedEvent)
   TFile* file_ptr = gFile;  // save current gFile
   file->cd();
 
+  const auto start = std::chrono::steady_clock::now();
   if (requestedEvent)
   {
-    if ((bytesRead = tree->GetEvent(requestedEvent)))
+    if ((bytesRead = getEntry(requestedEvent)))
     {
       eventNumber = requestedEvent + 1;
     }
   }
   else
   {
-    bytesRead = tree->GetEvent(eventNumber++);
+    bytesRead = getEntry(eventNumber++);
+  }
+  m_ReadTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (bytesRead > 0)
+  {
+    ++m_EntriesRead;
   }
 
   gFile = file_ptr;  // recover gFile
@@ -317,6 +359,43 @@ bool PHNodeIOManager::readEventFromFile(size_t requestedEvent)
   return true;
 }
 
+int PHNodeIOManager::getEntry(size_t entry)
+{
+  if (!m_ReadReport)
+  {
+    return tree->GetEntry(entry);
+  }
+
+  // same as TTree::GetEntry but timing every branch
+  if (static_cast<Long64_t>(entry) >= tree->GetEntries())
+  {
+    return 0;
+  }
+  // sets the current entry of the tree, the TTreeCache prefetches from there
+  tree->LoadTree(entry);
+  TObjArray* branchArray = tree->GetListOfBranches();
+  m_BranchReadStats.resize(branchArray->GetEntriesFast());
+  int nbytes = 0;
+  for (int i = 0; i < branchArray->GetEntriesFast(); ++i)
+  {
+    TBranch* branch = static_cast<TBranch*>(branchArray->UncheckedAt(i));
+    if (branch->TestBit(kDoNotProcess))
+    {
+      continue;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const int nb = branch->GetEntry(entry);
+    m_BranchReadStats[i].time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (nb < 0)
+    {
+      return nb;
+    }
+    m_BranchReadStats[i].bytes += nb;
+    nbytes += nb;
+  }
+  return nbytes;
+}
+
 int PHNodeIOManager::readSpecific(size_t requestedEvent, const std::string& objectName)
 {
   // objectName should be one of the valid branch name of the "T" TTree, and
@@ -384,6 +463,7 @@ PHNodeIOManager::reconstructNodeTree(PHCompositeNode* topNode)
                             static_cast<bool>(it->second));
     }
   }
+  setupReadCache();
   // The file contains a TTree with a list of the TBranchObjects
   // attached to it.
   TObjArray* branchArray = tree->GetListOfBranches();
@@ -506,6 +586,7 @@ void PHNodeIOManager::selectObjectToRead(const std::string& objectName, bool rea
       tree->SetBranchStatus((it->first).c_str(),
                             static_cast<bool>(it->second));
     }
+    setupReadCache();
   }
   return;
 }
@@ -537,6 +618,169 @@ bool PHNodeIOManager::SetCompressionSetting(const int level)
   return true;
 }
 
+void PHNodeIOManager::SetAutoFlush(const int64_t autoflush)
+{
+  m_AutoFlush = autoflush;
+  if (tree && m_AutoFlush)
+  {
+    tree->SetAutoFlush(m_AutoFlush);
+  }
+}
+
+void PHNodeIOManager::SetReadCache(const int64_t maxbytes)
+{
+  m_ReadCacheMax = maxbytes;
+  setupReadCache();
+}
+
+void PHNodeIOManager::setupReadCache()
+{
+  if (!tree || m_ReadCacheMax <= 0 || accessMode != PHReadOnly)
+  {
+    return;
+  }
+  const Long64_t entries = tree->GetEntries();
+  if (entries <= 0)
+  {
+    return;
+  }
+
+  // the cache holds one cluster (the entries between two auto flushes)
+  // of the compressed baskets of the selected branches
+  double zipbytes = 0;
+  TObjArray* branchArray = tree->GetListOfBranches();
+  for (int i = 0; i < branchArray->GetEntriesFast(); ++i)
+  {
+    TBranch* branch = static_cast<TBranch*>(branchArray->UncheckedAt(i));
+    if (!branch->TestBit(kDoNotProcess))
+    {
+      zipbytes += branch->GetZipBytes("*");
+    }
+  }
+  const Long64_t cluster = (tree->GetAutoFlush() > 0) ? std::min(tree->GetAutoFlush(), entries) : entries;
+  // 10% margin for clusters larger than the average
+  const int64_t cachesize = std::clamp<int64_t>(static_cast<int64_t>(1.1 * zipbytes * cluster / entries), std::min<int64_t>(1000000, m_ReadCacheMax), m_ReadCacheMax);
+
+  std::string currdir = gDirectory->GetPath();
+  TFile* file_ptr = gFile;
+  file->cd();
+  tree->SetCacheSize(cachesize);
+  // the branch set is known, skip the learning phase
+  tree->DropBranchFromCache("*", true);
+  for (int i = 0; i < branchArray->GetEntriesFast(); ++i)
+  {
+    TBranch* branch = static_cast<TBranch*>(branchArray->UncheckedAt(i));
+    if (!branch->TestBit(kDoNotProcess))
+    {
+      tree->AddBranchToCache(branch, true);
+    }
+  }
+  tree->StopCacheLearningPhase();
+  gFile = file_ptr;
+  gROOT->cd(currdir.c_str());
+}
+
+void PHNodeIOManager::PrintReadReport(std::ostream& os) const
+{
+  if (!tree || !file)
+  {
+    return;
+  }
+  // precision and adjustment set below are not left on the caller's stream
+  boost::io::ios_all_saver saver(os);
+
+  os << "PHNodeIOManager::PrintReadReport - " << filename << " tree " << TreeName
+     << " entries read: " << m_EntriesRead
+     << " read time: " << m_ReadTime << " s"
+     << " file bytes read: " << file->GetBytesRead()
+     << " read calls: " << file->GetReadCalls() << std::endl;
+  TTreeCache* cache = dynamic_cast<TTreeCache*>(file->GetCacheRead(tree));
+  if (cache)
+  {
+    os << "TTreeCache size: " << cache->GetBufferSize()
+       << " efficiency: " << std::setprecision(3) << cache->GetEfficiency() << std::endl;
+  }
+  if (m_BranchReadStats.empty())
+  {
+    return;
+  }
+  os << std::setw(48) << std::left << "branch" << std::right
+     << std::setw(14) << "uncompressed"
+     << std::setw(14) << "compressed"
+     << std::setw(12) << "time (s)"
+     << std::setw(14) << "ms/entry" << std::endl;
+
+  TObjArray* branchArray = tree->GetListOfBranches();
+  const size_t nbranches = std::min<size_t>(branchArray->GetEntriesFast(), m_BranchReadStats.size());
+  for (size_t i = 0; i < nbranches; ++i)
+  {
+    const BranchReadStat& stat = m_BranchReadStats[i];
+    if (!stat.bytes)
+    {
+      continue;
+    }
+    // the compressed size of the entries read is estimated from the branch compression ratio
+    TBranch* branch = static_cast<TBranch*>(branchArray->UncheckedAt(i));
+    const double branch_totbytes = branch->GetTotBytes("*");
+    const double ratio = branch_totbytes > 0 ? branch->GetZipBytes("*") / branch_totbytes : 1;
+    os << std::setw(48) << std::left << branch->GetName() << std::right
+       << std::setw(14) << stat.bytes
+       << std::setw(14) << static_cast<uint64_t>(stat.bytes * ratio)
+       << std::setw(12) << std::setprecision(3) << stat.time
+       << std::setw(14) << std::setprecision(3) << (m_EntriesRead ? 1000. * stat.time / m_EntriesRead : 0)
+       << std::endl;
+  }
+}
+
+void PHNodeIOManager::PrintWriteReport(std::ostream& os) const
+{
+  if (!tree)
+  {
+    return;
+  }
+  // precision and adjustment set below are not left on the caller's stream
+  boost::io::ios_all_saver saver(os);
+
+  // TTree::Fill does not time the branches separately, the write time
+  // is split between branches according to their uncompressed size
+  const double totbytes = tree->GetTotBytes();
+  const double zipbytes = tree->GetZipBytes();
+
+  os << "PHNodeIOManager::PrintWriteReport - " << filename << " tree " << TreeName
+     << " entries: " << tree->GetEntries()
+     << " autoflush: " << tree->GetAutoFlush()
+     << " fill time: " << m_FillTime << " s" << std::endl;
+  os << std::setw(48) << std::left << "branch" << std::right
+     << std::setw(14) << "uncompressed"
+     << std::setw(14) << "compressed"
+     << std::setw(8) << "ratio"
+     << std::setw(8) << "comp"
+     << std::setw(10) << "basket"
+     << std::setw(15) << "est. time (s)" << std::endl;
+
+  TObjArray* branchArray = tree->GetListOfBranches();
+  for (int i = 0; i < branchArray->GetEntriesFast(); ++i)
+  {
+    TBranch* branch = static_cast<TBranch*>(branchArray->UncheckedAt(i));
+    const double branch_totbytes = branch->GetTotBytes("*");
+    const double branch_zipbytes = branch->GetZipBytes("*");
+    os << std::setw(48) << std::left << branch->GetName() << std::right
+       << std::setw(14) << static_cast<uint64_t>(branch_totbytes)
+       << std::setw(14) << static_cast<uint64_t>(branch_zipbytes)
+       << std::setw(8) << std::setprecision(3) << (branch_zipbytes > 0 ? branch_totbytes / branch_zipbytes : 0)
+       << std::setw(8) << branch->GetCompressionSettings()
+       << std::setw(10) << branch->GetBasketSize()
+       << std::setw(15) << std::setprecision(3) << (totbytes > 0 ? m_FillTime * branch_totbytes / totbytes : 0)
+       << std::endl;
+  }
+  os << std::setw(48) << std::left << "total" << std::right
+     << std::setw(14) << static_cast<uint64_t>(totbytes)
+     << std::setw(14) << static_cast<uint64_t>(zipbytes)
+     << std::setw(8) << std::setprecision(3) << (zipbytes > 0 ? totbytes / zipbytes : 0)
+     << std::endl;
+  os << "est. time: fill time split between branches by uncompressed size, not measured per branch" << std::endl;
+}
+
 uint64_t
 PHNodeIOManager::GetBytesWritten()
 {
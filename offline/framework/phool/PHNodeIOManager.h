@@ -10,8 +10,11 @@
 #include "phool.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <iostream>
 #include <map>
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
 class TBranch;
@@ -22,6 +25,13 @@ class TTree;
 class PHNodeIOManager : public PHIOManager
 {
  public:
+  //! output settings of the branch of a given node. Negative values keep the defaults
+  struct BranchPolicy
+  {
+    int compression{-1};  // ROOT compression setting, 100 * algorithm + level
+    int basketsize{-1};   // basket size in bytes, instead of the PHIODataNode buffersize
+  };
+
   PHNodeIOManager() {}
   PHNodeIOManager(const std::string &, const PHAccessType = PHReadOnly);
   PHNodeIOManager(const std::string &, const std::string &, const PHAccessType = PHReadOnly);
@@ -41,6 +51,22 @@ class PHNodeIOManager : public PHIOManager
   bool isSelected(const std::string &objectName);
   int isFunctional() const { return isFunctionalFlag; }
   bool SetCompressionSetting(const int level);
+  //! output settings for the branch of node nodename, applied when the branch is created
+  void SetBranchPolicy(const std::string &nodename, const BranchPolicy &policy) { m_BranchPolicies[nodename] = policy; }
+  //! TTree::SetAutoFlush: > 0 number of entries, < 0 number of bytes per cluster. 0 keeps the ROOT default
+  void SetAutoFlush(const int64_t autoflush);
+  //! per branch compressed and uncompressed bytes and estimated write time
+  void PrintWriteReport(std::ostream &os = std::cout) const;
+  //! print the write report when the file is closed
+  void WriteReport(const bool flag) { m_WriteReport = flag; }
+  //! TTreeCache for the selected branches when reading, sized for one cluster of them
+  //! but at most maxbytes. 0 disables it
+  void SetReadCache(const int64_t maxbytes);
+  //! per branch bytes and read time (including decompression)
+  void PrintReadReport(std::ostream &os = std::cout) const;
+  //! time the branches separately when reading and print the read report when the file is closed.
+  //! The branches are then read one after the other, without ROOT implicit multi threading
+  void ReadReport(const bool flag) { m_ReadReport = flag; }
   uint64_t GetBytesWritten();
   uint64_t GetFileSize();
   std::map<std::string, TBranch *> *GetBranchMap();
@@ -53,12 +79,29 @@ class PHNodeIOManager : public PHIOManager
   PHCompositeNode *reconstructNodeTree(PHCompositeNode *);
   bool readEventFromFile(size_t requestedEvent);
   std::string getBranchClassName(TBranch *);
+  void setupReadCache();
+  int getEntry(size_t entry);
+
+  struct BranchReadStat
+  {
+    uint64_t bytes{0};
+    double time{0};  // seconds spent in TBranch::GetEntry
+  };
 
   TFile *file{nullptr};
   TTree *tree{nullptr};
   std::string TreeName{"T"};
   int accessMode{PHReadOnly};
   int m_CompressionSetting{505};  // ZSTD
+  int64_t m_AutoFlush{0};
+  bool m_WriteReport{false};
+  double m_FillTime{0};  // seconds spent in TTree::Fill
+  int64_t m_ReadCacheMax{0};
+  bool m_ReadReport{false};
+  double m_ReadTime{0};  // seconds spent reading entries
+  size_t m_EntriesRead{0};
+  std::vector<BranchReadStat> m_BranchReadStats;  // indexed like the list of branches
+  std::map<std::string, BranchPolicy> m_BranchPolicies;
   int isFunctionalFlag{0};        // flag to tell if that object initialized properly
   std::map<std::string, TBranch *> fBranches;
   std::map<std::string, bool> objectToRead;
@@ -0,0 +1,315 @@
+#include "PHSharedStore.h"
+
+#include "recoConsts.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+  struct StoreFileHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t spare;
+    uint64_t key;
+    uint64_t size;
+    char padding[32];
+  };
+  static_assert(sizeof(StoreFileHeader) == 64, "payload has to start at a 64 byte boundary");
+
+  std::string to_hex(uint64_t value)
+  {
+    std::ostringstream out;
+    out << std::hex << value;
+    return out.str();
+  }
+
+  //! exclusive lock on a file, released on destruction
+  class FileLock
+  {
+   public:
+    explicit FileLock(const std::string &path)
+      : m_fd(open(path.c_str(), O_RDWR | O_CREAT, 0666))
+    {
+      if (m_fd >= 0 && flock(m_fd, LOCK_EX) != 0)
+      {
+        close(m_fd);
+        m_fd = -1;
+      }
+    }
+
+    ~FileLock()
+    {
+      if (m_fd >= 0)
+      {
+        flock(m_fd, LOCK_UN);
+        close(m_fd);
+      }
+    }
+
+    FileLock(const FileLock &) = delete;
+    FileLock &operator=(const FileLock &) = delete;
+
+    bool locked() const { return m_fd >= 0; }
+
+   private:
+    int m_fd = -1;
+  };
+}  // namespace
+
+PHSharedStore::Segment::~Segment()
+{
+  if (m_mapped)
+  {
+    munmap(const_cast<char *>(m_data) - sizeof(StoreFileHeader), m_mapSize);
+  }
+}
+
+PHSharedStore *PHSharedStore::instance()
+{
+  static PHSharedStore store;
+  return &store;
+}
+
+void PHSharedStore::Directory(const std::string &dir)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Directory = dir;
+  m_DirectorySet = true;
+}
+
+std::string PHSharedStore::Directory()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (!m_DirectorySet)
+  {
+    recoConsts *rc = recoConsts::instance();
+    if (rc->FlagExist("SHARED_STORE"))
+    {
+      m_Directory = rc->get_StringFlag("SHARED_STORE");
+    }
+    else if (const char *env = getenv("SPHENIX_SHARED_STORE"))
+    {
+      m_Directory = env;
+    }
+    m_DirectorySet = true;
+    if (!m_Directory.empty())
+    {
+      std::cout << "PHSharedStore: using shared store in " << m_Directory << std::endl;
+    }
+  }
+  return m_Directory;
+}
+
+std::shared_ptr<const PHSharedStore::Segment> PHSharedStore::get(const std::string &name, uint64_t key, const Builder &build)
+{
+  const std::string directory = Directory();
+  const std::string id = name + "-" + to_hex(key);
+
+  std::shared_ptr<Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto &slot = m_Segments[id];
+    if (!slot)
+    {
+      slot = std::make_shared<Entry>();
+    }
+    entry = slot;
+  }
+
+  // waiting for our own build would never return
+  if (entry->m_Builder.load() == std::this_thread::get_id())
+  {
+    std::cout << "PHSharedStore::get - " << id << " requested again while it is built, recursive Builder" << std::endl;
+    exit(1);
+  }
+
+  // only this object is locked, other objects can be built at the same time
+  std::lock_guard<std::mutex> entrylock(entry->m_Mutex);
+  if (auto segment = entry->m_Segment.lock())
+  {
+    return segment;
+  }
+
+  entry->m_Builder = std::this_thread::get_id();
+  auto segment = build_segment(name, id, key, directory, build);
+  entry->m_Builder = std::thread::id();
+  entry->m_Segment = segment;
+  return segment;
+}
+
+std::shared_ptr<const PHSharedStore::Segment> PHSharedStore::build_segment(const std::string &name, const std::string &id, uint64_t key, const std::string &directory, const Builder &build)
+{
+  std::shared_ptr<Segment> segment;
+  std::vector<char> payload;
+  bool built = false;
+  if (!directory.empty())
+  {
+    const std::string path = directory + "/" + id + ".bin";
+    segment = attach(path, key);
+    if (!segment)
+    {
+      std::error_code error;
+      std::filesystem::create_directories(directory, error);
+      // another process might be building it, wait for it and check again
+      FileLock filelock(path + ".lock");
+      if (filelock.locked())
+      {
+        segment = attach(path, key);
+        if (!segment)
+        {
+          if (!build(payload))
+          {
+            return nullptr;
+          }
+          built = true;
+          if (publish(path, key, payload))
+          {
+            segment = attach(path, key);
+          }
+        }
+      }
+      else
+      {
+        std::cout << "PHSharedStore::get - could not lock " << path << ".lock, " << name << " is not shared" << std::endl;
+      }
+    }
+    if (segment && Verbosity() > 0)
+    {
+      std::cout << "PHSharedStore::get - " << (built ? "published " : "attached ") << path << std::endl;
+    }
+  }
+
+  if (!segment)
+  {
+    // no store or the store is not usable, keep the object in the memory of this process
+    if (!built && !build(payload))
+    {
+      return nullptr;
+    }
+    segment.reset(new Segment);
+    segment->m_buffer = std::move(payload);
+    segment->m_data = segment->m_buffer.data();
+    segment->m_size = segment->m_buffer.size();
+  }
+
+  return segment;
+}
+
+std::shared_ptr<PHSharedStore::Segment> PHSharedStore::attach(const std::string &path, uint64_t key) const
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+  struct stat st
+  {
+  };
+  void *data = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(StoreFileHeader))
+  {
+    data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  // the mapping stays valid after the file is closed
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  StoreFileHeader header{};
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, m_magic, sizeof(m_magic)) != 0 ||
+      header.version != m_version ||
+      header.key != key ||
+      header.size != st.st_size - sizeof(header))
+  {
+    std::cout << "PHSharedStore::attach - " << path << " is invalid, ignored" << std::endl;
+    munmap(data, st.st_size);
+    return nullptr;
+  }
+
+  std::shared_ptr<Segment> segment(new Segment);
+  segment->m_data = static_cast<const char *>(data) + sizeof(header);
+  segment->m_size = header.size;
+  segment->m_mapSize = st.st_size;
+  segment->m_mapped = true;
+  return segment;
+}
+
+bool PHSharedStore::publish(const std::string &path, uint64_t key, const std::vector<char> &payload) const
+{
+  StoreFileHeader header{};
+  std::memcpy(header.magic, m_magic, sizeof(m_magic));
+  header.version = m_version;
+  header.key = key;
+  header.size = payload.size();
+
+  // unique temporary name, the rename is atomic within the directory
+  const std::string tmpPath = path + ".tmp." + std::to_string(getpid());
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.write(reinterpret_cast<const char *>(&header), sizeof(header)) ||
+        !out.write(payload.data(), payload.size()))
+    {
+      std::cout << "PHSharedStore::publish - could not write " << tmpPath << std::endl;
+      out.close();
+      std::remove(tmpPath.c_str());
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(tmpPath, path, error);
+  if (error)
+  {
+    std::cout << "PHSharedStore::publish - could not rename " << tmpPath << " to " << path << ": " << error.message() << std::endl;
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+uint64_t PHSharedStore::hash(const void *data, std::size_t size, uint64_t seed)
+{
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  uint64_t value = seed;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    value ^= bytes[i];
+    value *= 1099511628211ULL;
+  }
+  return value;
+}
+
+uint64_t PHSharedStore::hashString(const std::string &value, uint64_t seed)
+{
+  return hash(value.data(), value.size(), seed);
+}
+
+uint64_t PHSharedStore::hashUrl(const std::string &url, uint64_t seed)
+{
+  uint64_t value = hashString(url, seed);
+  struct stat st
+  {
+  };
+  if (stat(url.c_str(), &st) == 0)
+  {
+    value = hashValue(static_cast<int64_t>(st.st_size), value);
+    value = hashValue(static_cast<int64_t>(st.st_mtime), value);
+  }
+  return value;
+}
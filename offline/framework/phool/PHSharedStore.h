@@ -0,0 +1,136 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef PHOOL_PHSHAREDSTORE_H
+#define PHOOL_PHSHAREDSTORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Node wide store of immutable, flat laid out data (field maps, calibration payloads).
+ *
+ *  Every object is identified by a name and a 64 bit key (a hash of everything its
+ *  content depends on, e.g. the payload url and file). The first process on a node
+ *  which asks for an object builds it and publishes it as a file in the store
+ *  directory, all other processes map this file read only. With the store on a tmpfs
+ *  (/dev/shm) the pages are shared by all jobs on the node instead of every job
+ *  holding its own copy.
+ *
+ *  The store is off unless a directory is given, either with Directory(), the
+ *  recoConsts string flag SHARED_STORE or the environment variable SPHENIX_SHARED_STORE.
+ *  When it is off (or the directory is not writable) the object is built in the
+ *  memory of the process as before.
+ *
+ *  Builds are serialized with a lock file per object, so concurrently starting jobs
+ *  build an object only once. Files are written to a temporary name and renamed.
+ *  Objects are never removed by the store, a changed input just produces a new key.
+ *
+ *  Within a process the same holds for threads: a thread asking for an object which
+ *  is being built waits for that build, requests for other objects are not blocked.
+ *  A Builder may get other objects from the store, but not the one it is building.
+ */
+class PHSharedStore
+{
+ public:
+  //! read only block of data, mapped from the store or held in memory
+  class Segment
+  {
+   public:
+    ~Segment();
+
+    Segment(const Segment &) = delete;
+    Segment &operator=(const Segment &) = delete;
+
+    const char *data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+    //! true if the data is mapped from the store
+    bool isShared() const { return m_mapped; }
+
+   private:
+    friend class PHSharedStore;
+    Segment() = default;
+
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_mapSize = 0;
+    bool m_mapped = false;
+    std::vector<char> m_buffer;
+  };
+
+  //! fills the payload of an object, returns false on failure
+  using Builder = std::function<bool(std::vector<char> &)>;
+
+  static PHSharedStore *instance();
+
+  PHSharedStore(const PHSharedStore &) = delete;
+  PHSharedStore &operator=(const PHSharedStore &) = delete;
+
+  //! directory of the store, empty to switch it off
+  void Directory(const std::string &dir);
+  std::string Directory();
+
+  //! object name/key from the store, built with build if it is not published yet
+  /*! returns nullptr if the object had to be built and the build failed.
+   *  build runs without the store lock held, asking for the same object from within build is fatal */
+  std::shared_ptr<const Segment> get(const std::string &name, uint64_t key, const Builder &build);
+
+  //! 64 bit FNV-1a hash of a buffer, chained through seed
+  static uint64_t hash(const void *data, std::size_t size, uint64_t seed = m_hashSeed);
+
+  //! hash of a value, chained through seed
+  template <class T>
+  static uint64_t hashValue(const T &value, uint64_t seed = m_hashSeed)
+  {
+    return hash(&value, sizeof(T), seed);
+  }
+
+  //! hash of a string, chained through seed
+  static uint64_t hashString(const std::string &value, uint64_t seed = m_hashSeed);
+
+  //! hash of a payload url. For local files size and modification time are included,
+  //! so that a file which is replaced in place gets a new key
+  static uint64_t hashUrl(const std::string &url, uint64_t seed = m_hashSeed);
+
+  void Verbosity(const int i) { m_Verbosity = i; }
+  int Verbosity() const { return m_Verbosity; }
+
+ private:
+  PHSharedStore() = default;
+
+  //! attaches to or builds (and publishes) the object, called with the object entry locked
+  std::shared_ptr<const Segment> build_segment(const std::string &name, const std::string &id, uint64_t key, const std::string &directory, const Builder &build);
+  std::shared_ptr<Segment> attach(const std::string &path, uint64_t key) const;
+  bool publish(const std::string &path, uint64_t key, const std::vector<char> &payload) const;
+
+  static constexpr uint64_t m_hashSeed = 14695981039346656037ULL;
+
+  //! file header, the payload starts after it at a 64 byte boundary
+  static constexpr char m_magic[8] = {'S', 'P', 'H', 'S', 'T', 'O', 'R', 0};
+  static constexpr uint32_t m_version = 1;
+
+  bool m_DirectorySet = false;
+  std::string m_Directory;
+  int m_Verbosity = 0;
+
+  //! one object in use by this process, its mutex is held while it is built
+  struct Entry
+  {
+    std::mutex m_Mutex;
+    std::atomic<std::thread::id> m_Builder{};
+    std::weak_ptr<const Segment> m_Segment;
+  };
+
+  //! protects m_Directory and m_Segments, never held while an object is built
+  std::mutex m_Mutex;
+  std::map<std::string, std::shared_ptr<Entry>> m_Segments;
+};
+
+#endif
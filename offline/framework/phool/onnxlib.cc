@@ -1,15 +1,25 @@
 #include "onnxlib.h"
 
+#include <algorithm>
 #include <iostream>
 
+namespace
+{
+  //! one environment for all sessions, it has to live as long as they do
+  Ort::Env &onnxEnv()
+  {
+    static Ort::Env env(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "fit");
+    return env;
+  }
+}  // namespace
+
 // --------------------------------------------------
 Ort::Session *onnxSession(std::string &modelfile)
 {
-  Ort::Env env(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "fit");
   Ort::SessionOptions sessionOptions;
   sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
 
-  return new Ort::Session(env, modelfile.c_str(), sessionOptions);
+  return new Ort::Session(onnxEnv(), modelfile.c_str(), sessionOptions);
 }
 
 std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &input, int N, int Nsamp, int Nreturn)
@@ -34,6 +44,8 @@ std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &inpu
   std::vector<const char *> outputNames{session->GetOutputName(0, allocator)};
 
   session->Run(Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(), 1, outputNames.data(), outputTensors.data(), 1);
+  allocator.Free(const_cast<char *>(inputNames[0]));
+  allocator.Free(const_cast<char *>(outputNames[0]));
 
   return outputTensorValuesN;
 }
@@ -61,5 +73,92 @@ std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &inpu
   std::vector<const char *> inputNames{session->GetInputName(0, allocator)};
   std::vector<const char *> outputNames{session->GetOutputName(0, allocator)};
   session->Run(Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(), 1, outputNames.data(), outputTensors.data(), 1);
+  allocator.Free(const_cast<char *>(inputNames[0]));
+  allocator.Free(const_cast<char *>(outputNames[0]));
   return outputTensorValues;
 }
+
+// --------------------------------------------------
+OnnxBatchSession::OnnxBatchSession(const std::string &modelfile, const std::vector<int64_t> &itemInputShape, const std::vector<int64_t> &itemOutputShape, int nthreads)
+  : m_memoryInfo(Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault))
+{
+  Ort::SessionOptions sessionOptions;
+  sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+  // the onnxruntime default is one thread per core, which oversubscribes nodes running one job per core
+  sessionOptions.SetIntraOpNumThreads(std::max(nthreads, 1));
+  sessionOptions.SetInterOpNumThreads(1);
+  sessionOptions.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+  m_session = Ort::Session(onnxEnv(), modelfile.c_str(), sessionOptions);
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  char *name = m_session.GetInputName(0, allocator);
+  m_inputName = name;
+  allocator.Free(name);
+  name = m_session.GetOutputName(0, allocator);
+  m_outputName = name;
+  allocator.Free(name);
+
+  // first dimension is the batch size, set for every batch
+  m_inputShape.push_back(0);
+  for (auto dim : itemInputShape)
+  {
+    m_inputShape.push_back(dim);
+    m_inputSize *= dim;
+  }
+  m_outputShape.push_back(0);
+  for (auto dim : itemOutputShape)
+  {
+    m_outputShape.push_back(dim);
+    m_outputSize *= dim;
+  }
+
+  const auto modelShape = m_session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+  if (!modelShape.empty() && modelShape[0] > 0)
+  {
+    m_maxBatch = modelShape[0];
+  }
+}
+
+const std::vector<float> &OnnxBatchSession::run()
+{
+  const std::size_t nitems = m_input.size() / m_inputSize;
+  if (nitems * m_inputSize != m_input.size())
+  {
+    std::cout << "OnnxBatchSession::run - input size " << m_input.size()
+              << " is not a multiple of the item size " << m_inputSize << std::endl;
+    m_output.clear();
+    return m_output;
+  }
+
+  // a model with a fixed batch size gets full chunks, the last one padded
+  const std::size_t batch = m_maxBatch ? m_maxBatch : nitems;
+  const std::size_t nrun = m_maxBatch ? (nitems + m_maxBatch - 1) / m_maxBatch * m_maxBatch : nitems;
+  m_input.resize(nrun * m_inputSize, 0);
+  m_output.resize(nrun * m_outputSize);
+  for (std::size_t first = 0; first < nrun; first += batch)
+  {
+    runChunk(first, batch);
+  }
+  m_output.resize(nitems * m_outputSize);
+  return m_output;
+}
+
+void OnnxBatchSession::runChunk(std::size_t first, std::size_t nitems)
+{
+  float *input = m_input.data() + first * m_inputSize;
+  float *output = m_output.data() + first * m_outputSize;
+  if (nitems != m_tensorBatch || input != m_tensorInputData || output != m_tensorOutputData)
+  {
+    m_inputShape[0] = nitems;
+    m_outputShape[0] = nitems;
+    m_inputTensor = Ort::Value::CreateTensor<float>(m_memoryInfo, input, nitems * m_inputSize, m_inputShape.data(), m_inputShape.size());
+    m_outputTensor = Ort::Value::CreateTensor<float>(m_memoryInfo, output, nitems * m_outputSize, m_outputShape.data(), m_outputShape.size());
+    m_tensorBatch = nitems;
+    m_tensorInputData = input;
+    m_tensorOutputData = output;
+  }
+
+  const char *inputNames[] = {m_inputName.c_str()};
+  const char *outputNames[] = {m_outputName.c_str()};
+  m_session.Run(Ort::RunOptions{nullptr}, inputNames, &m_inputTensor, 1, outputNames, &m_outputTensor, 1);
+}
@@ -7,6 +7,11 @@
 #include <onnxruntime_cxx_api.h>
 #pragma GCC diagnostic pop
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 // This is a stub for some ONNX code refactoring
 
 Ort::Session *onnxSession(std::string &modelfile);
@@ -15,4 +20,62 @@ std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &inpu
 
 std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &input, int N, int Nx, int Ny, int Nz, int Nreturn);
 
+/** ONNX model evaluated on whole batches (all channels or clusters of an event) in one Run.
+ *
+ *  The caller fills the items of a batch one after the other into input()
+ *  (inputSize() floats per item) and calls run(), which returns outputSize()
+ *  floats per item. Session options and threads are configured once, input and
+ *  output buffers and their tensors are kept and reused from batch to batch.
+ *  The first dimension of the model input is the batch dimension. If the model
+ *  has a fixed batch size, larger batches are run in chunks of that size.
+ *
+ *  A session is not thread safe, use one per thread.
+ */
+class OnnxBatchSession
+{
+ public:
+  //! itemInputShape/itemOutputShape: dimensions of one item without the batch dimension
+  OnnxBatchSession(const std::string &modelfile, const std::vector<int64_t> &itemInputShape, const std::vector<int64_t> &itemOutputShape, int nthreads = 1);
+
+  OnnxBatchSession(const OnnxBatchSession &) = delete;
+  OnnxBatchSession &operator=(const OnnxBatchSession &) = delete;
+
+  //! number of floats per item in input and output
+  std::size_t inputSize() const { return m_inputSize; }
+  std::size_t outputSize() const { return m_outputSize; }
+
+  //! input of the next batch, to be filled by the caller
+  std::vector<float> &input() { return m_input; }
+
+  //! evaluate the model on all items in input(), the output stays valid until the next call
+  const std::vector<float> &run();
+
+ private:
+  void runChunk(std::size_t first, std::size_t nitems);
+
+  Ort::Session m_session{nullptr};
+  Ort::MemoryInfo m_memoryInfo{nullptr};
+
+  std::string m_inputName;
+  std::string m_outputName;
+
+  std::vector<int64_t> m_inputShape;
+  std::vector<int64_t> m_outputShape;
+  std::size_t m_inputSize = 1;
+  std::size_t m_outputSize = 1;
+
+  //! fixed batch size of the model, 0 for a dynamic batch dimension
+  std::size_t m_maxBatch = 0;
+
+  std::vector<float> m_input;
+  std::vector<float> m_output;
+
+  //! tensors on the buffers, recreated only if the batch or the buffers change
+  Ort::Value m_inputTensor{nullptr};
+  Ort::Value m_outputTensor{nullptr};
+  const float *m_tensorInputData = nullptr;
+  const float *m_tensorOutputData = nullptr;
+  std::size_t m_tensorBatch = 0;
+};
+
 #endif
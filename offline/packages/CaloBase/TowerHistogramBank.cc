@@ -0,0 +1,96 @@
+#include "TowerHistogramBank.h"
+
+#include <TH1.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+unsigned int TowerHistogramBank::book(unsigned int nchannels, int nbins, double xmin, double xmax)
+{
+  const unsigned int first = m_channels.size();
+  m_channels.reserve(first + nchannels);
+  for (unsigned int i = 0; i < nchannels; ++i)
+  {
+    Channel ch;
+    ch.offset = m_content.size() + i * static_cast<std::size_t>(nbins + 2);
+    ch.nbins = nbins;
+    ch.xmin = xmin;
+    ch.xmax = xmax;
+    m_channels.push_back(ch);
+  }
+  m_stats.resize(m_channels.size());
+  m_content.resize(m_content.size() + nchannels * static_cast<std::size_t>(nbins + 2), 0);
+  return first;
+}
+
+void TowerHistogramBank::fill(std::size_t n, const unsigned int* channels, const float* values)
+{
+  // find all bins first, then update the contents and statistics
+  m_bins.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    m_bins[i] = m_channels[channels[i]].findBin(values[i]);
+  }
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const Channel& ch = m_channels[channels[i]];
+    const int bin = m_bins[i];
+    m_content[ch.offset + bin] += 1;
+    Stats& stats = m_stats[channels[i]];
+    ++stats.entries;
+    if (bin > 0 && bin <= ch.nbins)
+    {
+      const double x = values[i];
+      stats.sumw += 1;
+      stats.sumwx += x;
+      stats.sumwx2 += x * x;
+    }
+  }
+}
+
+bool TowerHistogramBank::add(const TowerHistogramBank& other)
+{
+  bool same = m_channels.size() == other.m_channels.size() && m_content.size() == other.m_content.size();
+  for (std::size_t i = 0; same && i < m_channels.size(); ++i)
+  {
+    const Channel& ch = m_channels[i];
+    const Channel& och = other.m_channels[i];
+    same = ch.offset == och.offset && ch.nbins == och.nbins && ch.xmin == och.xmin && ch.xmax == och.xmax;
+  }
+  if (!same)
+  {
+    std::cout << "TowerHistogramBank::add - banks have different bookings, not added" << std::endl;
+    return false;
+  }
+
+  std::transform(m_content.begin(), m_content.end(), other.m_content.begin(), m_content.begin(), std::plus<>());
+  for (std::size_t i = 0; i < m_stats.size(); ++i)
+  {
+    m_stats[i].entries += other.m_stats[i].entries;
+    m_stats[i].sumw += other.m_stats[i].sumw;
+    m_stats[i].sumwx += other.m_stats[i].sumwx;
+    m_stats[i].sumwx2 += other.m_stats[i].sumwx2;
+  }
+  return true;
+}
+
+void TowerHistogramBank::reset()
+{
+  std::fill(m_content.begin(), m_content.end(), 0);
+  std::fill(m_stats.begin(), m_stats.end(), Stats());
+}
+
+TH1* TowerHistogramBank::toTH1(unsigned int channel, const std::string& name, const std::string& title) const
+{
+  const Channel& ch = m_channels[channel];
+  TH1F* h = new TH1F(name.c_str(), title.c_str(), ch.nbins, ch.xmin, ch.xmax);
+  std::copy_n(m_content.begin() + ch.offset, ch.nbins + 2, h->GetArray());
+
+  const Stats& stats = m_stats[channel];
+  double rootstats[4] = {stats.sumw, stats.sumw, stats.sumwx, stats.sumwx2};
+  h->PutStats(rootstats);
+  h->SetEntries(stats.entries);
+  return h;
+}
@@ -0,0 +1,113 @@
+#ifndef CALOBASE_TOWERHISTOGRAMBANK_H
+#define CALOBASE_TOWERHISTOGRAMBANK_H
+
+/*!
+ * \file TowerHistogramBank.h
+ * \brief one dimensional histograms for many channels (towers) in one contiguous array
+ *
+ * Meant for tower by tower calibrations which would otherwise book one TH1F per tower.
+ * Channels are booked in groups sharing the same fixed binning, each channel owns a
+ * slice of nbins + 2 floats (underflow, bins, overflow), laid out as the TH1F array.
+ * Fills have unit weight. Bin contents, entries and statistics are identical to what
+ * the same sequence of TH1F::Fill calls gives, so that histograms converted with toTH1
+ * at the end of the job can replace the ones previously filled directly.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TH1;
+
+class TowerHistogramBank
+{
+ public:
+  TowerHistogramBank() = default;
+
+  //! book nchannels histograms with nbins between xmin and xmax. Returns the index of the first one
+  unsigned int book(unsigned int nchannels, int nbins, double xmin, double xmax);
+
+  //! number of booked channels
+  unsigned int nchannels() const { return m_channels.size(); }
+
+  //! fill one value
+  void fill(unsigned int channel, double x)
+  {
+    const Channel& ch = m_channels[channel];
+    const int bin = ch.findBin(x);
+    m_content[ch.offset + bin] += 1;
+    Stats& stats = m_stats[channel];
+    ++stats.entries;
+    if (bin > 0 && bin <= ch.nbins)
+    {
+      stats.sumw += 1;
+      stats.sumwx += x;
+      stats.sumwx2 += x * x;
+    }
+  }
+
+  //! fill n values, e.g. all towers of an event
+  void fill(std::size_t n, const unsigned int* channels, const float* values);
+
+  //! add the content of another bank with the same booking. Returns false if the booking differs
+  bool add(const TowerHistogramBank& other);
+
+  //! reset all contents, keeping the booking
+  void reset();
+
+  //! number of fills of a channel, including under and overflows
+  double getEntries(unsigned int channel) const { return m_stats[channel].entries; }
+
+  //! content of a bin, with the TH1 convention (0 is underflow, nbins + 1 overflow)
+  double getBinContent(unsigned int channel, int bin) const { return m_content[m_channels[channel].offset + bin]; }
+
+  //! new TH1F with the content of a channel, created in the current ROOT directory
+  TH1* toTH1(unsigned int channel, const std::string& name, const std::string& title = "") const;
+
+  //! total number of bins, including under and overflows
+  std::size_t size() const { return m_content.size(); }
+
+ private:
+  struct Channel
+  {
+    std::size_t offset = 0;
+    int nbins = 0;
+    double xmin = 0;
+    double xmax = 0;
+
+    //! same as TAxis::FindFixBin
+    int findBin(double x) const
+    {
+      if (x < xmin)
+      {
+        return 0;
+      }
+      if (!(x < xmax))
+      {
+        return nbins + 1;
+      }
+      return 1 + int(nbins * (x - xmin) / (xmax - xmin));
+    }
+  };
+
+  //! statistics as kept by TH1 (sum of weights squared equals sum of weights for unit weights)
+  struct Stats
+  {
+    double entries = 0;
+    double sumw = 0;
+    double sumwx = 0;
+    double sumwx2 = 0;
+  };
+
+  std::vector<Channel> m_channels;
+  std::vector<Stats> m_stats;
+
+  //! bin contents of all channels
+  std::vector<float> m_content;
+
+  //! bins of the values in a batched fill
+  std::vector<int> m_bins;
+};
+
+#endif
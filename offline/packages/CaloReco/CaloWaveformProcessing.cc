@@ -12,11 +12,10 @@
 #include <memory>                     // for allocator_traits<>::value_type
 #include <string>
 
-Ort::Session *onnxmodule;
-
 CaloWaveformProcessing::~CaloWaveformProcessing()
 {
   delete m_Fitter;
+  delete m_Onnx;
 }
 
 void CaloWaveformProcessing::initialize_processing()
@@ -48,7 +47,8 @@ void CaloWaveformProcessing::initialize_processing()
   {
     std::string calibrations_repo_model = std::string(calibrationsroot) + "/WaveformProcessing/models/" + m_model_name;
     url_onnx = CDBInterface::instance()->getUrl(m_model_name, calibrations_repo_model);
-    onnxmodule = onnxSession(url_onnx);
+    delete m_Onnx;
+    m_Onnx = new OnnxBatchSession(url_onnx, {m_onnx_nsamples}, {m_onnx_nreturn}, get_nthreads());
   }
   else if (m_processingtype == CaloWaveformProcessing::NYQUIST)
   {
@@ -90,17 +90,29 @@ std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(std
 {
   std::vector<std::vector<float>> fit_values;
   int nchnls = chnlvector.size();
+  if (nchnls == 0)
+  {
+    return fit_values;
+  }
+
+  // all channels of the event go to the model as one batch
+  std::vector<float> &input = m_Onnx->input();
+  input.assign(nchnls * m_onnx_nsamples, 0);
   for (int m = 0; m < nchnls; m++)
   {
-    std::vector<float> v = chnlvector.at(m);
-    int nsamples = v.size() - 1;
-    std::vector<float> vtmp;
-    vtmp.reserve(nsamples);
+    const std::vector<float> &v = chnlvector.at(m);
+    int nsamples = std::min<int>(v.size() - 1, m_onnx_nsamples);
     for (int k = 0; k < nsamples; k++)
     {
-      vtmp.push_back(v.at(k) / 1000.0);
+      input[m * m_onnx_nsamples + k] = v.at(k) / 1000.0;
     }
-    std::vector<float> val = onnxInference(onnxmodule, vtmp, 1, 31, 3);
+  }
+
+  const std::vector<float> &output = m_Onnx->run();
+  fit_values.reserve(nchnls);
+  for (int m = 0; m < nchnls; m++)
+  {
+    std::vector<float> val(output.begin() + m * m_onnx_nreturn, output.begin() + (m + 1) * m_onnx_nreturn);
     int nvals = val.size();
     for (int i = 0; i < nvals; i++)
     {
@@ -110,7 +122,6 @@ std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(std
       }
     }
     fit_values.push_back(val);
-    val.clear();
   }
   return fit_values;
 }
@@ -7,6 +7,7 @@
 #include <vector>
 
 class CaloWaveformFitting;
+class OnnxBatchSession;
 
 class CaloWaveformProcessing : public SubsysReco
 {
@@ -79,6 +80,7 @@ class CaloWaveformProcessing : public SubsysReco
 
  private:
   CaloWaveformFitting *m_Fitter = nullptr;
+  OnnxBatchSession *m_Onnx = nullptr;
 
   CaloWaveformProcessing::process m_processingtype = CaloWaveformProcessing::TEMPLATE;
   int _nthreads = 1;
@@ -96,5 +98,8 @@ class CaloWaveformProcessing : public SubsysReco
 
   std::string url_onnx;
   std::string m_model_name = "CEMC_ONNX";
+  // samples per channel in, fit values (amplitude, time, pedestal) out
+  int m_onnx_nsamples = 31;
+  int m_onnx_nreturn = 3;
 };
 #endif
@@ -38,8 +38,8 @@ RawClusterCNNClassifier::~RawClusterCNNClassifier() = default;
 
 int RawClusterCNNClassifier::Init(PHCompositeNode *topNode)
 {
-  // init the onnx model
-  onnxmodule = onnxSession(m_modelPath);
+  // init the onnx model, all clusters of an event are classified in one batch
+  onnxmodule = new OnnxBatchSession(m_modelPath, {inputDimx, inputDimy, inputDimz}, {outputDim});
 
   if (m_inputNodeName == m_outputNodeName)
   {
@@ -93,6 +93,11 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::ABORTEVENT;
   }
 
+  // inputs of all clusters to classify, one after the other
+  std::vector<float> &input = onnxmodule->input();
+  input.clear();
+  std::vector<RawCluster *> batchClusters;
+
   RawClusterContainer::Map clusterMap = _clusters->getClustersMap();
   for (auto &clusterPair : clusterMap)
   {
@@ -148,19 +153,19 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
       }
     }
     // find the N by N tower around the max tower
-    std::vector<float> input;
-    // resize to inputDimx * inputDimy
+    int xlength = int((inputDimx - 1) / 2);
+    int ylength = int((inputDimy - 1) / 2);
+    if (maxtowerE > 0 && (maxtowerieta - ylength < 0 || maxtowerieta + ylength >= 96))
+    {
+      continue;
+    }
+    // append inputDimx * inputDimy entries to the batch
     int vectorSize = inputDimx * inputDimy;
-    input.resize(vectorSize, 0);
+    const std::size_t offset = input.size();
+    input.resize(offset + vectorSize, 0);
 
     if (maxtowerE > 0)
     {
-      int xlength = int((inputDimx - 1) / 2);
-      int ylength = int((inputDimy - 1) / 2);
-      if (maxtowerieta - ylength < 0 || maxtowerieta + ylength >= 96)
-      {
-        continue;
-      }
       for (int ieta = maxtowerieta - ylength; ieta <= maxtowerieta + ylength; ieta++)
       {
         for (int iphi = maxtoweriphi - xlength; iphi <= maxtoweriphi + xlength; iphi++)
@@ -185,14 +190,21 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
             continue;
           }
           int index = (ieta - maxtowerieta + ylength) * inputDimx + iphi - maxtoweriphi + xlength;
-          input.at(index) = towerinfo->get_energy();
+          input.at(offset + index) = towerinfo->get_energy();
         }
       }
     }
-    std::vector<float> prob = onnxInference(onnxmodule, input, 1, inputDimx, inputDimy, inputDimz, outputDim);
-    // std::cout << "new prob: " << prob[0] << "ET: " << ET << " original prob: " << recoCluster->get_prob() << std::endl;
-    // inplace change for the prob for now
-    recoCluster->set_prob(prob[0]);
+    batchClusters.push_back(recoCluster);
+  }
+
+  if (!batchClusters.empty())
+  {
+    const std::vector<float> &prob = onnxmodule->run();
+    for (std::size_t i = 0; i < batchClusters.size(); ++i)
+    {
+      // inplace change for the prob for now
+      batchClusters[i]->set_prob(prob[i * outputDim]);
+    }
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
@@ -201,6 +213,7 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
 int RawClusterCNNClassifier::End(PHCompositeNode * /*topNode*/)
 {
   delete onnxmodule;
+  onnxmodule = nullptr;
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
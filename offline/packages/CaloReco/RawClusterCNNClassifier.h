@@ -34,7 +34,7 @@ class RawClusterCNNClassifier : public SubsysReco
   void set_min_cluster_e(const float min_cluster_e) { m_min_cluster_e = min_cluster_e; }
 
  private:
-  Ort::Session *onnxmodule{nullptr};
+  OnnxBatchSession *onnxmodule{nullptr};
   const int inputDimx{5};
   const int inputDimy{5};
   const int inputDimz{1};
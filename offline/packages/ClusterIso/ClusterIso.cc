@@ -27,9 +27,182 @@
 
 #include <CLHEP/Vector/ThreeVector.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <map>
 #include <utility>
+#include <vector>
+
+/** \Brief Towers of one calorimeter, arranged for fast cone sums
+ *
+ * Towers are grouped by eta bin, and sorted in phi inside each eta bin, with a running sum
+ * of their transverse energy. For a given cone, the towers of an eta bin that are closer in phi
+ * than the cone half width at the largest eta distance of the bin are all inside the cone,
+ * and their energy is the difference of two running sums. Only the remaining towers up to the
+ * half width at the smallest eta distance are tested individually with deltaR, so that the result
+ * is the same as testing all towers.
+ */
+class ClusterIso::ConeSumGrid
+{
+ public:
+  void add(int ieta, float eta, float phi, float et)
+  {
+    if (ieta < 0)
+    {
+      return;
+    }
+    if (static_cast<std::size_t>(ieta) >= m_rows.size())
+    {
+      m_rows.resize(ieta + 1);
+    }
+    m_rows[ieta].towers.push_back({phi, eta, et});
+  }
+
+  //! sort towers and compute running sums. Must be called once all towers are added
+  void build()
+  {
+    for (auto &row : m_rows)
+    {
+      std::sort(row.towers.begin(), row.towers.end(), [](const Tower &lhs, const Tower &rhs)
+                { return lhs.phi < rhs.phi; });
+      row.phi.resize(row.towers.size());
+      row.sum.assign(row.towers.size() + 1, 0);
+      row.eta_min = row.eta_max = row.towers.empty() ? 0 : row.towers.front().eta;
+      for (std::size_t i = 0; i < row.towers.size(); ++i)
+      {
+        const auto &tower = row.towers[i];
+        row.phi[i] = tower.phi;
+        row.sum[i + 1] = row.sum[i] + tower.et;
+        row.eta_min = std::min(row.eta_min, tower.eta);
+        row.eta_max = std::max(row.eta_max, tower.eta);
+      }
+    }
+  }
+
+  //! transverse energy of the towers with deltaR < coneSize
+  double sum(float eta, float phi, float coneSize) const
+  {
+    double total = 0;
+    for (const auto &row : m_rows)
+    {
+      if (row.towers.empty())
+      {
+        continue;
+      }
+
+      // eta distance range of the towers of this row
+      const float deta_min = (eta < row.eta_min) ? row.eta_min - eta : ((eta > row.eta_max) ? eta - row.eta_max : 0);
+      if (deta_min >= coneSize)
+      {
+        continue;
+      }
+      const float deta_max = std::max(std::abs(eta - row.eta_min), std::abs(eta - row.eta_max));
+
+      // towers closer than inner in phi are inside the cone, towers further than outer are outside.
+      // Both are moved away from the cone edge by m_margin, so that towers at the edge are always tested with deltaR
+      const float inner = (deta_max < coneSize) ? std::sqrt(coneSize * coneSize - deta_max * deta_max) - m_margin : 0;
+      const float outer = std::sqrt(coneSize * coneSize - deta_min * deta_min) + m_margin;
+
+      const auto [outer_first, outer_count] = window(row, phi, outer);
+      const auto [inner_first, inner_count] = window(row, phi, inner);
+
+      // position of the inner window in the outer one
+      const std::size_t n = row.towers.size();
+      std::size_t offset = (inner_first + n - outer_first) % n;
+      std::size_t inner_size = inner_count;
+      if (inner_count == 0 || offset + inner_count > outer_count)
+      {
+        // no inner window, or rounding at the phi boundaries: test all towers
+        offset = 0;
+        inner_size = 0;
+      }
+
+      total += windowSum(row, (outer_first + offset) % n, inner_size);
+      for (std::size_t k = 0; k < outer_count; ++k)
+      {
+        if (k == offset && inner_size > 0)
+        {
+          k += inner_size - 1;
+          continue;
+        }
+        const auto &tower = row.towers[(outer_first + k) % n];
+        if (deltaR(eta, tower.eta, phi, tower.phi) < coneSize)
+        {
+          total += tower.et;
+        }
+      }
+    }
+    return total;
+  }
+
+ private:
+  struct Tower
+  {
+    float phi;
+    float eta;
+    float et;
+  };
+
+  struct Row
+  {
+    std::vector<Tower> towers;  ///< sorted in phi
+    std::vector<float> phi;     ///< tower phi, for binary search
+    std::vector<double> sum;    ///< sum[i] is the transverse energy of the first i towers
+    float eta_min = 0;
+    float eta_max = 0;
+  };
+
+  //! first tower and number of towers with wrapped phi distance below width. The window can wrap around the row
+  static std::pair<std::size_t, std::size_t> window(const Row &row, float phi, float width)
+  {
+    const std::size_t n = row.phi.size();
+    if (width <= 0)
+    {
+      return {0, 0};
+    }
+    if (width >= M_PI)
+    {
+      return {0, n};
+    }
+
+    float lo = phi - width;
+    float hi = phi + width;
+    if (lo < -M_PI)
+    {
+      lo += 2 * M_PI;
+    }
+    if (hi > M_PI)
+    {
+      hi -= 2 * M_PI;
+    }
+
+    const std::size_t first = std::upper_bound(row.phi.begin(), row.phi.end(), lo) - row.phi.begin();
+    const std::size_t last = std::lower_bound(row.phi.begin(), row.phi.end(), hi) - row.phi.begin();
+    if (lo < hi)
+    {
+      return {first, (last > first) ? last - first : 0};
+    }
+    return {first % std::max<std::size_t>(n, 1), n - first + last};
+  }
+
+  //! sum of count towers starting at first, wrapping around the row
+  static double windowSum(const Row &row, std::size_t first, std::size_t count)
+  {
+    const std::size_t n = row.towers.size();
+    if (first + count <= n)
+    {
+      return row.sum[first + count] - row.sum[first];
+    }
+    return row.sum[n] - row.sum[first] + row.sum[first + count - n];
+  }
+
+  //! phi margin around the cone edge, larger than the rounding errors of deltaR
+  static constexpr float m_margin = 1e-4;
+
+  std::vector<Row> m_rows;
+};
 
 /** \Brief Function to get correct tower eta
  *
@@ -76,7 +249,7 @@ ClusterIso::ClusterIso(const std::string &kname, float eTCut = 0.0, int coneSize
   seteTCut(eTCut);
   if (Verbosity() >= VERBOSITY_EVEN_MORE)
   {
-    std::cout << Name() << "::ClusterIso::m_coneSize is:" << m_coneSize << '\n';
+    std::cout << Name() << "::ClusterIso::m_coneSize is:" << getConeSize() / 10.0 << '\n';
     std::cout << Name() << "::ClusterIso::m_eTCut is:" << m_eTCut << '\n';
   }
   if (!do_subtracted && !do_unsubtracted && Verbosity() >= VERBOSITY_QUIET)
@@ -100,10 +273,22 @@ void ClusterIso::seteTCut(float eTCut)
 
 /**
  * Set the size of isolation cone as integer multiple of 0.1, (i.e. 3 will use an R=0.3 cone)
+ * This replaces all previously set cone sizes
  */
 void ClusterIso::setConeSize(int coneSize)
 {
-  this->m_coneSize = coneSize / 10.0;
+  m_coneSizes = {coneSize};
+}
+
+/**
+ * Add a size of isolation cone as integer multiple of 0.1, (i.e. 3 will use an R=0.3 cone)
+ */
+void ClusterIso::addConeSize(int coneSize)
+{
+  if (std::find(m_coneSizes.begin(), m_coneSizes.end(), coneSize) == m_coneSizes.end())
+  {
+    m_coneSizes.push_back(coneSize);
+  }
 }
 
 /**
@@ -119,7 +304,7 @@ void ClusterIso::setConeSize(int coneSize)
  */
 /*const*/ int ClusterIso::getConeSize()
 {
-  return (int) m_coneSize * 10;
+  return m_coneSizes.empty() ? 0 : m_coneSizes.front();
 }
 
 /**
@@ -132,8 +317,8 @@ void ClusterIso::setConeSize(int coneSize)
 
 /** \Brief Calculates isolation energy for all electromagnetic calorimeter clusters over the specified eT cut.
  *
- * For each cluster in the EMCal this iterates through all of the towers in each calorimeter,
- * if the towers are within the isolation cone their energy is added to the sum of isolation energy.
+ * The towers of each calorimeter are first arranged in a ConeSumGrid. For each cluster the transverse
+ * energy in each isolation cone is then taken from the grids, for all cone sizes.
  * Finally subtract the cluster energy from the sum
  */
 int ClusterIso::process_event(PHCompositeNode *topNode)
@@ -142,13 +327,6 @@ int ClusterIso::process_event(PHCompositeNode *topNode)
   {
     std::cout << Name() << "::ClusterIso::process_event" << '\n';
   }
-  /**
-   * If there event is embedded in Au+Au or another larger background we want to
-   * get isolation energy from the towers with a subtracted background. This first section
-   * looks at those towers instead of the original objects which include the background.
-   * NOTE: that during the background event subtraction the EMCal towers are grouped
-   * together so we have to use the inner HCal geometry.
-   */
 
   std::string RawCemcClusterNodeName = "CLUSTER_CEMC";
   if (m_use_towerinfo)
@@ -156,354 +334,184 @@ int ClusterIso::process_event(PHCompositeNode *topNode)
     RawCemcClusterNodeName = m_cluster_node_name;
   }
 
-  if (m_do_subtracted)
+  RawClusterContainer *clusters = findNode::getClass<RawClusterContainer>(topNode, RawCemcClusterNodeName);
+  if (!clusters)
   {
+    if (Verbosity() >= VERBOSITY_SOME)
     {
-      if (Verbosity() >= VERBOSITY_EVEN_MORE)
-      {
-        std::cout << Name() << "::ClusterIso starting subtracted calculation" << '\n';
-      }
-      // get EMCal towers
-      TowerInfoContainer *towersEM3old = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_CEMC_RETOWER_SUB1");
-      if (towersEM3old == nullptr)
-      {
-        m_do_subtracted = false;
-        if (Verbosity() >= VERBOSITY_SOME)
-        {
-          std::cout << "In " << Name() << "::ClusterIso WARNING substracted towers do not exist subtracted isolation cannot be preformed \n";
-        }
-      }
-      if (Verbosity() >= VERBOSITY_MORE)
-      {
-        std::cout << Name() << "::ClusterIso::process_event: " << towersEM3old->size() << " TOWERINFO_CALIB_CEMC_RETOWER_SUB1 towers" << '\n';
-      }
-
-      // get InnerHCal towers
-      TowerInfoContainer *towersIH3 = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_HCALIN_SUB1");
-      if (Verbosity() >= VERBOSITY_MORE)
-      {
-        std::cout << Name() << "::ClusterIso::process_event: " << towersIH3->size() << " TOWERINFO_CALIB_HCALIN_SUB1 towers" << '\n';
-      }
-
-      // get outerHCal towers
-      TowerInfoContainer *towersOH3 = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_HCALOUT_SUB1");
-      if (Verbosity() >= VERBOSITY_MORE)
-      {
-        std::cout << Name() << "::ClusterIso::process_event: " << towersOH3->size() << " TOWERINFO_CALIB_HCALOUT_SUB1 towers" << std::endl;
-      }
+      std::cout << "In " << Name() << "::ClusterIso WARNING " << RawCemcClusterNodeName << " not found, isolation cannot be preformed \n";
+    }
+    return 0;
+  }
+  if (Verbosity() >= VERBOSITY_SOME)
+  {
+    std::cout << Name() << "::ClusterIso sees " << clusters->size() << " clusters " << '\n';
+  }
 
-      // get geometry of calorimeter towers
-      RawTowerGeomContainer *geomEM = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
-      RawTowerGeomContainer *geomIH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
-      RawTowerGeomContainer *geomOH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
+  // vertexmap is used to get correct collision vertex
+  GlobalVertexMap *vertexmap = findNode::getClass<GlobalVertexMap>(topNode, "GlobalVertexMap");
+  m_vx = m_vy = m_vz = 0;
+  if (vertexmap && !vertexmap->empty())
+  {
+    GlobalVertex *vertex = (vertexmap->begin()->second);
+    m_vx = vertex->get_x();
+    m_vy = vertex->get_y();
+    m_vz = vertex->get_z();
+    if (Verbosity() >= VERBOSITY_SOME)
+    {
+      std::cout << Name() << "::ClusterIso Event Vertex Calculated at x:" << m_vx << " y:" << m_vy << " z:" << m_vz << '\n';
+    }
+  }
 
+  /**
+   * If there event is embedded in Au+Au or another larger background we want to
+   * get isolation energy from the towers with a subtracted background. This first section
+   * looks at those towers instead of the original objects which include the background.
+   * NOTE: that during the background event subtraction the EMCal towers are grouped
+   * together so we have to use the inner HCal geometry.
+   */
+  if (m_do_subtracted)
+  {
+    if (Verbosity() >= VERBOSITY_EVEN_MORE)
+    {
+      std::cout << Name() << "::ClusterIso starting subtracted calculation" << '\n';
+    }
+    TowerInfoContainer *towersEM = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_CEMC_RETOWER_SUB1");
+    TowerInfoContainer *towersIH = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_HCALIN_SUB1");
+    TowerInfoContainer *towersOH = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_HCALOUT_SUB1");
+    RawTowerGeomContainer *geomIH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
+    RawTowerGeomContainer *geomOH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
+    if (!towersEM || !towersIH || !towersOH || !geomIH || !geomOH)
+    {
+      m_do_subtracted = false;
+      if (Verbosity() >= VERBOSITY_SOME)
       {
-        RawClusterContainer *clusters = findNode::getClass<RawClusterContainer>(topNode, RawCemcClusterNodeName.c_str());
-        RawClusterContainer::ConstRange begin_end = clusters->getClusters();
-        RawClusterContainer::ConstIterator rtiter;
-        if (Verbosity() >= VERBOSITY_SOME)
-        {
-          std::cout << Name() << "::ClusterIso sees " << clusters->size() << " clusters " << '\n';
-        }
-
-        // vertexmap is used to get correct collision vertex
-        GlobalVertexMap *vertexmap = findNode::getClass<GlobalVertexMap>(topNode, "GlobalVertexMap");
-        m_vx = m_vy = m_vz = 0;
-        if (vertexmap && !vertexmap->empty())
-        {
-          GlobalVertex *vertex = (vertexmap->begin()->second);
-          m_vx = vertex->get_x();
-          m_vy = vertex->get_y();
-          m_vz = vertex->get_z();
-          if (Verbosity() >= VERBOSITY_SOME)
-          {
-            std::cout << Name() << "::ClusterIso Event Vertex Calculated at x:" << m_vx << " y:" << m_vy << " z:" << m_vz << '\n';
-          }
-        }
-
-        for (rtiter = begin_end.first; rtiter != begin_end.second; ++rtiter)
-        {
-          RawCluster *cluster = rtiter->second;
-
-          CLHEP::Hep3Vector vertex(m_vx, m_vy, m_vz);
-          CLHEP::Hep3Vector E_vec_cluster = RawClusterUtility::GetEVec(*cluster, vertex);
-          double cluster_energy = E_vec_cluster.mag();
-          double cluster_eta = E_vec_cluster.pseudoRapidity();
-          double cluster_phi = E_vec_cluster.phi();
-          double et = cluster_energy / cosh(cluster_eta);
-          double isoEt = 0;
-
-          if (et < m_eTCut)
-          {
-            continue;
-          }  // skip if cluster is under eT cut
-
-          // calculate EMCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersEM3old->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersEM3old->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersEM3old->encode_key(channel);
-              int ieta = towersEM3old->getTowerEtaBin(towerkey);
-              int iphi = towersEM3old->getTowerPhiBin(towerkey);
-
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALIN, ieta, iphi);
-
-              RawTowerGeom *tower_geom = geomEM->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = tower_geom->get_eta();
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
-
-          // calculate Inner HCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersIH3->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersIH3->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersIH3->encode_key(channel);
-              int ieta = towersIH3->getTowerEtaBin(towerkey);
-              int iphi = towersIH3->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALIN, ieta, iphi);
-              RawTowerGeom *tower_geom = geomIH->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
-
-          // calculate Outer HCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersOH3->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersOH3->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersOH3->encode_key(channel);
-              int ieta = towersOH3->getTowerEtaBin(towerkey);
-              int iphi = towersOH3->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALOUT, ieta, iphi);
-              RawTowerGeom *tower_geom = geomOH->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
-
-          isoEt -= et;  // Subtract cluster eT from isoET
-          if (Verbosity() >= VERBOSITY_EVEN_MORE)
-          {
-            std::cout << Name() << "::ClusterIso iso_et for ";
-            cluster->identify();
-            std::cout << "=" << isoEt << '\n';
-          }
-          cluster->set_et_iso(isoEt, (int) 10 * m_coneSize, true, true);
-        }
+        std::cout << "In " << Name() << "::ClusterIso WARNING substracted towers do not exist subtracted isolation cannot be preformed \n";
       }
     }
+    else
+    {
+      // retowered EMCal towers use the inner HCal geometry, with eta from the geometry
+      ConeSumGrid gridEM;
+      ConeSumGrid gridIH;
+      ConeSumGrid gridOH;
+      fillConeSumGrid(gridEM, towersEM, geomIH, RawTowerDefs::CalorimeterId::HCALIN, false);
+      fillConeSumGrid(gridIH, towersIH, geomIH, RawTowerDefs::CalorimeterId::HCALIN, true);
+      fillConeSumGrid(gridOH, towersOH, geomOH, RawTowerDefs::CalorimeterId::HCALOUT, true);
+      setIsolation(clusters, {&gridEM, &gridIH, &gridOH}, true);
+    }
   }
+
+  /**
+   * This second section repeats the isolation calculation without any background subtraction
+   */
   if (m_do_unsubtracted)
   {
-    /**
-     * This second section repeats the isolation calculation without any background subtraction
-     */
     if (Verbosity() >= VERBOSITY_EVEN_MORE)
     {
       std::cout << Name() << "::ClusterIso starting unsubtracted calculation" << '\n';
     }
+    TowerInfoContainer *towersEM = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_CEMC");
+    TowerInfoContainer *towersIH = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_HCALIN");
+    TowerInfoContainer *towersOH = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_HCALOUT");
+    RawTowerGeomContainer *geomEM = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_CEMC");
+    RawTowerGeomContainer *geomIH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
+    RawTowerGeomContainer *geomOH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
+    if (!towersEM || !towersIH || !towersOH || !geomEM || !geomIH || !geomOH)
     {
-      // get EMCal towers
-      TowerInfoContainer *towersEM3old = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_CEMC");
-      if (Verbosity() >= VERBOSITY_MORE)
+      m_do_unsubtracted = false;
+      if (Verbosity() >= VERBOSITY_SOME)
       {
-        std::cout << "ClusterIso::process_event: " << towersEM3old->size() << " TOWERINFO_CALIB_CEMC towers" << '\n';
+        std::cout << "In " << Name() << "::ClusterIso WARNING towers do not exist unsubtracted isolation cannot be preformed \n";
       }
+    }
+    else
+    {
+      ConeSumGrid gridEM;
+      ConeSumGrid gridIH;
+      ConeSumGrid gridOH;
+      fillConeSumGrid(gridEM, towersEM, geomEM, RawTowerDefs::CalorimeterId::CEMC, true);
+      fillConeSumGrid(gridIH, towersIH, geomIH, RawTowerDefs::CalorimeterId::HCALIN, true);
+      fillConeSumGrid(gridOH, towersOH, geomOH, RawTowerDefs::CalorimeterId::HCALOUT, true);
+      setIsolation(clusters, {&gridEM, &gridIH, &gridOH}, false);
+    }
+  }
+  return 0;
+}
+
+void ClusterIso::fillConeSumGrid(ConeSumGrid &grid, TowerInfoContainer *towers, RawTowerGeomContainer *geom, RawTowerDefs::CalorimeterId caloId, bool correctEta)
+{
+  if (Verbosity() >= VERBOSITY_MORE)
+  {
+    std::cout << Name() << "::ClusterIso::process_event: " << towers->size() << " " << RawTowerDefs::convert_caloid_to_name(caloId) << " towers" << '\n';
+  }
 
-      // get InnerHCal towers
-      TowerInfoContainer *towersIH3 = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_HCALIN");
-      if (Verbosity() >= VERBOSITY_MORE)
+  const unsigned int ntowers = towers->size();
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    TowerInfo *tower = towers->get_tower_at_channel(channel);
+    if (!IsAcceptableTower(tower))
+    {
+      continue;
+    }
+    unsigned int towerkey = towers->encode_key(channel);
+    int ieta = towers->getTowerEtaBin(towerkey);
+    int iphi = towers->getTowerPhiBin(towerkey);
+    const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(caloId, ieta, iphi);
+    RawTowerGeom *tower_geom = geom->get_tower_geometry(key);
+    double this_phi = tower_geom->get_phi();
+    double this_eta = correctEta ? getTowerEta(tower_geom, m_vx, m_vy, m_vz) : tower_geom->get_eta();
+    grid.add(ieta, this_eta, this_phi, tower->get_energy() / cosh(this_eta));
+  }
+  grid.build();
+}
+
+void ClusterIso::setIsolation(RawClusterContainer *clusters, const std::vector<const ConeSumGrid *> &grids, bool subtracted)
+{
+  const CLHEP::Hep3Vector vertex(m_vx, m_vy, m_vz);
+  RawClusterContainer::ConstRange begin_end = clusters->getClusters();
+  for (RawClusterContainer::ConstIterator rtiter = begin_end.first; rtiter != begin_end.second; ++rtiter)
+  {
+    RawCluster *cluster = rtiter->second;
+
+    CLHEP::Hep3Vector E_vec_cluster = RawClusterUtility::GetEVec(*cluster, vertex);
+    double cluster_energy = E_vec_cluster.mag();
+    double cluster_eta = E_vec_cluster.pseudoRapidity();
+    double cluster_phi = E_vec_cluster.phi();
+    double et = cluster_energy / cosh(cluster_eta);
+    if (Verbosity() >= VERBOSITY_MAX)
+    {
+      std::cout << Name() << "::ClusterIso processing";
+      cluster->identify();
+      std::cout << '\n';
+    }
+    if (et < m_eTCut)
+    {
+      if (Verbosity() >= VERBOSITY_MAX)
       {
-        std::cout << "ClusterIso::process_event: " << towersIH3->size() << " TOWERINFO_CALIB_HCALIN towers" << '\n';
+        std::cout << "\t does not pass eT cut" << '\n';
       }
+      continue;
+    }  // skip if cluster is below eT cut
 
-      // get outerHCal towers
-      TowerInfoContainer *towersOH3 = findNode::getClass<TowerInfoContainer>(topNode, "TOWERINFO_CALIB_HCALOUT");
-      if (Verbosity() >= VERBOSITY_MORE)
+    for (const int coneSize : m_coneSizes)
+    {
+      double isoEt = 0;
+      for (const auto *grid : grids)
       {
-        std::cout << "ClusterIso::process_event: " << towersOH3->size() << " TOWERINFO_CALIB_HCALOUT towers" << std::endl;
+        isoEt += grid->sum(cluster_eta, cluster_phi, coneSize / 10.0);  // energy of the towers in the cone
       }
 
-      // get geometry of calorimeter towers
-      RawTowerGeomContainer *geomEM = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_CEMC");
-      RawTowerGeomContainer *geomIH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
-      RawTowerGeomContainer *geomOH = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
-
+      isoEt -= et;  // Subtract cluster eT from isoET
+      if (Verbosity() >= VERBOSITY_EVEN_MORE)
       {
-        RawClusterContainer *clusters = findNode::getClass<RawClusterContainer>(topNode, RawCemcClusterNodeName.c_str());
-        RawClusterContainer::ConstRange begin_end = clusters->getClusters();
-        RawClusterContainer::ConstIterator rtiter;
-        if (Verbosity() >= VERBOSITY_SOME)
-        {
-          std::cout << " ClusterIso sees " << clusters->size() << " clusters " << '\n';
-        }
-
-        // vertexmap is used to get correct collision vertex
-        GlobalVertexMap *vertexmap = findNode::getClass<GlobalVertexMap>(topNode, "GlobalVertexMap");
-        m_vx = m_vy = m_vz = 0;
-        if (vertexmap && !vertexmap->empty())
-        {
-          GlobalVertex *vertex = (vertexmap->begin()->second);
-          m_vx = vertex->get_x();
-          m_vy = vertex->get_y();
-          m_vz = vertex->get_z();
-          if (Verbosity() >= VERBOSITY_SOME)
-          {
-            std::cout << Name() << "ClusterIso Event Vertex Calculated at x:" << m_vx << " y:" << m_vy << " z:" << m_vz << '\n';
-          }
-        }
-
-        for (rtiter = begin_end.first; rtiter != begin_end.second; ++rtiter)
-        {
-          RawCluster *cluster = rtiter->second;
-
-          CLHEP::Hep3Vector vertex(m_vx, m_vy, m_vz);
-          CLHEP::Hep3Vector E_vec_cluster = RawClusterUtility::GetEVec(*cluster, vertex);
-          double cluster_energy = E_vec_cluster.mag();
-          double cluster_eta = E_vec_cluster.pseudoRapidity();
-          double cluster_phi = E_vec_cluster.phi();
-          double et = cluster_energy / cosh(cluster_eta);
-          double isoEt = 0;
-          if (Verbosity() >= VERBOSITY_MAX)
-          {
-            std::cout << Name() << "::ClusterIso processing";
-            cluster->identify();
-            std::cout << '\n';
-          }
-          if (et < m_eTCut)
-          {
-            if (Verbosity() >= VERBOSITY_MAX)
-            {
-              std::cout << "\t does not pass eT cut" << '\n';
-            }
-            continue;
-          }  // skip if cluster is below eT cut
-
-          // calculate EMCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersEM3old->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersEM3old->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersEM3old->encode_key(channel);
-              int ieta = towersEM3old->getTowerEtaBin(towerkey);
-              int iphi = towersEM3old->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::CEMC, ieta, iphi);
-              RawTowerGeom *tower_geom = geomEM->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
-          if (Verbosity() >= VERBOSITY_MAX)
-          {
-            std::cout << "\t after EMCal isoEt:" << isoEt << '\n';
-          }
-          // calculate Inner HCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersIH3->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersIH3->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersIH3->encode_key(channel);
-              int ieta = towersIH3->getTowerEtaBin(towerkey);
-              int iphi = towersIH3->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALIN, ieta, iphi);
-              RawTowerGeom *tower_geom = geomIH->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
-          if (Verbosity() >= VERBOSITY_MAX)
-          {
-            std::cout << "\t after innerHCal isoEt:" << isoEt << '\n';
-          }
-          // calculate Outer HCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersOH3->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersOH3->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersOH3->encode_key(channel);
-              int ieta = towersOH3->getTowerEtaBin(towerkey);
-              int iphi = towersOH3->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALOUT, ieta, iphi);
-              RawTowerGeom *tower_geom = geomOH->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
-          if (Verbosity() >= VERBOSITY_MAX)
-          {
-            std::cout << "\t after outerHCal isoEt:" << isoEt << '\n';
-          }
-          isoEt -= et;  // Subtract cluster eT from isoET
-          if (Verbosity() >= VERBOSITY_EVEN_MORE)
-          {
-            std::cout << Name() << "::ClusterIso iso_et for ";
-            cluster->identify();
-            std::cout << "=" << isoEt << '\n';
-          }
-          cluster->set_et_iso(isoEt, (int) 10 * m_coneSize, false, true);
-        }
+        std::cout << Name() << "::ClusterIso iso_et R=" << coneSize / 10.0 << " for ";
+        cluster->identify();
+        std::cout << "=" << isoEt << '\n';
       }
+      cluster->set_et_iso(isoEt, coneSize, subtracted, true);
     }
   }
-  return 0;
 }
 
 int ClusterIso::End(PHCompositeNode * /*topNode*/)
@@ -4,20 +4,27 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <calobase/RawTowerDefs.h>
+
 #include <CLHEP/Vector/ThreeVector.h>
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
+class RawClusterContainer;
 class RawTowerGeom;
+class RawTowerGeomContainer;
 class TowerInfo;
+class TowerInfoContainer;
 
 /** \Brief Tool to find isolation energy of each EMCal cluster.
  *
  * This tool finds isoET of clusters by summing towers energy
  * in a cone of radius R around the cluster and subtracting
- * the cluster from the sum
+ * the cluster from the sum. Several cone sizes can be given,
+ * they are all computed in the same pass over the clusters
  */
 
 class ClusterIso : public SubsysReco
@@ -34,9 +41,12 @@ class ClusterIso : public SubsysReco
   int End(PHCompositeNode*) override;
 
   void seteTCut(float x);
+  //! replaces all cone sizes with x
   void setConeSize(int x);
+  //! adds a cone size, as integer multiple of .1
+  void addConeSize(int x);
   /*const*/ float geteTCut();
-  //! returns coneSize*10 as an int
+  //! returns the first coneSize*10 as an int
   /*const*/ int getConeSize();
   /*const*/ CLHEP::Hep3Vector getVertex();
   void set_use_towerinfo(bool usetowerinfo)
@@ -50,10 +60,19 @@ class ClusterIso : public SubsysReco
   }
 
  private:
+  class ConeSumGrid;
+
   double getTowerEta(RawTowerGeom* tower_geom, double vx, double vy, double vz);
   bool IsAcceptableTower(TowerInfo* tower);
-  float m_eTCut{};     ///< The minimum required transverse energy in a cluster for ClusterIso to be run
-  float m_coneSize{};  ///< Size of the cone used to isolate a given cluster
+
+  //! fill grid with the transverse energy of the acceptable towers. Tower eta is taken from the geometry if correctEta is false
+  void fillConeSumGrid(ConeSumGrid& grid, TowerInfoContainer* towers, RawTowerGeomContainer* geom, RawTowerDefs::CalorimeterId caloId, bool correctEta);
+
+  //! set the isolation energy of all clusters above the eT cut, for all cone sizes
+  void setIsolation(RawClusterContainer* clusters, const std::vector<const ConeSumGrid*>& grids, bool subtracted);
+
+  float m_eTCut{};               ///< The minimum required transverse energy in a cluster for ClusterIso to be run
+  std::vector<int> m_coneSizes;  ///< Sizes of the cones used to isolate a given cluster, as integer multiple of .1
   float m_vx;          ///< Correct vertex x coordinate
   float m_vy;          ///< Correct vertex y coordinate
   float m_vz;          ///< Correct vertex z coordinate
@@ -29,6 +29,7 @@
 
 #include <trackbase_historic/SvtxTrack.h>
 #include <trackbase_historic/SvtxTrackMap.h>
+#include <trackbase_historic/TrackAnalysisUtils.h>
 
 #include <globalvertex/GlobalVertex.h>
 #include <globalvertex/GlobalVertexMap.h>
@@ -220,17 +221,13 @@ std::vector<KFParticle> KFParticle_Tools::makeAllDaughterParticles(PHCompositeNo
 
     if (silseed)
     {
-      for (auto cluster_iter = silseed->begin_cluster_keys();
-           cluster_iter != silseed->end_cluster_keys(); ++cluster_iter)
+      TrackAnalysisUtils::for_each_cluster_key(silseed, [&MVTX_hits](TrkrDefs::cluskey cluster_key)
       {
-        const auto &cluster_key = *cluster_iter;
-        const auto trackerID = TrkrDefs::getTrkrId(cluster_key);
-
-        if (trackerID == TrkrDefs::mvtxId)
+        if (TrkrDefs::getTrkrId(cluster_key) == TrkrDefs::mvtxId)
         {
           ++MVTX_hits;
         }
-      }
+      });
       if (MVTX_hits < m_nMVTXHits)
       {
         continue;
@@ -238,16 +235,13 @@ std::vector<KFParticle> KFParticle_Tools::makeAllDaughterParticles(PHCompositeNo
     }
     if (tpcseed)
     {
-      for (auto cluster_iter = tpcseed->begin_cluster_keys(); cluster_iter != tpcseed->end_cluster_keys(); ++cluster_iter)
+      TrackAnalysisUtils::for_each_cluster_key(tpcseed, [&TPC_hits](TrkrDefs::cluskey cluster_key)
       {
-        const auto &cluster_key = *cluster_iter;
-        const auto trackerID = TrkrDefs::getTrkrId(cluster_key);
-
-        if (trackerID == TrkrDefs::tpcId)
+        if (TrkrDefs::getTrkrId(cluster_key) == TrkrDefs::tpcId)
         {
           ++TPC_hits;
         }
-      }
+      });
       if (TPC_hits < m_nTPCHits)
       {
         continue;
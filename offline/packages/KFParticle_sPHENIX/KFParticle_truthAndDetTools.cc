@@ -18,6 +18,7 @@
 #include <trackbase_historic/SvtxPHG4ParticleMap_v1.h>
 #include <trackbase_historic/SvtxTrack.h>     // for SvtxTrack, SvtxTrack::...
 #include <trackbase_historic/SvtxTrackMap.h>  // for SvtxTrackMap, SvtxTrac...
+#include <trackbase_historic/TrackAnalysisUtils.h>
 
 #include <globalvertex/GlobalVertex.h>
 #include <globalvertex/GlobalVertexMap.h>
@@ -595,9 +596,8 @@ void KFParticle_truthAndDetTools::fillDetectorBranch(PHCompositeNode *topNode,
 
   if (silseed)
   {
-    for (auto cluster_iter = silseed->begin_cluster_keys(); cluster_iter != silseed->end_cluster_keys(); ++cluster_iter)
+    TrackAnalysisUtils::for_each_cluster_key(silseed, [&](TrkrDefs::cluskey cluster_key)
     {
-      const auto &cluster_key = *cluster_iter;
       const auto trackerID = TrkrDefs::getTrkrId(cluster_key);
   
       detector_layer[daughter_id].push_back(TrkrDefs::getLayer(cluster_key));
@@ -624,14 +624,13 @@ void KFParticle_truthAndDetTools::fillDetectorBranch(PHCompositeNode *topNode,
       intt_ladderPhiID[daughter_id].push_back(ladderPhiId);
       tpc_sectorID[daughter_id].push_back(sectorId);
       tpc_side[daughter_id].push_back(side);
-    }
+    });
   }
 
   if (tpcseed)
   {
-    for (auto cluster_iter = tpcseed->begin_cluster_keys(); cluster_iter != tpcseed->end_cluster_keys(); ++cluster_iter)
+    TrackAnalysisUtils::for_each_cluster_key(tpcseed, [&](TrkrDefs::cluskey cluster_key)
     {
-      const auto &cluster_key = *cluster_iter;
       const auto trackerID = TrkrDefs::getTrkrId(cluster_key);
 
       detector_layer[daughter_id].push_back(TrkrDefs::getLayer(cluster_key));
@@ -656,14 +655,11 @@ void KFParticle_truthAndDetTools::fillDetectorBranch(PHCompositeNode *topNode,
       intt_ladderPhiID[daughter_id].push_back(ladderPhiId);
       tpc_sectorID[daughter_id].push_back(sectorId);
       tpc_side[daughter_id].push_back(side);
-    }
+    });
   }
 
-  for (auto state_iter = track->begin_states();
-       state_iter != track->end_states();
-       ++state_iter)
+  TrackAnalysisUtils::for_each_state(track, [&](const SvtxTrackState* tstate)
   {
-    SvtxTrackState* tstate = state_iter->second;
     if (tstate->get_pathlength() != 0) //The first track state is an extrapolation so has no cluster
     {
       auto stateckey = tstate->get_cluskey();
@@ -674,7 +670,7 @@ void KFParticle_truthAndDetTools::fillDetectorBranch(PHCompositeNode *topNode,
       residual_y[daughter_id].push_back(global.y() - tstate->get_y());
       residual_z[daughter_id].push_back(global.z() - tstate->get_z()); 
     }
-  }
+  });
 }
 
 void KFParticle_truthAndDetTools::allPVInfo(PHCompositeNode *topNode,
@@ -9,6 +9,8 @@
 #include <Geant4/G4SystemOfUnits.hh>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
@@ -18,10 +20,6 @@
 
 PHField2D::PHField2D(const std::string &filename, const int verb, const float magfield_rescale)
   : PHField(verb)
-  , r_index0_cache(0)
-  , r_index1_cache(0)
-  , z_index0_cache(0)
-  , z_index1_cache(0)
 {
   if (Verbosity() > 0)
   {
@@ -227,6 +225,33 @@ PHField2D::PHField2D(const std::string &filename, const int verb, const float ma
   }
 }
 
+PHField2D::~PHField2D() = default;
+
+uint64_t PHField2D::NewCacheId()
+{
+  static std::atomic<uint64_t> last_id = 0;
+  return ++last_id;
+}
+
+PHField2D::IndexCache &PHField2D::ThreadCache() const
+{
+  // a few field maps can be used alternately on one thread without evicting each other,
+  // beyond that the caches are replaced round robin
+  static thread_local std::array<IndexCache, 4> caches;
+  static thread_local unsigned int next = 0;
+  for (auto &cache : caches)
+  {
+    if (cache.owner == m_CacheId)
+    {
+      return cache;
+    }
+  }
+  IndexCache &cache = caches[next++ % caches.size()];
+  cache = IndexCache();
+  cache.owner = m_CacheId;
+  return cache;
+}
+
 void PHField2D::GetFieldValue(const double point[4], double *Bfield) const
 {
   if (Verbosity() > 2)
@@ -310,8 +335,9 @@ void PHField2D::GetFieldCyl(const double CylPoint[4], double *BfieldCyl) const
   // between subsequent calls, we can save on the expense of the upper_bound
   // lookup (~10-15% of central event run time) with some caching between calls
 
-  unsigned int r_index0 = r_index0_cache;
-  unsigned int r_index1 = r_index1_cache;
+  IndexCache &cache = ThreadCache();
+  unsigned int r_index0 = cache.r_index0_cache;
+  unsigned int r_index1 = cache.r_index1_cache;
 
   if (!((r > r_map_[r_index0]) && (r < r_map_[r_index1])))
   {
@@ -338,12 +364,12 @@ void PHField2D::GetFieldCyl(const double CylPoint[4], double *BfieldCyl) const
     }
 
     // update cache
-    r_index0_cache = r_index0;
-    r_index1_cache = r_index1;
+    cache.r_index0_cache = r_index0;
+    cache.r_index1_cache = r_index1;
   }
 
-  unsigned int z_index0 = z_index0_cache;
-  unsigned int z_index1 = z_index1_cache;
+  unsigned int z_index0 = cache.z_index0_cache;
+  unsigned int z_index1 = cache.z_index1_cache;
 
   if (!((z > z_map_[z_index0]) && (z < z_map_[z_index1])))
   {
@@ -361,8 +387,8 @@ void PHField2D::GetFieldCyl(const double CylPoint[4], double *BfieldCyl) const
     }
 
     // update cache
-    z_index0_cache = z_index0;
-    z_index1_cache = z_index1;
+    cache.z_index0_cache = z_index0;
+    cache.z_index1_cache = z_index1;
   }
 
   double Br000 = BFieldR_[z_index0][r_index0];
@@ -4,6 +4,7 @@
 
 #include "PHField.h"
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <tuple>
@@ -15,7 +16,7 @@ class PHField2D : public PHField
 
  public:
   PHField2D(const std::string &filename, const int verb = 0, const float magfield_rescale = 1.0);
-  ~PHField2D() override {}
+  ~PHField2D() override;
   //! access field value
   //! Follow the convention of G4ElectroMagneticField
   //! @param[in]  Point   space time coordinate. x, y, z, t in Geant4/CLHEP units
@@ -40,16 +41,22 @@ class PHField2D : public PHField
 
  private:
   void print_map(std::map<trio, trio>::iterator &it) const;
-  // mutable allows to change internal data even in const methods
-  // I don't like this too much but these are cached values to speed up
-  // the field lookup by a lot
-  // I want them to be data members so we can run 2 fieldmaps in parallel
-  // and still have caching. Putting those as static variables into
-  // the implementation will prevent this
-  mutable unsigned int r_index0_cache;
-  mutable unsigned int r_index1_cache;
-  mutable unsigned int z_index0_cache;
-  mutable unsigned int z_index1_cache;
+  // cached indices of the last lookup, to speed up the field lookup by a lot.
+  // They are kept per thread and per field map (see ThreadCache()), so we can
+  // run 2 fieldmaps in parallel and Geant4 worker threads can share one map
+  struct IndexCache
+  {
+    uint64_t owner = 0;  // m_CacheId of the field map, 0 if unused
+    unsigned int r_index0_cache = 0;
+    unsigned int r_index1_cache = 0;
+    unsigned int z_index0_cache = 0;
+    unsigned int z_index1_cache = 0;
+  };
+  IndexCache &ThreadCache() const;
+
+  //! unique for every field map ever created, a map allocated at the address of a deleted one does not reuse its caches
+  static uint64_t NewCacheId();
+  const uint64_t m_CacheId = NewCacheId();
 };
 
 #endif
@@ -15,47 +15,99 @@
 #include <boost/stacktrace.hpp>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <iterator>
 #include <set>
-#include <utility>
 
 PHField3DCartesian::PHField3DCartesian(const std::string &fname, const float magfield_rescale, const float innerradius, const float outerradius, const float size_z)
   : filename(fname)
 {
-  for (int i = 0; i < 2; i++)
-  {
-    for (int j = 0; j < 2; j++)
-    {
-      for (int k = 0; k < 2; k++)
-      {
-        for (int l = 0; l < 3; l++)
-        {
-          xyz[i][j][k][l] = NAN;
-          bf[i][j][k][l] = NAN;
-        }
-      }
-    }
-  }
   std::cout << "\n================ Begin Construct Mag Field =====================" << std::endl;
   std::cout << "\n-----------------------------------------------------------"
             << "\n      Magnetic field Module - Verbosity:"
             << "\n-----------------------------------------------------------";
 
+  // the grid depends on the file and on all parameters applied while reading it
+  uint64_t key = PHSharedStore::hashString("PHField3DCartesian");
+  key = PHSharedStore::hashUrl(filename, key);
+  key = PHSharedStore::hashValue(magfield_rescale, key);
+  key = PHSharedStore::hashValue(innerradius, key);
+  key = PHSharedStore::hashValue(outerradius, key);
+  key = PHSharedStore::hashValue(size_z, key);
+  grid = PHSharedStore::instance()->get("PHField3DCartesian", key, [&](std::vector<char> &payload)
+                                        { return BuildGrid(filename, magfield_rescale, innerradius, outerradius, size_z, payload); });
+  if (!grid)
+  {
+    std::cout << "\n could not build field grid from " << filename << " exiting now" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  if (grid->isShared())
+  {
+    std::cout << "\n ---> "
+                 "Using the field grid of "
+              << filename << " from the shared store" << std::endl;
+  }
+
+  uint32_t dims[4];
+  std::memcpy(dims, grid->data(), sizeof(dims));
+  nxvals = dims[0];
+  nyvals = dims[1];
+  nzvals = dims[2];
+  if (nxvals < 2 || nyvals < 2 || nzvals < 2 ||
+      grid->size() != sizeof(dims) + sizeof(float) * (nxvals + nyvals + nzvals + 3 * static_cast<std::size_t>(nxvals) * nyvals * nzvals))
+  {
+    std::cout << PHWHERE << " invalid field grid for " << filename << " exiting now" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  xvals = reinterpret_cast<const float *>(grid->data() + sizeof(dims));
+  yvals = xvals + nxvals;
+  zvals = yvals + nyvals;
+  bfield = zvals + nzvals;
+
+  xmin = xvals[0];
+  xmax = xvals[nxvals - 1];
+
+  ymin = yvals[0];
+  ymax = yvals[nyvals - 1];
+  if (ymin != xmin || ymax != xmax)
+  {
+    std::cout << "PHField3DCartesian: Compiler bug!!!!!!!! Do not use inlining!!!!!!" << std::endl;
+    std::cout << "exiting now - recompile with -fno-inline" << std::endl;
+    exit(1);
+  }
+
+  zmin = zvals[0];
+  zmax = zvals[nzvals - 1];
+
+  xstepsize = (xmax - xmin) / (nxvals - 1);
+  ystepsize = (ymax - ymin) / (nyvals - 1);
+  zstepsize = (zmax - zmin) / (nzvals - 1);
+
+  std::cout << "\n================= End Construct Mag Field ======================\n"
+            << std::endl;
+}
+
+bool PHField3DCartesian::BuildGrid(const std::string &fname, const float magfield_rescale, const float innerradius, const float outerradius, const float size_z, std::vector<char> &payload)
+{
   // open file
-  TFile *rootinput = TFile::Open(filename.c_str());
+  TFile *rootinput = TFile::Open(fname.c_str());
   if (!rootinput)
   {
-    std::cout << "\n could not open " << filename << " exiting now" << std::endl;
+    std::cout << "\n could not open " << fname << " exiting now" << std::endl;
     gSystem->Exit(1);
     exit(1);
   }
   std::cout << "\n ---> "
                "Reading the field grid from "
-            << filename << " ... " << std::endl;
+            << fname << " ... " << std::endl;
 
   //  get root NTuple objects
   TNtuple *field_map = nullptr;
@@ -63,7 +115,7 @@ PHField3DCartesian::PHField3DCartesian(const std::string &fname, const float mag
   if (field_map == nullptr)
   {
     std::cout << PHWHERE << " Could not load fieldmap ntuple from "
-              << filename << " exiting now" << std::endl;
+              << fname << " exiting now" << std::endl;
     gSystem->Exit(1);
     exit(1);
   }
@@ -75,61 +127,109 @@ PHField3DCartesian::PHField3DCartesian(const std::string &fname, const float mag
   field_map->SetBranchAddress("bx", &ROOT_BX);
   field_map->SetBranchAddress("by", &ROOT_BY);
   field_map->SetBranchAddress("bz", &ROOT_BZ);
+
+  // the grid is spanned by all points, the field is only kept for the selected ones
+  std::set<float> xset;
+  std::set<float> yset;
+  std::set<float> zset;
+  std::vector<std::array<float, 6> > points;
+  points.reserve(field_map->GetEntries());
   for (int i = 0; i < field_map->GetEntries(); i++)
   {
     field_map->GetEntry(i);
-    trio coord_key(ROOT_X * cm, ROOT_Y * cm, ROOT_Z * cm);
-    trio field_val(ROOT_BX * tesla * magfield_rescale, ROOT_BY * tesla * magfield_rescale, ROOT_BZ * tesla * magfield_rescale);
-    xvals.insert(ROOT_X * cm);
-    yvals.insert(ROOT_Y * cm);
-    zvals.insert(ROOT_Z * cm);
+    xset.insert(ROOT_X * cm);
+    yset.insert(ROOT_Y * cm);
+    zset.insert(ROOT_Z * cm);
     if ((std::sqrt(ROOT_X * cm * ROOT_X * cm + ROOT_Y * cm * ROOT_Y * cm) >= innerradius &&
          std::sqrt(ROOT_X * cm * ROOT_X * cm + ROOT_Y * cm * ROOT_Y * cm) <= outerradius) ||
         std::abs(ROOT_Z * cm) > size_z)
     {
-      fieldmap[coord_key] = field_val;
+      points.push_back({static_cast<float>(ROOT_X * cm), static_cast<float>(ROOT_Y * cm), static_cast<float>(ROOT_Z * cm),
+                        static_cast<float>(ROOT_BX * tesla * magfield_rescale), static_cast<float>(ROOT_BY * tesla * magfield_rescale), static_cast<float>(ROOT_BZ * tesla * magfield_rescale)});
     }
   }
-  xmin = *(xvals.begin());
-  xmax = *(xvals.rbegin());
+  delete field_map;
+  delete rootinput;
 
-  ymin = *(yvals.begin());
-  ymax = *(yvals.rbegin());
-  if (ymin != xmin || ymax != xmax)
+  const std::vector<float> x(xset.begin(), xset.end());
+  const std::vector<float> y(yset.begin(), yset.end());
+  const std::vector<float> z(zset.begin(), zset.end());
+  const uint32_t dims[4] = {static_cast<uint32_t>(x.size()), static_cast<uint32_t>(y.size()), static_cast<uint32_t>(z.size()), 0};
+  std::vector<float> values(x.size() + y.size() + z.size() + 3 * x.size() * y.size() * z.size(), NAN);
+  auto iter = std::copy(x.begin(), x.end(), values.begin());
+  iter = std::copy(y.begin(), y.end(), iter);
+  iter = std::copy(z.begin(), z.end(), iter);
+  float *field = &*iter;
+  for (const auto &point : points)
   {
-    std::cout << "PHField3DCartesian: Compiler bug!!!!!!!! Do not use inlining!!!!!!" << std::endl;
-    std::cout << "exiting now - recompile with -fno-inline" << std::endl;
-    exit(1);
+    const std::size_t ix = std::lower_bound(x.begin(), x.end(), point[0]) - x.begin();
+    const std::size_t iy = std::lower_bound(y.begin(), y.end(), point[1]) - y.begin();
+    const std::size_t iz = std::lower_bound(z.begin(), z.end(), point[2]) - z.begin();
+    // a point given twice takes the last value
+    std::copy(point.begin() + 3, point.end(), field + 3 * ((ix * y.size() + iy) * z.size() + iz));
   }
 
-  zmin = *(zvals.begin());
-  zmax = *(zvals.rbegin());
-
-  xstepsize = (xmax - xmin) / (xvals.size() - 1);
-  ystepsize = (ymax - ymin) / (yvals.size() - 1);
-  zstepsize = (zmax - zmin) / (zvals.size() - 1);
-
-  delete field_map;
-  delete rootinput;
-  std::cout << "\n================= End Construct Mag Field ======================\n"
-            << std::endl;
+  payload.resize(sizeof(dims) + values.size() * sizeof(float));
+  std::memcpy(payload.data(), dims, sizeof(dims));
+  std::memcpy(payload.data() + sizeof(dims), values.data(), values.size() * sizeof(float));
+  return true;
 }
 
 PHField3DCartesian::~PHField3DCartesian()
 {
   if (Verbosity() > 0)
   {
-    std::cout << "PHField3DCartesian: cache hits: " << cache_hits
-              << " cache misses: " << cache_misses
-              << std::endl;
+    const Cache &cache = ThreadCache();
+    std::cout << "PHField3DCartesian: cache hits: " << cache.cache_hits
+              << " cache misses: " << cache.cache_misses
+              << " (this thread)" << std::endl;
+  }
+}
+
+uint64_t PHField3DCartesian::NewCacheId()
+{
+  static std::atomic<uint64_t> last_id = 0;
+  return ++last_id;
+}
+
+PHField3DCartesian::Cache &PHField3DCartesian::ThreadCache() const
+{
+  // a few field maps can be used alternately on one thread without evicting each other,
+  // beyond that the caches are replaced round robin
+  static thread_local std::array<Cache, 4> caches;
+  static thread_local unsigned int next = 0;
+  for (auto &entry : caches)
+  {
+    if (entry.owner == m_CacheId)
+    {
+      return entry;
+    }
   }
+  Cache &cache = caches[next++ % caches.size()];
+  cache = Cache();
+  cache.owner = m_CacheId;
+  for (int i = 0; i < 2; i++)
+  {
+    for (int j = 0; j < 2; j++)
+    {
+      for (int k = 0; k < 2; k++)
+      {
+        for (int l = 0; l < 3; l++)
+        {
+          cache.xyz[i][j][k][l] = NAN;
+          cache.bf[i][j][k][l] = NAN;
+        }
+      }
+    }
+  }
+  return cache;
 }
 
 void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) const
 {
-  static double xsav = -1000000.;
-  static double ysav = -1000000.;
-  static double zsav = -1000000.;
+  static thread_local double xsav = -1000000.;
+  static thread_local double ysav = -1000000.;
+  static thread_local double zsav = -1000000.;
 
   double x = point[0];
   double y = point[1];
@@ -140,7 +240,7 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
   Bfield[2] = 0.0;
   if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z))
   {
-    static int ifirst = 0;
+    static thread_local int ifirst = 0;
     if (ifirst < 10)
     {
       std::cout << "PHField3DCartesian::GetFieldValue: "
@@ -172,11 +272,15 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
   {
     return;
   }
+  // same as std::set<float>::lower_bound, the point is compared as float
+  unsigned int xindex[2];
   double xkey[2];
-  std::set<float>::const_iterator it = xvals.lower_bound(x);
+  const float *it = std::lower_bound(xvals, xvals + nxvals, static_cast<float>(x));
+  xindex[0] = it - xvals;
   xkey[0] = *it;
-  if (it == xvals.begin())
+  if (it == xvals)
   {
+    xindex[1] = xindex[0];
     xkey[1] = *it;
     if (x < xkey[0])
     {
@@ -186,15 +290,18 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
   }
   else
   {
-    --it;
-    xkey[1] = *it;
+    xindex[1] = xindex[0] - 1;
+    xkey[1] = xvals[xindex[1]];
   }
 
+  unsigned int yindex[2];
   double ykey[2];
-  it = yvals.lower_bound(y);
+  it = std::lower_bound(yvals, yvals + nyvals, static_cast<float>(y));
+  yindex[0] = it - yvals;
   ykey[0] = *it;
-  if (it == yvals.begin())
+  if (it == yvals)
   {
+    yindex[1] = yindex[0];
     ykey[1] = *it;
     if (y < ykey[0])
     {
@@ -204,14 +311,17 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
   }
   else
   {
-    --it;
-    ykey[1] = *it;
+    yindex[1] = yindex[0] - 1;
+    ykey[1] = yvals[yindex[1]];
   }
+  unsigned int zindex[2];
   double zkey[2];
-  it = zvals.lower_bound(z);
+  it = std::lower_bound(zvals, zvals + nzvals, static_cast<float>(z));
+  zindex[0] = it - zvals;
   zkey[0] = *it;
-  if (it == zvals.begin())
+  if (it == zvals)
   {
+    zindex[1] = zindex[0];
     zkey[1] = *it;
     if (z < zkey[0])
     {
@@ -221,29 +331,27 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
   }
   else
   {
-    --it;
-    zkey[1] = *it;
+    zindex[1] = zindex[0] - 1;
+    zkey[1] = zvals[zindex[1]];
   }
-  if (xkey_save != xkey[0] ||
-      ykey_save != ykey[0] ||
-      zkey_save != zkey[0])
+  Cache &cache = ThreadCache();
+  if (cache.xkey_save != xkey[0] ||
+      cache.ykey_save != ykey[0] ||
+      cache.zkey_save != zkey[0])
   {
-    cache_misses++;
-    xkey_save = xkey[0];
-    ykey_save = ykey[0];
-    zkey_save = zkey[0];
+    cache.cache_misses++;
+    cache.xkey_save = xkey[0];
+    cache.ykey_save = ykey[0];
+    cache.zkey_save = zkey[0];
 
-    std::map<std::tuple<float, float, float>, std::tuple<float, float, float> >::const_iterator magval;
-    trio key;
     for (int i = 0; i < 2; i++)
     {
       for (int j = 0; j < 2; j++)
       {
         for (int k = 0; k < 2; k++)
         {
-          key = std::make_tuple(xkey[i], ykey[j], zkey[k]);
-          magval = fieldmap.find(key);
-          if (magval == fieldmap.end())
+          const float *magval = gridField(xindex[i], yindex[j], zindex[k]);
+          if (std::isnan(magval[0]))
           {
             std::cout << PHWHERE << " could not locate key in " << filename
                       << " value: x: " << xkey[i] / cm
@@ -251,20 +359,20 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
                       << ", z: " << zkey[k] / cm << std::endl;
             return;
           }
-          xyz[i][j][k][0] = std::get<0>(magval->first);
-          xyz[i][j][k][1] = std::get<1>(magval->first);
-          xyz[i][j][k][2] = std::get<2>(magval->first);
-          bf[i][j][k][0] = std::get<0>(magval->second);
-          bf[i][j][k][1] = std::get<1>(magval->second);
-          bf[i][j][k][2] = std::get<2>(magval->second);
+          cache.xyz[i][j][k][0] = xkey[i];
+          cache.xyz[i][j][k][1] = ykey[j];
+          cache.xyz[i][j][k][2] = zkey[k];
+          cache.bf[i][j][k][0] = magval[0];
+          cache.bf[i][j][k][1] = magval[1];
+          cache.bf[i][j][k][2] = magval[2];
           if (Verbosity() > 0)
           {
-            std::cout << "read x/y/z: " << xyz[i][j][k][0] / cm << "/"
-                      << xyz[i][j][k][1] / cm << "/"
-                      << xyz[i][j][k][2] / cm << " bx/by/bz: "
-                      << bf[i][j][k][0] / tesla << "/"
-                      << bf[i][j][k][1] / tesla << "/"
-                      << bf[i][j][k][2] / tesla << std::endl;
+            std::cout << "read x/y/z: " << cache.xyz[i][j][k][0] / cm << "/"
+                      << cache.xyz[i][j][k][1] / cm << "/"
+                      << cache.xyz[i][j][k][2] / cm << " bx/by/bz: "
+                      << cache.bf[i][j][k][0] / tesla << "/"
+                      << cache.bf[i][j][k][1] / tesla << "/"
+                      << cache.bf[i][j][k][2] / tesla << std::endl;
           }
         }
       }
@@ -272,7 +380,7 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
   }
   else
   {
-    cache_hits++;
+    cache.cache_hits++;
   }
 
   // how far are we away from the reference point
@@ -304,14 +412,14 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
 
   for (int i = 0; i < 3; i++)
   {
-    Bfield[i] = bf[0][0][0][i] * fractionx * fractiony * fractionz +
-                bf[1][0][0][i] * (1. - fractionx) * fractiony * fractionz +
-                bf[0][1][0][i] * fractionx * (1. - fractiony) * fractionz +
-                bf[0][0][1][i] * fractionx * fractiony * (1. - fractionz) +
-                bf[1][0][1][i] * (1. - fractionx) * fractiony * (1. - fractionz) +
-                bf[0][1][1][i] * fractionx * (1. - fractiony) * (1. - fractionz) +
-                bf[1][1][0][i] * (1. - fractionx) * (1. - fractiony) * fractionz +
-                bf[1][1][1][i] * (1. - fractionx) * (1. - fractiony) * (1. - fractionz);
+    Bfield[i] = cache.bf[0][0][0][i] * fractionx * fractiony * fractionz +
+                cache.bf[1][0][0][i] * (1. - fractionx) * fractiony * fractionz +
+                cache.bf[0][1][0][i] * fractionx * (1. - fractiony) * fractionz +
+                cache.bf[0][0][1][i] * fractionx * fractiony * (1. - fractionz) +
+                cache.bf[1][0][1][i] * (1. - fractionx) * fractiony * (1. - fractionz) +
+                cache.bf[0][1][1][i] * fractionx * (1. - fractiony) * (1. - fractionz) +
+                cache.bf[1][1][0][i] * (1. - fractionx) * (1. - fractiony) * fractionz +
+                cache.bf[1][1][1][i] * (1. - fractionx) * (1. - fractiony) * (1. - fractionz);
   }
 
   return;
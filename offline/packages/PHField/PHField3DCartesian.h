@@ -3,12 +3,17 @@
 
 #include "PHField.h"
 
+#include <phool/PHSharedStore.h>
+
 #include <cmath>
-#include <map>
-#include <set>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <tuple>
+#include <vector>
 
+//! 3D field map on a regular cartesian grid. The grid is kept as flat arrays which
+//! are published in the PHSharedStore (if enabled), so jobs on the same node share one copy
 class PHField3DCartesian : public PHField
 {
  public:
@@ -32,21 +37,46 @@ class PHField3DCartesian : public PHField
   double xstepsize = NAN;
   double ystepsize = NAN;
   double zstepsize = NAN;
-  // these are updated in a const method
-  // to cache previous values
-  mutable double xyz[2][2][2][3]{};
-  mutable double bf[2][2][2][3]{};
-  mutable double xkey_save = NAN;
-  mutable double ykey_save = NAN;
-  mutable double zkey_save = NAN;
-  mutable int cache_hits = 0;
-  mutable int cache_misses = 0;
-
-  typedef std::tuple<float, float, float> trio;
-  std::map<std::tuple<float, float, float>, std::tuple<float, float, float> > fieldmap;
-  std::set<float> xvals;
-  std::set<float> yvals;
-  std::set<float> zvals;
+  // the corners of the last interpolation cell, geant looks up the field
+  // in the same cell most of the time. These are updated in a const method
+  // and kept per thread, so Geant4 worker threads can share one field map
+  struct Cache
+  {
+    uint64_t owner = 0;  // m_CacheId of the field map, 0 if unused
+    double xyz[2][2][2][3]{};
+    double bf[2][2][2][3]{};
+    double xkey_save = NAN;
+    double ykey_save = NAN;
+    double zkey_save = NAN;
+    int cache_hits = 0;
+    int cache_misses = 0;
+  };
+  //! the calling thread's cache for this field map
+  Cache &ThreadCache() const;
+
+  //! unique for every field map ever created, a map allocated at the address of a deleted one does not reuse its caches
+  static uint64_t NewCacheId();
+  const uint64_t m_CacheId = NewCacheId();
+
+  //! read the field map ntuple into the flat grid layout (see the grid accessors below)
+  static bool BuildGrid(const std::string &fname, const float magfield_rescale, const float innerradius, const float outerradius, const float size_z, std::vector<char> &payload);
+
+  //! field vector at grid point ix/iy/iz, bx is NaN if the point is not in the field map
+  const float *gridField(unsigned int ix, unsigned int iy, unsigned int iz) const
+  {
+    return bfield + 3 * ((static_cast<std::size_t>(ix) * nyvals + iy) * nzvals + iz);
+  }
+
+  //! grid layout: nx, ny, nz (uint32), sorted x, y, z values, field values (bx, by, bz) for
+  //! all grid points, with z running fastest
+  std::shared_ptr<const PHSharedStore::Segment> grid;
+  unsigned int nxvals = 0;
+  unsigned int nyvals = 0;
+  unsigned int nzvals = 0;
+  const float *xvals = nullptr;
+  const float *yvals = nullptr;
+  const float *zvals = nullptr;
+  const float *bfield = nullptr;
 };
 
 #endif
@@ -582,13 +582,12 @@ int HelicalFitter::process_event(PHCompositeNode* /*unused*/)
       if (make_ntuple)
       {
         // get the local parameters using the ideal transforms
-        alignmentTransformationContainer::use_alignment = false;
-        Acts::Vector3 ideal_center = surf->center(_tGeometry->geometry().getGeoContext()) * 0.1;
-        Acts::Vector3 ideal_norm = -surf->normal(_tGeometry->geometry().getGeoContext());
+        const auto& idealContext = ActsGeometry::getIdealGeoContext();
+        Acts::Vector3 ideal_center = surf->center(idealContext) * 0.1;
+        Acts::Vector3 ideal_norm = -surf->normal(idealContext);
         Acts::Vector3 ideal_local(xloc, zloc, 0.0);  // cm
-        Acts::Vector3 ideal_glob = surf->transform(_tGeometry->geometry().getGeoContext()) * (ideal_local * Acts::UnitConstants::cm);
+        Acts::Vector3 ideal_glob = surf->transform(idealContext) * (ideal_local * Acts::UnitConstants::cm);
         ideal_glob /= Acts::UnitConstants::cm;
-        alignmentTransformationContainer::use_alignment = true;
 
         Acts::Vector3 sensorCenter = surf->center(_tGeometry->geometry().getGeoContext()) * 0.1;  // cm
         Acts::Vector3 sensorNormal = -surf->normal(_tGeometry->geometry().getGeoContext());
@@ -0,0 +1,173 @@
+#include "BenchmarkRunner.h"
+
+#include <unistd.h>
+
+#include <boost/io/ios_state.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <thread>
+
+namespace
+{
+  double cpu_time_ns()
+  {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+  }
+
+  double median(std::vector<double> values)
+  {
+    std::sort(values.begin(), values.end());
+    const std::size_t n = values.size();
+    return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+  }
+
+  std::string json_string(const std::string &value)
+  {
+    std::string out = "\"";
+    for (char c : value)
+    {
+      if (c == '"' || c == '\\')
+      {
+        out += '\\';
+      }
+      out += c;
+    }
+    return out + "\"";
+  }
+}  // namespace
+
+void BenchmarkRunner::run(const std::string &name, std::size_t items, const Function &body, const Function &setup)
+{
+  if (!m_filter.empty() && name.find(m_filter) == std::string::npos)
+  {
+    return;
+  }
+
+  std::vector<double> real;
+  std::vector<double> cpu;
+  // first call is a warm up, not recorded
+  for (unsigned int i = 0; i <= m_repetitions; ++i)
+  {
+    if (setup)
+    {
+      setup();
+    }
+    const double cpu_start = cpu_time_ns();
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    const auto stop = std::chrono::steady_clock::now();
+    const double cpu_stop = cpu_time_ns();
+    if (i > 0)
+    {
+      real.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+      cpu.push_back(cpu_stop - cpu_start);
+    }
+  }
+
+  Result result;
+  result.name = name;
+  result.items = items;
+  result.repetitions = m_repetitions;
+  if (!real.empty())
+  {
+    result.realMedian = median(real);
+    result.realMin = *std::min_element(real.begin(), real.end());
+    result.realMean = std::accumulate(real.begin(), real.end(), 0.) / real.size();
+    double sum2 = 0;
+    for (double value : real)
+    {
+      sum2 += (value - result.realMean) * (value - result.realMean);
+    }
+    result.realStdDev = real.size() > 1 ? std::sqrt(sum2 / (real.size() - 1)) : 0;
+    result.cpuMedian = median(cpu);
+  }
+  m_results.push_back(result);
+
+  // formatting is not left on std::cout
+  boost::io::ios_all_saver saver(std::cout);
+  std::cout << "BenchmarkRunner: " << std::left << std::setw(56) << name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(3) << result.realMedian * 1e-6 << " ms"
+            << std::setw(12) << std::setprecision(1) << (items ? result.realMedian / items : 0) << " ns/item"
+            << std::defaultfloat << std::endl;
+}
+
+void BenchmarkRunner::print(std::ostream &os) const
+{
+  boost::io::ios_all_saver saver(os);
+  os << std::left << std::setw(56) << "benchmark" << std::right
+     << std::setw(12) << "items"
+     << std::setw(14) << "median ms"
+     << std::setw(14) << "min ms"
+     << std::setw(12) << "rms %"
+     << std::setw(14) << "ns/item" << std::endl;
+  for (const auto &result : m_results)
+  {
+    os << std::left << std::setw(56) << result.name << std::right
+       << std::setw(12) << result.items
+       << std::fixed << std::setprecision(3)
+       << std::setw(14) << result.realMedian * 1e-6
+       << std::setw(14) << result.realMin * 1e-6
+       << std::setprecision(1)
+       << std::setw(12) << (result.realMean > 0 ? 100. * result.realStdDev / result.realMean : 0)
+       << std::setw(14) << (result.items ? result.realMedian / result.items : 0)
+       << std::defaultfloat << std::endl;
+  }
+}
+
+bool BenchmarkRunner::writeJson(const std::string &filename, const std::map<std::string, std::string> &context) const
+{
+  std::ofstream out(filename);
+  if (!out)
+  {
+    std::cout << "BenchmarkRunner::writeJson - could not open " << filename << std::endl;
+    return false;
+  }
+
+  char date[64] = {};
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+  char host[256] = {};
+  gethostname(host, sizeof(host) - 1);
+
+  out << "{\n  \"context\": {\n"
+      << "    \"date\": " << json_string(date) << ",\n"
+      << "    \"host_name\": " << json_string(host) << ",\n"
+      << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+      << "    \"repetitions\": " << m_repetitions;
+  for (const auto &[key, value] : context)
+  {
+    out << ",\n    " << json_string(key) << ": " << json_string(value);
+  }
+  out << "\n  },\n  \"benchmarks\": [";
+
+  out << std::setprecision(10);
+  for (std::size_t i = 0; i < m_results.size(); ++i)
+  {
+    const Result &result = m_results[i];
+    out << (i ? ",\n" : "\n")
+        << "    {\n"
+        << "      \"name\": " << json_string(result.name) << ",\n"
+        << "      \"run_name\": " << json_string(result.name) << ",\n"
+        << "      \"run_type\": \"iteration\",\n"
+        << "      \"iterations\": " << result.repetitions << ",\n"
+        << "      \"real_time\": " << result.realMedian << ",\n"
+        << "      \"cpu_time\": " << result.cpuMedian << ",\n"
+        << "      \"time_unit\": \"ns\",\n"
+        << "      \"min_real_time\": " << result.realMin << ",\n"
+        << "      \"mean_real_time\": " << result.realMean << ",\n"
+        << "      \"stddev_real_time\": " << result.realStdDev << ",\n"
+        << "      \"items\": " << result.items << ",\n"
+        << "      \"items_per_second\": " << (result.realMedian > 0 ? result.items / result.realMedian * 1e9 : 0) << "\n"
+        << "    }";
+  }
+  out << "\n  ]\n}" << std::endl;
+  return static_cast<bool>(out);
+}
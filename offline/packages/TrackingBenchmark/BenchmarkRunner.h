@@ -0,0 +1,74 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef TRACKINGBENCHMARK_BENCHMARKRUNNER_H
+#define TRACKINGBENCHMARK_BENCHMARKRUNNER_H
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/** Minimal benchmark harness.
+ *
+ *  Every benchmark is a function processing one full event, timed (wall clock and
+ *  process cpu time) for a number of repetitions after one untimed warm up run.
+ *  An optional setup function runs untimed before every repetition, e.g. to reset
+ *  the container a fill benchmark writes into.
+ *
+ *  Results are written as json in the layout of google benchmark
+ *  (context, benchmarks with name, iterations, real_time, cpu_time, time_unit),
+ *  so that the output of two versions can be compared with its compare.py.
+ *  real_time and cpu_time are the medians over the repetitions.
+ */
+class BenchmarkRunner
+{
+ public:
+  struct Result
+  {
+    std::string name;
+    std::size_t items = 0;
+    unsigned int repetitions = 0;
+
+    //! ns per event
+    double realMedian = 0;
+    double realMin = 0;
+    double realMean = 0;
+    double realStdDev = 0;
+    double cpuMedian = 0;
+  };
+
+  using Function = std::function<void()>;
+
+  void Repetitions(const unsigned int n) { m_repetitions = n; }
+  unsigned int Repetitions() const { return m_repetitions; }
+
+  //! only benchmarks with names containing filter are run
+  void Filter(const std::string &filter) { m_filter = filter; }
+
+  //! time body, items is the number of objects processed per call (for the rates)
+  void run(const std::string &name, std::size_t items, const Function &body, const Function &setup = nullptr);
+
+  const std::vector<Result> &results() const { return m_results; }
+
+  //! table of all results
+  void print(std::ostream &os = std::cout) const;
+
+  //! json output, context is added to the json context block
+  bool writeJson(const std::string &filename, const std::map<std::string, std::string> &context) const;
+
+  //! keep the compiler from optimizing away results of a benchmark
+  template <class T>
+  static void doNotOptimize(const T &value)
+  {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+ private:
+  unsigned int m_repetitions = 10;
+  std::string m_filter;
+  std::vector<Result> m_results;
+};
+
+#endif
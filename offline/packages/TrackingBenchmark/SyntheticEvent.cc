@@ -0,0 +1,329 @@
+#include "SyntheticEvent.h"
+
+#include <trackbase/ActsSurfaceMaps.h>
+#include <trackbase/MvtxDefs.h>
+#include <trackbase/TpcDefs.h>
+
+#include <Acts/Definitions/Algebra.hpp>
+#include <Acts/Definitions/Units.hpp>
+#include <Acts/Surfaces/PlaneSurface.hpp>
+#include <Acts/Surfaces/RectangleBounds.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <random>
+
+namespace
+{
+  //!@name simplified MVTX geometry, cm
+  //@{
+  constexpr unsigned int mvtxLayers = 3;
+  constexpr std::array<unsigned int, mvtxLayers> mvtxStaves = {12, 16, 20};
+  constexpr std::array<double, mvtxLayers> mvtxRadius = {2.5, 3.25, 4.0};
+  constexpr unsigned int mvtxChips = 9;
+  constexpr unsigned int mvtxColumns = 1024;
+  constexpr unsigned int mvtxRows = 512;
+  constexpr double mvtxChipHalfWidth = 0.75;
+  constexpr double mvtxChipHalfLength = 1.5;
+  //@}
+
+  //!@name simplified TPC geometry, cm and ns
+  //@{
+  constexpr unsigned int tpcFirstLayer = 7;
+  constexpr unsigned int tpcLayers = 48;
+  constexpr unsigned int tpcSectors = 12;
+  constexpr unsigned int tpcSides = 2;
+  constexpr unsigned int tpcTBins = 498;
+  constexpr unsigned int tpcSubSurfaces = 12;  // per sector
+  constexpr double tpcInnerRadius = 30.;
+  constexpr double tpcLayerStep = 1.;
+  constexpr double tpcSurfaceZCenter = 52.89;  // as in ActsGeometry
+  constexpr double tpcDriftVelocity = 8.0e-3;  // ActsGeometry default
+  constexpr double tpcMaxDrift = 105.5;
+  constexpr double tpcTimeBin = tpcMaxDrift / tpcDriftVelocity / tpcTBins;
+  //@}
+
+  unsigned int tpcPads(unsigned int layer)
+  {
+    // 1152, 1536 and 2304 pads per layer in the three modules
+    const unsigned int module = (layer - tpcFirstLayer) / 16;
+    return (module == 0 ? 1152 : module == 1 ? 1536 : 2304) / tpcSectors;
+  }
+
+  double tpcRadius(unsigned int layer)
+  {
+    return tpcInnerRadius + (layer - tpcFirstLayer) * tpcLayerStep;
+  }
+
+  double tpcSectorWidth()
+  {
+    return 2. * M_PI / tpcSectors;
+  }
+
+  double tpcSectorPhiMin(unsigned int sector)
+  {
+    return -M_PI + sector * tpcSectorWidth();
+  }
+
+  double tpcSubSurfaceWidth()
+  {
+    return tpcSectorWidth() / tpcSubSurfaces;
+  }
+
+  //! index of the TPC surface in the layer surface vector, north side first
+  unsigned int tpcSurfaceIndex(unsigned int side, unsigned int sector, unsigned int subsurface)
+  {
+    const unsigned int index = sector * tpcSubSurfaces + subsurface;
+    return side == 1 ? index : tpcSectors * tpcSubSurfaces + index;
+  }
+
+  double mvtxStavePhi(unsigned int layer, unsigned int stave)
+  {
+    return 2. * M_PI * stave / mvtxStaves[layer];
+  }
+
+  double mvtxChipZ(unsigned int chip)
+  {
+    return (static_cast<double>(chip) - 0.5 * (mvtxChips - 1)) * 2. * mvtxChipHalfLength;
+  }
+
+  //! plane surface with local x along phi and local y along z, position in cm
+  Surface makeSurface(double radius, double phi, double z, double halfX, double halfY)
+  {
+    Acts::RotationMatrix3 rotation;
+    rotation.col(0) = Acts::Vector3(-std::sin(phi), std::cos(phi), 0);
+    rotation.col(1) = Acts::Vector3(0, 0, 1);
+    rotation.col(2) = Acts::Vector3(std::cos(phi), std::sin(phi), 0);
+
+    const Acts::Vector3 center = Acts::Vector3(radius * std::cos(phi), radius * std::sin(phi), z) * Acts::UnitConstants::cm;
+    const Acts::Transform3 transform(Acts::Translation3(center) * rotation);
+
+    auto bounds = std::make_shared<const Acts::RectangleBounds>(halfX * Acts::UnitConstants::cm, halfY * Acts::UnitConstants::cm);
+    return Acts::Surface::makeShared<Acts::PlaneSurface>(transform, bounds);
+  }
+}  // namespace
+
+bool SyntheticEvent::occupancyPreset(const std::string& name, Occupancy& occupancy)
+{
+  if (name == "pp")
+  {
+    occupancy = {name, 0.0005, 0.1};
+  }
+  else if (name == "auau_mb")
+  {
+    occupancy = {name, 0.015, 2.};
+  }
+  else if (name == "auau_central")
+  {
+    occupancy = {name, 0.08, 10.};
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+void SyntheticEvent::generate(const Occupancy& occupancy, unsigned int seed)
+{
+  m_occupancy = occupancy;
+  m_hitsets.clear();
+  m_nHits = 0;
+  m_nClusters = 0;
+  m_nAssocs = 0;
+  m_nTruth = 0;
+
+  generateMvtx(seed);
+  generateTpc(seed + 1);
+
+  // the mvtx keys come first, keep all hitsets sorted
+  std::sort(m_hitsets.begin(), m_hitsets.end(), [](const HitSet& lhs, const HitSet& rhs)
+            { return lhs.key < rhs.key; });
+
+  PHG4HitDefs::keytype g4hitkey = 0;
+  std::mt19937 rng(seed + 2);
+  std::bernoulli_distribution second_g4hit(0.25);
+  for (auto& hitset : m_hitsets)
+  {
+    for (const auto& [hitkey, adc] : hitset.hits)
+    {
+      hitset.truth.emplace_back(hitkey, g4hitkey++);
+      if (second_g4hit(rng))
+      {
+        hitset.truth.emplace_back(hitkey, g4hitkey++);
+      }
+    }
+    m_nHits += hitset.hits.size();
+    m_nClusters += hitset.clusters.size();
+    m_nTruth += hitset.truth.size();
+    for (const auto& cluster : hitset.clusters)
+    {
+      m_nAssocs += cluster.hits.size();
+    }
+  }
+}
+
+void SyntheticEvent::generateMvtx(unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::poisson_distribution<unsigned int> nclusters(m_occupancy.mvtxClustersPerChip);
+  std::uniform_int_distribution<unsigned int> column(0, mvtxColumns - 3);
+  std::uniform_int_distribution<unsigned int> row(0, mvtxRows - 3);
+  std::uniform_int_distribution<unsigned int> size(1, 6);
+
+  std::array<unsigned int, 9> window{};
+  for (unsigned int i = 0; i < window.size(); ++i)
+  {
+    window[i] = i;
+  }
+
+  for (unsigned int layer = 0; layer < mvtxLayers; ++layer)
+  {
+    for (unsigned int stave = 0; stave < mvtxStaves[layer]; ++stave)
+    {
+      for (unsigned int chip = 0; chip < mvtxChips; ++chip)
+      {
+        const unsigned int n = nclusters(rng);
+        if (n == 0)
+        {
+          continue;
+        }
+
+        HitSet hitset;
+        hitset.key = MvtxDefs::genHitSetKey(layer, stave, chip, 0);
+        std::map<TrkrDefs::hitkey, unsigned int> hits;
+        for (unsigned int iclus = 0; iclus < n; ++iclus)
+        {
+          // a few pixels out of a 3x3 window
+          const unsigned int col0 = column(rng);
+          const unsigned int row0 = row(rng);
+          std::shuffle(window.begin(), window.end(), rng);
+
+          Cluster cluster;
+          cluster.key = TrkrDefs::genClusKey(hitset.key, iclus);
+          const unsigned int npixels = size(rng);
+          for (unsigned int i = 0; i < npixels; ++i)
+          {
+            const auto hitkey = MvtxDefs::genHitKey(col0 + window[i] % 3, row0 + window[i] / 3);
+            cluster.hits.push_back(hitkey);
+            hits[hitkey] = 1;
+          }
+          std::sort(cluster.hits.begin(), cluster.hits.end());
+          cluster.adc = npixels;
+          cluster.localX = (row0 + 1.5) / mvtxRows * 2. * mvtxChipHalfWidth - mvtxChipHalfWidth;
+          cluster.localY = (col0 + 1.5) / mvtxColumns * 2. * mvtxChipHalfLength - mvtxChipHalfLength;
+          hitset.clusters.push_back(std::move(cluster));
+        }
+        hitset.hits.assign(hits.begin(), hits.end());
+        m_hitsets.push_back(std::move(hitset));
+      }
+    }
+  }
+}
+
+void SyntheticEvent::generateTpc(unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned int> tbin(0, tpcTBins - 5);
+  std::uniform_int_distribution<unsigned int> adc(30, 400);
+  std::uniform_int_distribution<unsigned int> size(4, 12);
+
+  // cells of a 3 pad x 5 time bin window
+  std::array<unsigned int, 15> window{};
+  for (unsigned int i = 0; i < window.size(); ++i)
+  {
+    window[i] = i;
+  }
+  // average number of hits per cluster
+  const double hitsPerCluster = 8;
+
+  for (unsigned int layer = tpcFirstLayer; layer < tpcFirstLayer + tpcLayers; ++layer)
+  {
+    const unsigned int npads = tpcPads(layer);
+    const double radius = tpcRadius(layer);
+    std::uniform_int_distribution<unsigned int> pad(0, npads - 3);
+    std::poisson_distribution<unsigned int> nclusters(m_occupancy.tpcFraction * npads * tpcTBins / hitsPerCluster);
+
+    for (unsigned int sector = 0; sector < tpcSectors; ++sector)
+    {
+      for (unsigned int side = 0; side < tpcSides; ++side)
+      {
+        const unsigned int n = nclusters(rng);
+        if (n == 0)
+        {
+          continue;
+        }
+
+        HitSet hitset;
+        hitset.key = TpcDefs::genHitSetKey(layer, sector, side);
+        std::map<TrkrDefs::hitkey, unsigned int> hits;
+        for (unsigned int iclus = 0; iclus < n; ++iclus)
+        {
+          const unsigned int pad0 = pad(rng);
+          const unsigned int tbin0 = tbin(rng);
+          std::shuffle(window.begin(), window.end(), rng);
+
+          Cluster cluster;
+          cluster.key = TpcDefs::genClusKey(layer, sector, side, iclus);
+          const unsigned int ncells = size(rng);
+          for (unsigned int i = 0; i < ncells; ++i)
+          {
+            const auto hitkey = TpcDefs::genHitKey(pad0 + window[i] % 3, tbin0 + window[i] / 3);
+            const unsigned int hitadc = adc(rng);
+            cluster.hits.push_back(hitkey);
+            cluster.adc += hitadc;
+            hits[hitkey] += hitadc;
+          }
+          std::sort(cluster.hits.begin(), cluster.hits.end());
+
+          // position from the window center
+          const double phi = (pad0 + 1.5) * tpcSectorWidth() / npads;
+          const auto subsurface = std::min<unsigned int>(phi / tpcSubSurfaceWidth(), tpcSubSurfaces - 1);
+          cluster.subsurfkey = tpcSurfaceIndex(side, sector, subsurface);
+          cluster.localX = radius * (phi - (subsurface + 0.5) * tpcSubSurfaceWidth());
+          cluster.localY = (tbin0 + 2.5) * tpcTimeBin;
+          hitset.clusters.push_back(std::move(cluster));
+        }
+        hitset.hits.assign(hits.begin(), hits.end());
+        m_hitsets.push_back(std::move(hitset));
+      }
+    }
+  }
+}
+
+void SyntheticEvent::fillSurfaceMaps(ActsSurfaceMaps& maps)
+{
+  for (unsigned int layer = 0; layer < mvtxLayers; ++layer)
+  {
+    for (unsigned int stave = 0; stave < mvtxStaves[layer]; ++stave)
+    {
+      for (unsigned int chip = 0; chip < mvtxChips; ++chip)
+      {
+        maps.m_siliconSurfaceMap[MvtxDefs::genHitSetKey(layer, stave, chip, 0)] =
+            makeSurface(mvtxRadius[layer], mvtxStavePhi(layer, stave), mvtxChipZ(chip), mvtxChipHalfWidth, mvtxChipHalfLength);
+      }
+    }
+  }
+
+  for (unsigned int layer = tpcFirstLayer; layer < tpcFirstLayer + tpcLayers; ++layer)
+  {
+    const double radius = tpcRadius(layer);
+    const double halfwidth = 0.5 * radius * tpcSubSurfaceWidth();
+    SurfaceVec& surfaces = maps.m_tpcSurfaceMap[layer];
+    surfaces.resize(tpcSides * tpcSectors * tpcSubSurfaces);
+    for (unsigned int side = 0; side < tpcSides; ++side)
+    {
+      const double z = side == 1 ? tpcSurfaceZCenter : -tpcSurfaceZCenter;
+      for (unsigned int sector = 0; sector < tpcSectors; ++sector)
+      {
+        for (unsigned int subsurface = 0; subsurface < tpcSubSurfaces; ++subsurface)
+        {
+          const double phi = tpcSectorPhiMin(sector) + (subsurface + 0.5) * tpcSubSurfaceWidth();
+          surfaces[tpcSurfaceIndex(side, sector, subsurface)] = makeSurface(radius, phi, z, halfwidth, tpcSurfaceZCenter);
+        }
+      }
+    }
+  }
+}
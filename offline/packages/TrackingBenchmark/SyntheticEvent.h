@@ -0,0 +1,96 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef TRACKINGBENCHMARK_SYNTHETICEVENT_H
+#define TRACKINGBENCHMARK_SYNTHETICEVENT_H
+
+#include <trackbase/TrkrDefs.h>
+
+#include <g4main/PHG4HitDefs.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ActsSurfaceMaps;
+
+/** Synthetic MVTX and TPC event for the trackbase benchmarks.
+ *
+ *  Hits, clusters, cluster-hit and hit-truth associations are generated at a
+ *  given occupancy with the key layout of the real detectors (layers, staves,
+ *  chips, sectors, sides, pads and time bins). The geometry is simplified:
+ *  fillSurfaceMaps() creates plain Acts surfaces matching the generated keys,
+ *  so that getGlobalPosition can be run on the clusters without a geometry file.
+ *  The event depends only on the occupancy and the seed.
+ */
+class SyntheticEvent
+{
+ public:
+  //! occupancy of the generated event
+  struct Occupancy
+  {
+    std::string name;
+
+    //! fraction of TPC pad/time bin cells with a hit
+    double tpcFraction = 0;
+
+    //! average number of clusters per MVTX chip
+    double mvtxClustersPerChip = 0;
+  };
+
+  struct Cluster
+  {
+    TrkrDefs::cluskey key = 0;
+    TrkrDefs::subsurfkey subsurfkey = 0;
+    float localX = 0;
+    float localY = 0;
+    unsigned int adc = 0;
+    std::vector<TrkrDefs::hitkey> hits;
+  };
+
+  struct HitSet
+  {
+    TrkrDefs::hitsetkey key = 0;
+
+    //! hit key and adc, sorted by hit key
+    std::vector<std::pair<TrkrDefs::hitkey, unsigned int>> hits;
+
+    //! clusters, sorted by cluster key
+    std::vector<Cluster> clusters;
+
+    //! hit key and g4hit key
+    std::vector<std::pair<TrkrDefs::hitkey, PHG4HitDefs::keytype>> truth;
+  };
+
+  //! preset occupancies: pp, auau_mb (minimum bias Au+Au), auau_central
+  static bool occupancyPreset(const std::string& name, Occupancy& occupancy);
+
+  void generate(const Occupancy& occupancy, unsigned int seed);
+
+  //! all hitsets with hits, sorted by hitset key
+  const std::vector<HitSet>& hitsets() const { return m_hitsets; }
+
+  const Occupancy& occupancy() const { return m_occupancy; }
+
+  std::size_t nHits() const { return m_nHits; }
+  std::size_t nClusters() const { return m_nClusters; }
+  std::size_t nAssocs() const { return m_nAssocs; }
+  std::size_t nTruth() const { return m_nTruth; }
+
+  //! silicon and TPC surfaces for all keys of the generated events
+  static void fillSurfaceMaps(ActsSurfaceMaps& maps);
+
+ private:
+  void generateMvtx(unsigned int seed);
+  void generateTpc(unsigned int seed);
+
+  Occupancy m_occupancy;
+  std::vector<HitSet> m_hitsets;
+
+  std::size_t m_nHits = 0;
+  std::size_t m_nClusters = 0;
+  std::size_t m_nAssocs = 0;
+  std::size_t m_nTruth = 0;
+};
+
+#endif
@@ -0,0 +1,568 @@
+// micro benchmarks of the trackbase containers, the cluster global position
+// transformation and the TPC distortion correction on synthetic events.
+// Run trackbase_benchmark --help for the options
+
+#include "BenchmarkRunner.h"
+#include "SyntheticEvent.h"
+
+#include <tpc/TpcDistortionCorrection.h>
+#include <tpc/TpcDistortionCorrectionContainer.h>
+
+#include <trackbase/ActsGeometry.h>
+#include <trackbase/TrkrClusterContainerv4.h>
+#include <trackbase/TrkrClusterHitAssocv3.h>
+#include <trackbase/TrkrClusterv5.h>
+#include <trackbase/TrkrHitSet.h>
+#include <trackbase/TrkrHitSetContainerv1.h>
+#include <trackbase/TrkrHitTruthAssocv1.h>
+#include <trackbase/TrkrHitv2.h>
+
+#include <phool/PHObject.h>
+
+#include <TBufferFile.h>
+#include <TH3.h>
+
+#include <getopt.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+  //! getG4Hits scans all associations of a hitset, do not look up every hit
+  constexpr std::size_t maxTruthLookups = 20000;
+
+  void usage(const char *name)
+  {
+    std::cout << "usage: " << name << " [options]\n"
+              << "  -o, --occupancy NAME       pp, auau_mb or auau_central (default auau_mb)\n"
+              << "      --tpc-fraction X       fraction of TPC cells with a hit, overrides the preset\n"
+              << "      --mvtx-clusters X      average number of clusters per MVTX chip, overrides the preset\n"
+              << "  -r, --repetitions N        timed repetitions per benchmark (default 10)\n"
+              << "  -s, --seed N               seed of the synthetic event (default 1)\n"
+              << "  -f, --filter STRING        run only benchmarks with names containing STRING\n"
+              << "  -j, --json FILE            json output (default trackbase_benchmark_<occupancy>.json)\n"
+              << "  -h, --help                 this message" << std::endl;
+  }
+
+  TrkrCluster *makeCluster(const SyntheticEvent::Cluster &source)
+  {
+    auto *cluster = new TrkrClusterv5;
+    cluster->setLocalX(source.localX);
+    cluster->setLocalY(source.localY);
+    cluster->setSubSurfKey(source.subsurfkey);
+    cluster->setAdc(source.adc);
+    return cluster;
+  }
+
+  void fillHitSets(const SyntheticEvent &event, TrkrHitSetContainer &container)
+  {
+    for (const auto &hitset : event.hitsets())
+    {
+      auto hitsetit = container.findOrAddHitSet(hitset.key);
+      for (const auto &[hitkey, adc] : hitset.hits)
+      {
+        auto *hit = new TrkrHitv2;
+        hit->setAdc(adc);
+        hitsetit->second->addHitSpecificKey(hitkey, hit);
+      }
+    }
+  }
+
+  void fillClusters(const SyntheticEvent &event, TrkrClusterContainer &container)
+  {
+    for (const auto &hitset : event.hitsets())
+    {
+      for (const auto &cluster : hitset.clusters)
+      {
+        container.addClusterSpecifyKey(cluster.key, makeCluster(cluster));
+      }
+    }
+  }
+
+  void fillAssocs(const SyntheticEvent &event, TrkrClusterHitAssoc &container)
+  {
+    for (const auto &hitset : event.hitsets())
+    {
+      for (const auto &cluster : hitset.clusters)
+      {
+        for (const auto &hitkey : cluster.hits)
+        {
+          container.addAssoc(cluster.key, hitkey);
+        }
+      }
+    }
+  }
+
+  void fillTruth(const SyntheticEvent &event, TrkrHitTruthAssoc &container)
+  {
+    for (const auto &hitset : event.hitsets())
+    {
+      for (const auto &[hitkey, g4hitkey] : hitset.truth)
+      {
+        container.addAssoc(hitset.key, hitkey, g4hitkey);
+      }
+    }
+  }
+
+  //! root streaming of a filled container to a TBufferFile and back into copy, as done for DST input/output
+  void benchmarkStreaming(BenchmarkRunner &runner, const std::string &prefix, const std::string &suffix, std::size_t items, PHObject &filled, PHObject &copy)
+  {
+    TBufferFile buffer(TBuffer::kWrite);
+    runner.run(prefix + "/stream_write/" + suffix, items, [&]()
+               {
+      buffer.SetWriteMode();
+      buffer.SetBufferOffset(0);
+      buffer.ResetMap();
+      filled.Streamer(buffer);
+      BenchmarkRunner::doNotOptimize(buffer.Length()); });
+
+    // the buffer has to be filled for reading even if the write benchmark was filtered out
+    buffer.SetWriteMode();
+    buffer.SetBufferOffset(0);
+    buffer.ResetMap();
+    filled.Streamer(buffer);
+    runner.run(
+        prefix + "/stream_read/" + suffix, items, [&]()
+        {
+      buffer.SetReadMode();
+      buffer.SetBufferOffset(0);
+      buffer.ResetMap();
+      copy.Streamer(buffer); },
+        [&]()
+        { copy.Reset(); });
+  }
+
+  //! smooth synthetic distortions, phi in radians
+  TH3 *makeDistortionHistogram(const std::string &name, int side, double scale)
+  {
+    const double zmin = side ? 0 : -105.5;
+    const double zmax = side ? 105.5 : 0;
+    auto *h = new TH3F(name.c_str(), name.c_str(), 36, 0, 2 * M_PI, 16, 20, 80, 40, zmin, zmax);
+    for (int iphi = 1; iphi <= h->GetNbinsX(); ++iphi)
+    {
+      for (int ir = 1; ir <= h->GetNbinsY(); ++ir)
+      {
+        for (int iz = 1; iz <= h->GetNbinsZ(); ++iz)
+        {
+          const double phi = h->GetXaxis()->GetBinCenter(iphi);
+          const double r = h->GetYaxis()->GetBinCenter(ir);
+          const double z = h->GetZaxis()->GetBinCenter(iz);
+          h->SetBinContent(iphi, ir, iz, scale * (1 + 0.1 * std::sin(3 * phi)) * (80 - r) / 50 * (1 - std::abs(z) / 105.5));
+        }
+      }
+    }
+    return h;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  std::string occupancy_name = "auau_mb";
+  double tpc_fraction = -1;
+  double mvtx_clusters_per_chip = -1;
+  unsigned int repetitions = 10;
+  unsigned int seed = 1;
+  std::string filter;
+  std::string json;
+
+  enum
+  {
+    OPT_TPC_FRACTION = 256,
+    OPT_MVTX_CLUSTERS
+  };
+  const option options[] = {
+      {"occupancy", required_argument, nullptr, 'o'},
+      {"tpc-fraction", required_argument, nullptr, OPT_TPC_FRACTION},
+      {"mvtx-clusters", required_argument, nullptr, OPT_MVTX_CLUSTERS},
+      {"repetitions", required_argument, nullptr, 'r'},
+      {"seed", required_argument, nullptr, 's'},
+      {"filter", required_argument, nullptr, 'f'},
+      {"json", required_argument, nullptr, 'j'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, 0, nullptr, 0}};
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "o:r:s:f:j:h", options, nullptr)) != -1)
+  {
+    switch (opt)
+    {
+    case 'o':
+      occupancy_name = optarg;
+      break;
+    case OPT_TPC_FRACTION:
+      tpc_fraction = std::atof(optarg);
+      break;
+    case OPT_MVTX_CLUSTERS:
+      mvtx_clusters_per_chip = std::atof(optarg);
+      break;
+    case 'r':
+      repetitions = std::atoi(optarg);
+      break;
+    case 's':
+      seed = std::atoi(optarg);
+      break;
+    case 'f':
+      filter = optarg;
+      break;
+    case 'j':
+      json = optarg;
+      break;
+    case 'h':
+      usage(argv[0]);
+      return 0;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  SyntheticEvent::Occupancy occupancy;
+  if (!SyntheticEvent::occupancyPreset(occupancy_name, occupancy))
+  {
+    std::cout << argv[0] << ": unknown occupancy " << occupancy_name << std::endl;
+    usage(argv[0]);
+    return 1;
+  }
+  if (tpc_fraction >= 0)
+  {
+    occupancy.tpcFraction = tpc_fraction;
+  }
+  if (mvtx_clusters_per_chip >= 0)
+  {
+    occupancy.mvtxClustersPerChip = mvtx_clusters_per_chip;
+  }
+  if (json.empty())
+  {
+    json = "trackbase_benchmark_" + occupancy.name + ".json";
+  }
+
+  SyntheticEvent event;
+  event.generate(occupancy, seed);
+  std::cout << "trackbase_benchmark: occupancy " << occupancy.name
+            << " hitsets: " << event.hitsets().size()
+            << " hits: " << event.nHits()
+            << " clusters: " << event.nClusters()
+            << " cluster-hit associations: " << event.nAssocs()
+            << " hit-truth associations: " << event.nTruth() << std::endl;
+
+  BenchmarkRunner runner;
+  runner.Repetitions(repetitions);
+  runner.Filter(filter);
+  const std::string &suffix = occupancy.name;
+
+  // hits
+  {
+    TrkrHitSetContainerv1 hitsets;
+    runner.run(
+        "TrkrHitSetContainerv1/fill/" + suffix, event.nHits(), [&]()
+        { fillHitSets(event, hitsets); },
+        [&]()
+        { hitsets.Reset(); });
+
+    fillHitSets(event, hitsets);
+    runner.run("TrkrHitSetContainerv1/iterate/" + suffix, event.nHits(), [&]()
+               {
+      unsigned int sum = 0;
+      const auto hitsetrange = hitsets.getHitSets();
+      for (auto hitsetitr = hitsetrange.first; hitsetitr != hitsetrange.second; ++hitsetitr)
+      {
+        const auto hitrange = hitsetitr->second->getHits();
+        for (auto hitr = hitrange.first; hitr != hitrange.second; ++hitr)
+        {
+          sum += hitr->second->getAdc();
+        }
+      }
+      BenchmarkRunner::doNotOptimize(sum); });
+
+    runner.run("TrkrHitSetContainerv1/find/" + suffix, event.nHits(), [&]()
+               {
+      unsigned int sum = 0;
+      for (const auto &hitset : event.hitsets())
+      {
+        TrkrHitSet *found = hitsets.findHitSet(hitset.key);
+        for (const auto &[hitkey, adc] : hitset.hits)
+        {
+          sum += found->getHit(hitkey)->getAdc();
+        }
+      }
+      BenchmarkRunner::doNotOptimize(sum); });
+
+    TrkrHitSetContainerv1 copy;
+    benchmarkStreaming(runner, "TrkrHitSetContainerv1", suffix, event.nHits(), hitsets, copy);
+    copy.Reset();
+
+    runner.run(
+        "TrkrHitSetContainerv1/reset/" + suffix, event.nHits(), [&]()
+        { hitsets.Reset(); },
+        [&]()
+        { hitsets.Reset(); fillHitSets(event, hitsets); });
+  }
+
+  // clusters
+  {
+    TrkrClusterContainerv4 clusters;
+    runner.run(
+        "TrkrClusterContainerv4/fill/" + suffix, event.nClusters(), [&]()
+        { fillClusters(event, clusters); },
+        [&]()
+        { clusters.Reset(); });
+
+    runner.run(
+        "TrkrClusterContainerv4/fill_bulk/" + suffix, event.nClusters(), [&]()
+        {
+      TrkrClusterContainer::HitSetKeyList keys;
+      for (const auto &hitset : event.hitsets())
+      {
+        keys.push_back(hitset.key);
+      }
+      clusters.reserveHitSets(keys);
+      for (const auto &hitset : event.hitsets())
+      {
+        std::vector<TrkrCluster *> hitset_clusters;
+        for (const auto &cluster : hitset.clusters)
+        {
+          const auto index = TrkrDefs::getClusIndex(cluster.key);
+          if (index >= hitset_clusters.size())
+          {
+            hitset_clusters.resize(index + 1, nullptr);
+          }
+          hitset_clusters[index] = makeCluster(cluster);
+        }
+        clusters.addClusters(hitset.key, std::move(hitset_clusters));
+      }
+      clusters.pruneHitSets(); },
+        [&]()
+        { clusters.Reset(); });
+
+    clusters.Reset();
+    fillClusters(event, clusters);
+    runner.run("TrkrClusterContainerv4/iterate/" + suffix, event.nClusters(), [&]()
+               {
+      unsigned int sum = 0;
+      for (const auto &hitsetkey : clusters.getHitSetKeys())
+      {
+        const auto range = clusters.getClusters(hitsetkey);
+        for (auto clusIter = range.first; clusIter != range.second; ++clusIter)
+        {
+          sum += clusIter->second->getAdc();
+        }
+      }
+      BenchmarkRunner::doNotOptimize(sum); });
+
+    runner.run("TrkrClusterContainerv4/find/" + suffix, event.nClusters(), [&]()
+               {
+      unsigned int sum = 0;
+      for (const auto &hitset : event.hitsets())
+      {
+        for (const auto &cluster : hitset.clusters)
+        {
+          sum += clusters.findCluster(cluster.key)->getAdc();
+        }
+      }
+      BenchmarkRunner::doNotOptimize(sum); });
+
+    TrkrClusterContainerv4 copy;
+    benchmarkStreaming(runner, "TrkrClusterContainerv4", suffix, event.nClusters(), clusters, copy);
+    copy.Reset();
+
+    runner.run(
+        "TrkrClusterContainerv4/reset/" + suffix, event.nClusters(), [&]()
+        { clusters.Reset(); },
+        [&]()
+        { clusters.Reset(); fillClusters(event, clusters); });
+  }
+
+  // cluster-hit associations
+  {
+    TrkrClusterHitAssocv3 assocs;
+    runner.run(
+        "TrkrClusterHitAssocv3/fill/" + suffix, event.nAssocs(), [&]()
+        { fillAssocs(event, assocs); },
+        [&]()
+        { assocs.Reset(); });
+
+    runner.run(
+        "TrkrClusterHitAssocv3/fill_bulk/" + suffix, event.nAssocs(), [&]()
+        {
+      TrkrClusterHitAssoc::HitSetKeyList keys;
+      for (const auto &hitset : event.hitsets())
+      {
+        keys.push_back(hitset.key);
+      }
+      assocs.reserveHitSets(keys);
+      for (const auto &hitset : event.hitsets())
+      {
+        TrkrClusterHitAssoc::AssocVector hitset_assocs;
+        for (const auto &cluster : hitset.clusters)
+        {
+          for (const auto &hitkey : cluster.hits)
+          {
+            hitset_assocs.emplace_back(cluster.key, hitkey);
+          }
+        }
+        assocs.addAssocs(hitset.key, std::move(hitset_assocs));
+      }
+      assocs.pruneHitSets(); },
+        [&]()
+        { assocs.Reset(); });
+
+    assocs.Reset();
+    fillAssocs(event, assocs);
+    runner.run("TrkrClusterHitAssocv3/find/" + suffix, event.nClusters(), [&]()
+               {
+      std::size_t sum = 0;
+      for (const auto &hitset : event.hitsets())
+      {
+        for (const auto &cluster : hitset.clusters)
+        {
+          const auto range = assocs.getHits(cluster.key);
+          sum += std::distance(range.first, range.second);
+        }
+      }
+      BenchmarkRunner::doNotOptimize(sum); });
+
+    TrkrClusterHitAssocv3 copy;
+    benchmarkStreaming(runner, "TrkrClusterHitAssocv3", suffix, event.nAssocs(), assocs, copy);
+
+    runner.run(
+        "TrkrClusterHitAssocv3/reset/" + suffix, event.nAssocs(), [&]()
+        { assocs.Reset(); },
+        [&]()
+        { assocs.Reset(); fillAssocs(event, assocs); });
+  }
+
+  // hit-truth associations
+  {
+    TrkrHitTruthAssocv1 truth;
+    runner.run(
+        "TrkrHitTruthAssocv1/fill/" + suffix, event.nTruth(), [&]()
+        { fillTruth(event, truth); },
+        [&]()
+        { truth.Reset(); });
+
+    truth.Reset();
+    fillTruth(event, truth);
+    const std::size_t stride = event.nHits() / maxTruthLookups + 1;
+    const std::size_t lookups = (event.nHits() + stride - 1) / stride;
+    runner.run("TrkrHitTruthAssocv1/find/" + suffix, lookups, [&]()
+               {
+      std::size_t sum = 0;
+      std::size_t ihit = 0;
+      TrkrHitTruthAssoc::MMap g4hits;
+      for (const auto &hitset : event.hitsets())
+      {
+        for (const auto &[hitkey, adc] : hitset.hits)
+        {
+          if (ihit++ % stride)
+          {
+            continue;
+          }
+          g4hits.clear();
+          truth.getG4Hits(hitset.key, hitkey, g4hits);
+          sum += g4hits.size();
+        }
+      }
+      BenchmarkRunner::doNotOptimize(sum); });
+
+    TrkrHitTruthAssocv1 copy;
+    benchmarkStreaming(runner, "TrkrHitTruthAssocv1", suffix, event.nTruth(), truth, copy);
+
+    runner.run(
+        "TrkrHitTruthAssocv1/reset/" + suffix, event.nTruth(), [&]()
+        { truth.Reset(); },
+        [&]()
+        { truth.Reset(); fillTruth(event, truth); });
+  }
+
+  // global positions and distortion corrections
+  {
+    ActsGeometry geometry;
+    SyntheticEvent::fillSurfaceMaps(geometry.maps());
+
+    std::vector<std::pair<TrkrDefs::cluskey, std::unique_ptr<TrkrCluster>>> mvtx_clusters;
+    std::vector<std::pair<TrkrDefs::cluskey, std::unique_ptr<TrkrCluster>>> tpc_clusters;
+    for (const auto &hitset : event.hitsets())
+    {
+      auto &clusters = TrkrDefs::getTrkrId(hitset.key) == TrkrDefs::tpcId ? tpc_clusters : mvtx_clusters;
+      for (const auto &cluster : hitset.clusters)
+      {
+        clusters.emplace_back(cluster.key, makeCluster(cluster));
+      }
+    }
+
+    const auto &context = ActsGeometry::getIdealGeoContext();
+    const auto benchmarkGlobalPosition = [&](const std::string &name, const std::vector<std::pair<TrkrDefs::cluskey, std::unique_ptr<TrkrCluster>>> &clusters)
+    {
+      runner.run("ActsGeometry/getGlobalPosition_" + name + "/" + suffix, clusters.size(), [&]()
+                 {
+        double sum = 0;
+        for (const auto &[cluskey, cluster] : clusters)
+        {
+          sum += geometry.getGlobalPosition(cluskey, cluster.get(), context).z();
+        }
+        BenchmarkRunner::doNotOptimize(sum); });
+    };
+    benchmarkGlobalPosition("mvtx", mvtx_clusters);
+    benchmarkGlobalPosition("tpc", tpc_clusters);
+
+    std::vector<Acts::Vector3> positions;
+    positions.reserve(tpc_clusters.size());
+    for (const auto &[cluskey, cluster] : tpc_clusters)
+    {
+      positions.push_back(geometry.getGlobalPosition(cluskey, cluster.get(), context));
+    }
+
+    TH1::AddDirectory(false);
+    TpcDistortionCorrectionContainer dcc;
+    for (int side = 0; side < 2; ++side)
+    {
+      const std::string name = "_" + std::to_string(side);
+      dcc.m_hDPint[side] = makeDistortionHistogram("hIntDistortionP" + name, side, 0.002);
+      dcc.m_hDRint[side] = makeDistortionHistogram("hIntDistortionR" + name, side, 0.1);
+      dcc.m_hDZint[side] = makeDistortionHistogram("hIntDistortionZ" + name, side, 0.05);
+    }
+
+    TpcDistortionCorrection correction;
+    runner.run("TpcDistortionCorrection/get_corrected_position/" + suffix, positions.size(), [&]()
+               {
+      double sum = 0;
+      for (const auto &position : positions)
+      {
+        sum += correction.get_corrected_position(position, &dcc).z();
+      }
+      BenchmarkRunner::doNotOptimize(sum); });
+
+    for (int side = 0; side < 2; ++side)
+    {
+      delete dcc.m_hDPint[side];
+      delete dcc.m_hDRint[side];
+      delete dcc.m_hDZint[side];
+    }
+  }
+
+  std::cout << std::endl;
+  runner.print();
+
+  const std::map<std::string, std::string> context = {
+      {"occupancy", occupancy.name},
+      {"tpc_fraction", std::to_string(occupancy.tpcFraction)},
+      {"mvtx_clusters_per_chip", std::to_string(occupancy.mvtxClustersPerChip)},
+      {"seed", std::to_string(seed)},
+      {"hitsets", std::to_string(event.hitsets().size())},
+      {"hits", std::to_string(event.nHits())},
+      {"clusters", std::to_string(event.nClusters())},
+      {"cluster_hit_assocs", std::to_string(event.nAssocs())},
+      {"hit_truth_assocs", std::to_string(event.nTruth())}};
+  if (!runner.writeJson(json, context))
+  {
+    return 1;
+  }
+  std::cout << "trackbase_benchmark: results written to " << json << std::endl;
+  return 0;
+}
@@ -1,6 +1,7 @@
 
 #include "TrackResiduals.h"
 
+#include <trackbase/ActsGeometry.h>
 #include <trackbase/ClusterErrorPara.h>
 #include <trackbase/InttDefs.h>
 #include <trackbase/MvtxDefs.h>
@@ -62,20 +63,6 @@ namespace
   {
     return std::sqrt(square(x) + square(y));
   }
-
-  std::vector<TrkrDefs::cluskey> get_cluster_keys(SvtxTrack* track)
-  {
-    std::vector<TrkrDefs::cluskey> out;
-    for (const auto& seed : {track->get_silicon_seed(), track->get_tpc_seed()})
-    {
-      if (seed)
-      {
-        std::copy(seed->begin_cluster_keys(), seed->end_cluster_keys(), std::back_inserter(out));
-      }
-    }
-
-    return out;
-  }
 }  // namespace
 
 //____________________________________________________________________________..
@@ -292,8 +279,9 @@ int TrackResiduals::process_event(PHCompositeNode* topNode)
 float TrackResiduals::calc_dedx(TrackSeed* tpcseed, TrkrClusterContainer* clustermap, PHG4TpcCylinderGeomContainer* tpcGeom)
 {
   std::vector<TrkrDefs::cluskey> clusterKeys;
-  clusterKeys.insert(clusterKeys.end(), tpcseed->begin_cluster_keys(),
-                     tpcseed->end_cluster_keys());
+  clusterKeys.reserve(tpcseed->size_cluster_keys());
+  TrackAnalysisUtils::for_each_cluster_key(tpcseed, [&clusterKeys](TrkrDefs::cluskey key)
+                                           { clusterKeys.push_back(key); });
 
   std::vector<float> dedxlist;
   for (unsigned long cluster_key : clusterKeys)
@@ -422,9 +410,8 @@ void TrackResiduals::fillFailedSeedTree(PHCompositeNode* topNode, std::set<unsig
       {
         continue;
       }
-      for (auto it = tseed->begin_cluster_keys(); it != tseed->end_cluster_keys(); ++it)
+      TrackAnalysisUtils::for_each_cluster_key(tseed, [&](TrkrDefs::cluskey ckey)
       {
-        auto ckey = *it;
         auto cluster = clustermap->findCluster(ckey);
         const Acts::Vector3 global = m_globalPositionWrapper.getGlobalPositionDistortionCorrected(ckey, cluster, crossing );
         const auto local = geometry->getLocalCoords(ckey, cluster);
@@ -456,7 +443,7 @@ void TrackResiduals::fillFailedSeedTree(PHCompositeNode* topNode, std::set<unsig
         {
           m_nmms++;
         }
-      }
+      });
     }
     m_failedfits->Fill();
   }
@@ -487,7 +474,7 @@ void TrackResiduals::fillVertexTree(PHCompositeNode* topNode)
         {
           continue;
         }
-        for (const auto& ckey : get_cluster_keys(track))
+        for (const auto& ckey : TrackAnalysisUtils::get_cluster_keys(track))
         {
           TrkrCluster* cluster = clustermap->findCluster(ckey);
 
@@ -1014,21 +1001,16 @@ void TrackResiduals::fillClusterBranchesKF(TrkrDefs::cluskey ckey, SvtxTrack* tr
     break;
   }
 
-  SvtxTrackState* state = nullptr;
+  const SvtxTrackState* state = nullptr;
 
   // the track states from the Acts fit are fitted to fully corrected clusters, and are on the surface
-  for (auto state_iter = track->begin_states();
-       state_iter != track->end_states();
-       ++state_iter)
+  TrackAnalysisUtils::for_each_state(track, [&state, ckey](const SvtxTrackState* tstate)
   {
-    SvtxTrackState* tstate = state_iter->second;
-    auto stateckey = tstate->get_cluskey();
-    if (stateckey == ckey)
+    if (!state && tstate->get_cluskey() == ckey)
     {
       state = tstate;
-      break;
     }
-  }
+  });
 
   if (!state)
   {
@@ -1135,10 +1117,10 @@ void TrackResiduals::fillClusterBranchesKF(TrkrDefs::cluskey ckey, SvtxTrack* tr
   float mbeta = -asin(misrot(0, 1));
   float malpha = atan2(misrot(1, 1), misrot(2, 1));
 
-  //! Switch to get ideal transforms
-  alignmentTransformationContainer::use_alignment = false;
-  auto idealcenter = surf->center(geometry->geometry().getGeoContext());
-  auto idealnorm = -1 * surf->normal(geometry->geometry().getGeoContext());
+  //! ideal transforms
+  const auto& idealContext = ActsGeometry::getIdealGeoContext();
+  auto idealcenter = surf->center(idealContext);
+  auto idealnorm = -1 * surf->normal(idealContext);
 
   // replace the corrected moved cluster local position with the readout position from ideal geometry for now
   // This allows us to see the distortion corrections by subtracting this uncorrected position
@@ -1146,8 +1128,8 @@ void TrackResiduals::fillClusterBranchesKF(TrkrDefs::cluskey ckey, SvtxTrack* tr
   //  Acts::Vector3 ideal_local(loc.x(), loc.y(), 0.0);
   auto nominal_loc = geometry->getLocalCoords(ckey, cluster);
   Acts::Vector3 ideal_local(nominal_loc.x(), nominal_loc.y(), 0.0);
-  Acts::Vector3 ideal_glob = surf->transform(geometry->geometry().getGeoContext()) * (ideal_local * Acts::UnitConstants::cm);
-  auto idealrot = surf->transform(geometry->geometry().getGeoContext()).rotation();
+  Acts::Vector3 ideal_glob = surf->transform(idealContext) * (ideal_local * Acts::UnitConstants::cm);
+  auto idealrot = surf->transform(idealContext).rotation();
 
   //! These calculations are taken from the wikipedia page for Euler angles,
   //! under the Tait-Bryan angle explanation. Formulas for the angles
@@ -1161,8 +1143,6 @@ void TrackResiduals::fillClusterBranchesKF(TrkrDefs::cluskey ckey, SvtxTrack* tr
   float ibeta = -asin(idealrot(0, 1));
   float ialpha = atan2(idealrot(1, 1), idealrot(2, 1));
 
-  alignmentTransformationContainer::use_alignment = true;
-
   idealcenter /= Acts::UnitConstants::cm;
   misaligncenter /= Acts::UnitConstants::cm;
   ideal_glob /= Acts::UnitConstants::cm;
@@ -1388,13 +1368,13 @@ void TrackResiduals::fillClusterBranchesSeeds(TrkrDefs::cluskey ckey,  // SvtxTr
   float mbeta = -asin(misrot(0, 1));
   float malpha = atan2(misrot(1, 1), misrot(2, 1));
 
-  //! Switch to get ideal transforms
-  alignmentTransformationContainer::use_alignment = false;
-  auto idealcenter = surf->center(geometry->geometry().getGeoContext());
-  auto idealnorm = -1 * surf->normal(geometry->geometry().getGeoContext());
+  //! ideal transforms
+  const auto& idealContext = ActsGeometry::getIdealGeoContext();
+  auto idealcenter = surf->center(idealContext);
+  auto idealnorm = -1 * surf->normal(idealContext);
   Acts::Vector3 ideal_local(loc.x(), loc.y(), 0.0);
-  Acts::Vector3 ideal_glob = surf->transform(geometry->geometry().getGeoContext()) * (ideal_local * Acts::UnitConstants::cm);
-  auto idealrot = surf->transform(geometry->geometry().getGeoContext()).rotation();
+  Acts::Vector3 ideal_glob = surf->transform(idealContext) * (ideal_local * Acts::UnitConstants::cm);
+  auto idealrot = surf->transform(idealContext).rotation();
 
   //! These calculations are taken from the wikipedia page for Euler angles,
   //! under the Tait-Bryan angle explanation. Formulas for the angles
@@ -1408,8 +1388,6 @@ void TrackResiduals::fillClusterBranchesSeeds(TrkrDefs::cluskey ckey,  // SvtxTr
   float ibeta = -asin(idealrot(0, 1));
   float ialpha = atan2(idealrot(1, 1), idealrot(2, 1));
 
-  alignmentTransformationContainer::use_alignment = true;
-
   idealcenter /= Acts::UnitConstants::cm;
   misaligncenter /= Acts::UnitConstants::cm;
   ideal_glob /= Acts::UnitConstants::cm;
@@ -1961,7 +1939,7 @@ void TrackResiduals::fillResidualTreeKF(PHCompositeNode* topNode)
 
     // get the fully corrected cluster global positions
     std::vector<std::pair<TrkrDefs::cluskey, Acts::Vector3>> global_raw;
-    for (const auto& ckey : get_cluster_keys(track))
+    for (const auto& ckey : TrackAnalysisUtils::get_cluster_keys(track))
     {
       auto cluster = clustermap->findCluster(ckey);
 
@@ -1976,7 +1954,7 @@ void TrackResiduals::fillResidualTreeKF(PHCompositeNode* topNode)
 
     if (!m_doAlignment)
     {
-      for (const auto& ckey : get_cluster_keys(track))
+      for (const auto& ckey : TrackAnalysisUtils::get_cluster_keys(track))
       {
         fillClusterBranchesKF(ckey, track, global_raw, topNode);
       }
@@ -2313,7 +2291,7 @@ void TrackResiduals::fillResidualTreeSeeds(PHCompositeNode* topNode)
     std::vector<std::pair<TrkrDefs::cluskey, Acts::Vector3>> global_raw;
     float minR = std::numeric_limits<float>::max();
     float maxR = 0;
-    for (const auto& ckey : get_cluster_keys(track))
+    for (const auto& ckey : TrackAnalysisUtils::get_cluster_keys(track))
     {
       auto cluster = clustermap->findCluster(ckey);
 
@@ -2337,7 +2315,7 @@ void TrackResiduals::fillResidualTreeSeeds(PHCompositeNode* topNode)
     if (!m_doAlignment)
     {
       std::vector<TrkrDefs::cluskey> keys;
-      for (const auto& ckey : get_cluster_keys(track))
+      for (const auto& ckey : TrackAnalysisUtils::get_cluster_keys(track))
       {
         keys.push_back(ckey);
       }
@@ -2352,7 +2330,7 @@ void TrackResiduals::fillResidualTreeSeeds(PHCompositeNode* topNode)
         circleFitClusters(keys, clustermap, m_crossing);
       }
 
-      for (const auto& ckey : get_cluster_keys(track))
+      for (const auto& ckey : TrackAnalysisUtils::get_cluster_keys(track))
       {
         fillClusterBranchesSeeds(ckey, global_raw, topNode);
       }
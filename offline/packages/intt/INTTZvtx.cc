@@ -14,6 +14,8 @@
 #include <boost/format.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <numeric>
@@ -64,11 +66,6 @@ INTTZvtx::INTTZvtx(const std::string& runType,
   N_comb_phi.clear();
   // eff_N_comb.clear(); eff_z_mid.clear(); eff_N_comb_e.clear(); eff_z_range.clear(); // note : eff_sig
 
-  inner_clu_phi_map.clear();
-  outer_clu_phi_map.clear();
-  inner_clu_phi_map = std::vector<std::vector<std::pair<bool, clu_info>>>(360);
-  outer_clu_phi_map = std::vector<std::vector<std::pair<bool, clu_info>>>(360);
-
   ///////////
   // ntuple variables
   out_eID = 0;
@@ -230,30 +227,33 @@ void INTTZvtx::Init()
 
 void INTTZvtx::InitHist()
 {
-  // histos for z-vertex calculation
-  evt_possible_z = new TH1F("evt_possible_z", "evt_possible_z", 50, evt_possible_z_range.first, evt_possible_z_range.second);
-  evt_possible_z->SetLineWidth(1);
-  evt_possible_z->GetXaxis()->SetTitle("Z [mm]");
-  evt_possible_z->GetYaxis()->SetTitle("Entry");
-
-  int N = 1200;        // note : N bins for each side, regardless the bin at zero
-  double width = 0.5;  // note : bin width with the unit [mm]
-  line_breakdown_hist = new TH1F("line_breakdown_hist", "line_breakdown_hist", 2 * N + 1, -1 * (width * N + width / 2.), width * N + width / 2.);
-  line_breakdown_hist->SetLineWidth(1);
-  line_breakdown_hist->GetXaxis()->SetTitle("Z [mm]");
-  line_breakdown_hist->GetYaxis()->SetTitle("Entry");
+  // note : the z-vertex is calculated on the arrays of InttZvtxEngine
   if (print_message_opt == true)
   {
+    const InttZvtxEngine::Profile& line_profile = m_engine.GetLineProfile();
     std::cout << "class INTTZvtx, Line breakdown hist, range : "
-              << line_breakdown_hist->GetXaxis()->GetXmin() << " "
-              << line_breakdown_hist->GetXaxis()->GetXmax() << " "
-              << line_breakdown_hist->GetBinWidth(1) << std::endl;
+              << line_profile.xmin << " "
+              << line_profile.GetXmax() << " "
+              << line_profile.binwidth << std::endl;
   }
 
   // QA histograms
   // event by event
   if (draw_event_display)
   {
+    // histos of the z-vertex calculation, filled from the engine
+    evt_possible_z = new TH1F("evt_possible_z", "evt_possible_z", 50, evt_possible_z_range.first, evt_possible_z_range.second);
+    evt_possible_z->SetLineWidth(1);
+    evt_possible_z->GetXaxis()->SetTitle("Z [mm]");
+    evt_possible_z->GetYaxis()->SetTitle("Entry");
+
+    int N = 1200;        // note : N bins for each side, regardless the bin at zero
+    double width = 0.5;  // note : bin width with the unit [mm]
+    line_breakdown_hist = new TH1F("line_breakdown_hist", "line_breakdown_hist", 2 * N + 1, -1 * (width * N + width / 2.), width * N + width / 2.);
+    line_breakdown_hist->SetLineWidth(1);
+    line_breakdown_hist->GetXaxis()->SetTitle("Z [mm]");
+    line_breakdown_hist->GetYaxis()->SetTitle("Entry");
+
     evt_select_track_phi = new TH1F("evt_select_track_phi", "evt_select_track_phi", 361, 0, 361);
     evt_select_track_phi->GetXaxis()->SetTitle("Track phi [degree]");
     evt_select_track_phi->GetYaxis()->SetTitle("Entry");
@@ -689,28 +689,17 @@ bool INTTZvtx::ProcessEvt(
     return false;
   }
 
-  //--std::cout<<"--1--"<<std::endl;
   //-----------------
   // cluster pair
-  // note : put the cluster into the phi map, the first bool is for the cluster usage.
-  // note : false means the cluster is not used
-  double Clus_InnerPhi_Offset = 0;  // note : the vertex in XY is not at zero, so the "offset" moves the offset back to the orign which is (0,0)
-  double Clus_OuterPhi_Offset = 0;  // note : the vertex in XY is not at zero, so the "offset" moves the offset back to the orign which is (0,0)
+  m_engine.Reset();
+  m_engine.SetBeamOrigin(beam_origin.first, beam_origin.second);
+  m_engine.SetPhiCut(phi_diff_cut);
+  m_engine.SetDCACut(DCA_cut);
+  m_engine.SetZRange(evt_possible_z_range);
+
   for (auto& inner_i : temp_sPH_inner_nocolumn_vec)
   {
-    Clus_InnerPhi_Offset = (inner_i.y - beam_origin.second < 0)
-                               ? atan2(inner_i.y - beam_origin.second,
-                                       inner_i.x - beam_origin.first) *
-                                         (180. / TMath::Pi()) +
-                                     360
-                               : atan2(inner_i.y - beam_origin.second,
-                                       inner_i.x - beam_origin.first) *
-                                     (180. / TMath::Pi());
-
-    // std::cout<<"inner clu phi : "<<Clus_InnerPhi_Offset<<" origin: "<< temp_sPH_inner_nocolumn_vec[inner_i].phi <<std::endl;
-    // std::cout<<" ("<<Clus_InnerPhi_Offset<<", "<< temp_sPH_inner_nocolumn_vec[inner_i].phi<<")" <<std::endl;
-    //
-    inner_clu_phi_map[int(Clus_InnerPhi_Offset)].push_back({false, inner_i});
+    m_engine.AddInnerCluster(inner_i.x, inner_i.y, inner_i.z);
 
     if (inner_i.z > 0)
     {
@@ -721,19 +710,9 @@ bool INTTZvtx::ProcessEvt(
       out_N_cluster_south += 1;
     }
   }
-  //--std::cout<<"--2--"<<std::endl;
   for (auto& outer_i : temp_sPH_outer_nocolumn_vec)
   {
-    Clus_OuterPhi_Offset = (outer_i.y - beam_origin.second < 0)
-                               ? atan2(outer_i.y - beam_origin.second,
-                                       outer_i.x - beam_origin.first) *
-                                         (180. / TMath::Pi()) +
-                                     360
-                               : atan2(outer_i.y - beam_origin.second,
-                                       outer_i.x - beam_origin.first) *
-                                     (180. / TMath::Pi());
-
-    outer_clu_phi_map[int(Clus_OuterPhi_Offset)].push_back({false, outer_i});
+    m_engine.AddOuterCluster(outer_i.x, outer_i.y, outer_i.z);
 
     if (outer_i.z > 0)
     {
@@ -745,120 +724,60 @@ bool INTTZvtx::ProcessEvt(
     }
   }
 
-  //--std::cout<<"--3--"<<std::endl;
   ////
   // tracklet reconstruction from inner and outer clusters
-  int good_pair_count = 0;
+  // note : the clusters are sorted in phi, only the outer clusters within phi_diff_cut of each inner cluster are visited
+  m_engine.MakeTracklets();
 
-  for (int inner_phi_i = 0; inner_phi_i < 360; inner_phi_i++)  // note : each phi cell (1 degree)
+  for (const auto& tracklet : m_engine.GetTracklets())
   {
-    // note : N cluster in this phi cell
-    for (unsigned int inner_phi_clu_i = 0; inner_phi_clu_i < inner_clu_phi_map[inner_phi_i].size(); inner_phi_clu_i++)
-    {
-      if (inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].first == true)
-      {
-        continue;
-      }
-
-      Clus_InnerPhi_Offset = (inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y - beam_origin.second < 0)
-                                 ? atan2(inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y - beam_origin.second,
-                                         inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.x - beam_origin.first) *
-                                           (180. / TMath::Pi()) +
-                                       360
-                                 : atan2(inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y - beam_origin.second,
-                                         inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.x - beam_origin.first) *
-                                       (180. / TMath::Pi());
-
-      // todo: change the outer phi scan range
-      // note : the outer phi index, -1, 0, 1
-      for (int scan_i = -1; scan_i < 2; scan_i++)
-      {
-        int true_scan_i = ((inner_phi_i + scan_i) < 0)     ? 360 + (inner_phi_i + scan_i)
-                          : ((inner_phi_i + scan_i) > 359) ? (inner_phi_i + scan_i) - 360
-                                                           : inner_phi_i + scan_i;
+    N_comb.push_back(good_comb_id);
+    N_comb_e.push_back(0);
+    N_comb_phi.push_back(tracklet.phi);
+    z_mid.push_back(tracklet.zmid);
+    z_range.push_back(tracklet.zwidth);
 
-        // note : N clusters in that outer phi cell
-        for (unsigned int outer_phi_clu_i = 0; outer_phi_clu_i < outer_clu_phi_map[true_scan_i].size(); outer_phi_clu_i++)
-        {
-          if (outer_clu_phi_map[true_scan_i][outer_phi_clu_i].first == true)
-          {
-            continue;
-          }
-
-          Clus_OuterPhi_Offset = (outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y - beam_origin.second < 0)
-                                     ? atan2(outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y - beam_origin.second,
-                                             outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.x - beam_origin.first) *
-                                               (180. / TMath::Pi()) +
-                                           360
-                                     : atan2(outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y - beam_origin.second,
-                                             outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.x - beam_origin.first) *
-                                           (180. / TMath::Pi());
+    good_comb_id += 1;
+  }
 
-          double delta_phi = get_delta_phi(Clus_InnerPhi_Offset, Clus_OuterPhi_Offset);
+  if (m_enable_qa)
+  {
+    m_engine.ForEachPair(phi_diff_cut, [this](const InttZvtxEngine::Cluster& inner, const InttZvtxEngine::Cluster& outer, double /*delta_phi*/)
+                         {
+      double DCA_sign = InttZvtxEngine::calculateAngleBetweenVectors(outer.x, outer.y, inner.x, inner.y, beam_origin.first, beam_origin.second);
+      dca_inner_phi->Fill(inner.phi, DCA_sign);
+    });
+  }
 
-          if (draw_event_display)
-          {
-            evt_phi_diff_1D->Fill(delta_phi);                                       // QA
-            evt_phi_diff_inner_phi->Fill(Clus_InnerPhi_Offset, delta_phi);          // QA
-            evt_inner_outer_phi->Fill(Clus_InnerPhi_Offset, Clus_OuterPhi_Offset);  // QA
+  if (draw_event_display)
+  {
+    // note : all the pairs from neighbouring 1 degree phi cells, before the phi cut
+    m_engine.ForEachPair(2., [this](const InttZvtxEngine::Cluster& inner, const InttZvtxEngine::Cluster& outer, double delta_phi)
+                         {
+      int cell_diff = std::abs(int(inner.phi) - int(outer.phi));
+      if (cell_diff > 1 && cell_diff != 359)
+      {
+        return;
+      }
+      evt_phi_diff_1D->Fill(delta_phi);                   // QA
+      evt_phi_diff_inner_phi->Fill(inner.phi, delta_phi);  // QA
+      evt_inner_outer_phi->Fill(inner.phi, outer.phi);     // QA
 
-            phi_diff_inner_phi->Fill(Clus_InnerPhi_Offset, delta_phi);  // QA
-          }
+      phi_diff_inner_phi->Fill(inner.phi, delta_phi);  // QA
+    });
 
-          if (fabs(delta_phi) < phi_diff_cut)
-          {
-            double DCA_sign = calculateAngleBetweenVectors(
-                outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.x, outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y,
-                inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.x, inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y,
-                beam_origin.first, beam_origin.second);
-            if (m_enable_qa) {
-              dca_inner_phi->Fill(Clus_InnerPhi_Offset, DCA_sign);
-            }
-
-            if (DCA_cut.first < DCA_sign && DCA_sign < DCA_cut.second)
-            {
-              good_pair_count += 1;
-              // used_outer_check[outer_i] = 1; //note : this outer cluster was already used!
-
-              // note : we basically transform the coordinate from cartesian to cylinder
-              // note : we should set the offset first, otherwise it provides the bias
-              // todo : which point should be used, DCA point or vertex xy ? Has to be studied
-              std::pair<double, double> z_range_info = Get_possible_zvtx(
-                  0.,  // get_radius(beam_origin.first,beam_origin.second),
-                  {get_radius(inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.x - beam_origin.first,
-                              inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.y - beam_origin.second),
-                   inner_clu_phi_map[inner_phi_i][inner_phi_clu_i].second.z},  // note : unsign radius
-                  {get_radius(outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.x - beam_origin.first,
-                              outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.y - beam_origin.second),
-                   outer_clu_phi_map[true_scan_i][outer_phi_clu_i].second.z}  // note : unsign radius
-              );
-
-              // note : try to remove some crazy background candidates. Can be a todo
-              if (evt_possible_z_range.first < z_range_info.first && z_range_info.first < evt_possible_z_range.second)
-              {
-                N_comb.push_back(good_comb_id);
-                N_comb_e.push_back(0);
-                N_comb_phi.push_back(get_track_phi(Clus_InnerPhi_Offset, delta_phi));
-                z_mid.push_back(z_range_info.first);
-                z_range.push_back(z_range_info.second);
-
-                evt_possible_z->Fill(z_range_info.first);  // used for calculation
-
-                // note : fill the line_breakdwon histogram as well as a vector for the width determination
-                line_breakdown(line_breakdown_hist,  // used for calculation
-                               {z_range_info.first - z_range_info.second,
-                                z_range_info.first + z_range_info.second});
-
-                good_comb_id += 1;
-              }
-            }
-          }
-        }
-      }  // note : end of outer clu loop
+    // note : the z histograms are only needed for the display, copy the engine profiles
+    const InttZvtxEngine::Profile& coarse_profile = m_engine.GetCoarseProfile();
+    for (int i = 0; i < coarse_profile.nbins + 2; i++)
+    {
+      evt_possible_z->SetBinContent(i, coarse_profile.content[i]);
     }
-
-  }  // note : end of inner clu loop
-  //--std::cout<<"--4--"<<std::endl;
+    const InttZvtxEngine::Profile& line_profile = m_engine.GetLineProfile();
+    for (int i = 0; i < line_profile.nbins + 2; i++)
+    {
+      line_breakdown_hist->SetBinContent(i, line_profile.content[i]);
+    }
+  }
 
   // if (event_i == 906) {
   //     for (int hist_i = 0; hist_i < line_breakdown_hist->GetNbinsX(); hist_i++){
@@ -880,97 +799,81 @@ bool INTTZvtx::ProcessEvt(
   if (N_comb.size() > zvtx_cal_require)
   {
     //--std::cout<<"--4 1--"<<std::endl;
-    N_group_info = find_Ngroup(evt_possible_z);
-    N_group_info_detail = find_Ngroup(line_breakdown_hist);
-
-    // note : first fit is for the width, so apply the constraints on the Gaussian offset
-    gaus_fit->SetParameters(line_breakdown_hist->GetBinContent(line_breakdown_hist->GetMaximumBin()),
-                            line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()),
-                            40,
-                            0);
-    gaus_fit->SetParLimits(0, 0, 100000);  // note : size
-    gaus_fit->SetParLimits(2, 5, 10000);   // note : Width
-    gaus_fit->SetParLimits(3, 0, 10000);   // note : offset
-    // todo : try to use single gaus to fit the distribution, and try to only fit the peak region (peak - 100 mm + peak + 100 mm)
-    line_breakdown_hist->Fit(gaus_fit, "NQ", "",
-                             line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()) - 90,
-                             line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()) + 90);
+    const InttZvtxEngine::Profile& line_profile = m_engine.GetLineProfile();
+    N_group_info = InttZvtxEngine::find_Ngroup(m_engine.GetCoarseProfile());
+    N_group_info_detail = InttZvtxEngine::find_Ngroup(line_profile);
+
+    // note : peak of the line breakdown profile. Sliding window seed, then mean shift within +- 90 mm
+    // note : on top of the window minimum (the offset). The width is from the second moment in the window
+    InttZvtxEngine::Peak peak = m_engine.FindPeak();
+
     //----------------
     // 1st try z-vertex
-    tight_offset_peak = gaus_fit->GetParameter(1);
-    tight_offset_width = fabs(gaus_fit->GetParameter(2));
+    tight_offset_peak = peak.mean;
+    tight_offset_width = peak.sigma;
 
     double final_selection_widthU = (tight_offset_peak + tight_offset_width);
     double final_selection_widthD = (tight_offset_peak - tight_offset_width);
 
-    double gaus_fit_offset = gaus_fit->GetParameter(3);
-    gaus_fit->SetParameter(3, 0);  // note : in order to calculate the integration
-    double gaus_ratio = (fabs(gaus_fit->GetParameter(0)) / gaus_fit->Integral(-600, 600)) / fabs(gaus_fit->GetParameter(2));
-    gaus_fit->SetParameter(3, gaus_fit_offset);  // note : put the offset back to the function
-
-    // note : second fit is for the peak position, therefore, loose the constraints on the Gaussian offset
-    gaus_fit->SetParameters(line_breakdown_hist->GetBinContent(line_breakdown_hist->GetMaximumBin()),
-                            line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()),
-                            40,
-                            0);
-
-    gaus_fit->SetParLimits(0, 0, 100000);    // note : size
-    gaus_fit->SetParLimits(2, 5, 10000);     // note : Width
-    gaus_fit->SetParLimits(3, -200, 10000);  // note : offset
-    // todo : try to use single gaus to fit the distribution, and try to only fit the peak region (peak - 100 mm + peak + 100 mm)
-    line_breakdown_hist->Fit(gaus_fit, "NQ", "",
-                             line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()) - 90,
-                             line_breakdown_hist->GetBinCenter(line_breakdown_hist->GetMaximumBin()) + 90);
+    double gaus_fit_offset = peak.offset;
+    double gaus_ratio = 1. / (std::sqrt(2. * M_PI) * peak.sigma * peak.sigma);  // note : (size / integral) / width
+    double peak_chi2ndf = peak.chi2ndf;
 
-    // line_breakdown_hist -> Fit(gaus_fit, "NQ", "", N_group_info_detail[2]-10, N_group_info_detail[3]+10);
+    // note : only for drawing
+    gaus_fit->SetParameters(peak.height, peak.mean, peak.sigma, peak.offset);
 
     //--std::cout<<"--5--"<<std::endl;
     //----------------
     // final z-vertex
-    loose_offset_peak = gaus_fit->GetParameter(1);
-    loose_offset_peakE = gaus_fit->GetParError(1);
+    loose_offset_peak = peak.mean;
+    loose_offset_peakE = peak.meanE;
 
     // additional QA below
     // note : eff sigma method, relatively sensitive to the background
     // note : use z-mid to do the effi_sig, because that line_breakdown takes too long time
-    temp_event_zvtx_info = InttVertexUtil::sigmaEff_avg(z_mid, Integrate_portion);
-
+    // note : not used for the z-vertex, so only done for the QA and the event display
     std::vector<double> eff_N_comb;    // QA
     std::vector<double> eff_N_comb_e;  // QA
     std::vector<double> eff_z_mid;     // QA
     std::vector<double> eff_z_range;   // QA note : eff_sig
-    for (unsigned int track_i = 0; track_i < N_comb.size(); track_i++)
+    double width_density_par = -1;     // QA
+    if (m_enable_qa || draw_event_display)
     {
-      if (N_group_info[2] <= z_mid[track_i] && z_mid[track_i] <= N_group_info[3])
-      {
-        eff_N_comb.push_back(N_comb[track_i]);
-        eff_N_comb_e.push_back(N_comb_e[track_i]);
-        eff_z_mid.push_back(z_mid[track_i]);
-        eff_z_range.push_back(z_range[track_i]);
-      }
+      temp_event_zvtx_info = InttVertexUtil::sigmaEff_avg(z_mid, Integrate_portion);
 
-      if (draw_event_display)
+      for (unsigned int track_i = 0; track_i < N_comb.size(); track_i++)
       {
-        if (final_selection_widthD <= z_mid[track_i] && z_mid[track_i] <= final_selection_widthU)
+        if (N_group_info[2] <= z_mid[track_i] && z_mid[track_i] <= N_group_info[3])
+        {
+          eff_N_comb.push_back(N_comb[track_i]);
+          eff_N_comb_e.push_back(N_comb_e[track_i]);
+          eff_z_mid.push_back(z_mid[track_i]);
+          eff_z_range.push_back(z_range[track_i]);
+        }
+
+        if (draw_event_display)
         {
-          // note : for monitoring the the phi distribution that is used for the z vertex determination.
-          // note : in principle, I expect it should be something uniform.
-          evt_select_track_phi->Fill(N_comb_phi[track_i]);  // QA
+          if (final_selection_widthD <= z_mid[track_i] && z_mid[track_i] <= final_selection_widthU)
+          {
+            // note : for monitoring the the phi distribution that is used for the z vertex determination.
+            // note : in principle, I expect it should be something uniform.
+            evt_select_track_phi->Fill(N_comb_phi[track_i]);  // QA
+          }
         }
       }
-    }
 
-    //--std::cout<<"--6--"<<std::endl;
-    if (z_range_gr != nullptr)
-    {
-      delete z_range_gr;
-    }
-    z_range_gr = new TGraphErrors(eff_N_comb.size(),
-                                  &eff_N_comb[0], &eff_z_mid[0],
-                                  &eff_N_comb_e[0], &eff_z_range[0]);
+      //--std::cout<<"--6--"<<std::endl;
+      if (z_range_gr != nullptr)
+      {
+        delete z_range_gr;
+      }
+      z_range_gr = new TGraphErrors(eff_N_comb.size(),
+                                    &eff_N_comb[0], &eff_z_mid[0],
+                                    &eff_N_comb_e[0], &eff_z_range[0]);
 
-    z_range_gr->Fit(zvtx_finder, "NQ", "", 0, N_comb[N_comb.size() - 1]);
-    double width_density_par = (double(eff_N_comb.size()) / fabs(temp_event_zvtx_info[2] - temp_event_zvtx_info[1]));
+      z_range_gr->Fit(zvtx_finder, "NQ", "", 0, N_comb[N_comb.size() - 1]);
+      width_density_par = (double(eff_N_comb.size()) / fabs(temp_event_zvtx_info[2] - temp_event_zvtx_info[1]));
+    }
 
     if (zvtx_QA_width.first < tight_offset_width &&
         tight_offset_width < zvtx_QA_width.second &&
@@ -1015,7 +918,7 @@ bool INTTZvtx::ProcessEvt(
 
       // note : gaus fit on the linebreak
       gaus_width_Nclu->Fill(total_NClus, tight_offset_width);
-      gaus_rchi2_Nclu->Fill(total_NClus, gaus_fit->GetChisquare() / double(gaus_fit->GetNDF()));
+      gaus_rchi2_Nclu->Fill(total_NClus, peak_chi2ndf);
       line_breakdown_gaus_ratio_hist->Fill(gaus_ratio);
       line_breakdown_gaus_width_hist->Fill(tight_offset_width);
 
@@ -1062,9 +965,9 @@ bool INTTZvtx::ProcessEvt(
       out_ES_width_density = width_density_par;
 
       out_LB_Gaus_Mean_mean = loose_offset_peak;
-      out_LB_Gaus_Mean_meanE = gaus_fit->GetParError(1);                              // note : -> loose one
-      out_LB_Gaus_Mean_chi2 = gaus_fit->GetChisquare() / double(gaus_fit->GetNDF());  // note : -> loose one
-      out_LB_Gaus_Mean_width = fabs(gaus_fit->GetParameter(2));
+      out_LB_Gaus_Mean_meanE = loose_offset_peakE;
+      out_LB_Gaus_Mean_chi2 = peak_chi2ndf;
+      out_LB_Gaus_Mean_width = tight_offset_width;
 
       out_LB_Gaus_Width_width = tight_offset_width;
       out_LB_Gaus_Width_offset = gaus_fit_offset;
@@ -1080,10 +983,9 @@ bool INTTZvtx::ProcessEvt(
 
       out_centrality_bin = centrality_bin;
 
-      out_LB_geo_mean = LB_geo_mean(line_breakdown_hist,
-                                    {(tight_offset_peak - tight_offset_width),
-                                     (tight_offset_peak + tight_offset_width)},
-                                    event_i);
+      out_LB_geo_mean = InttZvtxEngine::LB_geo_mean(line_profile,
+                                                    {(tight_offset_peak - tight_offset_width),
+                                                     (tight_offset_peak + tight_offset_width)});
       out_good_zvtx_tag = good_zvtx_tag;
       bco_full_out = bco_full;
       MC_true_zvtx = TrigZvtxMC * 10.;
@@ -1202,7 +1104,7 @@ bool INTTZvtx::ProcessEvt(
                                      final_selection_widthU, line_breakdown_hist->GetMaximum());
       draw_text->DrawLatex(0.2, 0.82, (boost::format("Gaus mean %.2f mm") % loose_offset_peak).str().c_str());
       draw_text->DrawLatex(0.2, 0.78, (boost::format("Width : %.2f mm") % tight_offset_width).str().c_str());
-      draw_text->DrawLatex(0.2, 0.74, (boost::format("Reduced #chi2 : %.3f") % (gaus_fit->GetChisquare() / double(gaus_fit->GetNDF()))).str().c_str());
+      draw_text->DrawLatex(0.2, 0.74, (boost::format("Reduced #chi2 : %.3f") % peak_chi2ndf).str().c_str());
       draw_text->DrawLatex(0.2, 0.70, (boost::format("Norm. entry / Width : %.6f mm") % gaus_ratio).str().c_str());
       draw_text->DrawLatex(0.2, 0.66, (boost::format("LB Geo mean : %.3f mm") % out_LB_geo_mean).str().c_str());
 
@@ -1274,8 +1176,8 @@ bool INTTZvtx::ProcessEvt(
 
     m_zvtxinfo.zvtx = loose_offset_peak;
     m_zvtxinfo.zvtx_err = loose_offset_peakE;
-    m_zvtxinfo.width = gaus_fit->GetParameter(2);
-    m_zvtxinfo.chi2ndf = gaus_fit->GetChisquare() / double(gaus_fit->GetNDF());
+    m_zvtxinfo.width = peak.sigma;
+    m_zvtxinfo.chi2ndf = peak_chi2ndf;
     m_zvtxinfo.good = good_zvtx_tag;
     m_zvtxinfo.ngroup = N_group_info_detail[0];
     m_zvtxinfo.peakratio = N_group_info_detail[1];
@@ -1290,8 +1192,7 @@ bool INTTZvtx::ProcessEvt(
 
   ////////////////////////////////////////
 
-  // std::cout<<"good pair count : "<<good_pair_count<<std::endl;
-  std::cout << "evt : " << event_i << ", good pair count : " << N_comb.size() << " " << good_pair_count << std::endl;
+  std::cout << "evt : " << event_i << ", good pair count : " << N_comb.size() << std::endl;
 
   //--std::cout<<"--14 0--"<<std::endl;
   if (m_enable_qa)
@@ -1338,22 +1239,18 @@ void INTTZvtx::ClearEvt()
   N_group_info.clear();
   N_group_info_detail = {-1., -1., -1., -1.};
 
-  evt_possible_z->Reset("ICESM");
-  line_breakdown_hist->Reset("ICESM");
+  m_engine.Reset();
 
   if (draw_event_display)
   {
+    evt_possible_z->Reset("ICESM");
+    line_breakdown_hist->Reset("ICESM");
     evt_phi_diff_1D->Reset("ICESM");
     evt_inner_outer_phi->Reset("ICESM");
     evt_select_track_phi->Reset("ICESM");
     evt_phi_diff_inner_phi->Reset("ICESM");
   }
 
-  inner_clu_phi_map.clear();
-  outer_clu_phi_map.clear();
-  inner_clu_phi_map = std::vector<std::vector<std::pair<bool, clu_info>>>(360);
-  outer_clu_phi_map = std::vector<std::vector<std::pair<bool, clu_info>>>(360);
-
   // note : this is the distribution for full run
   // line_breakdown_gaus_ratio_hist -> Reset("ICESM");
 }
@@ -1673,256 +1570,3 @@ std::vector<double> INTTZvtx::GetEvtZPeak()
 {
   return {good_zvtx_tag_int, loose_offset_peak, loose_offset_peakE};
 }
-
-double INTTZvtx::get_radius(double x, double y)
-{
-  return sqrt(pow(x, 2) + pow(y, 2));
-}
-
-// note : Function to calculate the angle between two vectors in degrees using the cross product
-double INTTZvtx::calculateAngleBetweenVectors(double x1, double y1, double x2, double y2, double targetX, double targetY)
-{
-  // Calculate the vectors vector_1 (point_1 to point_2) and vector_2 (point_1 to target)
-  double vector1X = x2 - x1;
-  double vector1Y = y2 - y1;
-
-  double vector2X = targetX - x1;
-  double vector2Y = targetY - y1;
-
-  // Calculate the cross product of vector_1 and vector_2 (z-component)
-  double crossProduct = vector1X * vector2Y - vector1Y * vector2X;
-
-  // std::cout<<" crossProduct : "<<crossProduct<<std::endl;
-
-  // Calculate the magnitudes of vector_1 and vector_2
-  double magnitude1 = std::sqrt(vector1X * vector1X + vector1Y * vector1Y);
-  double magnitude2 = std::sqrt(vector2X * vector2X + vector2Y * vector2Y);
-
-  // Calculate the angle in radians using the inverse tangent of the cross product and dot product
-  //--double dotProduct = vector1X * vector2X + vector1Y * vector2Y;
-
-  //--double angleInRadians = std::atan2(std::abs(crossProduct), dotProduct);
-  // Convert the angle from radians to degrees and return it
-  //--double angleInDegrees = angleInRadians * 180.0 / M_PI;
-
-  double angleInRadians_new = std::asin(crossProduct / (magnitude1 * magnitude2));
-  //--double angleInDegrees_new = angleInRadians_new * 180.0 / M_PI;
-
-  // std::cout<<"angle : "<<angleInDegrees_new<<std::endl;
-
-  double DCA_distance = sin(angleInRadians_new) * magnitude2;
-
-  return DCA_distance;
-}
-
-double INTTZvtx::Get_extrapolation(double given_y, double p0x, double p0y, double p1x, double p1y)  // note : x : z, y : r
-{
-  if (fabs(p0x - p1x) < 0.00001)
-  {  // note : the line is vertical (if z is along the x axis)
-    return p0x;
-  }
-  else
-  {
-    double slope = (p1y - p0y) / (p1x - p0x);
-    double yIntercept = p0y - slope * p0x;
-    double xCoordinate = (given_y - yIntercept) / slope;
-    return xCoordinate;
-  }
-}
-
-std::pair<double, double> INTTZvtx::Get_possible_zvtx(double rvtx, std::vector<double> p0, std::vector<double> p1)  // note : inner p0, outer p1, vector {r,z}, -> {y,x}
-{
-  std::vector<double> p0_z_edge = {(fabs(p0[1]) < 130) ? p0[1] - 8. : p0[1] - 10., (fabs(p0[1]) < 130) ? p0[1] + 8. : p0[1] + 10.};  // note : vector {left edge, right edge}
-  std::vector<double> p1_z_edge = {(fabs(p1[1]) < 130) ? p1[1] - 8. : p1[1] - 10., (fabs(p1[1]) < 130) ? p1[1] + 8. : p1[1] + 10.};  // note : vector {left edge, right edge}
-
-  double edge_first = Get_extrapolation(rvtx, p0_z_edge[0], p0[0], p1_z_edge[1], p1[0]);
-  double edge_second = Get_extrapolation(rvtx, p0_z_edge[1], p0[0], p1_z_edge[0], p1[0]);
-
-  double mid_point = (edge_first + edge_second) / 2.;
-  double possible_width = fabs(edge_first - edge_second) / 2.;
-
-  return {mid_point, possible_width};  // note : first : mid point, second : width
-}
-
-void INTTZvtx::line_breakdown(TH1* hist_in, std::pair<double, double> line_range)
-{
-  int first_bin = int((line_range.first - hist_in->GetXaxis()->GetXmin()) / hist_in->GetBinWidth(1)) + 1;
-  int last_bin = int((line_range.second - hist_in->GetXaxis()->GetXmin()) / hist_in->GetBinWidth(1)) + 1;
-
-  if (first_bin < 1)
-  {
-    first_bin = 0;
-  }
-  else if (first_bin > hist_in->GetNbinsX())
-  {
-    first_bin = hist_in->GetNbinsX() + 1;
-  }
-
-  if (last_bin < 1)
-  {
-    last_bin = 0;
-  }
-  else if (last_bin > hist_in->GetNbinsX())
-  {
-    last_bin = hist_in->GetNbinsX() + 1;
-  }
-
-  // std::cout<<"Digitize the bin : "<<first_bin<<" "<<last_bin<<std::endl;
-
-  // note : if first:last = (0:0) or (N+1:N+1) -> the subtraction of them euqals to zero.
-  for (int i = 0; i < (last_bin - first_bin) + 1; i++)
-  {
-    hist_in->SetBinContent(first_bin + i, hist_in->GetBinContent(first_bin + i) + 1);
-  }
-}
-
-// note : search_range : should be the gaus fit range
-double INTTZvtx::LB_geo_mean(TH1* hist_in, std::pair<double, double> search_range, int /*event_i*/)
-{
-  int Highest_bin_index = hist_in->GetMaximumBin();
-  double Highest_bin_center = hist_in->GetBinCenter(Highest_bin_index);
-  double Highest_bin_content = hist_in->GetBinContent(Highest_bin_index);
-  if (Highest_bin_center < search_range.first || search_range.second < Highest_bin_center)
-  {
-    // std::cout<<"In INTTZvtx class, event : "<<event_i<<", interesting event, different group was fit"<<std::endl;
-    return -999.;
-  }
-
-  std::vector<float> same_height_bin;
-  same_height_bin.clear();
-  same_height_bin.push_back(Highest_bin_center);
-
-  int search_index = 1;
-  while ((hist_in->GetBinCenter(Highest_bin_index + search_index)) < search_range.second)
-  {
-    if (hist_in->GetBinContent(Highest_bin_index + search_index) == Highest_bin_content)
-    {
-      same_height_bin.push_back(hist_in->GetBinCenter(Highest_bin_index + search_index));
-    }
-    search_index++;
-  }
-
-  // std::cout<<"test, search_index right : "<<search_index<<std::endl;
-
-  search_index = 1;
-  while (search_range.first < (hist_in->GetBinCenter(Highest_bin_index - search_index)))
-  {
-    if (hist_in->GetBinContent(Highest_bin_index - search_index) == Highest_bin_content)
-    {
-      same_height_bin.push_back(hist_in->GetBinCenter(Highest_bin_index - search_index));
-    }
-    search_index++;
-  }
-
-  // std::cout<<"test, search_index left : "<<search_index<<std::endl;
-  // std::cout<<"test, same_height_bin.size(): "<<same_height_bin.size()<<std::endl;
-
-  return accumulate(same_height_bin.begin(), same_height_bin.end(), 0.0) / double(same_height_bin.size());
-}
-
-//  note : N group, group size, group tag, group width ?  // note : {group size, group entry, group tag, group widthL, group widthR}
-// note : {N_group, ratio (if two), peak widthL, peak widthR}
-std::vector<double> INTTZvtx::find_Ngroup(TH1* hist_in)
-{
-  double Highest_bin_Content = hist_in->GetBinContent(hist_in->GetMaximumBin());
-  double Highest_bin_Center = hist_in->GetBinCenter(hist_in->GetMaximumBin());
-
-  int group_Nbin = 0;
-  int peak_group_ID = 0;  // =0 added by TH 20240418
-  double group_entry = 0;
-  double peak_group_ratio;
-  std::vector<int> group_Nbin_vec;
-  group_Nbin_vec.clear();
-  std::vector<double> group_entry_vec;
-  group_entry_vec.clear();
-  std::vector<double> group_widthL_vec;
-  group_widthL_vec.clear();
-  std::vector<double> group_widthR_vec;
-  group_widthR_vec.clear();
-
-  for (int i = 0; i < hist_in->GetNbinsX(); i++)
-  {
-    // todo : the background rejection is here : Highest_bin_Content/2. for the time being
-    double bin_content = (hist_in->GetBinContent(i + 1) <= Highest_bin_Content / 2.) ? 0. : (hist_in->GetBinContent(i + 1) - Highest_bin_Content / 2.);
-
-    if (bin_content != 0)
-    {
-      if (group_Nbin == 0)
-      {
-        group_widthL_vec.push_back(hist_in->GetBinCenter(i + 1) - (hist_in->GetBinWidth(i + 1) / 2.));
-      }
-
-      group_Nbin += 1;
-      group_entry += bin_content;
-    }
-    else if (bin_content == 0 && group_Nbin != 0)
-    {
-      group_widthR_vec.push_back(hist_in->GetBinCenter(i + 1) - (hist_in->GetBinWidth(i + 1) / 2.));
-      group_Nbin_vec.push_back(group_Nbin);
-      group_entry_vec.push_back(group_entry);
-      group_Nbin = 0;
-      group_entry = 0;
-    }
-  }
-  if (group_Nbin != 0)
-  {
-    group_Nbin_vec.push_back(group_Nbin);
-    group_entry_vec.push_back(group_entry);
-    group_widthR_vec.push_back(hist_in->GetXaxis()->GetXmax());
-  }  // note : the last group at the edge
-
-  // note : find the peak group
-  for (unsigned int i = 0; i < group_Nbin_vec.size(); i++)
-  {
-    if (group_widthL_vec[i] < Highest_bin_Center && Highest_bin_Center < group_widthR_vec[i])
-    {
-      peak_group_ID = i;
-      break;
-    }
-  }
-
-  peak_group_ratio = group_entry_vec[peak_group_ID] / (accumulate(group_entry_vec.begin(), group_entry_vec.end(), 0.0));
-
-  // for (int i = 0; i < group_Nbin_vec.size(); i++)
-  // {
-  //     std::cout<<" "<<std::endl;
-  //     std::cout<<"group size : "<<group_Nbin_vec[i]<<std::endl;
-  //     std::cout<<"group entry : "<<group_entry_vec[i]<<std::endl;
-  //     std::cout<<group_widthL_vec[i]<<" "<<group_widthR_vec[i]<<std::endl;
-  // }
-
-  // std::cout<<" "<<std::endl;
-  // std::cout<<"N group : "<<group_Nbin_vec.size()<<std::endl;
-  // std::cout<<"Peak group ID : "<<peak_group_ID<<std::endl;
-  // std::cout<<"peak group width : "<<group_widthL_vec[peak_group_ID]<<" "<<group_widthR_vec[peak_group_ID]<<std::endl;
-  // std::cout<<"ratio : "<<peak_group_ratio<<std::endl;
-
-  // note : {N_group, ratio (if two), peak widthL, peak widthR}
-  return {double(group_Nbin_vec.size()), peak_group_ratio, group_widthL_vec[peak_group_ID], group_widthR_vec[peak_group_ID]};
-}
-
-double INTTZvtx::get_delta_phi(double angle_1, double angle_2)
-{
-  std::vector<double> vec_abs = {fabs(angle_1 - angle_2), fabs(angle_1 - angle_2 + 360), fabs(angle_1 - angle_2 - 360)};
-  std::vector<double> vec = {(angle_1 - angle_2), (angle_1 - angle_2 + 360), (angle_1 - angle_2 - 360)};
-  return vec[std::distance(vec_abs.begin(), std::min_element(vec_abs.begin(), vec_abs.end()))];
-}
-
-double INTTZvtx::get_track_phi(double inner_clu_phi_in, double delta_phi_in)
-{
-  double track_phi = inner_clu_phi_in - (delta_phi_in / 2.);
-  if (track_phi < 0)
-  {
-    track_phi += 360;
-  }
-  else if (track_phi > 360)
-  {
-    track_phi -= 360;
-  }
-  else if (track_phi == 360)
-  {
-    track_phi = 0;
-  }
-  // else {track_phi = track_phi;}
-  return track_phi;
-}
@@ -2,6 +2,7 @@
 #define INTT_INTTZVTX_H
 
 #include "InttVertexUtil.h"
+#include "InttZvtxEngine.h"
 
 #include <string>
 #include <vector>
@@ -139,13 +140,12 @@ class INTTZvtx
   double zvtx_hist_r = 500;               // histogram range for QA
   int print_rate = 50;                    // if_print in processEvt, todo : the print rate is here
 
-  std::vector<std::vector<std::pair<bool, clu_info>>> inner_clu_phi_map{};  // note: phi
-  std::vector<std::vector<std::pair<bool, clu_info>>> outer_clu_phi_map{};  // note: phi
+  InttZvtxEngine m_engine;  // note : tracklets and z-vertex
 
   ZvtxInfo m_zvtxinfo;
 
-  TH1* evt_possible_z{nullptr};
-  TH1* line_breakdown_hist{nullptr};  // note : try to fill the line into the histogram
+  TH1* evt_possible_z{nullptr};       // draw processEvt, copy of the engine profile
+  TH1* line_breakdown_hist{nullptr};  // draw processEvt, copy of the engine profile
   TF1* gaus_fit{nullptr};
   TF1* zvtx_finder{nullptr};
   TGraphErrors* z_range_gr{nullptr};  // ana // memory leak
@@ -255,21 +255,6 @@ class INTTZvtx
   std::vector<float> z_mid{};        // tracklet
   std::vector<float> z_range{};      // tracklet
 
-  // function for analysis
-  std::pair<double, double> Get_possible_zvtx(double rvtx, std::vector<double> p0, std::vector<double> p1);
-  std::vector<double> find_Ngroup(TH1* hist_in);
-  double get_radius(double x, double y);
-  double calculateAngleBetweenVectors(double x1, double y1, double x2, double y2, double targetX, double targetY);
-  double Get_extrapolation(double given_y, double p0x, double p0y, double p1x, double p1y);
-  void line_breakdown(TH1* hist_in, std::pair<double, double> line_range);
-
-  // tracklet reco
-  double get_delta_phi(double angle_1, double angle_2);
-  double get_track_phi(double inner_clu_phi_in, double delta_phi_in);
-
-  // for Tree
-  double LB_geo_mean(TH1* hist_in, std::pair<double, double> search_range, int event_i);
-
   // InitCanvas
   void Characterize_Pad(TPad* pad, float left = 0.15, float right = 0.1,
                         float top = 0.1, float bottom = 0.12,
@@ -434,6 +434,11 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
       clusters.insert(std::make_pair(component[i], hitvec[i]));  // multiple entries per unique cluster id
     }
 
+    // clusters and associations of this hitset, added to the containers at once.
+    // Cluster ids run from 0 to the number of components
+    std::vector<TrkrCluster*> hitset_clusters(cluster_ids.size(), nullptr);
+    TrkrClusterHitAssoc::AssocVector hitset_assocs;
+
     // loop over the cluster ID's and make the clusters from the connected hits
     for (int clusid : cluster_ids)
     {
@@ -507,7 +512,7 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
         ++nhits;
 
         // add this cluster-hit association to the association map of (clusterkey,hitkey)
-        m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
+        hitset_assocs.emplace_back(ckey, mapiter->second.first);
 
         if (Verbosity() > 2)
         {
@@ -579,9 +584,12 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
         clus->identify();
       }
 
-      m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
+      hitset_clusters[clusid] = clus.release();
 
     }  // end loop over cluster ID's
+
+    m_clusterlist->addClusters(hitset->getHitSetKey(), std::move(hitset_clusters));
+    m_clusterhitassoc->addAssocs(hitset->getHitSetKey(), std::move(hitset_assocs));
   }    // end loop over hitsets
 
   if (Verbosity() > 2)
@@ -704,6 +712,11 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       clusters.insert(std::make_pair(component[i], hitvec[i]));  // multiple entries per unique cluster id
     }
 
+    // clusters and associations of this hitset, added to the containers at once.
+    // Cluster ids run from 0 to the number of components
+    std::vector<TrkrCluster*> hitset_clusters(cluster_ids.size(), nullptr);
+    TrkrClusterHitAssoc::AssocVector hitset_assocs;
+
     // loop over the cluster ID's and make the clusters from the connected hits
     for (int clusid : cluster_ids)
     {
@@ -882,9 +895,12 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
         clus->identify();
       }
 
-      m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
+      hitset_clusters[clusid] = clus.release();
 
     }  // end loop over cluster ID's
+
+    m_clusterlist->addClusters(hitset->getHitSetKey(), std::move(hitset_clusters));
+    m_clusterhitassoc->addAssocs(hitset->getHitSetKey(), std::move(hitset_assocs));
   }    // end loop over hitsets
 
   if (Verbosity() > 2)
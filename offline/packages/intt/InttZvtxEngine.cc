@@ -0,0 +1,443 @@
+#include "InttZvtxEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+int InttZvtxEngine::Profile::FindBin(double x) const
+{
+  if (x < xmin)
+  {
+    return 0;
+  }
+  if (x >= GetXmax())
+  {
+    return nbins + 1;
+  }
+  return int((x - xmin) / binwidth) + 1;
+}
+
+int InttZvtxEngine::Profile::GetMaximumBin() const
+{
+  // note : first bin with the highest content, under- and overflow excluded
+  int max_bin = 1;
+  for (int i = 2; i <= nbins; i++)
+  {
+    if (content[i] > content[max_bin])
+    {
+      max_bin = i;
+    }
+  }
+  return max_bin;
+}
+
+InttZvtxEngine::InttZvtxEngine()
+{
+  m_coarse.Init(50, m_z_range.first, m_z_range.second);
+
+  int N = 1200;        // note : N bins for each side, regardless the bin at zero
+  double width = 0.5;  // note : bin width with the unit [mm]
+  m_line.Init(2 * N + 1, -1 * (width * N + width / 2.), width * N + width / 2.);
+  m_ldiff.assign(m_line.nbins + 3, 0.);
+}
+
+void InttZvtxEngine::Reset()
+{
+  m_inner.clear();
+  m_outer.clear();
+  m_outer_phi.clear();
+  m_tracklets.clear();
+  m_coarse.Reset();
+  m_line.Reset();
+  std::fill(m_ldiff.begin(), m_ldiff.end(), 0.);
+}
+
+InttZvtxEngine::Cluster InttZvtxEngine::MakeCluster(double x, double y, double z) const
+{
+  // note : the vertex in XY is not at zero, so the "offset" moves the offset back to the orign which is (0,0)
+  double dx = x - m_beam.first;
+  double dy = y - m_beam.second;
+  double phi = std::atan2(dy, dx) * (180. / M_PI);
+  if (dy < 0)
+  {
+    phi += 360;
+  }
+
+  Cluster clu;
+  clu.x = x;
+  clu.y = y;
+  clu.z = z;
+  clu.r = std::sqrt(dx * dx + dy * dy);
+  clu.phi = phi;
+  return clu;
+}
+
+void InttZvtxEngine::MakeTracklets()
+{
+  auto by_phi = [](const Cluster& a, const Cluster& b)
+  { return a.phi < b.phi; };
+  std::sort(m_inner.begin(), m_inner.end(), by_phi);
+  std::sort(m_outer.begin(), m_outer.end(), by_phi);
+
+  m_outer_phi.resize(m_outer.size());
+  for (unsigned int i = 0; i < m_outer.size(); i++)
+  {
+    m_outer_phi[i] = m_outer[i].phi;
+  }
+
+  ForEachPair(m_phi_cut, [this](const Cluster& inner, const Cluster& outer, double delta_phi)
+              {
+    double DCA_sign = calculateAngleBetweenVectors(outer.x, outer.y, inner.x, inner.y, m_beam.first, m_beam.second);
+    if (!(m_dca_cut.first < DCA_sign && DCA_sign < m_dca_cut.second))
+    {
+      return;
+    }
+
+    // note : the radius is w.r.t. the beam origin, so the vertex is at r = 0
+    std::pair<double, double> z_range_info = Get_possible_zvtx(0., inner.r, inner.z, outer.r, outer.z);
+
+    // note : try to remove some crazy background candidates
+    if (!(m_z_range.first < z_range_info.first && z_range_info.first < m_z_range.second))
+    {
+      return;
+    }
+
+    m_tracklets.push_back({z_range_info.first, z_range_info.second, get_track_phi(inner.phi, delta_phi)});
+
+    m_coarse.content[m_coarse.FindBin(z_range_info.first)] += 1;
+
+    // note : line breakdown, the bins covered by the z range get one entry each.
+    // note : same bin finding as the former line_breakdown(), kept in a difference array
+    const double lo = z_range_info.first - z_range_info.second;
+    const double hi = z_range_info.first + z_range_info.second;
+    int first_bin = int((lo - m_line.xmin) / m_line.binwidth) + 1;
+    int last_bin = int((hi - m_line.xmin) / m_line.binwidth) + 1;
+    first_bin = (first_bin < 1) ? 0 : std::min(first_bin, m_line.nbins + 1);
+    last_bin = (last_bin < 1) ? 0 : std::min(last_bin, m_line.nbins + 1);
+    if (first_bin <= last_bin)
+    {
+      m_ldiff[first_bin] += 1;
+      m_ldiff[last_bin + 1] -= 1;
+    } });
+
+  std::partial_sum(m_ldiff.begin(), m_ldiff.end() - 1, m_line.content.begin());
+}
+
+InttZvtxEngine::Peak InttZvtxEngine::FindPeak() const
+{
+  Peak peak;
+  if (m_tracklets.empty())
+  {
+    return peak;
+  }
+
+  const std::vector<double>& y = m_line.content;
+  const int nbins = m_line.nbins;
+
+  // note : seed, the sliding window with the largest number of entries. A single bin is
+  // note : not used since the top of the profile is often a plateau
+  int half = std::max(0, int(m_seed_window / m_line.binwidth));
+  double sum = 0;
+  for (int i = 1; i <= std::min(nbins, 1 + half); i++)
+  {
+    sum += y[i];
+  }
+  double best_sum = sum;
+  int seed_bin = 1;
+  for (int i = 2; i <= nbins; i++)
+  {
+    if (i + half <= nbins)
+    {
+      sum += y[i + half];
+    }
+    if (i - half - 1 >= 1)
+    {
+      sum -= y[i - half - 1];
+    }
+    if (sum > best_sum)
+    {
+      best_sum = sum;
+      seed_bin = i;
+    }
+  }
+
+  // note : mean shift with a flat kernel of +- m_peak_window on top of the window minimum
+  double mean = m_line.GetBinCenter(seed_bin);
+  double offset = 0;
+  int first_bin = 1;
+  int last_bin = nbins;
+  double sumw = 0;
+  for (int iter = 0; iter < 100; iter++)
+  {
+    first_bin = std::max(1, m_line.FindBin(mean - m_peak_window));
+    last_bin = std::min(nbins, m_line.FindBin(mean + m_peak_window));
+    offset = *std::min_element(y.begin() + first_bin, y.begin() + last_bin + 1);
+
+    sumw = 0;
+    double sumwx = 0;
+    for (int i = first_bin; i <= last_bin; i++)
+    {
+      sumw += y[i] - offset;
+      sumwx += (y[i] - offset) * m_line.GetBinCenter(i);
+    }
+    if (sumw <= 0)
+    {
+      break;
+    }
+
+    double next = sumwx / sumw;
+    bool converged = std::fabs(next - mean) < 1e-3;
+    mean = next;
+    if (converged)
+    {
+      break;
+    }
+  }
+  if (sumw <= 0)
+  {
+    return peak;
+  }
+
+  // note : width from the second moment, corrected for the truncation at +- m_peak_window
+  double sumwxx = 0;
+  for (int i = first_bin; i <= last_bin; i++)
+  {
+    double dx = m_line.GetBinCenter(i) - mean;
+    sumwxx += (y[i] - offset) * dx * dx;
+  }
+  double var = sumwxx / sumw;
+  double sigma = std::sqrt(var);
+  for (int iter = 0; iter < 50 && sigma > 0; iter++)
+  {
+    double a = m_peak_window / sigma;
+    double corr = 1. - 2. * a * std::exp(-a * a / 2.) / std::sqrt(2. * M_PI) / std::erf(a / std::sqrt(2.));
+    if (corr <= 0)
+    {
+      break;
+    }
+    double next = std::sqrt(var / corr);
+    if (next > 10000 || std::fabs(next - sigma) < 1e-4)
+    {
+      sigma = std::min(next, 10000.);
+      break;
+    }
+    sigma = next;
+  }
+  sigma = std::clamp(sigma, 5., 10000.);  // note : same limits as the former fit
+
+  // note : height from the content in the window, chi2 of the gaussian + offset
+  double sumg = 0;
+  for (int i = first_bin; i <= last_bin; i++)
+  {
+    double dx = (m_line.GetBinCenter(i) - mean) / sigma;
+    sumg += std::exp(-dx * dx / 2.);
+  }
+  double height = (sumg > 0) ? sumw / sumg : 0;
+
+  double chi2 = 0;
+  int npoints = 0;
+  for (int i = first_bin; i <= last_bin; i++)
+  {
+    if (y[i] <= 0)
+    {
+      continue;
+    }
+    double dx = (m_line.GetBinCenter(i) - mean) / sigma;
+    double model = height * std::exp(-dx * dx / 2.) + offset;
+    chi2 += (y[i] - model) * (y[i] - model) / y[i];
+    npoints++;
+  }
+
+  peak.found = true;
+  peak.mean = mean;
+  peak.meanE = sigma / std::sqrt(std::max(height, 1.));  // note : height ~ number of tracklets at the peak
+  peak.sigma = sigma;
+  peak.height = height;
+  peak.offset = offset;
+  peak.chi2ndf = (npoints > 4) ? chi2 / (npoints - 4) : -1;
+
+  return peak;
+}
+
+// note : {N_group, ratio (if two), peak widthL, peak widthR}
+std::vector<double> InttZvtxEngine::find_Ngroup(const Profile& prof)
+{
+  double Highest_bin_Content = prof.content[prof.GetMaximumBin()];
+  double Highest_bin_Center = prof.GetBinCenter(prof.GetMaximumBin());
+
+  int group_Nbin = 0;
+  double group_entry = 0;
+  std::vector<double> group_entry_vec;
+  std::vector<double> group_widthL_vec;
+  std::vector<double> group_widthR_vec;
+
+  for (int i = 1; i <= prof.nbins; i++)
+  {
+    // todo : the background rejection is here : Highest_bin_Content/2. for the time being
+    double bin_content = (prof.content[i] <= Highest_bin_Content / 2.) ? 0. : (prof.content[i] - Highest_bin_Content / 2.);
+
+    if (bin_content != 0)
+    {
+      if (group_Nbin == 0)
+      {
+        group_widthL_vec.push_back(prof.GetBinCenter(i) - prof.binwidth / 2.);
+      }
+
+      group_Nbin += 1;
+      group_entry += bin_content;
+    }
+    else if (group_Nbin != 0)
+    {
+      group_widthR_vec.push_back(prof.GetBinCenter(i) - prof.binwidth / 2.);
+      group_entry_vec.push_back(group_entry);
+      group_Nbin = 0;
+      group_entry = 0;
+    }
+  }
+  if (group_Nbin != 0)
+  {
+    group_entry_vec.push_back(group_entry);
+    group_widthR_vec.push_back(prof.GetXmax());
+  }  // note : the last group at the edge
+
+  if (group_entry_vec.empty())
+  {
+    return {0., -1., -1., -1.};
+  }
+
+  // note : find the peak group
+  unsigned int peak_group_ID = 0;
+  for (unsigned int i = 0; i < group_entry_vec.size(); i++)
+  {
+    if (group_widthL_vec[i] < Highest_bin_Center && Highest_bin_Center < group_widthR_vec[i])
+    {
+      peak_group_ID = i;
+      break;
+    }
+  }
+
+  double peak_group_ratio = group_entry_vec[peak_group_ID] / (std::accumulate(group_entry_vec.begin(), group_entry_vec.end(), 0.0));
+
+  return {double(group_entry_vec.size()), peak_group_ratio, group_widthL_vec[peak_group_ID], group_widthR_vec[peak_group_ID]};
+}
+
+// note : search_range : should be the peak range
+double InttZvtxEngine::LB_geo_mean(const Profile& prof, std::pair<double, double> search_range)
+{
+  int Highest_bin_index = prof.GetMaximumBin();
+  double Highest_bin_center = prof.GetBinCenter(Highest_bin_index);
+  double Highest_bin_content = prof.content[Highest_bin_index];
+  if (Highest_bin_center < search_range.first || search_range.second < Highest_bin_center)
+  {
+    return -999.;
+  }
+
+  double sum_center = Highest_bin_center;
+  int n_same = 1;
+
+  for (int i = Highest_bin_index + 1; i <= prof.nbins + 1 && prof.GetBinCenter(i) < search_range.second; i++)
+  {
+    if (prof.content[i] == Highest_bin_content)
+    {
+      sum_center += prof.GetBinCenter(i);
+      n_same++;
+    }
+  }
+  for (int i = Highest_bin_index - 1; i >= 0 && search_range.first < prof.GetBinCenter(i); i--)
+  {
+    if (prof.content[i] == Highest_bin_content)
+    {
+      sum_center += prof.GetBinCenter(i);
+      n_same++;
+    }
+  }
+
+  return sum_center / n_same;
+}
+
+// note : Function to calculate the angle between two vectors in degrees using the cross product
+double InttZvtxEngine::calculateAngleBetweenVectors(double x1, double y1, double x2, double y2, double targetX, double targetY)
+{
+  // Calculate the vectors vector_1 (point_1 to point_2) and vector_2 (point_1 to target)
+  double vector1X = x2 - x1;
+  double vector1Y = y2 - y1;
+
+  double vector2X = targetX - x1;
+  double vector2Y = targetY - y1;
+
+  // Calculate the cross product of vector_1 and vector_2 (z-component)
+  double crossProduct = vector1X * vector2Y - vector1Y * vector2X;
+
+  // Calculate the magnitudes of vector_1 and vector_2
+  double magnitude1 = std::sqrt(vector1X * vector1X + vector1Y * vector1Y);
+  double magnitude2 = std::sqrt(vector2X * vector2X + vector2Y * vector2Y);
+
+  double angleInRadians_new = std::asin(crossProduct / (magnitude1 * magnitude2));
+
+  double DCA_distance = std::sin(angleInRadians_new) * magnitude2;
+
+  return DCA_distance;
+}
+
+double InttZvtxEngine::Get_extrapolation(double given_y, double p0x, double p0y, double p1x, double p1y)  // note : x : z, y : r
+{
+  if (std::fabs(p0x - p1x) < 0.00001)
+  {  // note : the line is vertical (if z is along the x axis)
+    return p0x;
+  }
+  double slope = (p1y - p0y) / (p1x - p0x);
+  double yIntercept = p0y - slope * p0x;
+  double xCoordinate = (given_y - yIntercept) / slope;
+  return xCoordinate;
+}
+
+// note : inner (r0,z0), outer (r1,z1)
+std::pair<double, double> InttZvtxEngine::Get_possible_zvtx(double rvtx, double r0, double z0, double r1, double z1)
+{
+  // note : {left edge, right edge} of the sensor strips
+  double p0_z_edge[2] = {(std::fabs(z0) < 130) ? z0 - 8. : z0 - 10., (std::fabs(z0) < 130) ? z0 + 8. : z0 + 10.};
+  double p1_z_edge[2] = {(std::fabs(z1) < 130) ? z1 - 8. : z1 - 10., (std::fabs(z1) < 130) ? z1 + 8. : z1 + 10.};
+
+  double edge_first = Get_extrapolation(rvtx, p0_z_edge[0], r0, p1_z_edge[1], r1);
+  double edge_second = Get_extrapolation(rvtx, p0_z_edge[1], r0, p1_z_edge[0], r1);
+
+  double mid_point = (edge_first + edge_second) / 2.;
+  double possible_width = std::fabs(edge_first - edge_second) / 2.;
+
+  return {mid_point, possible_width};  // note : first : mid point, second : width
+}
+
+double InttZvtxEngine::get_delta_phi(double angle_1, double angle_2)
+{
+  // note : the smallest of the three differences, in this order in case of a tie
+  double diff = angle_1 - angle_2;
+  double best = diff;
+  if (std::fabs(diff + 360) < std::fabs(best))
+  {
+    best = diff + 360;
+  }
+  if (std::fabs(diff - 360) < std::fabs(best))
+  {
+    best = diff - 360;
+  }
+  return best;
+}
+
+double InttZvtxEngine::get_track_phi(double inner_clu_phi_in, double delta_phi_in)
+{
+  double track_phi = inner_clu_phi_in - (delta_phi_in / 2.);
+  if (track_phi < 0)
+  {
+    track_phi += 360;
+  }
+  else if (track_phi > 360)
+  {
+    track_phi -= 360;
+  }
+  else if (track_phi == 360)
+  {
+    track_phi = 0;
+  }
+  return track_phi;
+}
@@ -0,0 +1,180 @@
+#ifndef INTT_INTTZVTXENGINE_H
+#define INTT_INTTZVTXENGINE_H
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+/*
+  histogram free z-vertex engine used by INTTZvtx.
+
+  inner and outer clusters are kept in arrays sorted in phi (seen from the beam spot),
+  the inner-outer pairs are found with a window search in the outer array.
+  the z ranges of the tracklets are accumulated into flat arrays with the same binning
+  as the former evt_possible_z and line_breakdown_hist, the vertex is the peak of the
+  line breakdown profile found with a sliding window and a mean-shift iteration.
+
+  all the event data sits in the engine, one instance per thread can run on independent events
+*/
+class InttZvtxEngine
+{
+ public:
+  struct Cluster
+  {
+    double x{0};
+    double y{0};
+    double z{0};
+    double r{0};    // note : radius w.r.t. the beam origin
+    double phi{0};  // note : phi w.r.t. the beam origin, unit degree [0, 360)
+  };
+
+  struct Tracklet
+  {
+    double zmid{0};    // note : mid point of the possible z range
+    double zwidth{0};  // note : half width of the possible z range
+    double phi{0};     // note : tracklet phi, unit degree
+  };
+
+  //! uniform binning with underflow (0) and overflow (nbins+1), same convention as TH1
+  struct Profile
+  {
+    double xmin{0};
+    double binwidth{1};
+    int nbins{0};
+    std::vector<double> content;
+
+    void Init(int n, double lo, double hi)
+    {
+      nbins = n;
+      xmin = lo;
+      binwidth = (hi - lo) / n;
+      content.assign(n + 2, 0.);
+    }
+    double GetXmax() const { return xmin + nbins * binwidth; }
+    double GetBinCenter(int bin) const { return xmin + (bin - 0.5) * binwidth; }
+    int FindBin(double x) const;
+    int GetMaximumBin() const;
+    void Reset() { std::fill(content.begin(), content.end(), 0.); }
+  };
+
+  struct Peak
+  {
+    bool found{false};
+    double mean{-9999};  // note : unit mm
+    double meanE{-1};    // note : unit mm
+    double sigma{-1};    // note : unit mm
+    double height{0};
+    double offset{0};
+    double chi2ndf{-1};
+  };
+
+  InttZvtxEngine();
+  virtual ~InttZvtxEngine() = default;
+
+  void SetBeamOrigin(double x, double y) { m_beam = std::make_pair(x, y); }
+  void SetPhiCut(double phi_cut) { m_phi_cut = phi_cut; }
+  void SetDCACut(std::pair<double, double> dca_cut) { m_dca_cut = dca_cut; }
+  void SetZRange(std::pair<double, double> z_range)
+  {
+    m_z_range = z_range;
+    m_coarse.Init(50, z_range.first, z_range.second);
+  }
+  void SetPeakWindow(double window) { m_peak_window = window; }
+
+  void Reset();
+
+  void AddInnerCluster(double x, double y, double z) { m_inner.push_back(MakeCluster(x, y, z)); }
+  void AddOuterCluster(double x, double y, double z) { m_outer.push_back(MakeCluster(x, y, z)); }
+
+  //! pair the clusters, fill the tracklets and both z profiles
+  void MakeTracklets();
+
+  const std::vector<Tracklet>& GetTracklets() const { return m_tracklets; }
+  const Profile& GetCoarseProfile() const { return m_coarse; }
+  const Profile& GetLineProfile() const { return m_line; }
+
+  //! gaussian peak of the line breakdown profile, the mean-shift window is +- m_peak_window
+  Peak FindPeak() const;
+
+  //! calls func(inner, outer, delta_phi) for all the pairs with |delta_phi| < window (window < 180 degree)
+  //! the cluster arrays are sorted by MakeTracklets, call it after
+  template <class Func>
+  void ForEachPair(double window, Func&& func) const;
+
+  // note : {N_group, ratio (if two), peak widthL, peak widthR}
+  static std::vector<double> find_Ngroup(const Profile& prof);
+  // note : average position of the bins at the maximum height, within search_range
+  static double LB_geo_mean(const Profile& prof, std::pair<double, double> search_range);
+
+  static double calculateAngleBetweenVectors(double x1, double y1, double x2, double y2, double targetX, double targetY);
+  static double Get_extrapolation(double given_y, double p0x, double p0y, double p1x, double p1y);
+  static std::pair<double, double> Get_possible_zvtx(double rvtx, double r0, double z0, double r1, double z1);
+  static double get_delta_phi(double angle_1, double angle_2);
+  static double get_track_phi(double inner_clu_phi_in, double delta_phi_in);
+
+ private:
+  Cluster MakeCluster(double x, double y, double z) const;
+
+  std::pair<double, double> m_beam{0, 0};
+  double m_phi_cut{0.11};                      // note : unit degree
+  std::pair<double, double> m_dca_cut{-1, 1};  // note : unit mm
+  std::pair<double, double> m_z_range{-700, 700};
+  double m_peak_window{90};  // note : unit mm, same as the range of the former gaussian fit
+  double m_seed_window{10};  // note : unit mm, sliding window for the peak seed
+
+  std::vector<Cluster> m_inner;
+  std::vector<Cluster> m_outer;
+  std::vector<double> m_outer_phi;  // note : phi of m_outer, for the window search
+
+  std::vector<Tracklet> m_tracklets;
+  Profile m_coarse;             // note : tracklet mid points, as evt_possible_z
+  Profile m_line;               // note : tracklet z ranges, as line_breakdown_hist
+  std::vector<double> m_ldiff;  // note : difference array of m_line
+};
+
+template <class Func>
+void InttZvtxEngine::ForEachPair(double window, Func&& func) const
+{
+  const auto begin = m_outer_phi.begin();
+  const auto end = m_outer_phi.end();
+
+  for (const Cluster& inner : m_inner)
+  {
+    double lo = inner.phi - window;
+    double hi = inner.phi + window;
+
+    // note : up to two ranges in the outer array when the window crosses 0/360
+    std::pair<double, double> ranges[2] = {{lo, hi}, {1, 0}};
+    if (lo < 0)
+    {
+      ranges[0] = {0, hi};
+      ranges[1] = {lo + 360, 360};
+    }
+    else if (hi >= 360)
+    {
+      ranges[0] = {lo, 360};
+      ranges[1] = {0, hi - 360};
+    }
+
+    for (const auto& range : ranges)
+    {
+      if (range.first > range.second)
+      {
+        continue;
+      }
+      auto itr = std::lower_bound(begin, end, range.first);
+      for (; itr != end && *itr <= range.second; ++itr)
+      {
+        const Cluster& outer = m_outer[itr - begin];
+        double delta_phi = get_delta_phi(inner.phi, outer.phi);
+        if (std::fabs(delta_phi) < window)
+        {
+          func(inner, outer, delta_phi);
+        }
+      }
+    }
+  }
+}
+
+#endif
@@ -25,6 +25,7 @@
 #include <TSystem.h>
 #include <TDirectory.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -145,6 +146,7 @@ int MbdEvent::InitRun()
   }
 
   // Init parameters of the signal processing
+  _fitchans.clear();
   for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
   {
     _mbdsig[ifeech].SetCalib(_mbdcal);
@@ -170,6 +172,7 @@ int MbdEvent::InitRun()
       _mbdsig[ifeech].SetTemplate(_mbdcal->get_shape(ifeech), _mbdcal->get_sherr(ifeech));
       _mbdsig[ifeech].SetMinMaxFitTime(_mbdcal->get_sampmax(ifeech) - 2 - 3, _mbdcal->get_sampmax(ifeech) - 2 + 3);
       //_mbdsig[ifeech].SetMinMaxFitTime( 0, 31 );
+      _fitchans.push_back(ifeech);
     }
   }
 
@@ -388,6 +391,17 @@ int MbdEvent::SetRawData(CaloPacketContainer *mbdraw, MbdPmtContainer *bbcpmts,
     if (dstp[ipkt])
     {
       _nsamples = dstp[ipkt]->iValue(0, "SAMPLES");
+      if (_nsamples < 0 || _nsamples > MbdDefs::MAX_SAMPLES)
+      {
+        static int counter = 0;
+        if (counter < 4)
+        {
+          std::cout << PHWHERE << " evt " << m_evt << " packet " << pktid << " has " << _nsamples
+                    << " samples, only " << MbdDefs::MAX_SAMPLES << " are supported" << std::endl;
+          counter++;
+        }
+        _nsamples = std::clamp(_nsamples, 0, MbdDefs::MAX_SAMPLES);
+      }
       {
         static int counter = 0;
         if ( counter<1 )
@@ -490,6 +504,17 @@ int MbdEvent::SetRawData(Event *event, MbdPmtContainer *bbcpmts)
     if (p[ipkt])
     {
       _nsamples = p[ipkt]->iValue(0, "SAMPLES");
+      if (_nsamples < 0 || _nsamples > MbdDefs::MAX_SAMPLES)
+      {
+        static int counter = 0;
+        if (counter < 4)
+        {
+          std::cout << PHWHERE << " evt " << m_evt << " packet " << pktid << " has " << _nsamples
+                    << " samples, only " << MbdDefs::MAX_SAMPLES << " are supported" << std::endl;
+          counter++;
+        }
+        _nsamples = std::clamp(_nsamples, 0, MbdDefs::MAX_SAMPLES);
+      }
       {
         static int counter = 0;
         if ( counter<1 )
@@ -584,6 +609,17 @@ int MbdEvent::ProcessRawPackets(MbdPmtContainer *bbcpmts)
   std::array<Double_t,MbdDefs::MBD_N_FEECH> tdc{0.};
   tdc.fill( 0. );
 
+  // template fit all charge channels in one go
+  if (do_templatefit)
+  {
+    _fitsampmax.resize(_fitchans.size());
+    for (size_t ifit = 0; ifit < _fitchans.size(); ifit++)
+    {
+      _fitsampmax[ifit] = _mbdcal->get_sampmax(_fitchans[ifit]);
+    }
+    MbdSig::FitTemplates(_mbdsig, _fitchans, _fitsampmax);
+  }
+
   for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
   {
     int pmtch = _mbdgeom->get_pmt(ifeech);
@@ -611,17 +647,9 @@ int MbdEvent::ProcessRawPackets(MbdPmtContainer *bbcpmts)
     else if ( type == 1 ) // process charge channels which have good time hit
     {
 
-      // Use dCFD method to seed time in charge channels (or as primary if not fitting template)
-      // std::cout << "getspline " << ifeech << std::endl;
-      _mbdsig[ifeech].GetSplineAmpl();
-      Double_t threshold = 0.5;
-      m_pmttq[pmtch] = _mbdsig[ifeech].dCFD(threshold);
-      m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in adc units
       if (do_templatefit)
       {
-        //std::cout << "fittemplate" << std::endl;
-        _mbdsig[ifeech].FitTemplate( _mbdcal->get_sampmax(ifeech) );
-
+        // already fit above, FitTemplates()
         if ( _verbose )
         {
           std::cout << "tt " << ifeech << " " << pmtch << " " << m_pmttt[pmtch] << std::endl;
@@ -629,6 +657,15 @@ int MbdEvent::ProcessRawPackets(MbdPmtContainer *bbcpmts)
         m_pmttq[pmtch] = _mbdsig[ifeech].GetTime(); // in units of sample number
         m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in units of adc
       }
+      else
+      {
+        // Use dCFD method to get time in charge channels when not fitting template
+        // std::cout << "getspline " << ifeech << std::endl;
+        _mbdsig[ifeech].GetSplineAmpl();
+        Double_t threshold = 0.5;
+        m_pmttq[pmtch] = _mbdsig[ifeech].dCFD(threshold);
+        m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in adc units
+      }
 
       // calpass 2, uncal_mbd. template fit. make sure qgain = 1, tq_t0 = 0
  
@@ -124,6 +124,8 @@ class MbdEvent
   Float_t m_pmttq[MbdDefs::MBD_N_PMT]{};  // time in each arm
 
   int do_templatefit{1};
+  std::vector<int> _fitchans;     //! feech of the channels with a template fit
+  std::vector<int> _fitsampmax;   //! their sampmax, updated every event
 
   // output data
   Short_t m_bbcn[2]{};                                            // num hits for each arm (north and south)
@@ -13,19 +13,79 @@
 #include <TSpline.h>
 #include <TTree.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <limits>
 
 using namespace std;
 
+namespace
+{
+  // event-by-event pedestal mean and rms. Only values inside the range
+  // of hPed0 are counted, as was the case for the histogram this replaces
+  struct PedSums
+  {
+    Double_t n{0.};
+    Double_t sum{0.};
+    Double_t sum2{0.};
+
+    void Add(const Double_t y)
+    {
+      if (y >= -0.5 && y < 2999.5)
+      {
+        n += 1.;
+        sum += y;
+        sum2 += y * y;
+      }
+    }
+    Double_t Mean() const { return n > 0. ? sum / n : 0.; }
+    Double_t RMS() const
+    {
+      if (n <= 0.)
+      {
+        return 0.;
+      }
+      Double_t var = sum2 / n - Mean() * Mean();
+      return var > 0. ? std::sqrt(var) : 0.;
+    }
+  };
+
+  // half width of the time window searched by the native template fit, in samples.
+  // Same as the fit time limits MbdEvent sets (sampmax-2 +/- 3)
+  const Double_t template_fit_window = 3.0;
+  // step of the coarse scan of the native template fit, the minimum is then refined
+  // by a golden section search to template_fit_tolerance
+  const Double_t template_fit_step = 0.1;
+  const Double_t template_fit_tolerance = 1e-4;
+}  // namespace
+
 MbdSig::MbdSig(const int chnum, const int nsamp)
   : _ch{chnum}
-  , _nsamples{nsamp}
 {
+  SetNSamples(nsamp);
   // cout << "In MbdSig::MbdSig(" << _ch << "," << _nsamples << ")" << endl;
 }
 
+void MbdSig::SetNSamples( const int s )
+{
+  // the waveform arrays hold at most MAX_SAMPLES samples
+  if ( s < 0 || s > MbdDefs::MAX_SAMPLES )
+  {
+    static int counter = 0;
+    if ( counter < 4 )
+    {
+      std::cout << PHWHERE << " ch " << _ch << ": " << s << " samples requested, limited to "
+                << MbdDefs::MAX_SAMPLES << std::endl;
+      counter++;
+    }
+    _nsamples = std::clamp(s, 0, MbdDefs::MAX_SAMPLES);
+    return;
+  }
+  _nsamples = s;
+}
+
 void MbdSig::Init()
 {
   TString name;
@@ -57,9 +117,6 @@ void MbdSig::Init()
   name += _ch;
   hPed0 = new TH1F(name, name, 3000, -0.5, 2999.5);
   // hPed0 = new TH1F(name,name,10000,1,0); // automatically determine the range
-  name = "hPedEvt_";
-  name += _ch;
-  hPedEvt = new TH1F(name, name, 3000, -0.5, 2999.5);
 
   SetTemplateSize(900, 1000, -10., 20.);
   // SetTemplateSize(300,300,0.,15.);
@@ -104,6 +161,8 @@ void MbdSig::SetTemplateSize(const Int_t nptsx, const Int_t nptsy, const Double_
   h2Residuals = new TH2F(name, name, template_npointsx, template_begintime - xbinwid / 2., template_endtime + xbinwid / 2,
                          80, -20, 20);
 
+  MakeTemplateTable();
+
   /*
   int nbins[] = { template_npointsx, nbinsy };
   Double_t lowrange[] = { template_begintime-xbinwid/2.0, -0.1+ybinwid/2.0 };
@@ -161,14 +220,14 @@ void MbdSig::SetY(const Float_t* y, const int invert)
     Init();
   }
 
-  hpulse->Reset();
   f_ampl = -9999.;
   f_time = -9999.;
 
+  m_rawerr = 0.;
   for (int isamp = 0; isamp < _nsamples; isamp++)
   {
-    hRawPulse->SetBinContent(isamp + 1, y[isamp]);
-    gRawPulse->SetPoint(isamp, Double_t(isamp), y[isamp]);
+    m_x[isamp] = isamp;
+    m_rawy[isamp] = y[isamp];
   }
 
   // Apply pedestal
@@ -191,11 +250,9 @@ void MbdSig::SetY(const Float_t* y, const int invert)
 
     for (int isamp = 0; isamp < _nsamples; isamp++)
     {
-      hSubPulse->SetBinContent(isamp + 1, invert * (y[isamp] - ped0));
-      hSubPulse->SetBinError(isamp + 1, ped0rms);
-      gSubPulse->SetPoint(isamp, (Double_t) isamp, invert * (y[isamp] - ped0));
-      gSubPulse->SetPointError(isamp, 0., ped0rms);
+      m_suby[isamp] = invert * (y[isamp] - ped0);
     }
+    m_nsub = _nsamples;
   }
 
   _evt_counter++;
@@ -209,8 +266,6 @@ void MbdSig::SetXY(const Float_t* x, const Float_t* y, const int invert)
     Init();
   }
 
-  hRawPulse->Reset();
-  hSubPulse->Reset();
   _status = 0;
 
   f_ampl = -9999.;
@@ -219,15 +274,16 @@ void MbdSig::SetXY(const Float_t* x, const Float_t* y, const int invert)
   // cout << "_nsamples " << _nsamples << endl;
   // cout << "use_ped0 " << use_ped0 << "\t" << ped0 << endl;
 
+  m_rawerr = 4.0;
   for (int isamp = 0; isamp < _nsamples; isamp++)
   {
     // cout << "aaa\t" << isamp << "\t" << x[isamp] << "\t" << y[isamp] << endl;
-    hRawPulse->SetBinContent(isamp + 1, y[isamp]);
-    gRawPulse->SetPoint(isamp, x[isamp], y[isamp]);
-    gRawPulse->SetPointError(isamp, 0, 4.0);
+    m_x[isamp] = x[isamp];
+    m_rawy[isamp] = y[isamp];
   }
   if ( _verbose && _ch==9 )
   {
+    FillGraphs();
     gRawPulse->Draw("ap");
     gRawPulse->GetHistogram()->SetTitle(gRawPulse->GetName());
     gPad->SetGridy(1);
@@ -257,13 +313,12 @@ void MbdSig::SetXY(const Float_t* x, const Float_t* y, const int invert)
       {
         cout << "bbb ch " << _ch << "\t" << isamp << "\t" << x[isamp] << "\t" << invert*(y[isamp]-ped0) << endl;
       }
-      hSubPulse->SetBinContent(isamp + 1, invert * (y[isamp] - ped0));
-      hSubPulse->SetBinError(isamp + 1, ped0rms);
-      gSubPulse->SetPoint(isamp, x[isamp], invert * (y[isamp] - ped0));
-      gSubPulse->SetPointError(isamp, 0., ped0rms);
+      m_suby[isamp] = invert * (y[isamp] - ped0);
     }
+    m_nsub = _nsamples;
     if ( _verbose && _ch==9 )
     {
+      FillGraphs();
       cout << "SetXY: ch " << _ch << endl;
       gSubPulse->Print("ALL");
     }
@@ -273,15 +328,52 @@ void MbdSig::SetXY(const Float_t* x, const Float_t* y, const int invert)
   _verbose = 0;
 }
 
+void MbdSig::FillGraphs()
+{
+  if (hRawPulse == nullptr)
+  {
+    Init();
+  }
+
+  hRawPulse->Reset();
+  for (int isamp = 0; isamp < _nsamples; isamp++)
+  {
+    hRawPulse->SetBinContent(isamp + 1, m_rawy[isamp]);
+    gRawPulse->SetPoint(isamp, m_x[isamp], m_rawy[isamp]);
+    gRawPulse->SetPointError(isamp, 0., m_rawerr);
+  }
+
+  hSubPulse->Reset();
+  for (int isamp = 0; isamp < m_nsub; isamp++)
+  {
+    hSubPulse->SetBinContent(isamp + 1, m_suby[isamp]);
+    hSubPulse->SetBinError(isamp + 1, ped0rms);
+    gSubPulse->SetPoint(isamp, m_x[isamp], m_suby[isamp]);
+    gSubPulse->SetPointError(isamp, 0., ped0rms);
+  }
+}
+
+TH1 *MbdSig::GetHist()
+{
+  FillGraphs();
+  return hpulse;
+}
+
+TGraphErrors *MbdSig::GetGraph()
+{
+  FillGraphs();
+  return gpulse;
+}
+
 Double_t MbdSig::GetSplineAmpl()
 {
-  if (gSubPulse == nullptr)
+  if (m_nsub == 0)
   {
-    cout << "gsub bad " << (uint64_t) gSubPulse << endl;
+    cout << "gsub bad, no pedestal subtracted samples" << endl;
     return 0.;
   }
 
-  TSpline3 s3("s3", gSubPulse);
+  TSpline3 s3("s3", m_x, m_suby, m_nsub);
 
   // First find maximum, to rescale
   f_ampl = -999999.;
@@ -306,11 +398,9 @@ void MbdSig::WritePedHist()
 
 void MbdSig::FillPed0(const Int_t sampmin, const Int_t sampmax)
 {
-  Double_t x, y;
-  for (int isamp = sampmin; isamp <= sampmax; isamp++)
+  for (int isamp = sampmin; isamp <= sampmax && isamp < _nsamples; isamp++)
   {
-    gRawPulse->GetPoint(isamp, x, y);
-    // gRawPulse->Print("all");
+    Double_t y = m_rawy[isamp];
     hPed0->Fill(y);
 
     /*
@@ -327,11 +417,10 @@ void MbdSig::FillPed0(const Int_t sampmin, const Int_t sampmax)
 
 void MbdSig::FillPed0(const Double_t begin, const Double_t end)
 {
-  Double_t x, y;
-  Int_t n = gRawPulse->GetN();
-  for (int isamp = 0; isamp < n; isamp++)
+  for (int isamp = 0; isamp < _nsamples; isamp++)
   {
-    gRawPulse->GetPoint(isamp, x, y);
+    Double_t x = m_x[isamp];
+    Double_t y = m_rawy[isamp];
     if (x >= begin && x <= end)
     {
       hPed0->Fill(y);
@@ -367,23 +456,22 @@ void MbdSig::SetPed0(const Double_t mean, const Double_t rms)
 void MbdSig::CalcEventPed0(const Int_t minpedsamp, const Int_t maxpedsamp)
 {
   // if (_ch==8) cout << "In MbdSig::CalcEventPed0(int,int)" << endl;
-  hPedEvt->Reset();
+  PedSums pedevt;
 
-  Double_t x, y;
-  for (int isamp = minpedsamp; isamp <= maxpedsamp; isamp++)
+  for (int isamp = minpedsamp; isamp <= maxpedsamp && isamp < _nsamples; isamp++)
   {
-    gRawPulse->GetPoint(isamp, x, y);
+    Double_t y = m_rawy[isamp];
 
     hPed0->Fill(y);
-    hPedEvt->Fill(y);
+    pedevt.Add(y);
     // ped0stats->Push( y );
     // if ( _ch==8 ) cout << "ped0stats " << isamp << "\t" << y << endl;
   }
 
   // use straight mean for pedestal
   // Could consider using fit to hPed0 to remove outliers
-  float mean = hPedEvt->GetMean();
-  float rms = hPedEvt->GetRMS();
+  float mean = pedevt.Mean();
+  float rms = pedevt.RMS();
 
   SetPed0(mean, rms);
   // if (_ch==8) cout << "ped0stats mean, rms " << mean << "\t" << rms << endl;
@@ -392,26 +480,24 @@ void MbdSig::CalcEventPed0(const Int_t minpedsamp, const Int_t maxpedsamp)
 // Get Event by Event Ped0 if requested
 void MbdSig::CalcEventPed0(const Double_t minpedx, const Double_t maxpedx)
 {
-  hPedEvt->Reset();
-
-  Double_t x, y;
-  Int_t n = gRawPulse->GetN();
+  PedSums pedevt;
 
-  for (int isamp = 0; isamp < n; isamp++)
+  for (int isamp = 0; isamp < _nsamples; isamp++)
   {
-    gRawPulse->GetPoint(isamp, x, y);
+    Double_t x = m_x[isamp];
+    Double_t y = m_rawy[isamp];
 
     if (x >= minpedx && x <= maxpedx)
     {
       hPed0->Fill(y);
-      hPedEvt->Fill(y);
+      pedevt.Add(y);
       // ped0stats->Push( y );
     }
   }
 
   // use straight mean for pedestal
   // Could consider using fit to hPed0 to remove outliers
-  SetPed0(hPedEvt->GetMean(), hPedEvt->GetRMS());
+  SetPed0(pedevt.Mean(), pedevt.RMS());
 }
 
 // Get Event by Event Ped0, num samples before peak
@@ -427,7 +513,7 @@ void MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
   Long64_t max = ped_presamp_maxsamp;
 
   // actual max from event
-  Long64_t actual_max = TMath::LocMax(gRawPulse->GetN(), gRawPulse->GetY());
+  Long64_t actual_max = TMath::LocMax(_nsamples, m_rawy);
 
   if ( ped_presamp_maxsamp == -1 ) // if there is no maxsamp set, use the max found in this event
   {
@@ -473,38 +559,55 @@ void MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
     rms = 5.0;
   }
 
-  ped_fcn->SetRange(minsamp-0.1,maxsamp+0.1);
-  ped_fcn->SetParameter(0,1500.);
-  if ( _verbose )
+  // fit of a constant to the samples in [minsamp-0.1,maxsamp+0.1].
+  // All samples have the same error, so the fit is the mean of the samples
+  const Double_t minpedx = minsamp - 0.1;
+  const Double_t maxpedx = maxsamp + 0.1;
+  double pedsum = 0.;
+  int npedsamp = 0;
+  for (int isamp = 0; isamp < _nsamples; isamp++)
   {
-    gRawPulse->Fit( ped_fcn, "RQ" );
-
-    double chi2ndf = ped_fcn->GetChisquare()/ped_fcn->GetNDF();
-    if ( chi2ndf > 4.0 )
+    if (m_x[isamp] >= minpedx && m_x[isamp] <= maxpedx)
     {
-      gRawPulse->Draw("ap");
-      ped_fcn->Draw("same");
-      PadUpdate();
+      pedsum += m_rawy[isamp];
+      npedsamp++;
     }
   }
-  else
+  if (npedsamp < 2)
   {
-    //std::cout << PHWHERE << std::endl;
-    gRawPulse->Fit( ped_fcn, "RNQ" );
+    // no pedestal fit possible, keep the previous pedestal
+    return;
   }
+  const double pedfit = pedsum / npedsamp;
+  const double pederr2 = (m_rawerr > 0.) ? m_rawerr * m_rawerr : 1.;  // unit weights without errors, as in TGraph::Fit
+  double chi2 = 0.;
+  for (int isamp = 0; isamp < _nsamples; isamp++)
+  {
+    if (m_x[isamp] >= minpedx && m_x[isamp] <= maxpedx)
+    {
+      chi2 += (m_rawy[isamp] - pedfit) * (m_rawy[isamp] - pedfit) / pederr2;
+    }
+  }
+  double ndf = npedsamp - 1;
 
-  double chi2 = ped_fcn->GetChisquare();
-  double ndf = ped_fcn->GetNDF();
+  if ( _verbose && chi2/ndf > 4.0 )
+  {
+    FillGraphs();
+    ped_fcn->SetRange(minpedx, maxpedx);
+    ped_fcn->SetParameter(0, pedfit);
+    gRawPulse->Draw("ap");
+    ped_fcn->Draw("same");
+    PadUpdate();
+  }
 
   if ( chi2/ndf < 4.0 )
   {
-    mean = ped_fcn->GetParameter(0);
+    mean = pedfit;
 
-    Double_t x, y;
-
-    for (int isamp = minsamp; isamp <= maxsamp; isamp++)
+    for (int isamp = minsamp; isamp <= maxsamp && isamp < _nsamples; isamp++)
     {
-      gRawPulse->GetPoint(isamp, x, y);
+      Double_t x = m_x[isamp];
+      Double_t y = m_rawy[isamp];
 
       // exclude outliers
       if ( fabs(y-mean) < 4.0*rms )
@@ -534,6 +637,7 @@ void MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
 
       if ( _verbose )
       {
+        FillGraphs();
         gRawPulse->Draw("ap");
         PadUpdate();
 
@@ -570,9 +674,9 @@ Double_t MbdSig::LeadingEdge(const Double_t threshold)
   // Find first point above threshold
   // We also make sure the next point is above threshold
   // to get rid of a high fluctuation
-  int n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  int n = m_nsub;
+  const Double_t* x = m_x;
+  const Double_t* y = m_suby;
 
   int sample = -1;
   for (int isamp = 0; isamp < n; isamp++)
@@ -606,9 +710,9 @@ Double_t MbdSig::dCFD(const Double_t fraction_threshold)
   // Find first point above threshold
   // We also make sure the next point is above threshold
   // to get rid of a high fluctuation
-  int n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  int n = m_nsub;
+  const Double_t* x = m_x;
+  const Double_t* y = m_suby;
 
   // Get max amplitude
   Double_t ymax = TMath::MaxElement(n, y);
@@ -651,9 +755,9 @@ Double_t MbdSig::MBDTDC(const Int_t max_samp)
 {
   // Get the amplitude of a fixed sample (max_samp) to get time
   // Used in MBD Time Channels
-  Double_t* y = gSubPulse->GetY();
+  const Double_t* y = m_suby;
 
-  if (y == nullptr)
+  if (m_nsub == 0)
   {
     std::cout << "ERROR y == 0" << std::endl;
     return NAN;
@@ -679,9 +783,9 @@ Double_t MbdSig::MBDTDC(const Int_t max_samp)
 
 Double_t MbdSig::Integral(const Double_t xmin, const Double_t xmax)
 {
-  Int_t n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  Int_t n = m_nsub;
+  const Double_t* x = m_x;
+  const Double_t* y = m_suby;
 
   f_integral = 0.;
   for (int ix = 0; ix < n; ix++)
@@ -702,15 +806,16 @@ void MbdSig::LocMax(Double_t& x_at_max, Double_t& ymax, Double_t xminrange, Doub
   _verbose = 0;
   if ( _verbose && _ch==250 )
   {
+    FillGraphs();
     gSubPulse->Draw("ap");
     gPad->Modified();
     gPad->Update();
   }
 
   // Find index of maximum peak
-  Int_t n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  Int_t n = m_nsub;
+  const Double_t* x = m_x;
+  const Double_t* y = m_suby;
 
   // if flipped or equal, we search the whole range
   if (xmaxrange <= xminrange)
@@ -753,9 +858,9 @@ void MbdSig::LocMax(Double_t& x_at_max, Double_t& ymax, Double_t xminrange, Doub
 void MbdSig::LocMin(Double_t& x_at_max, Double_t& ymin, Double_t xminrange, Double_t xmaxrange)
 {
   // Find index of minimum peak (for neg signals)
-  Int_t n = gSubPulse->GetN();
-  Double_t* x = gSubPulse->GetX();
-  Double_t* y = gSubPulse->GetY();
+  Int_t n = m_nsub;
+  const Double_t* x = m_x;
+  const Double_t* y = m_suby;
 
   // if flipped or equal, we search the whole range
   if (xmaxrange <= xminrange)
@@ -791,12 +896,11 @@ void MbdSig::LocMin(Double_t& x_at_max, Double_t& ymin, Double_t xminrange, Doub
 
 void MbdSig::Print()
 {
-  Double_t x, y;
+  const Double_t *y = (gpulse == gSubPulse) ? m_suby : m_rawy;
   cout << "CH " << _ch << endl;
   for (int isamp = 0; isamp < _nsamples; isamp++)
   {
-    gpulse->GetPoint(isamp, x, y);
-    cout << isamp << "\t" << x << "\t" << y << endl;
+    cout << isamp << "\t" << m_x[isamp] << "\t" << y[isamp] << endl;
   }
 }
 
@@ -853,7 +957,7 @@ Double_t MbdSig::TemplateFcn(const Double_t* x, const Double_t* par)
 		  << " ERROR x par0 par1 " << x[0] << "\t" << par[0] << "\t" << par[1] << std::endl;
 	if ( x[0] == 0. )
 	{
-	  gSubPulse->Print("ALL");
+	  Print();
 	}
       }
       return 0.;
@@ -926,11 +1030,9 @@ Double_t MbdSig::TemplateFcn(const Double_t* x, const Double_t* par)
 
   // Reject points where ADC saturates
   int samp_point = static_cast<int>(x[0]);
-  Double_t temp_x, temp_y;
-  gRawPulse->GetPoint(samp_point, temp_x, temp_y);
-  if (temp_y > 16370)
+  if (samp_point >= 0 && samp_point < _nsamples && m_rawy[samp_point] > 16370)
   {
-    // cout << "XXXX " << _ch << "\t" << samp_point << "\t" << temp_x << "\t" << temp_y << std::endl;
+    // cout << "XXXX " << _ch << "\t" << samp_point << "\t" << m_rawy[samp_point] << std::endl;
     TF1::RejectPoint();
   }
 
@@ -938,6 +1040,116 @@ Double_t MbdSig::TemplateFcn(const Double_t* x, const Double_t* par)
   return f;
 }
 
+Double_t MbdSig::TemplateChi2(const Double_t t, const Double_t xmax, Double_t& ampl) const
+{
+  // same points as the ones TemplateFcn accepts: inside the template range, on good
+  // parts of the template and not saturated. The errors are all ped0rms, so they
+  // don't change the minimum and are left out
+  Double_t sum_yt = 0.;
+  Double_t sum_tt = 0.;
+  Double_t sum_yy = 0.;
+  for (int isamp = 0; isamp < m_nsub; isamp++)
+  {
+    const Double_t x = m_x[isamp];
+    if (x < 0. || x > xmax)
+    {
+      continue;
+    }
+
+    const Double_t xx = x - t;
+    if (xx < template_begintime || xx > template_endtime)
+    {
+      continue;
+    }
+
+    const Double_t index = (xx - template_begintime) / template_step;
+    const int ilow = std::min(static_cast<int>(index), template_npointsx - 1);
+    const int ihigh = (index > ilow) ? std::min(ilow + 1, template_npointsx - 1) : ilow;
+    if (!template_ok[ilow] || !template_ok[ihigh])
+    {
+      continue;
+    }
+
+    const int samp_point = static_cast<int>(x);
+    if (samp_point < _nsamples && m_rawy[samp_point] > 16370)
+    {
+      continue;
+    }
+
+    const Double_t tval = template_y[ilow] + (template_slope[ilow] * (index - ilow));
+    const Double_t y = m_suby[isamp];
+    sum_yt += y * tval;
+    sum_tt += tval * tval;
+    sum_yy += y * y;
+  }
+
+  if (sum_tt <= 0.)
+  {
+    ampl = 0.;
+    return sum_yy;
+  }
+
+  // for a given time, chi2 is quadratic in the amplitude
+  ampl = sum_yt / sum_tt;
+  return sum_yy - (ampl * sum_yt);
+}
+
+void MbdSig::FitTemplateTime(const Double_t tseed, const Double_t xmax, Double_t& ampl, Double_t& time) const
+{
+  // coarse scan around the seed, so that we land in the same minimum as a fit started at the seed
+  Double_t tbest = tseed;
+  Double_t chi2best = TemplateChi2(tseed, xmax, ampl);
+  const int nsteps = static_cast<int>(std::lround(template_fit_window / template_fit_step));
+  for (int istep = -nsteps; istep <= nsteps; istep++)
+  {
+    Double_t t = tseed + (istep * template_fit_step);
+    Double_t a;
+    Double_t chi2 = TemplateChi2(t, xmax, a);
+    if (chi2 < chi2best)
+    {
+      chi2best = chi2;
+      tbest = t;
+    }
+  }
+
+  // golden section search in the interval around the best scan point
+  const Double_t gr = 0.5 * (std::sqrt(5.) - 1.);
+  Double_t tlo = tbest - template_fit_step;
+  Double_t thi = tbest + template_fit_step;
+  Double_t t1 = thi - (gr * (thi - tlo));
+  Double_t t2 = tlo + (gr * (thi - tlo));
+  Double_t a;
+  Double_t chi2_1 = TemplateChi2(t1, xmax, a);
+  Double_t chi2_2 = TemplateChi2(t2, xmax, a);
+  while ((thi - tlo) > template_fit_tolerance)
+  {
+    if (chi2_1 < chi2_2)
+    {
+      thi = t2;
+      t2 = t1;
+      chi2_2 = chi2_1;
+      t1 = thi - (gr * (thi - tlo));
+      chi2_1 = TemplateChi2(t1, xmax, a);
+    }
+    else
+    {
+      tlo = t1;
+      t1 = t2;
+      chi2_1 = chi2_2;
+      t2 = tlo + (gr * (thi - tlo));
+      chi2_2 = TemplateChi2(t2, xmax, a);
+    }
+  }
+
+  Double_t tmin = 0.5 * (tlo + thi);
+  if (TemplateChi2(tmin, xmax, a) < chi2best)
+  {
+    tbest = tmin;
+  }
+  time = tbest;
+  TemplateChi2(time, xmax, ampl);
+}
+
 // sampmax>0 means fit to the peak near sampmax
 int MbdSig::FitTemplate( const Int_t sampmax )
 {
@@ -949,7 +1161,7 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   }
 
   // Check if channel is empty
-  if (gSubPulse->GetN() == 0)
+  if (m_nsub == 0)
   {
     f_ampl = 0.;
     f_time = std::numeric_limits<Float_t>::quiet_NaN();
@@ -957,18 +1169,30 @@ int MbdSig::FitTemplate( const Int_t sampmax )
     return 1;
   }
 
+  if (template_ok.empty())
+  {
+    f_ampl = 0.;
+    f_time = std::numeric_limits<Float_t>::quiet_NaN();
+    cout << PHWHERE << " ERROR, no template for ch " << _ch << endl;
+    return 1;
+  }
+
   // Get x and y of maximum
   Double_t x_at_max{-1.};
   Double_t ymax{0.};
   if ( sampmax>=0 )
   {
-    gSubPulse->GetPoint(sampmax, x_at_max, ymax);
+    if ( sampmax < m_nsub )
+    {
+      x_at_max = m_x[sampmax];
+      ymax = m_suby[sampmax];
+    }
     x_at_max -= 2.0;
   }
   else
   {
-    ymax = TMath::MaxElement( gSubPulse->GetN(), gSubPulse->GetY() );
-    x_at_max = TMath::LocMax( gSubPulse->GetN(), gSubPulse->GetY() );
+    ymax = TMath::MaxElement( m_nsub, m_suby );
+    x_at_max = TMath::LocMax( m_nsub, m_suby );
   }
 
   // Threshold cut
@@ -980,6 +1204,7 @@ int MbdSig::FitTemplate( const Int_t sampmax )
     {
       // for checking pedestal
       std::cout << "skipping, ymax < 20" << std::endl;
+      FillGraphs();
       gSubPulse->Draw("ap");
       gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
       gPad->SetGridy(1);
@@ -990,81 +1215,32 @@ int MbdSig::FitTemplate( const Int_t sampmax )
     return 1;
   }
 
-  template_fcn->SetParameters(ymax, x_at_max);
-  // template_fcn->SetParLimits(1, fit_min_time, fit_max_time);
-  // template_fcn->SetParLimits(1, 3, 15);
-  // template_fcn->SetRange(template_min_xrange,template_max_xrange);
-  template_fcn->SetRange(0, _nsamples);
-
-  if (_verbose == 0)
-  {
-    //std::cout << PHWHERE << std::endl;
-    gSubPulse->Fit(template_fcn, "RNQ");
-  }
-  else
-  {
-    std::cout << "doing fit " << _verbose << std::endl;
-    gSubPulse->Fit(template_fcn, "R");
-    gSubPulse->Draw("ap");
-    gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
-    gPad->SetGridy(1);
-    std::cout << "doing fit2 " << _verbose << std::endl;
-    PadUpdate();
-    std::cout << "doing fit3 " << _verbose << std::endl;
-    //gSubPulse->Print("ALL");
-  }
-
-  // Get fit parameters
-  f_ampl = template_fcn->GetParameter(0);
-  f_time = template_fcn->GetParameter(1);
+  // The amplitude is linear in the template, so for a given time it is solved exactly,
+  // and only the time needs to be minimized. This gives the same minimum as the 2 parameter fit
+  // of template_fcn to gSubPulse, without creating a fitter for every channel and event
+  FitTemplateTime(x_at_max, _nsamples, f_ampl, f_time);
   if ( f_time<0. || f_time>_nsamples )
   {
     f_time = _nsamples*0.5;  // bad fit last time
   }
 
   // refit with new range to exclude after-pulses
-  template_fcn->SetParameters( f_ampl, f_time );
-  template_fcn->SetRange( 0., f_time+4.0 );
-
-  if (_verbose == 0)
-  {
-    //std::cout << PHWHERE << std::endl;
-    int fit_status = gSubPulse->Fit(template_fcn, "RNQ");
-    if ( fit_status<0 && _verbose )
-    {
-      std::cout << PHWHERE << "\t" << fit_status << std::endl;
-      gSubPulse->Print("ALL");
-      gSubPulse->Draw("ap");
-      gSubPulse->Fit(template_fcn, "R");
-      std::cout << "ampl time before refit " << f_ampl << "\t" << f_time << std::endl;
-      f_ampl = template_fcn->GetParameter(0);
-      f_time = template_fcn->GetParameter(1);
-      std::cout << "ampl time after  refit " << f_ampl << "\t" << f_time << std::endl;
-      PadUpdate();
-      std::string junk;
-      std::cin >> junk;
-    }
-  }
-  else
+  if (_verbose > 0)
   {
-    gSubPulse->Fit(template_fcn, "R");
-    //gSubPulse->Print("ALL");
     std::cout << "ampl time before refit " << f_ampl << "\t" << f_time << std::endl;
-    f_ampl = template_fcn->GetParameter(0);
-    f_time = template_fcn->GetParameter(1);
-    std::cout << "ampl time after  refit " << f_ampl << "\t" << f_time << std::endl;
   }
-
-  f_ampl = template_fcn->GetParameter(0);
-  f_time = template_fcn->GetParameter(1);
+  FitTemplateTime(f_time, f_time + 4.0, f_ampl, f_time);
 
   if (_verbose > 0 && fabs(f_ampl) > 0.)
   //if ( f_time<0 || f_time>30 )
   {
     cout << "FitTemplate " << _ch << "\t" << f_ampl << "\t" << f_time << endl;
+    FillGraphs();
     gSubPulse->Draw("ap");
     gSubPulse->GetHistogram()->SetTitle(gSubPulse->GetName());
     gPad->SetGridy(1);
+    template_fcn->SetParameters(f_ampl, f_time);
+    template_fcn->SetRange(0., _nsamples);
     template_fcn->SetLineColor(4);
     template_fcn->Draw("same");
     PadUpdate();
@@ -1074,6 +1250,31 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   return 1;
 }
 
+void MbdSig::FitTemplates(std::vector<MbdSig>& sigs, const std::vector<int>& chans, const std::vector<int>& sampmax)
+{
+  for (size_t i = 0; i < chans.size(); i++)
+  {
+    sigs[chans[i]].FitTemplate(sampmax[i]);
+  }
+}
+
+void MbdSig::MakeTemplateTable()
+{
+  template_step = (template_endtime - template_begintime) / (template_npointsx - 1);
+
+  const int npts = std::min({template_npointsx, static_cast<int>(template_y.size()), static_cast<int>(template_yrms.size())});
+  template_slope.assign(template_npointsx, 0.);
+  template_ok.assign(template_npointsx, 0);
+  for (int i = 0; i < npts; i++)
+  {
+    if (i + 1 < npts)
+    {
+      template_slope[i] = template_y[i + 1] - template_y[i];
+    }
+    template_ok[i] = (template_yrms[i] < 1.0);
+  }
+}
+
 int MbdSig::SetTemplate(const std::vector<float>& shape, const std::vector<float>& sherr)
 {
   template_y = shape;
@@ -1114,5 +1315,7 @@ int MbdSig::SetTemplate(const std::vector<float>& shape, const std::vector<float
     }
   }
 
+  MakeTemplateTable();
+
   return 1;
 }
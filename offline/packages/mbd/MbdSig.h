@@ -1,6 +1,7 @@
 #ifndef __MBDSIG_H__
 #define __MBDSIG_H__
 
+#include "MbdDefs.h"
 #include "MbdRunningStats.h"
 
 #include <TH1.h>
@@ -32,14 +33,16 @@ class MbdSig
 
   // MbdSig& operator= (const MbdSig& obj) = delete; // never used
 
-  void SetNSamples( const int s ) { _nsamples = s; }
+  //! number of samples used, limited to MbdDefs::MAX_SAMPLES
+  void SetNSamples( const int s );
   void SetY(const Float_t *y, const int invert = 1);
   void SetXY(const Float_t *x, const Float_t *y, const int invert = 1);
 
   void SetCalib(MbdCalib *mcal);
 
-  TH1 *GetHist() { return hpulse; }
-  TGraphErrors *GetGraph() { return gpulse; }
+  /** The waveform is kept in plain arrays, the hist and graph are only filled when asked for */
+  TH1 *GetHist();
+  TGraphErrors *GetGraph();
   Double_t GetAmpl() { return f_ampl; }
   Double_t GetTime() { return f_time; }
   Double_t GetIntegral() { return f_integral; }
@@ -102,6 +105,9 @@ class MbdSig
 
   /** Use template fit to get ampl and time */
   Int_t FitTemplate(const Int_t sampmax = -1);
+
+  /** Template fit of many channels, sampmax[i] is used for sigs[chans[i]] */
+  static void FitTemplates(std::vector<MbdSig> &sigs, const std::vector<int> &chans, const std::vector<int> &sampmax);
   // Double_t Ampl() { return f_ampl; }
   // Double_t Time() { return f_time; }
 
@@ -124,6 +130,18 @@ class MbdSig
  private:
   void Init();
 
+  /** Copy the sample arrays to the hists and graphs, for drawing and for the accessors */
+  void FillGraphs();
+
+  /** Precompute the interpolation table of the template, called when the template is set */
+  void MakeTemplateTable();
+
+  /** chi2 of the template at time t to the samples in [0,xmax], with the amplitude (returned in ampl) solved in closed form */
+  Double_t TemplateChi2(const Double_t t, const Double_t xmax, Double_t &ampl) const;
+
+  /** Minimize the template chi2 in time, starting from tseed */
+  void FitTemplateTime(const Double_t tseed, const Double_t xmax, Double_t &ampl, Double_t &time) const;
+
   int _ch;
   int _nsamples;
   int _status{0};
@@ -140,6 +158,13 @@ class MbdSig
 
   Double_t f_integral{0.}; /** integral */
 
+  /** waveform, x is in sample number (or time for DRS4 data) */
+  Double_t m_x[MbdDefs::MAX_SAMPLES]{};
+  Double_t m_rawy[MbdDefs::MAX_SAMPLES]{};
+  Double_t m_suby[MbdDefs::MAX_SAMPLES]{};  //! pedestal subtracted
+  Double_t m_rawerr{0.};                    //! error on the raw samples
+  int m_nsub{0};                            //! number of pedestal subtracted samples, 0 until a ped is applied
+
   TH1 *hRawPulse{nullptr};           //!
   TH1 *hSubPulse{nullptr};           //!
   TH1 *hpulse{nullptr};              //!
@@ -151,7 +176,6 @@ class MbdSig
   //std::unique_ptr<MbdRunningStats> ped0stats{nullptr};    //!
   MbdRunningStats *ped0stats{nullptr};    //!
   TH1 *hPed0{nullptr};            //! all events
-  TH1 *hPedEvt{nullptr};          //! evt-by-event pedestal
   TF1 *ped_fcn{nullptr};
   TF1 *ped_tail{nullptr};         //! tail of prev signal
   Double_t ped0{0.};                  //!
@@ -184,6 +208,9 @@ class MbdSig
   // Double_t template_max_xrange{0.};             //! for template, in original units of waveform data
   std::vector<float> template_y;
   std::vector<float> template_yrms;
+  std::vector<float> template_slope;  //! template_y[i+1]-template_y[i], for the native fit
+  std::vector<char> template_ok;      //! template_yrms[i] < 1, points on bad parts of the template are not fit
+  Double_t template_step{0.};         //! spacing of the template points
   TF1 *template_fcn{nullptr};
   Double_t fit_min_time{};  //! min time for fit, in original units of waveform data
   Double_t fit_max_time{};  //! max time for fit, in original units of waveform data
@@ -261,11 +261,16 @@ int MicromegasClusterizer::process_event(PHCompositeNode *topNode)
     // initialize cluster count
     int cluster_count = 0;
 
+    // clusters and associations of this hitset, added to the containers at once
+    std::vector<TrkrCluster*> hitset_clusters( ranges.size(), nullptr );
+    TrkrClusterHitAssoc::AssocVector hitset_assocs;
+
     // loop over found hit ranges and create clusters
     for( const auto& range : ranges )
     {
       // create cluster key and corresponding cluster
-      const auto ckey = TrkrDefs::genClusKey( hitsetkey, cluster_count++ );
+      const auto cluster_index = cluster_count++;
+      const auto ckey = TrkrDefs::genClusKey( hitsetkey, cluster_index );
 
       TVector2 local_coordinates;
       double weight_sum = 0;
@@ -290,7 +295,7 @@ int MicromegasClusterizer::process_event(PHCompositeNode *topNode)
         const auto hit = hit_it->second;
 
         // associate cluster key to hit key
-        trkrClusterHitAssoc->addAssoc(ckey, hitkey );
+        hitset_assocs.emplace_back( ckey, hitkey );
 
         // get strip number
         const auto strip = MicromegasDefs::getStrip( hitkey );
@@ -391,13 +396,16 @@ int MicromegasClusterizer::process_event(PHCompositeNode *topNode)
         }
       }
 
-      trkrClusterContainer->addClusterSpecifyKey( ckey, cluster.release() );
+      hitset_clusters[cluster_index] = cluster.release();
 
       // increment counter
       ++m_clustercounts[hitsetkey];
 
     }
 
+    trkrClusterContainer->addClusters( hitsetkey, std::move( hitset_clusters ) );
+    trkrClusterHitAssoc->addAssocs( hitsetkey, std::move( hitset_assocs ) );
+
   }
   // done
   return Fun4AllReturnCodes::EVENT_OK;
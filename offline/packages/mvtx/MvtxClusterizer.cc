@@ -408,6 +408,11 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       cluster_ids.insert(component[i]);
       clusters.insert(make_pair(component[i], hitvec[i]));
     }
+
+    // clusters and associations of this hitset, added to the containers at once.
+    // Cluster ids run from 0 to the number of components
+    std::vector<TrkrCluster *> hitset_clusters(cluster_ids.size(), nullptr);
+    TrkrClusterHitAssoc::AssocVector hitset_assocs;
     int total_clusters = 0;
     for (set<int>::iterator clusiter = cluster_ids.begin();
          clusiter != cluster_ids.end(); ++clusiter)
@@ -488,7 +493,7 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
         loczsum += local_coords.Z();
         // add the association between this cluster key and this hitkey to the
         // table
-        m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
+        hitset_assocs.emplace_back(ckey, mapiter->second.first);
 
       }  // mapiter
 
@@ -616,10 +621,13 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
 
       if (zbins.size() <= 127)
       {
-        m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
+        hitset_clusters[clusid] = clus.release();
       }
 
     }  // clusitr loop
+
+    m_clusterlist->addClusters(hitset->getHitSetKey(), std::move(hitset_clusters));
+    m_clusterhitassoc->addAssocs(hitset->getHitSetKey(), std::move(hitset_assocs));
   }    // loop over hitsets
 
   if (Verbosity() > 1)
@@ -723,6 +731,11 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
       cluster_ids.insert(component[i]);
       clusters.insert(make_pair(component[i], hitvec[i]));
     }
+
+    // clusters and associations of this hitset, added to the containers at once.
+    // Cluster ids run from 0 to the number of components
+    std::vector<TrkrCluster *> hitset_clusters(cluster_ids.size(), nullptr);
+    TrkrClusterHitAssoc::AssocVector hitset_assocs;
     //    cout << "found cluster #: "<< clusters.size()<< endl;
     // loop over the componenets and make clusters
     for (set<int>::iterator clusiter = cluster_ids.begin();
@@ -896,9 +909,12 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
 
       if (zbins.size() <= 127)
       {
-        m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
+        hitset_clusters[clusid] = clus.release();
       }
     }  // clusitr loop
+
+    m_clusterlist->addClusters(hitset->getHitSetKey(), std::move(hitset_clusters));
+    m_clusterhitassoc->addAssocs(hitset->getHitSetKey(), std::move(hitset_assocs));
   }    // loop over hitsets
 
   if (Verbosity() > 1)
@@ -2,6 +2,9 @@
 // Must include first to avoid conflict with "ClassDef" in Rtypes.h
 #include <torch/script.h>
 
+#include <ATen/Parallel.h>
+#include <c10/core/InferenceMode.h>
+
 #include "TpcClusterizer.h"
 
 #include "TrainingHits.h"
@@ -18,7 +21,6 @@
 #include <trackbase/TrkrHit.h>
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
-#include <trackbase/alignmentTransformationContainer.h>
 
 #include <trackbase/RawHit.h>
 #include <trackbase/RawHitSet.h>
@@ -86,6 +88,14 @@ namespace
   const int nd = 5;
   torch::jit::script::Module module_pos;
 
+  // cluster waiting for its NN position, evaluated for the whole sector at once
+  struct nn_cluster
+  {
+    TrkrCluster *cluster = nullptr;
+    Surface surface;
+    const TrainingHits *training_hits = nullptr;
+  };
+
   struct thread_data
   {
     PHG4TpcCylinderGeom *layergeom = nullptr;
@@ -121,10 +131,15 @@ namespace
     std::vector<assoc> association_vector;
     std::vector<TrkrCluster *> cluster_vector;
     std::vector<TrainingHits *> v_hits;
+    std::vector<nn_cluster> nn_clusters;  // only filled if use_nn
     int verbosity = 0;
     bool fillClusHitsVerbose = false;
     vec_dVerbose phivec_ClusHitsVerbose;  // only fill if fillClusHitsVerbose
     vec_dVerbose zvec_ClusHitsVerbose;    // only fill if fillClusHitsVerbose
+    // if set, the thread adds its clusters and associations to the containers itself.
+    // Only used if the containers reserved the hitsets up front
+    TrkrClusterContainer *clusterlist = nullptr;
+    TrkrClusterHitAssoc *clusterhitassoc = nullptr;
   };
 
   pthread_mutex_t mythreadlock;
@@ -597,10 +612,12 @@ namespace
     Acts::Vector3 global(clusx, clusy, clusz);
     TrkrDefs::subsurfkey subsurfkey = 0;
 
+    // the TPC clusters in global coordinates, the local coordinates are obtained with the construction transforms
     Surface surface = my_data.tGeometry->get_tpc_surface_from_coords(
         tpcHitSetKey,
         global,
-        subsurfkey);
+        subsurfkey,
+        ActsGeometry::getIdealGeoContext());
 
     if (!surface)
     {
@@ -632,7 +649,7 @@ namespace
     /// convert to Acts units
     global *= Acts::UnitConstants::cm;
     // std::cout << "transform" << std::endl;
-    Acts::Vector3 local = surface->transform(my_data.tGeometry->geometry().getGeoContext()).inverse() * global;
+    Acts::Vector3 local = surface->transform(ActsGeometry::getIdealGeoContext()).inverse() * global;
     local /= Acts::UnitConstants::cm;
     // std::cout << "done transform" << std::endl;
     //  we need the cluster key and all associated hit keys (note: the cluster key includes the hitset key)
@@ -664,33 +681,8 @@ namespace
 
     if (use_nn && clus_base && training_hits)
     {
-      try
-      {
-        // Create a vector of inputs
-        std::vector<torch::jit::IValue> inputs;
-        inputs.emplace_back(torch::stack({torch::from_blob(std::vector<float>(training_hits->v_adc.begin(), training_hits->v_adc.end()).data(), {1, 2 * nd + 1, 2 * nd + 1}, torch::kFloat32),
-                                          torch::full({1, 2 * nd + 1, 2 * nd + 1}, std::clamp((training_hits->layer - 7) / 16, 0, 2), torch::kFloat32),
-                                          torch::full({1, 2 * nd + 1, 2 * nd + 1}, training_hits->z / radius, torch::kFloat32)},
-                                         1));
-
-        // Execute the model and turn its output into a tensor
-        at::Tensor ten_pos = module_pos.forward(inputs).toTensor();
-        float nn_phi = training_hits->phi + std::clamp(ten_pos[0][0][0].item<float>(), -(float) nd, (float) nd) * training_hits->phistep;
-        float nn_z = training_hits->z + std::clamp(ten_pos[0][1][0].item<float>(), -(float) nd, (float) nd) * training_hits->zstep;
-        float nn_x = radius * std::cos(nn_phi);
-        float nn_y = radius * std::sin(nn_phi);
-        Acts::Vector3 nn_global(nn_x, nn_y, nn_z);
-        nn_global *= Acts::UnitConstants::cm;
-        Acts::Vector3 nn_local = surface->transform(my_data.tGeometry->geometry().geoContext).inverse() * nn_global;
-        nn_local /= Acts::UnitConstants::cm;
-        float nn_t = my_data.m_tdriftmax - std::fabs(nn_z) / my_data.tGeometry->get_drift_velocity();
-        clus_base->setLocalX(nn_local(0));
-        clus_base->setLocalY(nn_t);
-      }
-      catch (const c10::Error &e)
-      {
-        std::cout << PHWHERE << "Error: Failed to execute NN modules" << std::endl;
-      }
+      // the position is replaced once all clusters of the sector are found, see ProcessSectorNN
+      my_data.nn_clusters.push_back({clus_base, surface, training_hits});
     }  // use_nn
 
     if (my_data.fillClusHitsVerbose && b_made_cluster)
@@ -1010,10 +1002,88 @@ namespace
     */
     // pthread_exit(nullptr);
   }
+
+  // NN cluster positions of the sector, evaluated in one forward call
+  void ProcessSectorNN(thread_data *my_data)
+  {
+    auto &nn_clusters = my_data->nn_clusters;
+    if (nn_clusters.empty())
+    {
+      return;
+    }
+
+    // batch of (adc, layer group, z/r) windows, the same layout as the stack of the single cluster inputs
+    constexpr int nwindow = (2 * nd + 1) * (2 * nd + 1);
+    const int64_t nclus = nn_clusters.size();
+    at::Tensor input = torch::empty({nclus, 3, 2 * nd + 1, 2 * nd + 1}, torch::kFloat32);
+    float *data = input.data_ptr<float>();
+    for (const auto &entry : nn_clusters)
+    {
+      const TrainingHits *training_hits = entry.training_hits;
+      std::copy(training_hits->v_adc.begin(), training_hits->v_adc.end(), data);
+      std::fill_n(data + nwindow, nwindow, std::clamp((training_hits->layer - 7) / 16, 0, 2));
+      std::fill_n(data + 2 * nwindow, nwindow, training_hits->z / training_hits->radius);
+      data += 3 * nwindow;
+    }
+
+    try
+    {
+      c10::InferenceMode guard;
+      std::vector<torch::jit::IValue> inputs{input};
+
+      // Execute the model and turn its output into a tensor
+      at::Tensor ten_pos = module_pos.forward(inputs).toTensor().contiguous();
+      const auto pos = ten_pos.accessor<float, 3>();
+      for (int64_t i = 0; i < nclus; ++i)
+      {
+        const auto &[cluster, surface, training_hits] = nn_clusters[i];
+        const float radius = training_hits->radius;
+        float nn_phi = training_hits->phi + std::clamp(pos[i][0][0], -(float) nd, (float) nd) * training_hits->phistep;
+        float nn_z = training_hits->z + std::clamp(pos[i][1][0], -(float) nd, (float) nd) * training_hits->zstep;
+        float nn_x = radius * std::cos(nn_phi);
+        float nn_y = radius * std::sin(nn_phi);
+        Acts::Vector3 nn_global(nn_x, nn_y, nn_z);
+        nn_global *= Acts::UnitConstants::cm;
+        Acts::Vector3 nn_local = surface->transform(ActsGeometry::getIdealGeoContext()).inverse() * nn_global;
+        nn_local /= Acts::UnitConstants::cm;
+        float nn_t = my_data->m_tdriftmax - std::fabs(nn_z) / my_data->tGeometry->get_drift_velocity();
+        cluster->setLocalX(nn_local(0));
+        cluster->setLocalY(nn_t);
+      }
+    }
+    catch (const c10::Error &e)
+    {
+      std::cout << PHWHERE << "Error: Failed to execute NN modules" << std::endl;
+    }
+    nn_clusters.clear();
+  }
+
+  // hand over all clusters and associations of the sector to the containers, without per cluster insertion
+  void PublishSectorData(thread_data *my_data)
+  {
+    const auto hitsetkey = TpcDefs::genHitSetKey(my_data->layer, my_data->sector, my_data->side);
+
+    // association_vector holds the cluster index, replace it by the cluster key
+    for (auto &[ckey, hkey] : my_data->association_vector)
+    {
+      ckey = TrkrDefs::genClusKey(hitsetkey, ckey);
+    }
+    my_data->clusterlist->addClusters(hitsetkey, std::move(my_data->cluster_vector));
+    my_data->clusterhitassoc->addAssocs(hitsetkey, std::move(my_data->association_vector));
+  }
+
   void *ProcessSector(void *threadarg)
   {
     auto my_data = static_cast<thread_data *>(threadarg);
     ProcessSectorData(my_data);
+    if (use_nn)
+    {
+      ProcessSectorNN(my_data);
+    }
+    if (my_data->clusterlist)
+    {
+      PublishSectorData(my_data);
+    }
     pthread_exit(nullptr);
   }
 }  // namespace
@@ -1132,6 +1202,7 @@ int TpcClusterizer::InitRun(PHCompositeNode *topNode)
     {
       // Deserialize the ScriptModule from a file using torch::jit::load()
       module_pos = torch::jit::load(net_model);
+      module_pos.eval();
       std::cout << PHWHERE << "Load NN module: " << net_model << std::endl;
     }
     catch (const c10::Error &e)
@@ -1139,6 +1210,8 @@ int TpcClusterizer::InitRun(PHCompositeNode *topNode)
       std::cout << PHWHERE << "Error: Cannot load module " << net_model << std::endl;
       exit(1);
     }
+    // the sectors are already processed in parallel, more intra-op threads would oversubscribe the cores
+    at::set_num_threads(_nn_threads);
   }
   else
   {
@@ -1171,8 +1244,7 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
 {
   // The TPC is the only subsystem that clusters in global coordinates. For consistency,
   // we must use the construction transforms to get the local coordinates.
-  // Set the flag to use ideal transforms for the duration of this process_event, for thread safety
-  alignmentTransformationContainer::use_alignment = false;
+  // These are selected by passing ActsGeometry::getIdealGeoContext() to the geometry queries
 
   //  int print_layer = 18;
 
@@ -1289,6 +1361,35 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
     std::cout << std::endl << " mutex init failed" << std::endl;
     return 1;
   }
+
+  // with all hitsets reserved in the containers, each thread adds its own clusters.
+  // The verbose cluster hits need the clusters in order, they are still added here
+  bool publish_in_threads = false;
+  if (!mClusHitsVerbose)
+  {
+    TrkrClusterContainer::HitSetKeyList hitsetkeys;
+    hitsetkeys.reserve(num_hitsets);
+    auto add_key = [&hitsetkeys](TrkrDefs::hitsetkey key)
+    { hitsetkeys.push_back(TpcDefs::genHitSetKey(TrkrDefs::getLayer(key), TpcDefs::getSectorId(key), TpcDefs::getSide(key))); };
+    if (!do_read_raw)
+    {
+      for (auto hitsetitr = hitsetrange.first; hitsetitr != hitsetrange.second; ++hitsetitr)
+      {
+        add_key(hitsetitr->first);
+      }
+    }
+    else
+    {
+      for (auto hitsetitr = rawhitsetrange.first; hitsetitr != rawhitsetrange.second; ++hitsetitr)
+      {
+        add_key(hitsetitr->first);
+      }
+    }
+    // both reservations are needed, do not short circuit
+    const bool clusters_reserved = m_clusterlist->reserveHitSets(hitsetkeys);
+    const bool assocs_reserved = m_clusterhitassoc->reserveHitSets(hitsetkeys);
+    publish_in_threads = clusters_reserved && assocs_reserved;
+  }
   int count = 0;
 
   if (!do_read_raw)
@@ -1358,6 +1459,11 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       thread_pair.data.drift_velocity = m_tGeometry->get_drift_velocity();
       thread_pair.data.pads_per_sector = 0;
       thread_pair.data.phistep = 0;
+      if (publish_in_threads)
+      {
+        thread_pair.data.clusterlist = m_clusterlist;
+        thread_pair.data.clusterhitassoc = m_clusterhitassoc;
+      }
       int rc;
       rc = pthread_create(&thread_pair.thread, &attr, ProcessSector, (void *) &thread_pair.data);
 
@@ -1377,7 +1483,7 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
         const auto &data(thread_pair.data);
         const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
 
-        // copy clusters to map
+        // copy clusters to map. The vectors are empty if the thread already added them
         for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
         {
           // generate cluster key
@@ -1465,6 +1571,11 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       thread_pair.data.phioffset = PhiOffset;
       thread_pair.data.tbins = NTBinsSide;
       thread_pair.data.toffset = TOffset;
+      if (publish_in_threads)
+      {
+        thread_pair.data.clusterlist = m_clusterlist;
+        thread_pair.data.clusterhitassoc = m_clusterhitassoc;
+      }
 
       /*
       PHG4TpcCylinderGeom *testlayergeom = geom_container->GetLayerCellGeom(32);
@@ -1483,7 +1594,8 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
         Surface surface = m_tGeometry->get_tpc_surface_from_coords(
                                                                    tpcHitSetKey,
                                                                    global,
-                                                                   subsurfkey);
+                                                                   subsurfkey,
+                                                                   ActsGeometry::getIdealGeoContext());
         std::cout << " iphi: " << iphi << " clusphi: " << clusphi << " surfkey " << subsurfkey << std::endl;
         //	std::cout << "surfkey" << subsurfkey << std::endl;
       }
@@ -1512,7 +1624,7 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
         const auto &data(thread_pair.data);
         const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
 
-        // copy clusters to map
+        // copy clusters to map. The vectors are empty if the thread already added them
         for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
         {
           // generate cluster key
@@ -1556,7 +1668,7 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       const auto &data(thread_pair.data);
       const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
 
-      // copy clusters to map
+      // copy clusters to map. The vectors are empty if the thread already added them
       for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
       {
         // generate cluster key
@@ -1604,8 +1716,12 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
     }
   }
 
-  // set the flag to use alignment transformations, needed by the rest of reconstruction
-  alignmentTransformationContainer::use_alignment = true;
+  // reserved hitsets in which no cluster was found are not kept
+  if (publish_in_threads)
+  {
+    m_clusterlist->pruneHitSets();
+    m_clusterhitassoc->pruneHitSets();
+  }
 
   if (Verbosity() > 0)
   {
@@ -39,6 +39,8 @@ class TpcClusterizer : public SubsysReco
   void set_sector_fiducial_cut(const double cut) { SectorFiducialCut = cut; }
   void set_store_hits(bool store_hits) { _store_hits = store_hits; }
   void set_use_nn(bool use_nn) { _use_nn = use_nn; }
+  //! torch intra-op threads for the NN, on top of the sector threads
+  void set_nn_threads(int nthreads) { _nn_threads = nthreads; }
   void set_do_hit_association(bool do_assoc) { do_hit_assoc = do_assoc; }
   void set_do_wedge_emulation(bool do_wedge) { do_wedge_emulation = do_wedge; }
   void set_do_sequential(bool do_seq) { do_sequential = do_seq; }
@@ -85,6 +87,7 @@ class TpcClusterizer : public SubsysReco
   ActsGeometry *m_tGeometry = nullptr;
   bool _store_hits = false;
   bool _use_nn = false;
+  int _nn_threads = 1;
   bool do_hit_assoc = true;
   bool do_wedge_emulation = false;
   bool do_sequential = false;
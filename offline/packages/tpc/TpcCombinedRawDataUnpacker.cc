@@ -34,11 +34,16 @@
 #include <TNtuple.h>
 #include <TSystem.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
-#include <cstdint>   // for exit
-#include <cstdlib>   // for exit
-#include <iostream>  // for operator<<, endl, bas...
-#include <map>       // for _Rb_tree_iterator
+#include <cstdint>     // for exit
+#include <cstdlib>     // for exit
+#include <functional>  // for std::ref
+#include <iostream>    // for operator<<, endl, bas...
+#include <iterator>    // for std::size
+#include <map>         // for _Rb_tree_iterator
+#include <thread>
 #include <utility>
 
 #define dEBUG
@@ -62,6 +67,18 @@ int TpcCombinedRawDataUnpacker::Init(PHCompositeNode* /*topNode*/)
     // use generic CDBTree to load
     m_cdbttree = new CDBTTree(calibdir);
     m_cdbttree->LoadCalibrations();
+
+    // layer and phi of all channels, to avoid the CDBTTree lookups in the event loop
+    m_channel_map.assign(std::size(FEE_map) * 256, ChannelMap());
+    for (unsigned int key = 0; key < m_channel_map.size(); ++key)
+    {
+      auto& channel = m_channel_map[key];
+      channel.layer = m_cdbttree->GetIntValue(key, "layer", 0);
+      if (channel.layer > 0)
+      {
+        channel.phi = m_cdbttree->GetDoubleValue(key, "phi", 0);
+      }
+    }
   }
   else
   {
@@ -180,7 +197,6 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
     return Fun4AllReturnCodes::DISCARDEVENT;
   }
   _ievent++;
-  TH1F pedhist("pedhist", "pedhist", 251, -2.0, 1002);
 
   TrkrHitSetContainer* trkr_hit_set_container = findNode::getClass<TrkrHitSetContainer>(topNode, "TRKR_HITSET");
   if (!trkr_hit_set_container)
@@ -215,19 +231,13 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
     return Fun4AllReturnCodes::ABORTRUN;
   }
 
-  TrkrDefs::hitsetkey hit_set_key = 0;
-  TrkrDefs::hitkey hit_key = 0;
-  TrkrHitSetContainer::Iterator hit_set_container_itr;
-  TrkrHit* hit = nullptr;
-
   uint64_t bco_min = UINT64_MAX;
   uint64_t bco_max = 0;
 
+  // split the raw hits in ranges from the same packet
   const auto nhits = tpccont->get_nhits();
-
-  int ntotalchannels = 0;
-  int n_noisychannels = 0;
-  int max_time_range = 0;
+  m_range_begin.clear();
+  int32_t last_packet_id = 0;
   for (unsigned int i = 0; i < nhits; i++)
   {
     TpcRawHit* tpchit = tpccont->get_hit(i);
@@ -242,257 +252,76 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
       bco_max = gtm_bco;
     }
 
-    int fee = tpchit->get_fee();
-    int channel = tpchit->get_channel();
-    int feeM = FEE_map[fee];
-    if (FEE_R[fee] == 2)
-    {
-      feeM += 6;
-    }
-    if (FEE_R[fee] == 3)
+    const int32_t packet_id = tpchit->get_packetid();
+    if (i == 0 || packet_id != last_packet_id)
     {
-      feeM += 14;
+      m_range_begin.push_back(i);
+      last_packet_id = packet_id;
     }
+  }
+  m_range_begin.push_back(nhits);
 
-    int side = 1;
-    int32_t packet_id = tpchit->get_packetid();
-    int ep = (packet_id - 4000) % 10;
-    int sector = (packet_id - 4000 - ep) / 10;
-    if (sector > 11)
-    {
-      side = 0;
-    }
+  // the buffers keep their capacity from one event to the next
+  const std::size_t nranges = m_range_begin.size() - 1;
+  if (m_unpacked.size() < nranges)
+  {
+    m_unpacked.resize(nranges);
+  }
+  for (std::size_t irange = 0; irange < nranges; ++irange)
+  {
+    auto& unpacked = m_unpacked[irange];
+    unpacked.channels.clear();
+    unpacked.hits.clear();
+    unpacked.ntotalchannels = 0;
+    unpacked.n_noisychannels = 0;
+  }
+
+  if (Verbosity() > 2)
+  {
+    std::cout << "TpcCombinedRawDataUnpacker:: " << (m_do_zerosup ? "do zero suppression" : "no zero suppression") << std::endl;
+  }
 
-    unsigned int key = 256 * (feeM) + channel;
-    std::string varname = "layer";
-    int layer = m_cdbttree->GetIntValue(key, varname);
-    // antenna pads will be in 0 layer
-    if (layer <= 0)
+  // unpack the packets. Baseline correction and tree output fill shared objects, they run on a single thread
+  std::atomic<std::size_t> next_range(0);
+  const unsigned int nthreads = (m_do_baseline_corr || m_writeTree) ? 1 : std::min<std::size_t>(m_nthreads, nranges);
+  if (nthreads <= 1)
+  {
+    unpack_ranges(tpccont, geom_container, next_range);
+  }
+  else
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+    for (unsigned int i = 0; i < nthreads; ++i)
     {
-      continue;
+      threads.emplace_back(&TpcCombinedRawDataUnpacker::unpack_ranges, this, tpccont, geom_container, std::ref(next_range));
     }
-
-    uint16_t sampadd = tpchit->get_sampaaddress();
-    uint16_t sampch = tpchit->get_sampachannel();
-    uint16_t sam = tpchit->get_samples();
-    max_time_range = sam;
-    varname = "phi";  // + std::to_string(key);
-    double phi = -1 * pow(-1, side) * m_cdbttree->GetDoubleValue(key, varname) + (sector % 12) * M_PI / 6;
-    PHG4TpcCylinderGeom* layergeom = geom_container->GetLayerCellGeom(layer);
-    unsigned int phibin = layergeom->get_phibin(phi);
-    if (m_writeTree)
+    for (auto& thread : threads)
     {
-      float fX[12];
-      int n = 0;
-
-      fX[n++] = _ievent - 1;
-      fX[n++] = gtm_bco;
-      fX[n++] = packet_id;
-      fX[n++] = ep;
-      fX[n++] = sector;
-      fX[n++] = side;
-      fX[n++] = fee;
-      fX[n++] = channel;
-      fX[n++] = sampadd;
-      fX[n++] = sampch;
-      fX[n++] = sam;
-      m_ntup->Fill(fX);
+      thread.join();
     }
+  }
 
-    hit_set_key = TpcDefs::genHitSetKey(layer, (mc_sectors[sector % 12]), side);
-    hit_set_container_itr = trkr_hit_set_container->findOrAddHitSet(hit_set_key);
-
-    float hpedestal = 0;
-    float hpedwidth = 0;
-    pedhist.Reset();
-
-    if (!m_do_zerosup)
+  // add the hits to the container, in the order of the raw hits
+  int ntotalchannels = 0;
+  int n_noisychannels = 0;
+  for (std::size_t irange = 0; irange < nranges; ++irange)
+  {
+    const auto& unpacked = m_unpacked[irange];
+    ntotalchannels += unpacked.ntotalchannels;
+    n_noisychannels += unpacked.n_noisychannels;
+    for (const auto& channel : unpacked.channels)
     {
-      if (Verbosity() > 2)
+      TrkrHitSet* hitset = trkr_hit_set_container->findOrAddHitSet(channel.hitsetkey)->second;
+      for (std::size_t ihit = channel.first; ihit < channel.first + channel.count; ++ihit)
       {
-        std::cout << "TpcCombinedRawDataUnpacker:: no zero suppression" << std::endl;
-      }
-      for (uint16_t s = 0; s < sam; s++)
-      {
-        uint16_t adc = tpchit->get_adc(s);
-        int t = s - m_presampleShift;
-
-        hit_key = TpcDefs::genHitKey(phibin, (unsigned int) t);
+        const auto& [hit_key, adc] = unpacked.hits[ihit];
         // find existing hit, or create new one
-        hit = hit_set_container_itr->second->getHit(hit_key);
-        if (!hit)
+        if (!hitset->getHit(hit_key))
         {
-          hit = new TrkrHitv2();
-          hit->setAdc(float(adc));
-
-          hit_set_container_itr->second->addHitSpecificKey(hit_key, hit);
-        }
-      }
-    }
-    else
-    {
-      if (Verbosity() > 2)
-      {
-        std::cout << "TpcCombinedRawDataUnpacker:: do zero suppression" << std::endl;
-      }
-      TH2I* feehist = nullptr;
-      if(!m_do_zs_emulation){
-	for (uint16_t sampleNum = 0; sampleNum < sam; sampleNum++)
-	  {
-	    uint16_t adc = tpchit->get_adc(sampleNum);
-	    if (adc > 0)
-	      {
-		pedhist.Fill(adc);
-	      }
-	  }
-	int hmax = 0;
-	int hmaxbin = 0;
-	for (int nbin = 1; nbin <= pedhist.GetNbinsX(); nbin++)
-	  {
-	    float val = pedhist.GetBinContent(nbin);
-	    if (val > hmax)
-	      {
-		hmaxbin = nbin;
-		hmax = val;
-	      }
-	  }
-	
-	// calculate pedestal mean and sigma
-	
-	if (pedhist.GetStdDev() == 0 || pedhist.GetEntries() == 0)
-	  {
-	    hpedestal = pedhist.GetBinCenter(pedhist.GetMaximumBin());
-	    hpedwidth = 999;
-	  }
-	else
-	  {
-	    // calc peak position
-	    double adc_sum = 0.0;
-	    double ibin_sum = 0.0;
-	    double ibin2_sum = 0.0;
-	    
-	    for (int isum = -3; isum <= 3; isum++)
-	      {
-		float val = pedhist.GetBinContent(hmaxbin + isum);
-		float center = pedhist.GetBinCenter(hmaxbin + isum);
-		ibin_sum += center * val;
-		ibin2_sum += center * center * val;
-		adc_sum += val;
-	      }
-	    
-	    hpedestal = ibin_sum / adc_sum;
-	    hpedwidth = sqrt(ibin2_sum / adc_sum - (hpedestal * hpedestal));
-	  }
-	if (m_do_baseline_corr)
-	  {
-	    unsigned int pad_key = create_pad_key(side, layer, phibin);
-	    
-	    std::map<unsigned int, chan_info>::iterator chan_it = chan_map.find(pad_key);
-	    if (chan_it != chan_map.end())
-	      {
-		(*chan_it).second.ped = hpedestal;
-		(*chan_it).second.width = hpedwidth;
-	      }
-	    else
-	      {
-		chan_info nucinfo;
-		nucinfo.fee = fee;
-		nucinfo.ped = hpedestal;
-		nucinfo.width = hpedwidth;
-		chan_map.insert(std::make_pair(pad_key, nucinfo));
-	      }
-	    int rx = get_rx(layer);
-	    unsigned int fee_key = create_fee_key(side, mc_sectors[sector % 12], rx, fee);
-	    // find or insert TH2I;
-	    std::map<unsigned int, TH2I*>::iterator fee_map_it;
-	    
-	    fee_map_it = feeadc_map.find(fee_key);
-	    if (fee_map_it != feeadc_map.end())
-	      {
-		feehist = (*fee_map_it).second;
-	      }
-	    else
-	      {
-		std::string histname = "h" + std::to_string(fee_key);
-		feehist = new TH2I(histname.c_str(), "histname", max_time_range + 1, -0.5, max_time_range + 0.5, 501, -0.5, 1000.5);
-		feeadc_map.insert(std::make_pair(fee_key, feehist));
-	      }
-	  }
-	ntotalchannels++;
-	if (m_do_noise_rejection && !m_do_baseline_corr)
-	  {
-	    if (hpedwidth < 0.5 || hpedestal < 10 || hpedwidth == 999)
-	      {
-		n_noisychannels++;
-		continue;
-	      }
-	  }
-      }else{
-	hpedestal = 60;
-	hpedwidth = m_zs_threshold;
-      }
-      for (uint16_t s = 0; s < sam; s++)
-      {
-        uint16_t adc = tpchit->get_adc(s);
-        int t = s - m_presampleShift;
-        if (t < 0)
-        {
-          continue;
-        }
-	if (m_do_baseline_corr && feehist != nullptr &&(!m_do_zs_emulation))
-        {
-          if (adc > 0)
-          {
-            feehist->Fill(t, adc - hpedestal + pedestal_offset);
-          }
-	  
-        }
-	float threshold_cut = (hpedwidth * m_ped_sig_cut);
-	if(m_do_zs_emulation){
-	  threshold_cut = m_zs_threshold;
-	}
-        if ((float(adc) - hpedestal) > threshold_cut)
-        {
-          hit_key = TpcDefs::genHitKey(phibin, (unsigned int) t);
-          // find existing hit, or create new one
-          hit = hit_set_container_itr->second->getHit(hit_key);
-          if (!hit)
-          {
-            hit = new TrkrHitv2();
-            if (m_do_baseline_corr)
-            {
-              hit->setAdc(float(adc) - hpedestal + pedestal_offset);
-            }
-            else
-            {
-              hit->setAdc(float(adc) - hpedestal);
-            }
-            hit_set_container_itr->second->addHitSpecificKey(hit_key, hit);
-          }
-          if (m_writeTree)
-          {
-            float fXh[18];
-            int nh = 0;
-
-            fXh[nh++] = _ievent - 1;
-            fXh[nh++] = 0;                        // gtm_bco;
-            fXh[nh++] = 0;                        // packet_id;
-            fXh[nh++] = 0;                        // ep;
-            fXh[nh++] = mc_sectors[sector % 12];  // Sector;
-            fXh[nh++] = side;
-            fXh[nh++] = fee;
-            fXh[nh++] = 0;  // channel;
-            fXh[nh++] = 0;  // sampadd;
-            fXh[nh++] = 0;  // sampch;
-            fXh[nh++] = (float) phibin;
-            fXh[nh++] = (float) t;
-            fXh[nh++] = layer;
-            fXh[nh++] = (float(adc) - hpedestal + pedestal_offset);
-            fXh[nh++] = hpedestal;
-            fXh[nh++] = hpedwidth;
-
-            m_ntup_hits->Fill(fXh);
-          }
+          TrkrHit* hit = new TrkrHitv2();
+          hit->setAdc(adc);
+          hitset->addHitSpecificKey(hit_key, hit);
         }
       }
     }
@@ -611,7 +440,7 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
         float fee = 0;
         float hpedestal2 = 0;
         float hpedwidth2 = 0;
-        std::map<unsigned int, chan_info>::iterator chan_it = chan_map.find(pad_key);
+        auto chan_it = chan_map.find(pad_key);
         if (chan_it != chan_map.end())
         {
           chan_info cinfo = (*chan_it).second;
@@ -750,6 +579,300 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void TpcCombinedRawDataUnpacker::unpack_ranges(TpcRawHitContainer* tpccont, PHG4TpcCylinderGeomContainer* geom_container, std::atomic<std::size_t>& next_range)
+{
+  const std::size_t nranges = m_range_begin.size() - 1;
+  for (std::size_t irange = next_range++; irange < nranges; irange = next_range++)
+  {
+    auto& output = m_unpacked[irange];
+    for (std::size_t i = m_range_begin[irange]; i < m_range_begin[irange + 1]; ++i)
+    {
+      unpack_channel(tpccont->get_hit(i), geom_container, output);
+    }
+  }
+}
+
+void TpcCombinedRawDataUnpacker::unpack_channel(TpcRawHit* tpchit, PHG4TpcCylinderGeomContainer* geom_container, UnpackedHits& output)
+{
+  int fee = tpchit->get_fee();
+  if (fee < 0 || fee >= (int) std::size(FEE_map))
+  {
+    return;
+  }
+  int channel = tpchit->get_channel();
+  int feeM = FEE_map[fee];
+  if (FEE_R[fee] == 2)
+  {
+    feeM += 6;
+  }
+  if (FEE_R[fee] == 3)
+  {
+    feeM += 14;
+  }
+
+  int side = 1;
+  int32_t packet_id = tpchit->get_packetid();
+  int ep = (packet_id - 4000) % 10;
+  int sector = (packet_id - 4000 - ep) / 10;
+  if (sector > 11)
+  {
+    side = 0;
+  }
+
+  unsigned int key = 256 * (feeM) + channel;
+  if (key >= m_channel_map.size())
+  {
+    return;
+  }
+  const auto& channel_map = m_channel_map[key];
+  int layer = channel_map.layer;
+  // antenna pads will be in 0 layer
+  if (layer <= 0)
+  {
+    return;
+  }
+
+  uint16_t sampadd = tpchit->get_sampaaddress();
+  uint16_t sampch = tpchit->get_sampachannel();
+  uint16_t sam = tpchit->get_samples();
+  double phi = -1 * pow(-1, side) * channel_map.phi + (sector % 12) * M_PI / 6;
+  PHG4TpcCylinderGeom* layergeom = geom_container->GetLayerCellGeom(layer);
+  unsigned int phibin = layergeom->get_phibin(phi);
+  if (m_writeTree)
+  {
+    float fX[12];
+    int n = 0;
+
+    fX[n++] = _ievent - 1;
+    fX[n++] = tpchit->get_gtm_bco();
+    fX[n++] = packet_id;
+    fX[n++] = ep;
+    fX[n++] = sector;
+    fX[n++] = side;
+    fX[n++] = fee;
+    fX[n++] = channel;
+    fX[n++] = sampadd;
+    fX[n++] = sampch;
+    fX[n++] = sam;
+    m_ntup->Fill(fX);
+  }
+
+  // the hitset is created even if no sample passes the threshold
+  output.channels.push_back({TpcDefs::genHitSetKey(layer, (mc_sectors[sector % 12]), side), output.hits.size(), 0});
+
+  // copy the waveform once, raw hits may store samples in a map
+  output.adc.resize(sam);
+  for (uint16_t s = 0; s < sam; s++)
+  {
+    output.adc[s] = tpchit->get_adc(s);
+  }
+  const uint16_t* adc = output.adc.data();
+
+  if (!m_do_zerosup)
+  {
+    for (uint16_t s = 0; s < sam; s++)
+    {
+      int t = s - m_presampleShift;
+      output.hits.emplace_back(TpcDefs::genHitKey(phibin, (unsigned int) t), float(adc[s]));
+    }
+    output.channels.back().count = output.hits.size() - output.channels.back().first;
+    return;
+  }
+
+  float hpedestal = 0;
+  float hpedwidth = 0;
+  TH2I* feehist = nullptr;
+  if (!m_do_zs_emulation)
+  {
+    const auto pedestal = calc_pedestal(adc, sam);
+    hpedestal = pedestal.mean;
+    hpedwidth = pedestal.width;
+
+    if (m_do_baseline_corr)
+    {
+      unsigned int pad_key = create_pad_key(side, layer, phibin);
+
+      auto chan_it = chan_map.find(pad_key);
+      if (chan_it != chan_map.end())
+      {
+        (*chan_it).second.ped = hpedestal;
+        (*chan_it).second.width = hpedwidth;
+      }
+      else
+      {
+        chan_info nucinfo;
+        nucinfo.fee = fee;
+        nucinfo.ped = hpedestal;
+        nucinfo.width = hpedwidth;
+        chan_map.insert(std::make_pair(pad_key, nucinfo));
+      }
+      int rx = get_rx(layer);
+      unsigned int fee_key = create_fee_key(side, mc_sectors[sector % 12], rx, fee);
+      // find or insert TH2I;
+      std::map<unsigned int, TH2I*>::iterator fee_map_it;
+
+      fee_map_it = feeadc_map.find(fee_key);
+      if (fee_map_it != feeadc_map.end())
+      {
+        feehist = (*fee_map_it).second;
+      }
+      else
+      {
+        std::string histname = "h" + std::to_string(fee_key);
+        feehist = new TH2I(histname.c_str(), "histname", sam + 1, -0.5, sam + 0.5, 501, -0.5, 1000.5);
+        feeadc_map.insert(std::make_pair(fee_key, feehist));
+      }
+    }
+    output.ntotalchannels++;
+    if (m_do_noise_rejection && !m_do_baseline_corr)
+    {
+      if (hpedwidth < 0.5 || hpedestal < 10 || hpedwidth == 999)
+      {
+        output.n_noisychannels++;
+        return;
+      }
+    }
+  }
+  else
+  {
+    hpedestal = 60;
+    hpedwidth = m_zs_threshold;
+  }
+
+  // samples before the presample shift are dropped
+  const int first_sample = std::clamp<int>(m_presampleShift, 0, sam);
+
+  if (feehist)
+  {
+    for (int s = first_sample; s < sam; s++)
+    {
+      if (adc[s] > 0)
+      {
+        feehist->Fill(s - m_presampleShift, adc[s] - hpedestal + pedestal_offset);
+      }
+    }
+  }
+
+  // compare the whole waveform to the threshold without branches, so that the loop is vectorized
+  const float threshold_cut = m_do_zs_emulation ? m_zs_threshold : (hpedwidth * m_ped_sig_cut);
+  output.above.resize(sam);
+  uint8_t* above = output.above.data();
+  for (int s = first_sample; s < sam; s++)
+  {
+    above[s] = (float(adc[s]) - hpedestal) > threshold_cut;
+  }
+
+  for (int s = first_sample; s < sam; s++)
+  {
+    if (!above[s])
+    {
+      continue;
+    }
+    int t = s - m_presampleShift;
+    const float hit_adc = m_do_baseline_corr ? float(adc[s]) - hpedestal + pedestal_offset : float(adc[s]) - hpedestal;
+    output.hits.emplace_back(TpcDefs::genHitKey(phibin, (unsigned int) t), hit_adc);
+    if (m_writeTree)
+    {
+      float fXh[18];
+      int nh = 0;
+
+      fXh[nh++] = _ievent - 1;
+      fXh[nh++] = 0;                        // gtm_bco;
+      fXh[nh++] = 0;                        // packet_id;
+      fXh[nh++] = 0;                        // ep;
+      fXh[nh++] = mc_sectors[sector % 12];  // Sector;
+      fXh[nh++] = side;
+      fXh[nh++] = fee;
+      fXh[nh++] = 0;  // channel;
+      fXh[nh++] = 0;  // sampadd;
+      fXh[nh++] = 0;  // sampch;
+      fXh[nh++] = (float) phibin;
+      fXh[nh++] = (float) t;
+      fXh[nh++] = layer;
+      fXh[nh++] = (float(adc[s]) - hpedestal + pedestal_offset);
+      fXh[nh++] = hpedestal;
+      fXh[nh++] = hpedwidth;
+
+      m_ntup_hits->Fill(fXh);
+    }
+  }
+  output.channels.back().count = output.hits.size() - output.channels.back().first;
+}
+
+TpcCombinedRawDataUnpacker::Pedestal TpcCombinedRawDataUnpacker::calc_pedestal(const uint16_t* adc, uint16_t nsamples)
+{
+  // 4 adc wide bins covering [-2, 1002[ in bins 1 to nbins, bin 0 and nbins + 1 are under and overflow
+  constexpr int nbins = 251;
+  constexpr int binwidth = 4;
+  std::array<int, nbins + 2> counts{};
+
+  // bin centers are exact in float
+  auto center = [](int bin)
+  { return float(binwidth * bin - 4); };
+
+  int nentries = 0;
+  uint16_t inrange_min = std::numeric_limits<uint16_t>::max();
+  uint16_t inrange_max = 0;
+  for (uint16_t s = 0; s < nsamples; s++)
+  {
+    const uint16_t value = adc[s];
+    if (value == 0)
+    {
+      continue;
+    }
+    ++nentries;
+    const int bin = (value + 2) / binwidth + 1;
+    if (bin > nbins)
+    {
+      ++counts[nbins + 1];
+      continue;
+    }
+    ++counts[bin];
+    inrange_min = std::min(inrange_min, value);
+    inrange_max = std::max(inrange_max, value);
+  }
+
+  // first bin with the largest content, bin 1 if all are empty
+  int hmax = 0;
+  int hmaxbin = 0;
+  for (int bin = 1; bin <= nbins; bin++)
+  {
+    if (counts[bin] > hmax)
+    {
+      hmaxbin = bin;
+      hmax = counts[bin];
+    }
+  }
+
+  Pedestal pedestal;
+  if (nentries == 0 || inrange_min >= inrange_max)
+  {
+    // no entries, or zero width
+    pedestal.mean = center(hmaxbin > 0 ? hmaxbin : 1);
+    pedestal.width = 999;
+    return pedestal;
+  }
+
+  // calc peak position
+  double adc_sum = 0.0;
+  double ibin_sum = 0.0;
+  double ibin2_sum = 0.0;
+  for (int isum = -3; isum <= 3; isum++)
+  {
+    // like TH1::GetBinContent, bins past the overflow return the overflow content
+    const int bin = hmaxbin + isum;
+    const float val = counts[std::clamp(bin, 0, nbins + 1)];
+    const float bin_center = center(bin);
+    ibin_sum += bin_center * val;
+    ibin2_sum += bin_center * bin_center * val;
+    adc_sum += val;
+  }
+
+  pedestal.mean = ibin_sum / adc_sum;
+  pedestal.width = sqrt(ibin2_sum / adc_sum - (pedestal.mean * pedestal.mean));
+  return pedestal;
+}
+
 int TpcCombinedRawDataUnpacker::End(PHCompositeNode* /*topNode*/)
 {
   if (m_writeTree)
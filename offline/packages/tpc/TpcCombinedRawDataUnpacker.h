@@ -3,19 +3,28 @@
 #ifndef TPC_COMBINEDRAWDATAUNPACKER_H
 #define TPC_COMBINEDRAWDATAUNPACKER_H
 
+#include <trackbase/TrkrDefs.h>
+
 #include <fun4all/SubsysReco.h>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class PHCompositeNode;
+class PHG4TpcCylinderGeomContainer;
 class CDBTTree;
 class CDBInterface;
 class TH2I;
 class TFile;
 class TNtuple;
+class TpcRawHit;
+class TpcRawHitContainer;
 
 class TpcCombinedRawDataUnpacker : public SubsysReco
 {
@@ -41,6 +50,10 @@ class TpcCombinedRawDataUnpacker : public SubsysReco
   void skipNevent(int b) { startevt = b; }
   void useRawHitNodeName(const std::string &name) { m_TpcRawNodeName = name; }
 
+  //! number of threads used to unpack the packets.
+  /*! baseline correction and tree output need the channels in order, they always run on a single thread */
+  void setNThreads(unsigned int nthreads) { m_nthreads = nthreads ? nthreads : 1; }
+
   void event_range(int a, int b)
   {
     startevt = a;
@@ -89,6 +102,50 @@ class TpcCombinedRawDataUnpacker : public SubsysReco
   }
 
  private:
+  //! pedestal mean and width of a channel
+  struct Pedestal
+  {
+    float mean = 0;
+    float width = 0;
+  };
+
+  //! pedestal from the most probable adc value of a waveform
+  /*! same result as filling the adc values in a 251 bin histogram from -2 to 1002 and averaging
+   * the 7 bins around the maximum, using integer counts on the stack */
+  static Pedestal calc_pedestal(const uint16_t *adc, uint16_t nsamples);
+
+  //! layer and phi of a channel from the channel map, indexed by 256 * fee + channel
+  struct ChannelMap
+  {
+    int layer = std::numeric_limits<int>::min();
+    double phi = 0;
+  };
+
+  //! hits above threshold of a channel, to be added to the hitset container
+  struct ChannelHits
+  {
+    TrkrDefs::hitsetkey hitsetkey = 0;
+    std::size_t first = 0;
+    std::size_t count = 0;
+  };
+
+  //! output of a packet, or of a contiguous range of hits from the same packet
+  struct UnpackedHits
+  {
+    std::vector<ChannelHits> channels;
+    std::vector<std::pair<TrkrDefs::hitkey, float>> hits;
+    std::vector<uint16_t> adc;   ///< waveform buffer
+    std::vector<uint8_t> above;  ///< samples above threshold
+    int ntotalchannels = 0;
+    int n_noisychannels = 0;
+  };
+
+  //! unpack a single channel into output
+  void unpack_channel(TpcRawHit *tpchit, PHG4TpcCylinderGeomContainer *geom_container, UnpackedHits &output);
+
+  //! unpack ranges of raw hits from the same packet, taken from next_range
+  void unpack_ranges(TpcRawHitContainer *tpccont, PHG4TpcCylinderGeomContainer *geom_container, std::atomic<std::size_t> &next_range);
+
   TNtuple *m_ntup{nullptr};
   TNtuple *m_ntup_hits = nullptr;
   TNtuple *m_ntup_hits_corr = nullptr;
@@ -115,7 +172,11 @@ class TpcCombinedRawDataUnpacker : public SubsysReco
   int m_zs_threshold{30};
   std::string m_TpcRawNodeName{"TPCRAWHIT"};
   std::string outfile_name;
-  std::map<unsigned int, chan_info> chan_map;                  // stays in place
+  unsigned int m_nthreads{1};
+  std::vector<ChannelMap> m_channel_map;                       // from CDB, filled in Init
+  std::vector<std::size_t> m_range_begin;                      // first raw hit of each packet range, cleared after each event
+  std::vector<UnpackedHits> m_unpacked;                        // one per packet range, reused
+  std::unordered_map<unsigned int, chan_info> chan_map;        // stays in place
   std::map<unsigned int, TH2I *> feeadc_map;                   // histos reset after each event
   std::map<unsigned int, std::vector<float>> feebaseline_map;  // cleared after each event
 };
@@ -21,6 +21,13 @@ namespace
   }
 }  // namespace
 
+const Acts::GeometryContext& ActsGeometry::getIdealGeoContext()
+{
+  // an empty context, sPHENIXActsDetectorElement then returns the construction transform
+  static const Acts::GeometryContext idealContext;
+  return idealContext;
+}
+
 Eigen::Matrix<float, 3, 1> ActsGeometry::getGlobalPositionF(
     TrkrDefs::cluskey key,
     TrkrCluster* cluster)
@@ -30,13 +37,18 @@ Eigen::Matrix<float, 3, 1> ActsGeometry::getGlobalPositionF(
 }
 
 Acts::Vector3 ActsGeometry::getGlobalPosition(TrkrDefs::cluskey key, TrkrCluster* cluster)
+{
+  return getGlobalPosition(key, cluster, geometry().getGeoContext());
+}
+
+Acts::Vector3 ActsGeometry::getGlobalPosition(TrkrDefs::cluskey key, TrkrCluster* cluster, const Acts::GeometryContext& context)
 {
   Acts::Vector3 glob;
 
   const auto trkrid = TrkrDefs::getTrkrId(key);
   if (trkrid == TrkrDefs::tpcId)
   {
-    return getGlobalPositionTpc(key, cluster);
+    return getGlobalPositionTpc(key, cluster, context);
   }
 
   /// If silicon/TPOT, the transform is one-to-one since the surface is planar
@@ -55,7 +67,7 @@ Acts::Vector3 ActsGeometry::getGlobalPosition(TrkrDefs::cluskey key, TrkrCluster
 
   Acts::Vector2 local(cluster->getLocalX(), cluster->getLocalY());
   Acts::Vector3 global;
-  global = surface->localToGlobal(geometry().getGeoContext(),
+  global = surface->localToGlobal(context,
                                   local * Acts::UnitConstants::cm,
                                   Acts::Vector3(1, 1, 1));
   global /= Acts::UnitConstants::cm;
@@ -93,6 +105,11 @@ const float& clockPeriod)
   return glob;
 }
 Acts::Vector3 ActsGeometry::getGlobalPositionTpc(TrkrDefs::cluskey key, TrkrCluster* cluster)
+{
+  return getGlobalPositionTpc(key, cluster, geometry().getGeoContext());
+}
+
+Acts::Vector3 ActsGeometry::getGlobalPositionTpc(TrkrDefs::cluskey key, TrkrCluster* cluster, const Acts::GeometryContext& context)
 {
   Acts::Vector3 glob;
 
@@ -125,7 +142,7 @@ Acts::Vector3 ActsGeometry::getGlobalPositionTpc(TrkrDefs::cluskey key, TrkrClus
     zloc = -zloc;
   }
   Acts::Vector2 local(cluster->getLocalX(), zloc);
-  glob = surface->localToGlobal(geometry().getGeoContext(),
+  glob = surface->localToGlobal(context,
                                 local * Acts::UnitConstants::cm,
                                 Acts::Vector3(1, 1, 1));
   glob /= Acts::UnitConstants::cm;
@@ -137,6 +154,15 @@ Surface ActsGeometry::get_tpc_surface_from_coords(
     TrkrDefs::hitsetkey hitsetkey,
     Acts::Vector3 world,
     TrkrDefs::subsurfkey& subsurfkey)
+{
+  return get_tpc_surface_from_coords(hitsetkey, world, subsurfkey, geometry().getGeoContext());
+}
+
+Surface ActsGeometry::get_tpc_surface_from_coords(
+    TrkrDefs::hitsetkey hitsetkey,
+    Acts::Vector3 world,
+    TrkrDefs::subsurfkey& subsurfkey,
+    const Acts::GeometryContext& context)
 {
   unsigned int layer = TrkrDefs::getLayer(hitsetkey);
   unsigned int side = TpcDefs::getSide(hitsetkey);
@@ -172,7 +198,7 @@ Surface ActsGeometry::get_tpc_surface_from_coords(
 
   Surface this_surf = surf_vec[nsurf];
 
-  auto vec3d = this_surf->center(geometry().getGeoContext());
+  auto vec3d = this_surf->center(context);
   std::vector<double> surf_center = {vec3d(0) / 10.0, vec3d(1) / 10.0, vec3d(2) / 10.0};  // convert from mm to cm
   double surf_phi = atan2(surf_center[1], surf_center[0]);
   double surfStepPhi = geometry().tpcSurfStepPhi;
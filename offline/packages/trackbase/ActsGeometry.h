@@ -42,14 +42,33 @@ class ActsGeometry
       TrkrDefs::cluskey key,
       TrkrCluster* cluster);
 
+  //! geometry context selecting the ideal (construction) transforms
+  /*!
+   * geometry().getGeoContext() carries the alignment transformation container and selects the aligned transforms.
+   * Contexts are passed explicitly, so that ideal and aligned queries can run concurrently
+   */
+  static const Acts::GeometryContext& getIdealGeoContext();
+
+  //! global position with the aligned transforms
   Acts::Vector3 getGlobalPosition(
       TrkrDefs::cluskey key,
       TrkrCluster* cluster);
 
+  //! global position with the transforms selected by context
+  Acts::Vector3 getGlobalPosition(
+      TrkrDefs::cluskey key,
+      TrkrCluster* cluster,
+      const Acts::GeometryContext& context);
+
   Acts::Vector3 getGlobalPositionTpc(
       TrkrDefs::cluskey key,
       TrkrCluster* cluster);
 
+  Acts::Vector3 getGlobalPositionTpc(
+      TrkrDefs::cluskey key,
+      TrkrCluster* cluster,
+      const Acts::GeometryContext& context);
+
   Acts::Vector3 getGlobalPositionTpc(
       const TrkrDefs::hitsetkey& hitsetkey, const TrkrDefs::hitkey& hitkey, const float& phi, const float& rad,
       const float& clockPeriod);
@@ -59,6 +78,12 @@ class ActsGeometry
       Acts::Vector3 world,
       TrkrDefs::subsurfkey& subsurfkey);
 
+  Surface get_tpc_surface_from_coords(
+      TrkrDefs::hitsetkey hitsetkey,
+      Acts::Vector3 world,
+      TrkrDefs::subsurfkey& subsurfkey,
+      const Acts::GeometryContext& context);
+
   Acts::Transform3 makeAffineTransform(Acts::Vector3 rotation, Acts::Vector3 translation);
 
   Acts::Vector2 getLocalCoords(TrkrDefs::cluskey key, TrkrCluster* cluster);
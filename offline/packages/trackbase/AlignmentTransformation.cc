@@ -39,12 +39,6 @@ void AlignmentTransformation::createMap(PHCompositeNode* topNode)
 
   getNodes(topNode);
 
-  // Use construction transforms as a reference for making the map
-  if (alignmentTransformationContainer::use_alignment)
-  {
-    alignmentTransformationContainer::use_alignment = false;
-  }
-
   // Define Parsing Variables
   TrkrDefs::hitsetkey hitsetkey = 0;
   float alpha = 0.0, beta = 0.0, gamma = 0.0, dx = 0.0, dy = 0.0, dz = 0.0, dgrx = 0.0, dgry = 0.0, dgrz = 0.0;
@@ -206,7 +200,7 @@ void AlignmentTransformation::createMap(PHCompositeNode* topNode)
           std::cout << " Add transform for TPC with surface GeometryIdentifier " << id << std::endl
                     << " trkrid " << trkrId << " hitsetkey " << hitsetkey << " layer " << layer << " sector " << sector << " side " << side
                     << " subsurfkey " << subsurfkey << std::endl;
-          Acts::Vector3 center = surf->center(m_tGeometry->geometry().getGeoContext()) * 0.1;  // convert to cm
+          Acts::Vector3 center = surf->center(ActsGeometry::getIdealGeoContext()) * 0.1;  // convert to cm
           std::cout << "Ideal surface center: " << std::endl
                     << center << std::endl;
           std::cout << "transform matrix: " << std::endl
@@ -246,11 +240,8 @@ void AlignmentTransformation::createMap(PHCompositeNode* topNode)
     }
   }
 
-  // copy map into geoContext
+  // copy map into geoContext. Map is created, the geometry context now selects the aligned transforms
   m_tGeometry->geometry().geoContext = transformMap;
-
-  // map is created, now we can use the transforms
-  alignmentTransformationContainer::use_alignment = true;
 }
 
 // currently used as the transform maker
@@ -314,8 +305,8 @@ Acts::Transform3 AlignmentTransformation::newMakeTransform(const Surface& surf,
     mpTranslationAffine.translation() = millepedeTranslationxzy;
   }
 
-  // get the acts transform components
-  Acts::Transform3 actsTransform = surf->transform(m_tGeometry->geometry().getGeoContext());
+  // get the acts transform components. Use construction transforms as a reference for making the map
+  Acts::Transform3 actsTransform = surf->transform(ActsGeometry::getIdealGeoContext());
   Eigen::Matrix3d actsRotationPart = actsTransform.rotation();
   Eigen::Vector3d actsTranslationPart = actsTransform.translation();
 
@@ -0,0 +1,93 @@
+#include "ClusterPositionCache.h"
+
+#include <iostream>
+
+//_________________________________________________________________
+void ClusterPositionCache::invalidate()
+{
+  m_slices.clear();
+  m_nslots = 0;
+  m_container = nullptr;
+  m_valid = false;
+
+  // keep the capacity, the cache is refilled every event
+  m_raw.clear();
+  m_corrected.clear();
+  m_filled.clear();
+}
+
+//_________________________________________________________________
+void ClusterPositionCache::invalidate(TrkrDefs::cluskey key)
+{
+  const auto index = find(key);
+  if (index >= 0)
+  {
+    m_filled[index] = 0;
+  }
+}
+
+//_________________________________________________________________
+void ClusterPositionCache::addHitSet(TrkrDefs::hitsetkey hitsetkey, unsigned int nclusters)
+{
+  if (m_valid)
+  {
+    std::cout << "ClusterPositionCache::addHitSet - cache already allocated, invalidate it first" << std::endl;
+    return;
+  }
+  auto& slice = m_slices[hitsetkey];
+  if (slice.size)
+  {
+    std::cout << "ClusterPositionCache::addHitSet - duplicate hitset " << hitsetkey << std::endl;
+    return;
+  }
+  slice.offset = m_nslots;
+  slice.size = nclusters;
+  m_nslots += nclusters;
+}
+
+//_________________________________________________________________
+void ClusterPositionCache::allocate(const TrkrClusterContainer* container)
+{
+  m_raw.resize(m_nslots);
+  m_corrected.resize(m_nslots);
+  m_filled.assign(m_nslots, 0);
+  m_container = container;
+  m_valid = true;
+}
+
+//_________________________________________________________________
+void ClusterPositionCache::set(TrkrDefs::cluskey key, const Acts::Vector3& raw, const Acts::Vector3& corrected)
+{
+  const auto iter = m_slices.find(TrkrDefs::getHitSetKeyFromClusKey(key));
+  const auto index = TrkrDefs::getClusIndex(key);
+  if (!m_valid || iter == m_slices.end() || index >= iter->second.size)
+  {
+    std::cout << "ClusterPositionCache::set - no slot for cluster " << key << std::endl;
+    return;
+  }
+  const auto slot = iter->second.offset + index;
+  m_raw[slot] = raw;
+  m_corrected[slot] = corrected;
+  m_filled[slot] = 1;
+}
+
+//_________________________________________________________________
+int64_t ClusterPositionCache::find(TrkrDefs::cluskey key) const
+{
+  if (!m_valid)
+  {
+    return -1;
+  }
+  const auto iter = m_slices.find(TrkrDefs::getHitSetKeyFromClusKey(key));
+  if (iter == m_slices.end())
+  {
+    return -1;
+  }
+  const auto index = TrkrDefs::getClusIndex(key);
+  if (index >= iter->second.size)
+  {
+    return -1;
+  }
+  const int64_t slot = iter->second.offset + index;
+  return m_filled[slot] ? slot : -1;
+}
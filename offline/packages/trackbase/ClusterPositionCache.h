@@ -0,0 +1,97 @@
+#ifndef TRACKBASE_CLUSTERPOSITIONCACHE_H
+#define TRACKBASE_CLUSTERPOSITIONCACHE_H
+
+/*!
+ * \file ClusterPositionCache.h
+ * \brief per event global positions of all clusters, computed once and shared by the tracking modules
+ *
+ * Positions are stored in flat arrays. Each hitset owns a contiguous slice, indexed by the cluster index
+ * in the hitset, so that a lookup is one hash of the hitset key and one array access.
+ * Two positions are kept per cluster:
+ * - the raw position from the Acts surface transform
+ * - the position with TPC crossing (for crossing zero) and distortion corrections applied,
+ *   as given by TpcGlobalPositionWrapper. Identical to the raw position outside of the TPC
+ *
+ * The cache is filled by PHClusterPositionCacheMaker and lives on the node tree, but is not persistent.
+ * Modules that move clusters must invalidate the corresponding entries, or the full cache.
+ */
+
+#include "TrkrDefs.h"
+
+#include <Acts/Definitions/Algebra.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class TrkrClusterContainer;
+
+class ClusterPositionCache
+{
+ public:
+  ClusterPositionCache() = default;
+
+  //! clear content. The cache is invalid until allocate is called again
+  void invalidate();
+
+  //! invalidate a single cluster, e.g. after its local position was changed
+  void invalidate(TrkrDefs::cluskey);
+
+  //! true if the cache was filled from this cluster container
+  bool isValid(const TrkrClusterContainer* container) const
+  {
+    return m_valid && container == m_container;
+  }
+
+  //! reserve a slice of nclusters entries (largest cluster index + 1) for a hitset
+  void addHitSet(TrkrDefs::hitsetkey, unsigned int nclusters);
+
+  //! allocate storage for all added hitsets, for clusters of container
+  void allocate(const TrkrClusterContainer* container);
+
+  //! store the positions of a cluster
+  /*! different clusters can be set concurrently once allocate was called */
+  void set(TrkrDefs::cluskey, const Acts::Vector3& raw, const Acts::Vector3& corrected);
+
+  //! position from the Acts surface transform, nullptr if the cluster is not cached
+  const Acts::Vector3* getRawPosition(TrkrDefs::cluskey key) const
+  {
+    const auto index = find(key);
+    return index < 0 ? nullptr : &m_raw[index];
+  }
+
+  //! position with TPC corrections for crossing zero, nullptr if the cluster is not cached
+  const Acts::Vector3* getCorrectedPosition(TrkrDefs::cluskey key) const
+  {
+    const auto index = find(key);
+    return index < 0 ? nullptr : &m_corrected[index];
+  }
+
+  //! number of slots
+  std::size_t size() const { return m_raw.size(); }
+
+ private:
+  //! flat index of a cached cluster, -1 if not found
+  int64_t find(TrkrDefs::cluskey) const;
+
+  //! first slot and number of slots for each hitset
+  struct Slice
+  {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+  };
+  std::unordered_map<TrkrDefs::hitsetkey, Slice> m_slices;
+
+  std::vector<Acts::Vector3> m_raw;
+  std::vector<Acts::Vector3> m_corrected;
+
+  //! non zero if the slot was filled
+  std::vector<uint8_t> m_filled;
+
+  uint32_t m_nslots = 0;
+  const TrkrClusterContainer* m_container = nullptr;
+  bool m_valid = false;
+};
+
+#endif
@@ -5,6 +5,8 @@
  */
 #include "TrkrClusterContainer.h"
 
+#include <cstdint>
+
 namespace
 {
   TrkrClusterContainer::Map dummy_map;
@@ -21,3 +23,16 @@ TrkrClusterContainer::ConstRange TrkrClusterContainer::getClusters(TrkrDefs::hit
 {
   return std::make_pair(dummy_map.cbegin(), dummy_map.cend());
 }
+
+//__________________________________________________________
+void TrkrClusterContainer::addClusters(TrkrDefs::hitsetkey hitsetkey, std::vector<TrkrCluster*>&& clusters)
+{
+  for (uint32_t index = 0; index < clusters.size(); ++index)
+  {
+    if (clusters[index])
+    {
+      addClusterSpecifyKey(TrkrDefs::genClusKey(hitsetkey, index), clusters[index]);
+    }
+  }
+  clusters.clear();
+}
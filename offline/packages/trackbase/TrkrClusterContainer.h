@@ -15,6 +15,7 @@
 #include <iostream>  // for cout, ostream
 #include <map>
 #include <utility>  // for pair
+#include <vector>
 
 class TrkrCluster;
 
@@ -45,6 +46,23 @@ class TrkrClusterContainer : public PHObject
   //! add a cluster with specific key
   virtual void addClusterSpecifyKey(const TrkrDefs::cluskey, TrkrCluster*) {}
 
+  //! create the (empty) entries of a list of hitsets up front
+  /**
+   * returns true if addClusters can then be called concurrently, from several threads,
+   * for distinct hitsets of the list. The default implementation does nothing and returns false
+   */
+  virtual bool reserveHitSets(const HitSetKeyList&) { return false; }
+
+  //! remove the entries of reserved hitsets which got no cluster, once all addClusters calls are done
+  virtual void pruneHitSets() {}
+
+  //! add all clusters of a hitset at once. The cluster index is the position in the vector
+  /**
+   * the container takes ownership of the clusters, null entries are skipped.
+   * The default implementation calls addClusterSpecifyKey for every cluster
+   */
+  virtual void addClusters(TrkrDefs::hitsetkey, std::vector<TrkrCluster*>&&);
+
   //! remove cluster
   virtual void removeCluster(TrkrDefs::cluskey) {}
 
@@ -9,6 +9,7 @@
 #include "TrkrDefs.h"
 
 #include <algorithm>
+#include <cstdint>
 
 namespace
 {
@@ -133,6 +134,69 @@ void TrkrClusterContainerv4::addClusterSpecifyKey(const TrkrDefs::cluskey key, T
   }
 }
 
+//_________________________________________________________________
+bool TrkrClusterContainerv4::reserveHitSets(const HitSetKeyList& hitsetkeys)
+{
+  for (const auto& hitsetkey : hitsetkeys)
+  {
+    m_clusmap.try_emplace(hitsetkey);
+  }
+  return true;
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv4::pruneHitSets()
+{
+  for (auto iter = m_clusmap.begin(); iter != m_clusmap.end();)
+  {
+    if (iter->second.empty())
+    {
+      iter = m_clusmap.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv4::addClusters(TrkrDefs::hitsetkey hitsetkey, Vector&& clusters)
+{
+  // addClusterSpecifyKey never creates trailing null entries, do the same here
+  while (!clusters.empty() && !clusters.back())
+  {
+    clusters.pop_back();
+  }
+  if (clusters.empty())
+  {
+    return;
+  }
+
+  // only look up the hitset, the map is not modified if it was reserved
+  auto iter = m_clusmap.find(hitsetkey);
+  if (iter == m_clusmap.end())
+  {
+    m_clusmap.emplace(hitsetkey, std::move(clusters));
+  }
+  else if (iter->second.empty())
+  {
+    iter->second = std::move(clusters);
+  }
+  else
+  {
+    // merge with the existing clusters, including the check for duplicate keys
+    for (uint32_t index = 0; index < clusters.size(); ++index)
+    {
+      if (clusters[index])
+      {
+        addClusterSpecifyKey(TrkrDefs::genClusKey(hitsetkey, index), clusters[index]);
+      }
+    }
+  }
+  clusters.clear();
+}
+
 TrkrClusterContainerv4::ConstRange
 TrkrClusterContainerv4::getClusters() const
 {
@@ -211,10 +275,14 @@ TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv4::getHitSetKeys() cons
 {
   HitSetKeyList out;
   out.reserve(m_clusmap.size());
-  std::transform(
-      m_clusmap.begin(), m_clusmap.end(), std::back_inserter(out),
-      [](const std::pair<TrkrDefs::hitsetkey, Vector>& pair)
-      { return pair.first; });
+  for (const auto& [hitsetkey, clus_vector] : m_clusmap)
+  {
+    // hitsets reserved with reserveHitSets which got no cluster
+    if (!clus_vector.empty())
+    {
+      out.push_back(hitsetkey);
+    }
+  }
   return out;
 }
 
@@ -232,10 +300,13 @@ TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv4::getHitSetKeys(const
   // transform to a vector
   HitSetKeyList out;
   out.reserve(m_clusmap.size());
-  std::transform(
-      begin, end, std::back_inserter(out),
-      [](const std::pair<TrkrDefs::hitsetkey, Vector>& pair)
-      { return pair.first; });
+  for (auto iter = begin; iter != end; ++iter)
+  {
+    if (!iter->second.empty())
+    {
+      out.push_back(iter->first);
+    }
+  }
   return out;
 }
 
@@ -253,10 +324,13 @@ TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv4::getHitSetKeys(const
   // transform to a vector
   HitSetKeyList out;
   out.reserve(m_clusmap.size());
-  std::transform(
-      begin, end, std::back_inserter(out),
-      [](const std::pair<TrkrDefs::hitsetkey, Vector>& pair)
-      { return pair.first; });
+  for (auto iter = begin; iter != end; ++iter)
+  {
+    if (!iter->second.empty())
+    {
+      out.push_back(iter->first);
+    }
+  }
   return out;
 }
 
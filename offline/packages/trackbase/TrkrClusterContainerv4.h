@@ -28,6 +28,15 @@ class TrkrClusterContainerv4 : public TrkrClusterContainer
 
   void addClusterSpecifyKey(const TrkrDefs::cluskey, TrkrCluster*) override;
 
+  //! creates the entries of the hitsets, addClusters then only looks them up
+  bool reserveHitSets(const HitSetKeyList&) override;
+
+  //! erases the empty hitset entries, so that they are not written out
+  void pruneHitSets() override;
+
+  //! moves the vector in place, if the hitset has no clusters yet
+  void addClusters(TrkrDefs::hitsetkey, std::vector<TrkrCluster*>&&) override;
+
   void removeCluster(TrkrDefs::cluskey) override;
 
   ConstRange getClusters() const override;  // deprecated
@@ -8,3 +8,12 @@ void TrkrClusterHitAssoc::Reset()
   std::cout << "TrkrClusterHitAssoc: Reset() not implemented by daughter class" << std::endl;
   gSystem->Exit(1);
 }
+
+void TrkrClusterHitAssoc::addAssocs(TrkrDefs::hitsetkey /*hitsetkey*/, AssocVector&& assocs)
+{
+  for (const auto& [ckey, hkey] : assocs)
+  {
+    addAssoc(ckey, hkey);
+  }
+  assocs.clear();
+}
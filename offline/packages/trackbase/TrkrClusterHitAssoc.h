@@ -15,6 +15,7 @@
 #include <iostream>  // for cout, ostream
 #include <map>
 #include <utility>  // for pair
+#include <vector>
 
 /**
  * @brief Base class for associating clusters to the hits that went into them
@@ -27,6 +28,8 @@ class TrkrClusterHitAssoc : public PHObject
   using Map = std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>;
   using ConstIterator = Map::const_iterator;
   using ConstRange = std::pair<Map::const_iterator, Map::const_iterator>;
+  using HitSetKeyList = std::vector<TrkrDefs::hitsetkey>;
+  using AssocVector = std::vector<std::pair<TrkrDefs::cluskey, TrkrDefs::hitkey>>;
 
   void Reset() override;
 
@@ -37,6 +40,24 @@ class TrkrClusterHitAssoc : public PHObject
    */
   virtual void addAssoc(TrkrDefs::cluskey ckey, unsigned int hidx) = 0;
 
+  /**
+   * @brief Create the (empty) association maps of a list of hitsets up front
+   * @return true if addAssocs can then be called concurrently, from several threads,
+   * for distinct hitsets of the list. The default implementation does nothing and returns false
+   */
+  virtual bool reserveHitSets(const HitSetKeyList&) { return false; }
+
+  //! remove the association maps of reserved hitsets which got no association, once all addAssocs calls are done
+  virtual void pruneHitSets() {}
+
+  /**
+   * @brief Add the associations of all clusters of a hitset at once
+   * @param[in] hitsetkey Hitset key of all the clusters
+   * @param[in] assocs (cluster key, hit key) pairs, moved from
+   * The default implementation calls addAssoc for every pair
+   */
+  virtual void addAssocs(TrkrDefs::hitsetkey hitsetkey, AssocVector&& assocs);
+
   //! get pointer to cluster-to-hit map corresponding to a given hitset id
   virtual Map* getClusterMap(TrkrDefs::hitsetkey) { return nullptr; }
 
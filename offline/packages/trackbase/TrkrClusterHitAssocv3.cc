@@ -8,6 +8,7 @@
 #include "TrkrClusterHitAssocv3.h"
 #include "TrkrDefs.h"
 
+#include <algorithm>
 #include <ostream>  // for operator<<, endl, basic_ostream, ostream, basic_o...
 
 namespace
@@ -54,6 +55,67 @@ void TrkrClusterHitAssocv3::addAssoc(TrkrDefs::cluskey ckey, unsigned int hidx)
   clusterMap.insert(std::make_pair(ckey, hidx));
 }
 
+//_________________________________________________________________________
+bool TrkrClusterHitAssocv3::reserveHitSets(const HitSetKeyList& hitsetkeys)
+{
+  for (const auto& hitsetkey : hitsetkeys)
+  {
+    m_map.try_emplace(hitsetkey);
+  }
+  return true;
+}
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv3::pruneHitSets()
+{
+  for (auto iter = m_map.begin(); iter != m_map.end();)
+  {
+    if (iter->second.empty())
+    {
+      iter = m_map.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+}
+
+//_________________________________________________________________________
+void TrkrClusterHitAssocv3::addAssocs(TrkrDefs::hitsetkey hitsetkey, AssocVector&& assocs)
+{
+  if (assocs.empty())
+  {
+    return;
+  }
+
+  // build the map from sorted pairs, inserting at the end is constant time.
+  // Hits of the same cluster keep their order, as with repeated addAssoc calls
+  std::stable_sort(assocs.begin(), assocs.end(), [](const auto& lhs, const auto& rhs)
+                   { return lhs.first < rhs.first; });
+  Map clusterMap;
+  for (const auto& pair : assocs)
+  {
+    clusterMap.emplace_hint(clusterMap.end(), pair);
+  }
+  assocs.clear();
+
+  // only look up the hitset, the outer map is not modified if it was reserved
+  auto iter = m_map.find(hitsetkey);
+  if (iter == m_map.end())
+  {
+    m_map.emplace(hitsetkey, std::move(clusterMap));
+  }
+  else if (iter->second.empty())
+  {
+    iter->second.swap(clusterMap);
+  }
+  else
+  {
+    iter->second.insert(clusterMap.begin(), clusterMap.end());
+  }
+}
+
 //_________________________________________________________________________
 TrkrClusterHitAssocv3::Map* TrkrClusterHitAssocv3::getClusterMap(TrkrDefs::hitsetkey hitsetkey)
 {
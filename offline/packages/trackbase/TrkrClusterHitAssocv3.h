@@ -33,6 +33,15 @@ class TrkrClusterHitAssocv3 : public TrkrClusterHitAssoc
 
   void addAssoc(TrkrDefs::cluskey, unsigned int) override;
 
+  //! creates the association maps of the hitsets, addAssocs then only looks them up
+  bool reserveHitSets(const HitSetKeyList&) override;
+
+  //! erases the empty association maps, so that they are not written out
+  void pruneHitSets() override;
+
+  //! builds the association map of the hitset from the sorted pairs and moves it in place
+  void addAssocs(TrkrDefs::hitsetkey, AssocVector&&) override;
+
   Map* getClusterMap(TrkrDefs::hitsetkey) override;
 
   ConstRange getHits(TrkrDefs::cluskey) override;
@@ -14,8 +14,6 @@
 #include <ostream>
 #include <utility>
 
-bool alignmentTransformationContainer::use_alignment = false;
-
 alignmentTransformationContainer::alignmentTransformationContainer()
 {
   for (uint8_t layer = 0; layer < 57; layer++)
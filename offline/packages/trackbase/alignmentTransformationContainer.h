@@ -38,7 +38,6 @@ class alignmentTransformationContainer : public Acts::GeometryContext
   const std::vector<std::vector<Acts::Transform3>>& getMap() const;
   void setMisalignmentFactor(uint8_t layer, double factor);
   const double& getMisalignmentFactor(uint8_t layer) const { return m_misalignmentFactor.find(layer)->second; }
-  static bool use_alignment;
 
  private:
   unsigned int getsphlayer(Acts::GeometryIdentifier);
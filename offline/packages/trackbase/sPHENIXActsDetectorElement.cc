@@ -4,11 +4,16 @@
 
 #include <phool/phool.h>
 
+#include <any>
+
 sPHENIXActsDetectorElement::~sPHENIXActsDetectorElement() = default;
 
 const Acts::Transform3& sPHENIXActsDetectorElement::transform(const Acts::GeometryContext& ctxt) const
 {
-  if (alignmentTransformationContainer::use_alignment)
+  // contexts carrying an alignment transformation container select the aligned transforms,
+  // anything else (see ActsGeometry::getIdealGeoContext) selects the construction transforms
+  const auto transformContainerPtr = std::any_cast<alignmentTransformationContainer*>(&ctxt.inner());
+  if (transformContainerPtr && *transformContainerPtr)
   {
     Acts::GeometryIdentifier id = surface().geometryId();
 
@@ -17,7 +22,7 @@ const Acts::Transform3& sPHENIXActsDetectorElement::transform(const Acts::Geomet
     unsigned int sphlayer = base_layer_map.find(volume)->second + layer / 2 - 1;
     unsigned int sensor = id.sensitive() - 1;  // Acts sensor ID starts at 1
 
-    const alignmentTransformationContainer* transformContainer = ctxt.get<alignmentTransformationContainer*>();
+    const alignmentTransformationContainer* transformContainer = *transformContainerPtr;
 
     const auto& transformVec = transformContainer->getMap();
     auto& layerVec = transformVec[sphlayer];  // get the vector of transforms for this layer
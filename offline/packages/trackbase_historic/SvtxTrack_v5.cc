@@ -0,0 +1,229 @@
+#include "SvtxTrack_v5.h"
+#include "SvtxTrackState.h"
+#include "SvtxTrackState_v2.h"
+
+#include <trackbase/TrkrDefs.h>  // for cluskey
+
+#include <phool/PHObject.h>  // for PHObject
+
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <utility>  // for as_const
+#include <vector>   // for vector
+
+namespace
+{
+  //! compare states by path length
+  struct PathLengthLess
+  {
+    bool operator()(const SvtxTrackState_v2& state, float pathlength) const { return state.get_pathlength() < pathlength; }
+  };
+
+  //! copy any state into the compact state representation
+  SvtxTrackState_v2 to_compact(const SvtxTrackState& source)
+  {
+    if (const auto* state = dynamic_cast<const SvtxTrackState_v2*>(&source))
+    {
+      return *state;
+    }
+
+    SvtxTrackState_v2 state(source.get_pathlength());
+    state.set_x(source.get_x());
+    state.set_y(source.get_y());
+    state.set_z(source.get_z());
+    state.set_px(source.get_px());
+    state.set_py(source.get_py());
+    state.set_pz(source.get_pz());
+    for (unsigned int i = 0; i < 6; ++i)
+    {
+      for (unsigned int j = i; j < 6; ++j)
+      {
+        state.set_error(i, j, source.get_error(i, j));
+      }
+    }
+    state.set_cluskey(source.get_cluskey());
+    state.set_name(source.get_name());
+    return state;
+  }
+}  // namespace
+
+SvtxTrack_v5::SvtxTrack_v5()
+{
+  // always include the pca point
+  _state_store.emplace_back(0);
+}
+
+SvtxTrack_v5::SvtxTrack_v5(const SvtxTrack& source)
+{
+  SvtxTrack_v5::CopyFrom(source);
+}
+
+// have to suppress missingMemberCopy from cppcheck, it does not
+// go down to the CopyFrom method where things are done correctly
+// cppcheck-suppress missingMemberCopy
+SvtxTrack_v5::SvtxTrack_v5(const SvtxTrack_v5& source)
+  : SvtxTrack(source)
+{
+  SvtxTrack_v5::CopyFrom(source);
+}
+
+SvtxTrack_v5& SvtxTrack_v5::operator=(const SvtxTrack_v5& source)
+{
+  CopyFrom(source);
+  return *this;
+}
+
+void SvtxTrack_v5::CopyFrom(const SvtxTrack& source)
+{
+  // do nothing if copying onto oneself
+  if (this == &source)
+  {
+    return;
+  }
+
+  // parent class method
+  SvtxTrack::CopyFrom(source);
+
+  _tpc_seed = source.get_tpc_seed();
+  _silicon_seed = source.get_silicon_seed();
+  _vertex_id = source.get_vertex_id();
+  _is_positive_charge = source.get_positive_charge();
+  _chisq = source.get_chisq();
+  _ndf = source.get_ndf();
+  _track_crossing = source.get_crossing();
+
+  // copy the states, converting them to the compact representation if needed
+  clear_states();
+  if (const auto* track = dynamic_cast<const SvtxTrack_v5*>(&source))
+  {
+    _state_store = track->_state_store;
+  }
+  else
+  {
+    // source states are sorted by path length already
+    _state_store.reserve(source.size_states());
+    for (auto iter = source.begin_states(); iter != source.end_states(); ++iter)
+    {
+      _state_store.push_back(to_compact(*iter->second));
+    }
+  }
+}
+
+void SvtxTrack_v5::identify(std::ostream& os) const
+{
+  os << "SvtxTrack_v5 Object ";
+  os << "id: " << get_id() << " ";
+  os << "vertex id: " << get_vertex_id() << " ";
+  os << "charge: " << get_charge() << " ";
+  os << "chisq: " << get_chisq() << " ndf:" << get_ndf() << " ";
+  os << "nstates: " << _state_store.size() << " ";
+  os << std::endl;
+
+  os << "(px,py,pz) = ("
+     << get_px() << ","
+     << get_py() << ","
+     << get_pz() << ")" << std::endl;
+
+  os << "(x,y,z) = (" << get_x() << "," << get_y() << "," << get_z() << ")" << std::endl;
+
+  os << "Silicon clusters " << std::endl;
+  if (_silicon_seed)
+  {
+    for (auto iter = _silicon_seed->begin_cluster_keys();
+         iter != _silicon_seed->end_cluster_keys();
+         ++iter)
+    {
+      std::cout << *iter << ", ";
+    }
+  }
+  os << std::endl
+     << "Tpc + TPOT clusters " << std::endl;
+  if (_tpc_seed)
+  {
+    for (auto iter = _tpc_seed->begin_cluster_keys();
+         iter != _tpc_seed->end_cluster_keys();
+         ++iter)
+    {
+      std::cout << *iter << ", ";
+    }
+  }
+  os << std::endl;
+
+  return;
+}
+
+void SvtxTrack_v5::clear_states()
+{
+  _state_store.clear();
+  _states.clear();
+  _states_indexed = false;
+}
+
+int SvtxTrack_v5::isValid() const
+{
+  return 1;
+}
+
+SvtxTrackState* SvtxTrack_v5::insert_state(const SvtxTrackState* state)
+{
+  // find closest iterator
+  const auto pathlength = state->get_pathlength();
+  auto iterator = std::lower_bound(_state_store.begin(), _state_store.end(), pathlength, PathLengthLess());
+  if (iterator == _state_store.end() || pathlength < iterator->get_pathlength())
+  {
+    // pathlength not found. Insert a copy
+    iterator = _state_store.insert(iterator, to_compact(*state));
+    _states_indexed = false;
+  }
+
+  // return matching state
+  return &*iterator;
+}
+
+size_t SvtxTrack_v5::erase_state(float pathlength)
+{
+  auto iterator = std::lower_bound(_state_store.begin(), _state_store.end(), pathlength, PathLengthLess());
+  if (iterator != _state_store.end() && iterator->get_pathlength() == pathlength)
+  {
+    _state_store.erase(iterator);
+    _states_indexed = false;
+  }
+  return _state_store.size();
+}
+
+SvtxTrackState_v2& SvtxTrack_v5::pca_state()
+{
+  if (auto* state = find_store(0.0))
+  {
+    return *state;
+  }
+  const SvtxTrackState_v2 state(0);
+  return *static_cast<SvtxTrackState_v2*>(insert_state(&state));
+}
+
+const SvtxTrackState_v2* SvtxTrack_v5::find_store(float pathlength) const
+{
+  const auto iterator = std::lower_bound(_state_store.begin(), _state_store.end(), pathlength, PathLengthLess());
+  return (iterator == _state_store.end() || iterator->get_pathlength() != pathlength) ? nullptr : &*iterator;
+}
+
+SvtxTrackState_v2* SvtxTrack_v5::find_store(float pathlength)
+{
+  return const_cast<SvtxTrackState_v2*>(std::as_const(*this).find_store(pathlength));
+}
+
+SvtxTrack::StateMap& SvtxTrack_v5::state_index() const
+{
+  if (!_states_indexed)
+  {
+    // states are sorted, so that each insertion is at the end of the map
+    _states.clear();
+    for (const auto& state : _state_store)
+    {
+      _states.emplace_hint(_states.end(), state.get_pathlength(), const_cast<SvtxTrackState_v2*>(&state));
+    }
+    _states_indexed = true;
+  }
+  return _states;
+}
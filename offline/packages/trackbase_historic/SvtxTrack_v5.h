@@ -0,0 +1,188 @@
+#ifndef TRACKBASEHISTORIC_SVTXTRACKV5_H
+#define TRACKBASEHISTORIC_SVTXTRACKV5_H
+
+/*!
+ * \file SvtxTrack_v5.h
+ * \brief track with its states stored contiguously
+ *
+ * States are kept as SvtxTrackState_v2 (packed covariance) in a single vector, sorted by path length,
+ * instead of one separately allocated state object per path length as in SvtxTrack_v4.
+ * get_states() gives direct read access to this vector and should be preferred when looping over states.
+ * The StateMap based iterator interface of SvtxTrack is only kept for compatibility: it goes through
+ * a transient index of pointers into this vector, built on first use. Even the const versions of
+ * begin_states, find_state and end_states modify this index, so concurrent reads of the same
+ * track through them are not thread safe.
+ * Pointers and iterators to states are invalidated by insert_state, erase_state and clear_states.
+ */
+
+#include "SvtxTrack.h"
+#include "SvtxTrackState.h"
+#include "SvtxTrackState_v2.h"
+#include "TrackSeed.h"
+
+#include <trackbase/TrkrDefs.h>
+
+#include <cmath>
+#include <cstddef>  // for size_t
+#include <iostream>
+#include <map>
+#include <utility>  // for pair
+#include <vector>
+
+class PHObject;
+
+class SvtxTrack_v5 : public SvtxTrack
+{
+ public:
+  SvtxTrack_v5();
+
+  //* base class copy constructor
+  SvtxTrack_v5(const SvtxTrack&);
+
+  //* copy constructor
+  SvtxTrack_v5(const SvtxTrack_v5&);
+
+  //* assignment operator
+  SvtxTrack_v5& operator=(const SvtxTrack_v5& track);
+
+  //* destructor
+  ~SvtxTrack_v5() override = default;
+
+  // The "standard PHObject response" functions...
+  void identify(std::ostream& os = std::cout) const override;
+  void Reset() override { *this = SvtxTrack_v5(); }
+  int isValid() const override;
+  PHObject* CloneMe() const override { return new SvtxTrack_v5(*this); }
+
+  //! import PHObject CopyFrom, in order to avoid clang warning
+  using PHObject::CopyFrom;
+  // copy content from base class
+  void CopyFrom(const SvtxTrack&) override;
+  void CopyFrom(SvtxTrack* source) override
+  {
+    CopyFrom(*source);
+  }
+
+  //
+  // basic track information ---------------------------------------------------
+  //
+
+  unsigned int get_id() const override { return _track_id; }
+  void set_id(unsigned int id) override { _track_id = id; }
+
+  TrackSeed* get_tpc_seed() const override { return _tpc_seed; }
+  void set_tpc_seed(TrackSeed* seed) override { _tpc_seed = seed; }
+
+  TrackSeed* get_silicon_seed() const override { return _silicon_seed; }
+  void set_silicon_seed(TrackSeed* seed) override { _silicon_seed = seed; }
+
+  short int get_crossing() const override { return _track_crossing; }
+  void set_crossing(short int cross) override { _track_crossing = cross; }
+
+  unsigned int get_vertex_id() const override { return _vertex_id; }
+  void set_vertex_id(unsigned int id) override { _vertex_id = id; }
+
+  bool get_positive_charge() const override { return _is_positive_charge; }
+  void set_positive_charge(bool ispos) override { _is_positive_charge = ispos; }
+
+  int get_charge() const override { return (get_positive_charge()) ? 1 : -1; }
+  void set_charge(int charge) override { (charge > 0) ? set_positive_charge(true) : set_positive_charge(false); }
+
+  float get_chisq() const override { return _chisq; }
+  void set_chisq(float chisq) override { _chisq = chisq; }
+
+  unsigned int get_ndf() const override { return _ndf; }
+  void set_ndf(int ndf) override { _ndf = ndf; }
+
+  float get_quality() const override { return (_ndf != 0) ? _chisq / _ndf : NAN; }
+
+  float get_x() const override { return pca_state().get_x(); }
+  void set_x(float x) override { pca_state().set_x(x); }
+
+  float get_y() const override { return pca_state().get_y(); }
+  void set_y(float y) override { pca_state().set_y(y); }
+
+  float get_z() const override { return pca_state().get_z(); }
+  void set_z(float z) override { pca_state().set_z(z); }
+
+  float get_pos(unsigned int i) const override { return pca_state().get_pos(i); }
+
+  float get_px() const override { return pca_state().get_px(); }
+  void set_px(float px) override { pca_state().set_px(px); }
+
+  float get_py() const override { return pca_state().get_py(); }
+  void set_py(float py) override { pca_state().set_py(py); }
+
+  float get_pz() const override { return pca_state().get_pz(); }
+  void set_pz(float pz) override { pca_state().set_pz(pz); }
+
+  float get_mom(unsigned int i) const override { return pca_state().get_mom(i); }
+
+  float get_p() const override { return sqrt(pow(get_px(), 2) + pow(get_py(), 2) + pow(get_pz(), 2)); }
+  float get_pt() const override { return sqrt(pow(get_px(), 2) + pow(get_py(), 2)); }
+  float get_eta() const override { return asinh(get_pz() / get_pt()); }
+  float get_phi() const override { return atan2(get_py(), get_px()); }
+
+  float get_error(int i, int j) const override { return pca_state().get_error(i, j); }
+  void set_error(int i, int j, float value) override { return pca_state().set_error(i, j, value); }
+
+  //
+  // state methods -------------------------------------------------------------
+  //
+  bool empty_states() const override { return _state_store.empty(); }
+  size_t size_states() const override { return _state_store.size(); }
+  size_t count_states(float pathlength) const override { return find_store(pathlength) ? 1 : 0; }
+  // cppcheck-suppress virtualCallInConstructor
+  void clear_states() override;
+
+  const SvtxTrackState* get_state(float pathlength) const override { return find_store(pathlength); }
+  SvtxTrackState* get_state(float pathlength) override { return find_store(pathlength); }
+  SvtxTrackState* insert_state(const SvtxTrackState* state) override;
+  size_t erase_state(float pathlength) override;
+
+  ConstStateIter begin_states() const override { return state_index().begin(); }
+  ConstStateIter find_state(float pathlength) const override { return state_index().find(pathlength); }
+  ConstStateIter end_states() const override { return state_index().end(); }
+
+  StateIter begin_states() override { return state_index().begin(); }
+  StateIter find_state(float pathlength) override { return state_index().find(pathlength); }
+  StateIter end_states() override { return state_index().end(); }
+
+  //! states sorted by path length, read directly from storage without building the transient index
+  const std::vector<SvtxTrackState_v2>& get_states() const { return _state_store; }
+
+ private:
+  // track information
+  TrackSeed* _tpc_seed = nullptr;
+  TrackSeed* _silicon_seed = nullptr;
+  unsigned int _track_id = UINT_MAX;
+  unsigned int _vertex_id = UINT_MAX;
+  bool _is_positive_charge = false;
+  float _chisq = NAN;
+  unsigned int _ndf = 0;
+  short int _track_crossing = SHRT_MAX;
+
+  //! state at the point of closest approach. The non const version creates it if missing
+  const SvtxTrackState_v2& pca_state() const { return *find_store(0.0); }
+  SvtxTrackState_v2& pca_state();
+
+  //! state with matching path length, nullptr if not found
+  const SvtxTrackState_v2* find_store(float pathlength) const;
+  SvtxTrackState_v2* find_store(float pathlength);
+
+  //! path length => state index, rebuilt if the state storage changed. Not thread safe, even for const access
+  StateMap& state_index() const;
+
+  // track state information, sorted by path length
+  std::vector<SvtxTrackState_v2> _state_store;
+
+  //! transient index used by the iterator interface
+  mutable StateMap _states;  //!
+
+  //! true if _states matches _state_store
+  mutable bool _states_indexed = false;  //!
+
+  ClassDefOverride(SvtxTrack_v5, 1)
+};
+
+#endif
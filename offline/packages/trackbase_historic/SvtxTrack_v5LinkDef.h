@@ -0,0 +1,8 @@
+#ifdef __CINT__
+
+#pragma link C++ class SvtxTrack_v5 + ;
+
+// the state index is transient, make sure it is rebuilt after reading
+#pragma read sourceClass="SvtxTrack_v5" version="[1-]" targetClass="SvtxTrack_v5" source="" target="_states_indexed" code="{ _states_indexed = false; }"
+
+#endif /* __CINT__ */
@@ -72,7 +72,9 @@ namespace TrackAnalysisUtils
     {
       if (seed)
       {
-        std::copy(seed->begin_cluster_keys(), seed->end_cluster_keys(), std::back_inserter(out));
+        out.reserve(out.size() + seed->size_cluster_keys());
+        for_each_cluster_key(seed, [&out](TrkrDefs::cluskey key)
+                             { out.push_back(key); });
       }
     }
     return out;
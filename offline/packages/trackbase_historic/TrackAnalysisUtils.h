@@ -1,12 +1,16 @@
 #ifndef TRACKBASEHISTORIC_TRACKANALYSISUTILS_H
 #define TRACKBASEHISTORIC_TRACKANALYSISUTILS_H
 
+#include "SvtxTrack.h"
+#include "SvtxTrack_v5.h"
+#include "TrackSeed.h"
+#include "TrackSeed_v3.h"
+
 #include <trackbase/TrkrDefs.h>
 #include <Acts/Definitions/Algebra.hpp>
 
 #include <utility>
-
-class SvtxTrack;
+#include <vector>
 
 namespace TrackAnalysisUtils
 {
@@ -18,6 +22,44 @@ namespace TrackAnalysisUtils
 
   std::vector<TrkrDefs::cluskey> get_cluster_keys(SvtxTrack* track);
 
+  /// Calls f(TrkrDefs::cluskey) for each cluster key of the seed.
+  /// TrackSeed_v3 keys are read directly from storage, other versions go through the iterator interface
+  template <class F>
+  void for_each_cluster_key(const TrackSeed* seed, F&& f)
+  {
+    if (const auto* seed_v3 = dynamic_cast<const TrackSeed_v3*>(seed))
+    {
+      for (const auto& key : seed_v3->get_cluster_keys())
+      {
+        f(key);
+      }
+      return;
+    }
+    for (auto iter = seed->begin_cluster_keys(); iter != seed->end_cluster_keys(); ++iter)
+    {
+      f(*iter);
+    }
+  }
+
+  /// Calls f(const SvtxTrackState*) for each state of the track, sorted by path length.
+  /// SvtxTrack_v5 states are read directly from storage, other versions go through the iterator interface
+  template <class F>
+  void for_each_state(const SvtxTrack* track, F&& f)
+  {
+    if (const auto* track_v5 = dynamic_cast<const SvtxTrack_v5*>(track))
+    {
+      for (const auto& state : track_v5->get_states())
+      {
+        f(static_cast<const SvtxTrackState*>(&state));
+      }
+      return;
+    }
+    for (auto iter = track->begin_states(); iter != track->end_states(); ++iter)
+    {
+      f(static_cast<const SvtxTrackState*>(iter->second));
+    }
+  }
+
 };  // namespace TrackAnalysisUtils
 
 #endif
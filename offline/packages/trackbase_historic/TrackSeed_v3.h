@@ -0,0 +1,131 @@
+#ifndef TRACKBASEHISTORIC_TRACKSEED_V3_H
+#define TRACKBASEHISTORIC_TRACKSEED_V3_H
+
+/*!
+ * \file TrackSeed_v3.h
+ * \brief track seed with cluster keys stored in a sorted vector
+ *
+ * Same content as TrackSeed_v2, but the cluster keys are kept in a sorted std::vector
+ * rather than a std::set. get_cluster_keys() gives direct read access to this vector and should be
+ * preferred when looping over keys. The ClusterKeySet based iterator interface of TrackSeed is only
+ * kept for compatibility: it goes through a transient copy of the keys, built on first use. Even the
+ * const versions of begin_cluster_keys, find_cluster_key and end_cluster_keys modify this copy, so
+ * concurrent reads of the same seed through them are not thread safe.
+ * Iterators are invalidated by insert_cluster_key, erase_cluster_key and clear_cluster_keys.
+ */
+
+#include "TrackSeed.h"
+
+#include <trackbase/TrkrDefs.h>
+
+#include <limits.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+class TrackSeed_v3 : public TrackSeed
+{
+ public:
+  TrackSeed_v3();
+
+  /// Copy constructors
+  TrackSeed_v3(const TrackSeed&);
+  TrackSeed_v3(const TrackSeed_v3&);
+  TrackSeed_v3& operator=(const TrackSeed_v3& seed);
+  ~TrackSeed_v3() override;
+
+  void identify(std::ostream& os = std::cout) const override;
+  void Reset() override { *this = TrackSeed_v3(); }
+  int isValid() const override { return 1; }
+  void CopyFrom(const TrackSeed&) override;
+  void CopyFrom(TrackSeed* seed) override { CopyFrom(*seed); }
+  PHObject* CloneMe() const override { return new TrackSeed_v3(*this); }
+
+  // method to return phi from a given set of global positions
+  float get_phi(const std::map<TrkrDefs::cluskey, Acts::Vector3>& positions) const override;   // returns phi calculated from supplied cluster positions
+
+  // methods that return values based on track fit parameters
+  float get_pz() const override;
+  float get_x() const override;
+  float get_y() const override;
+  float get_z() const override;
+  float get_eta() const override;
+  float get_theta() const override;
+  float get_pt() const override;
+  float get_p() const override;
+  float get_px() const override;
+  float get_py() const override;
+
+  //methods that return member variables
+  int get_charge() const override;
+  float get_qOverR() const override { return m_qOverR; }
+  float get_X0() const override { return m_X0; }
+  float get_Y0() const override { return m_Y0; }
+  float get_slope() const override { return m_slope; }
+  float get_Z0() const override { return m_Z0; }
+  float get_phi() const override  { return m_phi; }  // returns the stored phi
+  short int get_crossing() const override { return m_crossing; }  
+  void set_crossing(const short int crossing) override { m_crossing = crossing; }
+  void set_qOverR(const float qOverR) override { m_qOverR = qOverR; }
+  void set_X0(const float X0) override { m_X0 = X0; }
+  void set_Y0(const float Y0) override { m_Y0 = Y0; }
+  void set_slope(const float slope) override { m_slope = slope; }
+  void set_Z0(const float Z0) override { m_Z0 = Z0; }
+  void set_phi(const float phi) override { m_phi = phi; }
+
+  void clear_cluster_keys() override;
+  bool empty_cluster_keys() const override { return m_cluster_keys.empty(); }
+  size_t size_cluster_keys() const override { return m_cluster_keys.size(); }
+
+  void insert_cluster_key(TrkrDefs::cluskey clusterid) override;
+  size_t erase_cluster_key(TrkrDefs::cluskey clusterid) override;
+  ConstClusterKeyIter find_cluster_key(TrkrDefs::cluskey clusterid) const override { return key_index().find(clusterid); }
+  ConstClusterKeyIter begin_cluster_keys() const override { return key_index().begin(); }
+  ConstClusterKeyIter end_cluster_keys() const override { return key_index().end(); }
+  ClusterKeyIter find_cluster_keys(unsigned int clusterid) override { return key_index().find(clusterid); }
+  ClusterKeyIter begin_cluster_keys() override { return key_index().begin(); }
+  ClusterKeyIter end_cluster_keys() override { return key_index().end(); }
+
+  //! sorted cluster keys, without going through the transient set
+  const std::vector<TrkrDefs::cluskey>& get_cluster_keys() const { return m_cluster_keys; }
+
+  /// Updates R, X0, Y0
+  void circleFitByTaubin(const std::map<TrkrDefs::cluskey, Acts::Vector3>& positions,
+                         uint8_t startLayer = 0,
+                         uint8_t endLayer = 58) override;
+
+  /// Updates r-z slope and intercept B
+  void lineFit(const std::map<TrkrDefs::cluskey, Acts::Vector3>& positions,
+               uint8_t startLayer = 0,
+               uint8_t endLayer = 58) override;
+
+ protected:
+  /// Returns transverse PCA to (0,0)
+  std::pair<float, float> findRoot() const;
+
+ private:
+  //! cluster keys as a set, rebuilt if m_cluster_keys changed. Not thread safe, even for const access
+  ClusterKeySet& key_index() const;
+
+  //! sorted cluster keys
+  std::vector<TrkrDefs::cluskey> m_cluster_keys;
+
+  //! transient set used by the iterator interface
+  mutable ClusterKeySet m_cluster_key_index;  //!
+
+  //! true if m_cluster_key_index matches m_cluster_keys
+  mutable bool m_cluster_keys_indexed = false;  //!
+
+  float m_qOverR = NAN;
+  float m_X0 = NAN;
+  float m_Y0 = NAN;
+  float m_slope = NAN;
+  float m_Z0 = NAN;
+  float m_phi = NAN;
+
+  short int m_crossing = std::numeric_limits<short int>::max();
+
+  ClassDefOverride(TrackSeed_v3, 1);
+};
+
+#endif
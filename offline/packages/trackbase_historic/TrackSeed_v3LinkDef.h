@@ -0,0 +1,8 @@
+#ifdef __CINT__
+
+#pragma link C++ class TrackSeed_v3 + ;
+
+// the cluster key set is transient, make sure it is rebuilt after reading
+#pragma read sourceClass="TrackSeed_v3" version="[1-]" targetClass="TrackSeed_v3" source="" target="m_cluster_keys_indexed" code="{ m_cluster_keys_indexed = false; }"
+
+#endif /* __CINT__ */
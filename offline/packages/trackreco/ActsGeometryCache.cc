@@ -0,0 +1,254 @@
+#include "ActsGeometryCache.h"
+
+#include <nlohmann/json.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+  //! read only memory mapping of a file, unmapped on destruction
+  class MappedFile
+  {
+   public:
+    explicit MappedFile(const std::string &path)
+    {
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+        return;
+      }
+      struct stat st
+      {
+      };
+      if (fstat(fd, &st) == 0 && st.st_size > 0)
+      {
+        void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+          m_data = static_cast<const char *>(data);
+          m_size = st.st_size;
+        }
+      }
+      // the mapping stays valid after the file is closed
+      close(fd);
+    }
+
+    ~MappedFile()
+    {
+      if (m_data)
+      {
+        munmap(const_cast<char *>(m_data), m_size);
+      }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+   private:
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+  };
+
+  struct SurfaceFileHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t nrecords;
+    uint64_t key;
+  };
+
+  std::string to_hex(uint64_t value)
+  {
+    std::ostringstream out;
+    out << std::hex << value;
+    return out.str();
+  }
+}  // namespace
+
+ActsGeometryCache::ActsGeometryCache(const std::string &directory)
+  : m_directory(directory)
+{
+}
+
+uint64_t ActsGeometryCache::hash(const void *data, std::size_t size, uint64_t seed)
+{
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  uint64_t value = seed;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    value ^= bytes[i];
+    value *= 1099511628211ULL;
+  }
+  return value;
+}
+
+uint64_t ActsGeometryCache::hashFile(const std::string &path, uint64_t seed)
+{
+  MappedFile file(path);
+  if (!file.data())
+  {
+    // missing file, hash its name so that the key still differs from an existing one
+    return hash(path.data(), path.size(), seed);
+  }
+  return hash(file.data(), file.size(), seed);
+}
+
+std::string ActsGeometryCache::getMaterialFile(const std::string &jsonFile) const
+{
+  if (jsonFile.find(".json") == std::string::npos)
+  {
+    return jsonFile;
+  }
+
+  const std::string cborFile = m_directory + "/material-" + to_hex(hashFile(jsonFile)) + ".cbor";
+  if (std::filesystem::exists(cborFile))
+  {
+    if (m_verbosity > 0)
+    {
+      std::cout << "ActsGeometryCache::getMaterialFile - using cached " << cborFile << std::endl;
+    }
+    return cborFile;
+  }
+
+  MappedFile file(jsonFile);
+  if (!file.data())
+  {
+    return jsonFile;
+  }
+
+  std::vector<std::uint8_t> cbor;
+  try
+  {
+    cbor = nlohmann::json::to_cbor(nlohmann::json::parse(file.data(), file.data() + file.size()));
+  }
+  catch (const nlohmann::json::exception &e)
+  {
+    std::cout << "ActsGeometryCache::getMaterialFile - could not convert " << jsonFile << ": " << e.what() << std::endl;
+    return jsonFile;
+  }
+
+  if (!writeFile(cborFile, cbor.data(), cbor.size()))
+  {
+    return jsonFile;
+  }
+
+  std::cout << "ActsGeometryCache::getMaterialFile - converted " << jsonFile << " to " << cborFile << std::endl;
+  return cborFile;
+}
+
+bool ActsGeometryCache::loadSurfaces(RecordMap &records) const
+{
+  const std::string path = surfaceFileName();
+  MappedFile file(path);
+  if (!file.data())
+  {
+    return false;
+  }
+
+  SurfaceFileHeader header{};
+  if (file.size() < sizeof(header))
+  {
+    std::cout << "ActsGeometryCache::loadSurfaces - " << path << " is truncated, ignored" << std::endl;
+    return false;
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, m_magic, sizeof(m_magic)) != 0 ||
+      header.version != m_version ||
+      header.key != m_key ||
+      file.size() != sizeof(header) + header.nrecords * sizeof(Record))
+  {
+    std::cout << "ActsGeometryCache::loadSurfaces - " << path << " is invalid, ignored" << std::endl;
+    return false;
+  }
+
+  records.clear();
+  const char *data = file.data() + sizeof(header);
+  for (uint32_t i = 0; i < header.nrecords; ++i)
+  {
+    Record record;
+    std::memcpy(&record, data + i * sizeof(Record), sizeof(Record));
+    records.emplace_hint(records.end(), record.geoId, record);
+  }
+
+  if (m_verbosity > 0)
+  {
+    std::cout << "ActsGeometryCache::loadSurfaces - loaded " << records.size() << " surfaces from " << path << std::endl;
+  }
+  return true;
+}
+
+bool ActsGeometryCache::saveSurfaces(const RecordMap &records) const
+{
+  SurfaceFileHeader header{};
+  std::memcpy(header.magic, m_magic, sizeof(m_magic));
+  header.version = m_version;
+  header.nrecords = records.size();
+  header.key = m_key;
+
+  std::vector<char> buffer(sizeof(header) + records.size() * sizeof(Record));
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  char *data = buffer.data() + sizeof(header);
+  for (const auto &[geoId, record] : records)
+  {
+    std::memcpy(data, &record, sizeof(Record));
+    data += sizeof(Record);
+  }
+
+  const std::string path = surfaceFileName();
+  if (!writeFile(path, buffer.data(), buffer.size()))
+  {
+    return false;
+  }
+
+  if (m_verbosity > 0)
+  {
+    std::cout << "ActsGeometryCache::saveSurfaces - saved " << records.size() << " surfaces to " << path << std::endl;
+  }
+  return true;
+}
+
+bool ActsGeometryCache::writeFile(const std::string &path, const void *data, std::size_t size) const
+{
+  std::error_code error;
+  std::filesystem::create_directories(m_directory, error);
+
+  // unique temporary name, the rename is atomic within the directory
+  const std::string tmpPath = path + ".tmp." + std::to_string(getpid());
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.write(static_cast<const char *>(data), size))
+    {
+      std::cout << "ActsGeometryCache::writeFile - could not write " << tmpPath << std::endl;
+      std::remove(tmpPath.c_str());
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tmpPath, path, error);
+  if (error)
+  {
+    std::cout << "ActsGeometryCache::writeFile - could not rename " << tmpPath << " to " << path << ": " << error.message() << std::endl;
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::string ActsGeometryCache::surfaceFileName() const
+{
+  return m_directory + "/surfaces-" + to_hex(m_key) + ".bin";
+}
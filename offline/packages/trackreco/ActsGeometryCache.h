@@ -0,0 +1,94 @@
+#ifndef TRACKRECO_ACTSGEOMETRYCACHE_H
+#define TRACKRECO_ACTSGEOMETRYCACHE_H
+
+/*!
+ *  \file		ActsGeometryCache.h
+ *  \brief		on-disk cache of the parts of the Acts geometry building that do not need TGeo
+ *  \details	MakeActsGeometry still builds the Acts tracking geometry from TGeo, since the
+ *  surfaces are tied to the TGeo based detector elements. What is cached, in a directory given
+ *  by the user, is
+ *  - the Acts material map, converted once from json to cbor (binary json), which the Acts
+ *    json material decorator reads much faster than the text version
+ *  - the association of every sensitive surface (by Acts geometry id) to its hitsetkey
+ *    (TPC: layer), which otherwise is found from the surface position in the sPHENIX
+ *    layer geometries. It is stored as a flat binary file and read through mmap
+ *  Files are named after a hash of their inputs, so a changed geometry, configuration or
+ *  material map just produces a new file. Files are written to a temporary name and
+ *  renamed, so concurrent jobs can share a cache directory
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+class ActsGeometryCache
+{
+ public:
+  //! surface categories stored in the cache
+  enum SurfaceType : uint32_t
+  {
+    Silicon = 0,
+    Tpc = 1,
+    Micromegas = 2
+  };
+
+  //! one surface. value is the hitsetkey, or the layer for TPC surfaces
+  struct Record
+  {
+    uint64_t geoId = 0;
+    uint32_t value = 0;
+    uint32_t type = 0;
+  };
+
+  using RecordMap = std::map<uint64_t, Record>;
+
+  explicit ActsGeometryCache(const std::string &directory);
+
+  //! 64 bit FNV-1a hash of a buffer, chained through seed
+  static uint64_t hash(const void *data, std::size_t size, uint64_t seed = m_hashSeed);
+
+  //! hash of a value, chained through seed
+  template <class T>
+  static uint64_t hashValue(const T &value, uint64_t seed)
+  {
+    return hash(&value, sizeof(T), seed);
+  }
+
+  //! hash of the content of a file, chained through seed
+  static uint64_t hashFile(const std::string &path, uint64_t seed = m_hashSeed);
+
+  //! key of the surface records, hash of everything the surface association depends on
+  void setKey(uint64_t key) { m_key = key; }
+  uint64_t getKey() const { return m_key; }
+
+  //! returns the cbor version of a json material file, creating it if needed
+  /*! returns the input file if the conversion is not possible */
+  std::string getMaterialFile(const std::string &jsonFile) const;
+
+  //! load the surface records for the current key. Returns false if not available
+  bool loadSurfaces(RecordMap &records) const;
+
+  //! save the surface records for the current key
+  bool saveSurfaces(const RecordMap &records) const;
+
+  void Verbosity(int verbosity) { m_verbosity = verbosity; }
+
+ private:
+  //! write a buffer to path through a temporary file
+  bool writeFile(const std::string &path, const void *data, std::size_t size) const;
+
+  std::string surfaceFileName() const;
+
+  static constexpr uint64_t m_hashSeed = 14695981039346656037ULL;
+
+  //! surface file header
+  static constexpr char m_magic[8] = {'S', 'P', 'H', 'A', 'C', 'T', 'S', 0};
+  static constexpr uint32_t m_version = 1;
+
+  std::string m_directory;
+  uint64_t m_key = 0;
+  int m_verbosity = 0;
+};
+
+#endif
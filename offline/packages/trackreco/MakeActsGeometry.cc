@@ -44,6 +44,7 @@
 #include <phool/PHNode.h>
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>
+#include <phool/PHTimer.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>
 
@@ -252,11 +253,30 @@ int MakeActsGeometry::buildAllGeometry(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::ABORTEVENT;
   }
 
+  if (!m_geometryCacheDir.empty())
+  {
+    m_geometryCache = std::make_unique<ActsGeometryCache>(m_geometryCacheDir);
+    m_geometryCache->Verbosity(Verbosity());
+
+    // the cache key starts from the geometry as found on the node tree, before the TPC edits
+    PHGeomIOTGeo *dstGeomIO = PHGeomUtility::GetGeomIOTGeoNode(topNode, false);
+    if (dstGeomIO && dstGeomIO->isValid())
+    {
+      const auto &data = dstGeomIO->GetData();
+      m_geometryHash = ActsGeometryCache::hash(data.data(), data.size());
+    }
+  }
+
+  PHTimer editTimer("editTimer");
+  editTimer.restart();
+
   setPlanarSurfaceDivisions();  // eshulga
   // This should be done only on the first tracking pass, to avoid adding surfaces twice.
   // There is a check for existing acts fake surfaces in editTPCGeometry
   editTPCGeometry(topNode);
 
+  editTimer.stop();
+
   /// Export the new geometry to a root file for examination
   if (Verbosity() > 3)
   {
@@ -270,7 +290,21 @@ int MakeActsGeometry::buildAllGeometry(PHCompositeNode *topNode)
   }
 
   /// Run Acts layer builder
+  PHTimer buildTimer("buildTimer");
+  buildTimer.restart();
   buildActsSurfaces();
+  buildTimer.stop();
+
+  // startup report, to compare jobs with and without the geometry cache
+  if (Verbosity() > 0)
+  {
+    std::cout << "MakeActsGeometry::buildAllGeometry - startup time (ms)"
+              << " TPC geometry edit: " << editTimer.elapsed()
+              << " Acts geometry build: " << buildTimer.elapsed() - m_unpackTime
+              << " surface maps: " << m_unpackTime
+              << " geometry cache: " << (m_geometryCache ? (m_surfaceCacheLoaded ? "hit" : "miss") : "off")
+              << std::endl;
+  }
 
   /// Create a map of sensor TGeoNode pointers using the TrkrDefs:: hitsetkey as the key
   // makeTGeoNodeMap(topNode);
@@ -508,6 +542,21 @@ void MakeActsGeometry::buildActsSurfaces()
   std::string responseFile, materialFile;
   setMaterialResponseFile(responseFile, materialFile);
 
+  if (m_geometryCache)
+  {
+    // everything the surface to hitsetkey association depends on
+    uint64_t key = ActsGeometryCache::hashFile(responseFile, m_geometryHash);
+    key = ActsGeometryCache::hashValue(m_nSurfPhi, key);
+    key = ActsGeometryCache::hashValue(m_nSurfZ, key);
+    key = ActsGeometryCache::hashValue(m_inttSurvey, key);
+    key = ActsGeometryCache::hashValue(m_mvtxapplymisalign, key);
+    m_geometryCache->setKey(key);
+    m_surfaceCacheLoaded = m_geometryCache->loadSurfaces(m_surfaceCache);
+
+    // the material map is cached on its own, by content
+    materialFile = m_geometryCache->getMaterialFile(materialFile);
+  }
+
   // Response file contains arguments necessary for geometry building
   std::istringstream stringline(m_magField);
   double fieldstrength = std::numeric_limits<double>::quiet_NaN();
@@ -643,7 +692,16 @@ void MakeActsGeometry::makeGeometry(int argc, char *argv[],
 
   m_geoCtxt = Acts::GeometryContext();
 
+  PHTimer unpackTimer("unpackTimer");
+  unpackTimer.restart();
   unpackVolumes();
+  unpackTimer.stop();
+  m_unpackTime = unpackTimer.elapsed();
+
+  if (m_geometryCache && !m_surfaceCacheLoaded)
+  {
+    m_geometryCache->saveSurfaces(m_surfaceCache);
+  }
 
   return;
 }
@@ -783,6 +841,37 @@ void MakeActsGeometry::unpackVolumes()
   return;
 }
 
+bool MakeActsGeometry::getCachedSurfaceKey(const Surface &surf, ActsGeometryCache::SurfaceType type, TrkrDefs::hitsetkey &key) const
+{
+  if (!m_surfaceCacheLoaded)
+  {
+    return false;
+  }
+
+  const auto iter = m_surfaceCache.find(surf->geometryId().value());
+  if (iter == m_surfaceCache.end() || iter->second.type != type)
+  {
+    return false;
+  }
+
+  key = iter->second.value;
+  return true;
+}
+
+void MakeActsGeometry::addCachedSurfaceKey(const Surface &surf, ActsGeometryCache::SurfaceType type, TrkrDefs::hitsetkey key)
+{
+  if (!m_geometryCache || m_surfaceCacheLoaded)
+  {
+    return;
+  }
+
+  ActsGeometryCache::Record record;
+  record.geoId = surf->geometryId().value();
+  record.value = key;
+  record.type = type;
+  m_surfaceCache[record.geoId] = record;
+}
+
 void MakeActsGeometry::makeTpcMapPairs(TrackingVolumePtr &tpcVolume)
 {
   if (Verbosity() > 10)
@@ -807,15 +896,26 @@ void MakeActsGeometry::makeTpcMapPairs(TrackingVolumePtr &tpcVolume)
     for (auto &j : surfaceVector)
     {
       auto surf = j->getSharedPtr();
-      auto vec3d = surf->center(m_geoCtxt);
 
-      /// convert to cm
-      std::vector<double> world_center = {vec3d(0) / 10.0,
-                                          vec3d(1) / 10.0,
-                                          vec3d(2) / 10.0};
+      TrkrDefs::hitsetkey cachedLayer = 0;
+      unsigned int layer = 0;
+      if (getCachedSurfaceKey(surf, ActsGeometryCache::Tpc, cachedLayer))
+      {
+        layer = cachedLayer;
+      }
+      else
+      {
+        auto vec3d = surf->center(m_geoCtxt);
 
-      TrkrDefs::hitsetkey hitsetkey = getTpcHitSetKeyFromCoords(world_center);
-      unsigned int layer = TrkrDefs::getLayer(hitsetkey);
+        /// convert to cm
+        std::vector<double> world_center = {vec3d(0) / 10.0,
+                                            vec3d(1) / 10.0,
+                                            vec3d(2) / 10.0};
+
+        TrkrDefs::hitsetkey hitsetkey = getTpcHitSetKeyFromCoords(world_center);
+        layer = TrkrDefs::getLayer(hitsetkey);
+        addCachedSurfaceKey(surf, ActsGeometryCache::Tpc, layer);
+      }
 
       /// If there is already an entry for this hitsetkey, add the surface
       /// to its corresponding vector
@@ -867,6 +967,15 @@ void MakeActsGeometry::makeMmMapPairs(TrackingVolumePtr &mmVolume)
     for (auto j : surfaceVector)
     {
       auto surface = j->getSharedPtr();
+
+      TrkrDefs::hitsetkey cachedKey = 0;
+      if (getCachedSurfaceKey(surface, ActsGeometryCache::Micromegas, cachedKey))
+      {
+        const auto [iter, inserted] = m_clusterSurfaceMapMmEdit.insert(std::make_pair(cachedKey, surface));
+        assert(inserted);
+        continue;
+      }
+
       auto vec3d = surface->center(m_geoCtxt);
 
       /// convert to cm
@@ -918,6 +1027,7 @@ void MakeActsGeometry::makeMmMapPairs(TrackingVolumePtr &mmVolume)
       const auto hitsetkey = MicromegasDefs::genHitSetKey(layer, segmentation_type, tileid);
       const auto [iter, inserted] = m_clusterSurfaceMapMmEdit.insert(std::make_pair(hitsetkey, surface));
       assert(inserted);
+      addCachedSurfaceKey(surface, ActsGeometryCache::Micromegas, hitsetkey);
     }
   }
 }
@@ -986,7 +1096,12 @@ void MakeActsGeometry::makeInttMapPairs(TrackingVolumePtr &inttVolume)
         }
       }
 
-      TrkrDefs::hitsetkey hitsetkey = getInttHitSetKeyFromCoords(layer, world_center);
+      TrkrDefs::hitsetkey hitsetkey = 0;
+      if (!getCachedSurfaceKey(surf, ActsGeometryCache::Silicon, hitsetkey))
+      {
+        hitsetkey = getInttHitSetKeyFromCoords(layer, world_center);
+        addCachedSurfaceKey(surf, ActsGeometryCache::Silicon, hitsetkey);
+      }
 
       // Add this surface to the map
       std::pair<TrkrDefs::hitsetkey, Surface> tmp = make_pair(hitsetkey, surf);
@@ -1084,7 +1199,12 @@ void MakeActsGeometry::makeMvtxMapPairs(TrackingVolumePtr &mvtxVolume)
         }
       }
 
-      TrkrDefs::hitsetkey hitsetkey = getMvtxHitSetKeyFromCoords(layer, world_center);
+      TrkrDefs::hitsetkey hitsetkey = 0;
+      if (!getCachedSurfaceKey(surf, ActsGeometryCache::Silicon, hitsetkey))
+      {
+        hitsetkey = getMvtxHitSetKeyFromCoords(layer, world_center);
+        addCachedSurfaceKey(surf, ActsGeometryCache::Silicon, hitsetkey);
+      }
 
       // Add this surface to the map
       std::pair<TrkrDefs::hitsetkey, Surface> tmp = make_pair(hitsetkey, surf);
@@ -8,6 +8,8 @@
 #ifndef MAKE_ACTS_GEOMETRY_H
 #define MAKE_ACTS_GEOMETRY_H
 
+#include "ActsGeometryCache.h"
+
 #include <fun4all/SubsysReco.h>
 #include <trackbase/TrkrDefs.h>
 
@@ -147,6 +149,9 @@ class MakeActsGeometry : public SubsysReco
   void set_mvtx_applymisalign(bool b) { m_mvtxapplymisalign = b; }
   void set_intt_survey(bool surv) { m_inttSurvey = surv; }
 
+  //! directory of the on-disk geometry cache (see ActsGeometryCache). Empty (default) disables it
+  void set_geometry_cache(const std::string &directory) { m_geometryCacheDir = directory; }
+
  private:
   /// Main function to build all acts geometry for use in the fitting modules
   int buildAllGeometry(PHCompositeNode *topNode);
@@ -209,6 +214,10 @@ class MakeActsGeometry : public SubsysReco
 
   void unpackVolumes();
 
+  /// hitsetkey (layer for the TPC) of a surface from the geometry cache. False if not cached
+  bool getCachedSurfaceKey(const Surface &surf, ActsGeometryCache::SurfaceType type, TrkrDefs::hitsetkey &key) const;
+  void addCachedSurfaceKey(const Surface &surf, ActsGeometryCache::SurfaceType type, TrkrDefs::hitsetkey key);
+
   /// Subdetector geometry containers for getting layer information
   PHG4CylinderGeomContainer *m_geomContainerMvtx = nullptr;
   PHG4CylinderGeomContainer *m_geomContainerIntt = nullptr;
@@ -228,6 +237,16 @@ class MakeActsGeometry : public SubsysReco
   bool m_useField = true;
   std::map<uint8_t, double> m_misalignmentFactor;
 
+  /// On-disk cache of the material and of the surface to hitsetkey association
+  std::string m_geometryCacheDir;
+  std::unique_ptr<ActsGeometryCache> m_geometryCache;
+  uint64_t m_geometryHash = 0;
+  bool m_surfaceCacheLoaded = false;
+  ActsGeometryCache::RecordMap m_surfaceCache;
+
+  /// time spent in unpackVolumes (ms), for the startup report
+  double m_unpackTime = 0;
+
   /// Several maps that connect Acts world to sPHENIX G4 world
   std::map<TrkrDefs::hitsetkey, TGeoNode *> m_clusterNodeMap;
   std::map<TrkrDefs::hitsetkey, Surface> m_clusterSurfaceMapSilicon;
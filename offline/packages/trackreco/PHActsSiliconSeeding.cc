@@ -29,7 +29,7 @@
 #include <trackbase_historic/TrackSeed.h>
 #include <trackbase_historic/TrackSeedContainer.h>
 #include <trackbase_historic/TrackSeedContainer_v1.h>
-#include <trackbase_historic/TrackSeed_v2.h>
+#include <trackbase_historic/TrackSeed_v3.h>
 
 #ifndef __clang__
 #pragma GCC diagnostic push
@@ -276,7 +276,7 @@ void PHActsSiliconSeeding::makeSvtxTracks(GridSeeds& seedVector)
       std::vector<Acts::Vector3> globalPositions;
 
       std::map<TrkrDefs::cluskey, Acts::Vector3> positions;
-      auto trackSeed = std::make_unique<TrackSeed_v2>();
+      auto trackSeed = std::make_unique<TrackSeed_v3>();
 
       for (auto& spacePoint : seed.sp())
       {
@@ -23,7 +23,7 @@
 #include <trackbase_historic/SvtxAlignmentStateMap_v1.h>
 #include <trackbase_historic/SvtxTrackMap_v2.h>
 #include <trackbase_historic/SvtxTrackState_v1.h>
-#include <trackbase_historic/SvtxTrack_v4.h>
+#include <trackbase_historic/SvtxTrack_v5.h>
 #include <trackbase_historic/TrackSeed.h>
 #include <trackbase_historic/TrackSeedContainer.h>
 
@@ -377,7 +377,7 @@ void PHActsTrkFitter::loopTracks(Acts::Logging::Level logLevel)
     bool use_estimate = false;
     short int nvary = 0;
     std::vector<float> chisq_ndf;
-    std::vector<SvtxTrack_v4> svtx_vec;
+    std::vector<SvtxTrack_v5> svtx_vec;
 
     if(m_pp_mode)
       {
@@ -647,7 +647,7 @@ void PHActsTrkFitter::loopTracks(Acts::Logging::Level logLevel)
           // this is a trial variation of the crossing estimate for this track
           // Capture the chisq/ndf so we can choose the best one after all trials
 
-          SvtxTrack_v4 newTrack;
+          SvtxTrack_v5 newTrack;
           newTrack.set_tpc_seed(tpcseed);
           newTrack.set_crossing(this_crossing);
           newTrack.set_silicon_seed(siseed);
@@ -698,7 +698,7 @@ void PHActsTrkFitter::loopTracks(Acts::Logging::Level logLevel)
         }
         else  // case where INTT crossing is known
         {
-          SvtxTrack_v4 newTrack;
+          SvtxTrack_v5 newTrack;
           newTrack.set_tpc_seed(tpcseed);
           newTrack.set_crossing(this_crossing);
           newTrack.set_silicon_seed(siseed);
@@ -27,6 +27,7 @@
 #include <ffamodules/CDBInterface.h>
 
 // trackbase_historic includes
+#include <trackbase/ClusterPositionCache.h>
 #include <trackbase/TrackFitUtils.h>
 #include <trackbase/TrkrCluster.h>  // for TrkrCluster
 #include <trackbase/TrkrClusterContainer.h>
@@ -35,6 +36,7 @@
 #include <trackbase/TrkrDefs.h>  // for getLayer, clu...
 #include <trackbase_historic/TrackSeedContainer.h>
 #include <trackbase_historic/TrackSeed_v2.h>
+#include <trackbase_historic/TrackSeed_v3.h>
 
 // ROOT includes for debugging
 #include <TFile.h>
@@ -204,6 +206,14 @@ int PHCASeeding::InitializeGeometry(PHCompositeNode* topNode)
 
 Acts::Vector3 PHCASeeding::getGlobalPosition(TrkrDefs::cluskey key, TrkrCluster* cluster) const
 {
+  if (m_positionCache && m_positionCache->isValid(_cluster_map))
+  {
+    const auto position = _pp_mode ? m_positionCache->getRawPosition(key) : m_positionCache->getCorrectedPosition(key);
+    if (position)
+    {
+      return *position;
+    }
+  }
   return _pp_mode ? m_tGeometry->getGlobalPosition(key, cluster) : m_globalPositionWrapper.getGlobalPositionDistortionCorrected(key, cluster, 0);
 }
 
@@ -318,8 +328,9 @@ std::vector<PHCASeeding::coordKey> PHCASeeding::FillTree(bgi::rtree<PHCASeeding:
   return coords;
 }
 
-int PHCASeeding::Process(PHCompositeNode* /*topNode*/)
+int PHCASeeding::Process(PHCompositeNode* topNode)
 {
+  m_positionCache = findNode::getClass<ClusterPositionCache>(topNode, "ClusterPositionCache");
   process_tupout_count();
   if (Verbosity() > 3)
   {
@@ -928,7 +939,7 @@ void PHCASeeding::publishSeeds(const std::vector<TrackSeed_v2>& seeds) const
 {
   for (const auto& seed : seeds)
   {
-    auto pseed = std::make_unique<TrackSeed_v2>(seed);
+    auto pseed = std::make_unique<TrackSeed_v3>(seed);
     if (Verbosity() > 4)
     {
       pseed->identify();
@@ -48,6 +48,7 @@
 #include <TNtuple.h>
 
 class ActsGeometry;
+class ClusterPositionCache;
 class PHCompositeNode;
 class PHTimer;
 class SvtxTrack_v3;
@@ -266,6 +267,9 @@ class PHCASeeding : public PHTrackSeeding
   /// global position wrapper
   TpcGlobalPositionWrapper m_globalPositionWrapper;
 
+  /// shared cluster positions, if filled by PHClusterPositionCacheMaker
+  ClusterPositionCache* m_positionCache{nullptr};
+
   std::unique_ptr<ALICEKF> fitter;
 
   std::unique_ptr<PHTimer> t_seed;
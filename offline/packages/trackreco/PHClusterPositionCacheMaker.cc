@@ -0,0 +1,160 @@
+#include "PHClusterPositionCacheMaker.h"
+
+#include <trackbase/ActsGeometry.h>
+#include <trackbase/ClusterPositionCache.h>
+#include <trackbase/TpcDefs.h>
+#include <trackbase/TrkrCluster.h>
+#include <trackbase/TrkrClusterContainer.h>
+
+#include <fun4all/Fun4AllReturnCodes.h>
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHDataNode.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/getClass.h>
+#include <phool/phool.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+//____________________________________________________________________________..
+PHClusterPositionCacheMaker::PHClusterPositionCacheMaker(const std::string &name)
+  : SubsysReco(name)
+{
+}
+
+//____________________________________________________________________________..
+int PHClusterPositionCacheMaker::InitRun(PHCompositeNode *topNode)
+{
+  m_tGeometry = findNode::getClass<ActsGeometry>(topNode, "ActsGeometry");
+  if (!m_tGeometry)
+  {
+    std::cout << PHWHERE << "No acts tracking geometry, can't proceed" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  // tpc global position wrapper
+  m_globalPositionWrapper.loadNodes(topNode);
+
+  return createNodes(topNode);
+}
+
+//____________________________________________________________________________..
+int PHClusterPositionCacheMaker::process_event(PHCompositeNode *topNode)
+{
+  m_cache->invalidate();
+
+  m_clusterContainer = findNode::getClass<TrkrClusterContainer>(topNode, m_clusterContainerName);
+  if (!m_clusterContainer)
+  {
+    std::cout << PHWHERE << " ERROR: Can't find node " << m_clusterContainerName << std::endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+
+  // collect the clusters. The cluster container is not thread safe, this is done serially
+  m_clusters.clear();
+  m_hitset_begin.clear();
+  for (const auto &hitsetkey : m_clusterContainer->getHitSetKeys())
+  {
+    m_hitset_begin.push_back(m_clusters.size());
+    unsigned int nclusters = 0;
+    auto range = m_clusterContainer->getClusters(hitsetkey);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      m_clusters.emplace_back(iter->first, iter->second);
+      nclusters = std::max(nclusters, TrkrDefs::getClusIndex(iter->first) + 1);
+    }
+    m_cache->addHitSet(hitsetkey, nclusters);
+  }
+  m_hitset_begin.push_back(m_clusters.size());
+  m_cache->allocate(m_clusterContainer);
+
+  // compute the positions
+  std::atomic<size_t> next_hitset(0);
+  const unsigned int nthreads = std::min<size_t>(m_nthreads, m_hitset_begin.size() - 1);
+  if (nthreads <= 1)
+  {
+    fill_hitsets(next_hitset);
+  }
+  else
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+    for (unsigned int i = 0; i < nthreads; ++i)
+    {
+      threads.emplace_back(&PHClusterPositionCacheMaker::fill_hitsets, this, std::ref(next_hitset));
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "PHClusterPositionCacheMaker::process_event - cached " << m_clusters.size()
+              << " cluster positions in " << m_hitset_begin.size() - 1 << " hitsets" << std::endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+//____________________________________________________________________________..
+void PHClusterPositionCacheMaker::fill_hitsets(std::atomic<size_t> &next_hitset)
+{
+  const size_t nhitsets = m_hitset_begin.size() - 1;
+  for (size_t ihitset = next_hitset++; ihitset < nhitsets; ihitset = next_hitset++)
+  {
+    for (size_t i = m_hitset_begin[ihitset]; i < m_hitset_begin[ihitset + 1]; ++i)
+    {
+      const auto &[key, cluster] = m_clusters[i];
+      const Acts::Vector3 raw = m_tGeometry->getGlobalPosition(key, cluster);
+      if (TrkrDefs::getTrkrId(key) == TrkrDefs::tpcId)
+      {
+        // same as TpcGlobalPositionWrapper::getGlobalPositionDistortionCorrected for crossing zero,
+        // without computing the raw position twice
+        Acts::Vector3 corrected = raw;
+        corrected.z() = m_crossingCorrection.correctZ(raw.z(), TpcDefs::getSide(key), 0);
+        m_cache->set(key, raw, m_globalPositionWrapper.applyDistortionCorrections(corrected));
+      }
+      else
+      {
+        m_cache->set(key, raw, raw);
+      }
+    }
+  }
+}
+
+//____________________________________________________________________________..
+int PHClusterPositionCacheMaker::createNodes(PHCompositeNode *topNode)
+{
+  m_cache = findNode::getClass<ClusterPositionCache>(topNode, "ClusterPositionCache");
+  if (m_cache)
+  {
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
+
+  PHNodeIterator iter(topNode);
+  auto dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  if (!dstNode)
+  {
+    std::cout << PHWHERE << "DST Node missing, doing nothing." << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  PHNodeIterator dstiter(dstNode);
+  auto trkrNode = dynamic_cast<PHCompositeNode *>(dstiter.findFirst("PHCompositeNode", "TRKR"));
+  if (!trkrNode)
+  {
+    trkrNode = new PHCompositeNode("TRKR");
+    dstNode->addNode(trkrNode);
+  }
+
+  // transient, PHDataNodes are not written out
+  m_cache = new ClusterPositionCache;
+  trkrNode->addNode(new PHDataNode<ClusterPositionCache>(m_cache, "ClusterPositionCache"));
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
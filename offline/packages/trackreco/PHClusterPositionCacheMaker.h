@@ -0,0 +1,75 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+
+/*!
+ *  \file PHClusterPositionCacheMaker.h
+ *  \brief fill the per event ClusterPositionCache with the global positions of all clusters
+ *
+ *  Runs once per event, after clustering and before the tracking modules that read the cache.
+ *  Hitsets are distributed dynamically over setNThreads threads.
+ */
+
+#ifndef TRACKRECO_PHCLUSTERPOSITIONCACHEMAKER_H
+#define TRACKRECO_PHCLUSTERPOSITIONCACHEMAKER_H
+
+#include <fun4all/SubsysReco.h>
+#include <tpc/TpcClusterZCrossingCorrection.h>
+#include <tpc/TpcGlobalPositionWrapper.h>
+#include <trackbase/TrkrDefs.h>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ActsGeometry;
+class ClusterPositionCache;
+class PHCompositeNode;
+class TrkrCluster;
+class TrkrClusterContainer;
+
+class PHClusterPositionCacheMaker : public SubsysReco
+{
+ public:
+  PHClusterPositionCacheMaker(const std::string &name = "PHClusterPositionCacheMaker");
+
+  ~PHClusterPositionCacheMaker() override = default;
+
+  int InitRun(PHCompositeNode *topNode) override;
+  int process_event(PHCompositeNode *topNode) override;
+
+  //! cluster container the positions are computed for
+  void setClusterContainerName(const std::string &name) { m_clusterContainerName = name; }
+
+  //! number of threads used to fill the cache
+  void setNThreads(unsigned int nthreads) { m_nthreads = nthreads ? nthreads : 1; }
+
+ private:
+  //! create the cache node if needed
+  int createNodes(PHCompositeNode *);
+
+  //! fill the positions of hitsets taken one after the other from the shared counter
+  void fill_hitsets(std::atomic<size_t> &next_hitset);
+
+  ActsGeometry *m_tGeometry = nullptr;
+  TrkrClusterContainer *m_clusterContainer = nullptr;
+  ClusterPositionCache *m_cache = nullptr;
+
+  //! tpc crossing correction
+  TpcClusterZCrossingCorrection m_crossingCorrection;
+
+  //! tpc distortion corrections
+  TpcGlobalPositionWrapper m_globalPositionWrapper;
+
+  std::string m_clusterContainerName = "TRKR_CLUSTER";
+  unsigned int m_nthreads = 1;
+
+  //! clusters of the current event, grouped by hitset
+  std::vector<std::pair<TrkrDefs::cluskey, TrkrCluster *>> m_clusters;
+
+  //! first cluster of each hitset in m_clusters, plus the total number of clusters
+  std::vector<size_t> m_hitset_begin;
+};
+
+#endif  // TRACKRECO_PHCLUSTERPOSITIONCACHEMAKER_H
@@ -25,6 +25,7 @@
 #include <tpc/TpcDistortionCorrectionContainer.h>
 
 #include <trackbase/ActsGeometry.h>
+#include <trackbase/ClusterPositionCache.h>
 #include <trackbase/TrackFitUtils.h>
 #include <trackbase/TrkrCluster.h>
 #include <trackbase/TrkrClusterContainer.h>
@@ -34,6 +35,7 @@
 #include <trackbase_historic/ActsTransformations.h>
 #include <trackbase_historic/TrackSeedContainer.h>
 #include <trackbase_historic/TrackSeed_v2.h>
+#include <trackbase_historic/TrackSeed_v3.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
 
@@ -225,6 +227,8 @@ int PHSimpleKFProp::process_event(PHCompositeNode* topNode)
     }
   }
 
+  m_positionCache = findNode::getClass<ClusterPositionCache>(topNode, "ClusterPositionCache");
+
   PHTimer timer("KFPropTimer");
 
   timer.stop();
@@ -477,6 +481,15 @@ int PHSimpleKFProp::process_event(PHCompositeNode* topNode)
 
 Acts::Vector3 PHSimpleKFProp::getGlobalPosition(TrkrDefs::cluskey key, TrkrCluster* cluster) const
 {
+  if (m_positionCache && m_positionCache->isValid(_cluster_map))
+  {
+    const auto position = _pp_mode ? m_positionCache->getRawPosition(key) : m_positionCache->getCorrectedPosition(key);
+    if (position)
+    {
+      return *position;
+    }
+  }
+
   // get global position from Acts transform
   return _pp_mode ?
     m_tgeometry->getGlobalPosition(key, cluster):
@@ -1446,7 +1459,8 @@ void PHSimpleKFProp::rejectAndPublishSeeds(std::vector<TrackSeed_v2>& seeds, con
       continue;
     }
     auto& seed = seeds[itrack];
-    _track_map->insert(&seed);
+    const TrackSeed_v3 pseed(seed);
+    _track_map->insert(&pseed);
 
     int q = seed.get_charge();
     if (Verbosity() > 0)
@@ -1469,6 +1483,7 @@ void PHSimpleKFProp::publishSeeds(const std::vector<TrackSeed_v2>& seeds)
 {
   for (const auto& seed : seeds)
   {
-    _track_map->insert(&seed);
+    const TrackSeed_v3 pseed(seed);
+    _track_map->insert(&pseed);
   }
 }
@@ -29,6 +29,7 @@
 #include <vector>
 
 class ActsGeometry;
+class ClusterPositionCache;
 class PHCompositeNode;
 class PHField;
 class TrkrClusterContainer;
@@ -115,6 +116,9 @@ class PHSimpleKFProp : public SubsysReco
   /// global position wrapper
   TpcGlobalPositionWrapper m_globalPositionWrapper;
 
+  /// shared cluster positions, if filled by PHClusterPositionCacheMaker
+  ClusterPositionCache* m_positionCache = nullptr;
+
   /// get global position for a given cluster
   /**
    * uses ActsTransformation to convert cluster local position into global coordinates
@@ -4,6 +4,7 @@
 
 /// Tracking includes
 
+#include <trackbase/ClusterPositionCache.h>
 #include <trackbase/TrkrCluster.h>            // for TrkrCluster
 #include <trackbase/TrkrClusterContainer.h>
 #include <trackbase_historic/TrackSeed.h>    
@@ -92,6 +93,9 @@ int PHTpcDeltaZCorrection::load_nodes( PHCompositeNode* topNode )
       m_cluster_map = findNode::getClass<TrkrClusterContainer>(topNode, "TRKR_CLUSTER");
     }
   assert(m_cluster_map);
+
+  m_position_cache = findNode::getClass<ClusterPositionCache>(topNode, "ClusterPositionCache");
+  if( m_position_cache && !m_position_cache->isValid(m_cluster_map) ) m_position_cache = nullptr;
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -155,7 +159,8 @@ void PHTpcDeltaZCorrection::process_track( unsigned int key, TrackSeed* track )
     if(!cluster) continue;
 
     // get cluster global position
-    const auto global = m_tGeometry->getGlobalPosition(cluster_key, cluster);
+    const auto cached = m_position_cache ? m_position_cache->getRawPosition(cluster_key) : nullptr;
+    const auto global = cached ? *cached : m_tGeometry->getGlobalPosition(cluster_key, cluster);
 
     // get delta z
     const double delta_z = global.z() - origin.z();
@@ -178,6 +183,7 @@ void PHTpcDeltaZCorrection::process_track( unsigned int key, TrackSeed* track )
      */
     const double t_correction = pathlength /speed_of_light;  
     cluster->setLocalY( cluster->getLocalY() - t_correction);
+    if( m_position_cache ) m_position_cache->invalidate( cluster_key );
 
     if( Verbosity() )
       { std::cout << "PHTpcDeltaZCorrection::process_track - cluster: " << cluster_key 
@@ -15,6 +15,7 @@
 #include <trackbase/ActsGeometry.h>
 #include <trackbase/TrkrDefs.h>
 
+class ClusterPositionCache;
 class TrackSeedContainer;
 class TrkrClusterContainer;
 class TrackSeed;
@@ -54,6 +55,9 @@ class PHTpcDeltaZCorrection : public SubsysReco, public PHParameterInterface
   /// cluster map
   TrkrClusterContainer *m_cluster_map = nullptr;
 
+  /// shared cluster positions. Corrected clusters are invalidated
+  ClusterPositionCache *m_position_cache = nullptr;
+
   /// list of corrected cluster keys
   /** needed to prevent clusters to be corrected twice, when same cluster is used for two different tracks */
   std::set<TrkrDefs::cluskey> m_corrected_clusters;
@@ -18,6 +18,8 @@
 #include <trackbase_historic/SvtxTrackMap.h>
 #include <trackbase_historic/SvtxTrackState.h>
 
+#include <vector>
+
 //____________________________________________________________________________..
 SvtxTrackStateRemoval::SvtxTrackStateRemoval(const std::string& name)
   : SubsysReco(name)
@@ -67,8 +69,11 @@ int SvtxTrackStateRemoval::process_event(PHCompositeNode* topNode)
   const float lastthickness = layergeom->get_thickness();
   const float lasttrackingradius = lastradius + lastthickness / 2.;
 
+  std::vector<float> pathlengths;
   for (auto& [key, track] : *trackmap)
   {
+    /// erasing invalidates the state iterators, collect the states first
+    pathlengths.clear();
     for (auto iter = track->begin_states(); iter != track->end_states(); ++iter)
     {
       /// Don't erase the PCA state information
@@ -80,9 +85,13 @@ int SvtxTrackStateRemoval::process_event(PHCompositeNode* topNode)
       float pathlength = iter->second->get_pathlength();
       if (pathlength < lasttrackingradius)
       {
-        track->erase_state(pathlength);
+        pathlengths.push_back(pathlength);
       }
     }
+    for (const auto& pathlength : pathlengths)
+    {
+      track->erase_state(pathlength);
+    }
 
     if (Verbosity() > 1)
     {
@@ -19,6 +19,9 @@ class SvtxTrackStateRemoval : public SubsysReco
   int Init(PHCompositeNode *topNode) override;
   int InitRun(PHCompositeNode *topNode) override;
   int process_event(PHCompositeNode *topNode) override;
+
+  //! only uses the nodes under topNode, can run in several event slots at once
+  bool ThreadSafe() const override { return true; }
   int End(PHCompositeNode *topNode) override;
 
  private:
@@ -33,6 +33,7 @@
 
 #include <boost/io/ios_state.hpp>
 
+#include <algorithm>  // for stable_sort, fill, max
 #include <cmath>      // for fabs, tan, atan2
 #include <cstdlib>    // for exit
 #include <exception>  // for exception
@@ -40,6 +41,7 @@
 #include <map>
 #include <stdexcept>
 #include <utility>  // for pair, make_pair
+#include <vector>
 
 RawTowerBuilder::RawTowerBuilder(const std::string &name)
   : SubsysReco(name)
@@ -80,6 +82,13 @@ int RawTowerBuilder::InitRun(PHCompositeNode *topNode)
     std::cout << e.what() << std::endl;
     //exit(1);
   }
+  // dense per event tower energies, sized from the tower geometry
+  if (m_RawTowerGeomContainer)
+  {
+    m_NumEtaBins = m_RawTowerGeomContainer->get_etabins();
+    m_NumPhiBins = m_RawTowerGeomContainer->get_phibins();
+  }
+  m_TowerEnergy.assign(std::max(m_NumEtaBins, 0) * std::max(m_NumPhiBins, 0), 0);
 
   if (Verbosity() >= 1)
   {
@@ -122,7 +131,9 @@ int RawTowerBuilder::process_event(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::ABORTEVENT;
   }
 
-  // loop over all cells in an event
+  // accumulate the cells in the dense tower array, the towers are
+  // only looked up once per event in the containers
+  m_TowerCells.clear();
   PHG4CellContainer::ConstIterator cell_iter;
   PHG4CellContainer::ConstRange cell_range = cells->getCells();
   for (cell_iter = cell_range.first; cell_iter != cell_range.second; ++cell_iter)
@@ -135,7 +146,6 @@ int RawTowerBuilder::process_event(PHCompositeNode *topNode)
       cell->identify();
     }
 
-
     //Calculate the cell weight
     float cell_weight = 0;
     if (m_TowerEnergySrcEnum == kEnergyDeposition)
@@ -147,119 +157,151 @@ int RawTowerBuilder::process_event(PHCompositeNode *topNode)
       cell_weight = cell->get_light_yield();
     }
 
+    unsigned int etabin;
+    unsigned int phibin;
+    if (cell->has_binning(PHG4CellDefs::spacalbinning))
+    {
+      etabin = PHG4CellDefs::SpacalBinning::get_etabin(cell->get_cellid());
+      phibin = PHG4CellDefs::SpacalBinning::get_phibin(cell->get_cellid());
+    }
+    else if (m_UseTowerInfo == kRawTowerOnly && cell->has_binning(PHG4CellDefs::sizebinning))
+    {
+      // TowerInfo only supports spacal binning
+      etabin = PHG4CellDefs::SizeBinning::get_zbin(cell->get_cellid());
+      phibin = PHG4CellDefs::SizeBinning::get_phibin(cell->get_cellid());
+    }
+    else
+    {
+      boost::io::ios_flags_saver ifs(std::cout);
+      std::cout << "unknown cell binning, implement 0x" << std::hex << PHG4CellDefs::get_binning(cell->get_cellid()) << std::dec << std::endl;
+      exit(1);
+    }
+    if (static_cast<int>(etabin) >= m_NumEtaBins || static_cast<int>(phibin) >= m_NumPhiBins)
+    {
+      std::cout << PHWHERE << " cell eta bin " << etabin << ", phi bin " << phibin
+                << " outside of tower geometry " << m_NumEtaBins << " x " << m_NumPhiBins << std::endl;
+      exit(1);
+    }
+    const unsigned int index = etabin * m_NumPhiBins + phibin;
+    m_TowerEnergy[index] += cell_weight;
+    if (m_UseTowerInfo != 1)
+    {
+      m_TowerCells.push_back({index, cell_weight, cell});
+    }
+  }
 
-    // add the energy to the corresponding tower
-    if (m_UseTowerInfo  != 1)
+  if (m_UseTowerInfo != 1)
+  {
+    // group the cells by tower, keeping the cell order within a tower
+    std::stable_sort(m_TowerCells.begin(), m_TowerCells.end(),
+                     [](const TowerCell &lhs, const TowerCell &rhs)
+                     { return lhs.index < rhs.index; });
+
+    // energy of towers below threshold, which are not created at all
+    double dropped_energy = 0;
+    for (auto cell_iter2 = m_TowerCells.begin(); cell_iter2 != m_TowerCells.end();)
+    {
+      const unsigned int index = cell_iter2->index;
+      auto tower_end = cell_iter2;
+      while (tower_end != m_TowerCells.end() && tower_end->index == index)
       {
-	RawTower *tower = nullptr;
-	short int firstpar;
-	short int secondpar;
-	if (cell->has_binning(PHG4CellDefs::sizebinning))
-	  {
-	    firstpar = PHG4CellDefs::SizeBinning::get_zbin(cell->get_cellid());
-	    secondpar = PHG4CellDefs::SizeBinning::get_phibin(cell->get_cellid());
-	  }
-	else if (cell->has_binning(PHG4CellDefs::spacalbinning))
-	  {
-	    firstpar = PHG4CellDefs::SpacalBinning::get_etabin(cell->get_cellid());
-	    secondpar = PHG4CellDefs::SpacalBinning::get_phibin(cell->get_cellid());
-	  }
-	else
-	  {
-	    boost::io::ios_flags_saver ifs(std::cout);
-	    std::cout << "unknown cell binning, implement 0x" << std::hex << PHG4CellDefs::get_binning(cell->get_cellid()) << std::dec << std::endl;
-	    exit(1);
-	  }
-	tower = m_TowerContainer->getTower(firstpar, secondpar);
-	if (!tower)
-	  {
-	    tower = new RawTowerv1();
-	    tower->set_energy(0);
-	    m_TowerContainer->AddTower(firstpar, secondpar, tower);
-	  }
-	
-	tower->add_ecell(cell->get_cellid(), cell_weight);
-	
-	PHG4Cell::ShowerEdepConstRange range = cell->get_g4showers();
-	for (PHG4Cell::ShowerEdepConstIterator shower_iter = range.first;
-	     shower_iter != range.second;
-	     ++shower_iter)
-	  {
-	    tower->add_eshower(shower_iter->first, shower_iter->second);
-	  }
-	
-	tower->set_energy(tower->get_energy() + cell_weight);
-	
-	if (Verbosity() > 2)
-	  {
-	    m_RawTowerGeomContainer = findNode::getClass<RawTowerGeomContainer>(topNode, m_TowerGeomNodeName);
-	    tower->identify();
-	  }
+        ++tower_end;
       }
-    if (m_UseTowerInfo > 0)
+      const unsigned int etabin = index / m_NumPhiBins;
+      const unsigned int phibin = index % m_NumPhiBins;
+      const double tower_energy = m_TowerEnergy[index];
+
+      RawTower *tower = m_TowerContainer->getTower(etabin, phibin);
+      if (!tower)
       {
-	TowerInfo *towerinfo;
-	unsigned int etabin;
-	unsigned int phibin;
-	if (cell->has_binning(PHG4CellDefs::spacalbinning))
-	  {
-	    etabin = PHG4CellDefs::SpacalBinning::get_etabin(cell->get_cellid());
-	    phibin = PHG4CellDefs::SpacalBinning::get_phibin(cell->get_cellid());
-	  }
-	else
-	  {
-	    boost::io::ios_flags_saver ifs(std::cout);
-	    std::cout << "unknown cell binning, implement 0x" << std::hex << PHG4CellDefs::get_binning(cell->get_cellid()) << std::dec << std::endl;
-	    exit(1);
-	  }
-	unsigned int towerkey = (etabin << 16U) + phibin;
-	// unsigned int towerindex = m_TowerInfoContainer->decode_key(towerkey);
-	towerinfo = m_TowerInfoContainer->get_tower_at_key(towerkey);
-        if (!towerinfo)
+        // compress would remove it anyway
+        if (m_Emin > 0 && tower_energy < m_Emin)
         {
-          std::cout << __PRETTY_FUNCTION__ << ": missing towerkey = " << towerkey << " in m_TowerInfoContainer!";
-          exit(1);
+          dropped_energy += tower_energy;
+          cell_iter2 = tower_end;
+          continue;
         }
-        else
+        tower = new RawTowerv1();
+        tower->set_energy(0);
+        m_TowerContainer->AddTower(etabin, phibin, tower);
+      }
+
+      for (; cell_iter2 != tower_end; ++cell_iter2)
+      {
+        PHG4Cell *cell = cell_iter2->cell;
+        tower->add_ecell(cell->get_cellid(), cell_iter2->weight);
+
+        PHG4Cell::ShowerEdepConstRange range = cell->get_g4showers();
+        for (PHG4Cell::ShowerEdepConstIterator shower_iter = range.first;
+             shower_iter != range.second;
+             ++shower_iter)
         {
-          towerinfo->set_energy(towerinfo->get_energy() + cell_weight);
+          tower->add_eshower(shower_iter->first, shower_iter->second);
         }
       }
+      tower->set_energy(tower->get_energy() + tower_energy);
+
+      if (Verbosity() > 2)
+      {
+        tower->identify();
+      }
+    }
+
+    double towerE = 0;
+    if (m_ChkEnergyConservationFlag)
+    {
+      double cellE = cells->getTotalEdep();
+      towerE = m_TowerContainer->getTotalEdep() + dropped_energy;
+      if (fabs(cellE - towerE) / cellE > 1e-5)
+      {
+        std::cout << "towerE: " << towerE << ", cellE: " << cellE << ", delta: "
+                  << cellE - towerE << std::endl;
+      }
+    }
+    if (Verbosity())
+    {
+      towerE = m_TowerContainer->getTotalEdep() + dropped_energy;
+    }
+
+    m_TowerContainer->compress(m_Emin);
+    if (Verbosity())
+    {
+      std::cout << "Energy lost by dropping towers with less than " << m_Emin
+                << " GeV energy, lost energy: " << towerE - m_TowerContainer->getTotalEdep()
+                << std::endl;
+      m_TowerContainer->identify();
+      RawTowerContainer::ConstRange begin_end = m_TowerContainer->getTowers();
+      RawTowerContainer::ConstIterator iter;
+      for (iter = begin_end.first; iter != begin_end.second; ++iter)
+      {
+        iter->second->identify();
+      }
+    }
   }
 
-  if (m_UseTowerInfo != 1 )
+  if (m_UseTowerInfo > 0)
+  {
+    // single pass over the dense array, empty towers are skipped
+    for (unsigned int index = 0; index < m_TowerEnergy.size(); ++index)
     {
-      double towerE = 0;
-      if (m_ChkEnergyConservationFlag)
-	{
-	  double cellE = cells->getTotalEdep();
-	  towerE = m_TowerContainer->getTotalEdep();
-	  if (fabs(cellE - towerE) / cellE > 1e-5)
-	    {
-	      std::cout << "towerE: " << towerE << ", cellE: " << cellE << ", delta: "
-			<< cellE - towerE << std::endl;
-	    }
-	}
-      if (Verbosity())
-	{
-	  towerE = m_TowerContainer->getTotalEdep();
-	}
-      
-      m_TowerContainer->compress(m_Emin);
-      if (Verbosity())
-	{
-	  std::cout << "Energy lost by dropping towers with less than " << m_Emin
-		    << " GeV energy, lost energy: " << towerE - m_TowerContainer->getTotalEdep()
-		    << std::endl;
-	  m_TowerContainer->identify();
-	  RawTowerContainer::ConstRange begin_end = m_TowerContainer->getTowers();
-	  RawTowerContainer::ConstIterator iter;
-	  for (iter = begin_end.first; iter != begin_end.second; ++iter)
-	    {
-	      iter->second->identify();
-	    }
-	}
+      if (m_TowerEnergy[index] == 0)
+      {
+        continue;
+      }
+      const unsigned int etabin = index / m_NumPhiBins;
+      const unsigned int phibin = index % m_NumPhiBins;
+      unsigned int towerkey = (etabin << 16U) + phibin;
+      TowerInfo *towerinfo = m_TowerInfoContainer->get_tower_at_key(towerkey);
+      if (!towerinfo)
+      {
+        std::cout << __PRETTY_FUNCTION__ << ": missing towerkey = " << towerkey << " in m_TowerInfoContainer!";
+        exit(1);
+      }
+      towerinfo->set_energy(towerinfo->get_energy() + m_TowerEnergy[index]);
     }
+  }
+
+  std::fill(m_TowerEnergy.begin(), m_TowerEnergy.end(), 0);
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -7,8 +7,10 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
+class PHG4Cell;
 class RawTowerContainer;
 class RawTowerGeomContainer;
 
@@ -91,6 +93,17 @@ class RawTowerBuilder : public SubsysReco
   double m_EtaStep {std::numeric_limits<double>::quiet_NaN()};
   double m_PhiStep {std::numeric_limits<double>::quiet_NaN()};
   RawTowerBuilder::ProcessTowerType m_UseTowerInfo {RawTowerBuilder::ProcessTowerType::kBothTowers};  // 0 just produce RawTowers, 1 just produce TowerInfo objects, and 2 produce both
+
+  //! per event tower energies, index = etabin * m_NumPhiBins + phibin
+  std::vector<double> m_TowerEnergy;
+  //! cells of the event with their tower index, to fill the cell and shower lists of the RawTowers
+  struct TowerCell
+  {
+    unsigned int index;
+    float weight;
+    PHG4Cell *cell;
+  };
+  std::vector<TowerCell> m_TowerCells;
 };
 
 #endif  // G4CALO_RAWTOWERBUILDER_H
@@ -18,6 +18,9 @@ class g4hitshift : public SubsysReco
 
   int process_event(PHCompositeNode *topNode) override;
 
+  //! only uses the nodes under topNode, can run in several event slots at once
+  bool ThreadSafe() const override { return true; }
+
  private:
 };
 
@@ -19,6 +19,9 @@ class g4hitshifthcal : public SubsysReco
 
   int process_event(PHCompositeNode *topNode) override;
 
+  //! only uses the nodes under topNode, can run in several event slots at once
+  bool ThreadSafe() const override { return true; }
+
  private:
 };
 
@@ -128,19 +128,30 @@ int PHG4CylinderSubsystem::InitRunSubsystem(PHCompositeNode *topNode)
     }
     PHG4CylinderGeom *mygeom = new PHG4CylinderGeomv1(GetParams()->get_double_param("radius"), GetParams()->get_double_param("place_z") - detlength / 2., GetParams()->get_double_param("place_z") + detlength / 2., GetParams()->get_double_param("thickness"));
     geo->AddLayerGeom(GetLayer(), mygeom);
-    auto *tmp = new PHG4CylinderSteppingAction(this, m_Detector, GetParams());
-    tmp->HitNodeName(nodename);
-    m_SteppingAction = tmp;
+    m_HitNodeName = nodename;
   }
-  else if (GetParams()->get_int_param("blackhole"))
+  PHG4WorkerActions actions;
+  CreateWorkerActions(actions);
+  m_SteppingAction = actions.SteppingAction;
+  return 0;
+}
+
+//_______________________________________________________________________
+void PHG4CylinderSubsystem::CreateWorkerActions(PHG4WorkerActions &actions)
+{
+  // used for the master copy in InitRunSubsystem as well
+  if (!GetParams()->get_int_param("active") && !GetParams()->get_int_param("blackhole"))
   {
-    m_SteppingAction = new PHG4CylinderSteppingAction(this, m_Detector, GetParams());
+    return;
   }
-  if (m_SteppingAction)
+  auto *tmp = new PHG4CylinderSteppingAction(this, m_Detector, GetParams());
+  if (!m_HitNodeName.empty())
   {
-    (dynamic_cast<PHG4CylinderSteppingAction *>(m_SteppingAction))->SaveAllHits(m_SaveAllHitsFlag);
+    tmp->HitNodeName(m_HitNodeName);
   }
-  return 0;
+  tmp->SaveAllHits(m_SaveAllHitsFlag);
+  actions.SteppingAction = tmp;
+  return;
 }
 
 //_______________________________________________________________________
@@ -45,6 +45,10 @@ class PHG4CylinderSubsystem : public PHG4DetectorSubsystem
   PHG4Detector* GetDetector(void) const override;
   PHG4SteppingAction* GetSteppingAction(void) const override { return m_SteppingAction; }
 
+  //! the stepping action only keeps per event state, so worker threads can each have their own
+  bool SupportsWorkerThreads() const override { return true; }
+  void CreateWorkerActions(PHG4WorkerActions& actions) override;
+
   PHG4DisplayAction* GetDisplayAction() const override { return m_DisplayAction; }
   void set_color(const double red, const double green, const double blue, const double alpha = 1.)
   {
@@ -78,6 +82,9 @@ class PHG4CylinderSubsystem : public PHG4DetectorSubsystem
   /*! derives from PHG4DisplayAction */
   PHG4DisplayAction* m_DisplayAction{nullptr};
 
+  //! G4HIT node filled by the stepping action (empty if not active)
+  std::string m_HitNodeName;
+
   bool m_SaveAllHitsFlag = false;
   //! Color setting if we want to override the default
   std::array<double, 4> m_ColorArray{};
@@ -44,16 +44,19 @@
 
 #include <TSystem.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <filesystem>
-#include <map>      // for _Rb_tree_const_it...
-#include <memory>   // for allocator_traits<...
+#include <iterator>  // for prev
+#include <map>       // for _Rb_tree_const_it...
+#include <memory>    // for allocator_traits<...
 #include <set>
-#include <utility>  // for pair, swap, make_...
-#include <vector>   // for vector
+#include <tuple>     // for tie
+#include <utility>   // for pair, swap, make_...
+#include <vector>    // for vector
 
 // update to make sure to clusterize clusters in loopers
 
@@ -293,6 +296,9 @@ int PHG4InttHitReco::process_event(PHCompositeNode *topNode)
     exit(1);
   }
 
+  // fired strips are buffered and inserted in the hitset container at the end of the event
+  m_strip_hits.clear();
+
   PHG4CylinderGeomContainer *geo = findNode::getClass<PHG4CylinderGeomContainer>(topNode, m_GeoNodeName);
   if (!geo)
   {
@@ -532,9 +538,6 @@ int PHG4InttHitReco::process_event(PHCompositeNode *topNode)
       // The hitset key includes the layer, the ladder_z_index (sensors numbered 0-3) and  ladder_phi_index (azimuthal location of ladder) for this hit
       TrkrDefs::hitsetkey hitsetkey = InttDefs::genHitSetKey(sphxlayer, ladder_z_index, ladder_phi_index, crossing);
 
-      // Use existing hitset or add new one if needed
-      TrkrHitSetContainer::Iterator hitsetit = hitsetcontainer->findOrAddHitSet(hitsetkey);
-
       // generate the key for this hit
       TrkrDefs::hitkey hitkey = InttDefs::genHitKey(vzbin[i1], vybin[i1]);
       // See if this hit already exists and is not a raw hit
@@ -553,32 +556,26 @@ int PHG4InttHitReco::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      TrkrHit *hit = hitsetit->second->getHit(hitkey);
-      if (!hit)
-      {
-        // Otherwise, create a new one
-        hit = new TrkrHitv2();
-        hitsetit->second->addHitSpecificKey(hitkey, hit);
-      }
-
-      // Either way, add the energy to it
+      // the hit is created or updated at the end of the event
       if (Verbosity() > 2)
       {
         std::cout << "add energy " << venergy[i1].first << " to intthit " << std::endl;
       }
 
-      hit->addEnergy(hit_energy);
+      m_strip_hits.push_back({hitsetkey, hitkey, hit_energy});
 
       // Add this hit to the association map
       hittruthassoc->addAssoc(hitsetkey, hitkey, hiter->first);
 
       if (Verbosity() > 2)
       {
-        std::cout << "PHG4InttHitReco: added hit wirh hitsetkey " << hitsetkey << " hitkey " << hitkey << " g4hitkey " << hiter->first << " energy " << hit->getEnergy() << std::endl;
+        std::cout << "PHG4InttHitReco: added hit wirh hitsetkey " << hitsetkey << " hitkey " << hitkey << " g4hitkey " << hiter->first << " energy " << hit_energy << std::endl;
       }
     }
   }  // end loop over g4hits
 
+  fill_hitsets(hitsetcontainer);
+
   // print the list of entries in the association table
   if (Verbosity() > 0)
   {
@@ -597,6 +594,38 @@ int PHG4InttHitReco::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }  // end process_event
 
+void PHG4InttHitReco::fill_hitsets(TrkrHitSetContainer *hitsetcontainer)
+{
+  // group the strips by hitset and hit key. The sort is stable so that the energies
+  // of a given strip are added in the g4hit order, as when they were added directly
+  std::stable_sort(m_strip_hits.begin(), m_strip_hits.end(), [](const StripHit &lhs, const StripHit &rhs)
+                   { return std::tie(lhs.hitsetkey, lhs.hitkey) < std::tie(rhs.hitsetkey, rhs.hitkey); });
+
+  TrkrHitSet *hitset = nullptr;
+  TrkrHit *hit = nullptr;
+  for (auto iter = m_strip_hits.begin(); iter != m_strip_hits.end(); ++iter)
+  {
+    if (!hitset || hitset->getHitSetKey() != iter->hitsetkey)
+    {
+      hitset = hitsetcontainer->findOrAddHitSet(iter->hitsetkey)->second;
+      hit = nullptr;
+    }
+
+    // one lookup per strip, the hit may already exist from a previous module
+    if (!hit || std::prev(iter)->hitkey != iter->hitkey)
+    {
+      hit = hitset->getHit(iter->hitkey);
+      if (!hit)
+      {
+        hit = new TrkrHitv2();
+        hitset->addHitSpecificKey(iter->hitkey, hit);
+      }
+    }
+
+    hit->addEnergy(iter->energy);
+  }
+}
+
 void PHG4InttHitReco::SetDefaultParameters()
 {
   // if we ever need separate timing windows, don't patch around here!
@@ -11,6 +11,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <intt/InttMapping.h>
 
@@ -79,6 +80,18 @@ class PHG4InttHitReco : public SubsysReco, public PHParameterInterface
   void cluster_truthhits(PHCompositeNode* topNode);
   void end_event_truthcluster(PHCompositeNode* topNode);
 
+  //! create or update the buffered hits
+  void fill_hitsets(TrkrHitSetContainer*);
+
+  //! fired strip, buffered until the end of the event
+  struct StripHit
+  {
+    TrkrDefs::hitsetkey hitsetkey;
+    TrkrDefs::hitkey hitkey;
+    double energy;
+  };
+  std::vector<StripHit> m_strip_hits;
+
   double m_pixel_thresholdrat{0.01};
   float max_g4hitstep{2.0};
   bool record_ClusHitsVerbose{false};
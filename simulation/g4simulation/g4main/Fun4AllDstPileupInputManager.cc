@@ -26,7 +26,7 @@
 
 #include <cassert>
 #include <iostream>  // for operator<<, basic_ostream, endl
-#include <utility>   // for pair
+#include <utility>   // for pair, move
 
 //_____________________________________________________________________________
 Fun4AllDstPileupInputManager::Fun4AllDstPileupInputManager(const std::string &name, const std::string &nodename, const std::string &topnodename)
@@ -168,6 +168,16 @@ int Fun4AllDstPileupInputManager::run(const int nevents)
     m_dstNodeInternal.reset(new PHCompositeNode("DST_INTERNAL"));
   }
 
+  // decode the background pool on first use
+  if (m_pool_size > 0 && m_pool.empty())
+  {
+    const auto result = fillPool();
+    if (result != 0)
+    {
+      return result;
+    }
+  }
+
   // create merger node
   Fun4AllDstPileupMerger merger;
   merger.copyDetectorActiveCrossings(m_DetectorTiming);
@@ -184,6 +194,18 @@ int Fun4AllDstPileupInputManager::run(const int nevents)
     const int ncollisions = gsl_ran_poisson(m_rng.get(), mu);
     for (int icollision = 0; icollision < ncollisions; ++icollision)
     {
+      if (!m_pool.empty())
+      {
+        // merge a random pool event
+        const auto ipool = gsl_rng_uniform_int(m_rng.get(), m_pool.size());
+        if (Verbosity() > 0)
+        {
+          std::cout << "Fun4AllDstPileupInputManager::run - merged pool event " << ipool << " time: " << crossing_time << std::endl;
+        }
+        merger.copy_background_event(*m_pool[ipool], crossing_time);
+        continue;
+      }
+
       // read one event
       const auto result = runOne(1);
       if (result != 0)
@@ -398,6 +420,35 @@ readagain:
   return 0;
 }
 
+//_____________________________________________________________________________
+int Fun4AllDstPileupInputManager::fillPool()
+{
+  m_pool.reserve(m_pool_size);
+  while (static_cast<int>(m_pool.size()) < m_pool_size)
+  {
+    if (runOne(1) != 0)
+    {
+      // not enough events in the input files, run with what was read
+      break;
+    }
+
+    auto event = Fun4AllDstPileupMerger::decode_background_event(m_dstNodeInternal.get());
+    if (event)
+    {
+      m_pool.push_back(std::move(event));
+    }
+  }
+
+  if (m_pool.empty())
+  {
+    std::cout << PHWHERE << Name() << ": could not read any background event for the pool" << std::endl;
+    return -1;
+  }
+
+  std::cout << Name() << ": background pool filled with " << m_pool.size() << " events" << std::endl;
+  return 0;
+}
+
 void Fun4AllDstPileupInputManager::setDetectorActiveCrossings(const std::string &name, const int nbcross)
 {
   setDetectorActiveCrossings(name, -nbcross, nbcross);
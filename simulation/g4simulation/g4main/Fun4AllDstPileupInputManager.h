@@ -8,6 +8,8 @@
  * \author Hugo Pereira Da Costa <hugo.pereira-da-costa@cea.fr>
  */
 
+#include "Fun4AllDstPileupMerger.h"
+
 #include <fun4all/Fun4AllInputManager.h>
 #include <fun4all/Fun4AllReturnCodes.h>  // for SYNC_NOOBJECT, SYNC_OK
 
@@ -20,6 +22,7 @@
 #include <memory>
 #include <string>
 #include <utility>  // for pair
+#include <vector>
 
 class SyncObject;
 
@@ -67,10 +70,23 @@ class Fun4AllDstPileupInputManager : public Fun4AllInputManager
 
   void setDetectorActiveCrossings(const std::string &name, const int min, const int max);
 
+  //! number of background events kept in memory and reused for all triggers
+  /*!
+   * the events are read and decoded once, on the first event, and each collision picks one at random.
+   * 0 (default) reads a new background event from the DST for every collision
+   */
+  void setBackgroundPoolSize(const int nevents)
+  {
+    m_pool_size = nevents;
+  }
+
  private:
   //! loads one event on internal DST node
   int runOne(const int nevents = 0);
 
+  //! reads and decodes the background pool events
+  int fillPool();
+
   //!@name event counters
   //@{
   bool m_ReadRunTTree = true;
@@ -123,6 +139,12 @@ class Fun4AllDstPileupInputManager : public Fun4AllInputManager
   std::unique_ptr<gsl_rng, Deleter> m_rng;
 
   std::map<std::string, std::pair<double, double>> m_DetectorTiming;
+
+  //!@name background event pool
+  //@{
+  int m_pool_size = 0;
+  std::vector<std::unique_ptr<Fun4AllDstPileupMerger::BackgroundEvent>> m_pool;
+  //@}
 };
 
 #endif /* __Fun4AllDstPileupInputManager_H__ */
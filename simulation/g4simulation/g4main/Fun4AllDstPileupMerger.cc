@@ -81,6 +81,20 @@ namespace
     ContainerMap m_containers;
   };
 
+  //! convert rank in a decoded background event into a key of the destination container
+  inline int rank_to_key(int rank, int minkey, int maxkey)
+  {
+    if (rank > 0)
+    {
+      return maxkey + rank;
+    }
+    if (rank < 0)
+    {
+      return minkey + rank;
+    }
+    return 0;
+  }
+
 }  // namespace
 
 //_____________________________________________________________________________
@@ -374,3 +388,245 @@ void Fun4AllDstPileupMerger::copy_background_event(PHCompositeNode *dstNode, dou
     }
   }
 }
+
+//_____________________________________________________________________________
+std::unique_ptr<Fun4AllDstPileupMerger::BackgroundEvent> Fun4AllDstPileupMerger::decode_background_event(PHCompositeNode *dstNode)
+{
+  auto event = std::make_unique<BackgroundEvent>();
+
+  // hepmc
+  const auto map = findNode::getClass<PHHepMCGenEventMap>(dstNode, "PHHepMCGenEventMap");
+  if (map)
+  {
+    if (map->size() != 1)
+    {
+      std::cout << "Fun4AllDstPileupMerger::decode_background_event - cannot merge events that contain more than one PHHepMCGenEventMap" << std::endl;
+      return nullptr;
+    }
+    auto genevent = map->get_map().begin()->second;
+    event->genevent.reset(static_cast<PHHepMCGenEvent *>(genevent->CloneMe()));
+
+    /*
+     * root writing a HepMC::GenEvent copy crashes on deleted items if the source has been deleted,
+     * which happens to the event read from the DST at the next read.
+     * Swapping keeps the event read from file in the pool and leaves the copy to be deleted
+     */
+    event->genevent->getEvent()->swap(*genevent->getEvent());
+  }
+
+  // source id to rank conversion, only needed while decoding
+  using ConversionMap = std::map<int, int>;
+  ConversionMap vtxid_map;
+  ConversionMap trkid_map;
+
+  const auto find_rank = [](const ConversionMap &conversion, int id, const std::string &what)
+  {
+    const auto keyiter = conversion.find(id);
+    if (keyiter != conversion.end())
+    {
+      return keyiter->second;
+    }
+    std::cout << "Fun4AllDstPileupMerger::decode_background_event - " << what << " id " << id << " not found in map" << std::endl;
+    return 0;
+  };
+
+  const auto container_truth = findNode::getClass<PHG4TruthInfoContainer>(dstNode, "G4TruthInfo");
+  if (container_truth)
+  {
+    {
+      // primary vertices
+      int rank = 0;
+      const auto range = container_truth->GetPrimaryVtxRange();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        event->vertices.emplace_back(iter->second);
+        event->vertices.back().set_id(++rank);
+        vtxid_map.insert(std::make_pair(iter->second->get_id(), rank));
+      }
+    }
+
+    {
+      // secondary vertices, from last to first, as in copy_background_event
+      int rank = 0;
+      const auto range = container_truth->GetSecondaryVtxRange();
+      for (
+          auto iter = std::reverse_iterator<PHG4TruthInfoContainer::ConstVtxIterator>(range.second);
+          iter != std::reverse_iterator<PHG4TruthInfoContainer::ConstVtxIterator>(range.first);
+          ++iter)
+      {
+        event->vertices.emplace_back(iter->second);
+        event->vertices.back().set_id(--rank);
+        vtxid_map.insert(std::make_pair(iter->second->get_id(), rank));
+      }
+    }
+
+    {
+      // primary particles
+      int rank = 0;
+      const auto range = container_truth->GetPrimaryParticleRange();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        const auto &source = iter->second;
+        event->particles.emplace_back(source);
+        auto &dest = event->particles.back();
+        dest.set_track_id(++rank);
+        dest.set_parent_id(0);
+        dest.set_primary_id(rank);
+        dest.set_vtx_id(find_rank(vtxid_map, source->get_vtx_id(), "vertex"));
+        trkid_map.insert(std::make_pair(source->get_track_id(), rank));
+      }
+    }
+
+    {
+      // secondary particles, from last to first so that parents are always converted first
+      int rank = 0;
+      const auto range = container_truth->GetSecondaryParticleRange();
+      for (
+          auto iter = std::reverse_iterator<PHG4TruthInfoContainer::ConstIterator>(range.second);
+          iter != std::reverse_iterator<PHG4TruthInfoContainer::ConstIterator>(range.first);
+          ++iter)
+      {
+        const auto &source = iter->second;
+        event->particles.emplace_back(source);
+        auto &dest = event->particles.back();
+        dest.set_track_id(--rank);
+        dest.set_parent_id(find_rank(trkid_map, source->get_parent_id(), "track"));
+        dest.set_primary_id(find_rank(trkid_map, source->get_primary_id(), "track"));
+        dest.set_vtx_id(find_rank(vtxid_map, source->get_vtx_id(), "vertex"));
+        trkid_map.insert(std::make_pair(source->get_track_id(), rank));
+      }
+    }
+  }
+
+  // g4hits
+  FindG4HitContainer nodeFinder;
+  PHNodeIterator(dstNode).forEach(nodeFinder);
+  for (const auto &pair : nodeFinder.containers())
+  {
+    auto &block = event->g4hits[pair.first];
+
+    const auto range = pair.second->getHits();
+    block.hits.reserve(pair.second->size());
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      block.hits.emplace_back(iter->second);
+      auto &hit = block.hits.back();
+      hit.set_trkid(find_rank(trkid_map, iter->second->get_trkid(), "track"));
+
+      // showers from background events are not copied, see copy_background_event
+      hit.set_shower_id(std::numeric_limits<int>::min());
+    }
+
+    const auto layers = pair.second->getLayers();
+    block.layers.assign(layers.first, layers.second);
+  }
+
+  return event;
+}
+
+//_____________________________________________________________________________
+void Fun4AllDstPileupMerger::copy_background_event(const BackgroundEvent &event, double delta_t) const
+{
+  // keep track of new embed id, after insertion as background event
+  int new_embed_id = -1;
+
+  if (event.genevent && m_geneventmap)
+  {
+    /*
+     * the decoded event holds the event read from file (see decode_background_event)
+     * and stays alive in the pool for the whole job, the copies inserted here can be written safely
+     */
+    auto newevent = m_geneventmap->insert_background_event(event.genevent.get());
+    newevent->moveVertex(0, 0, 0, delta_t);
+    new_embed_id = newevent->get_embedding_id();
+  }
+
+  // track ranks are converted using the destination indices before insertion
+  int minvtx = 0;
+  int maxvtx = 0;
+  int mintrk = 0;
+  int maxtrk = 0;
+
+  if (m_g4truthinfo)
+  {
+    minvtx = m_g4truthinfo->minvtxindex();
+    maxvtx = m_g4truthinfo->maxvtxindex();
+    mintrk = m_g4truthinfo->mintrkindex();
+    maxtrk = m_g4truthinfo->maxtrkindex();
+
+    for (const auto &source : event.vertices)
+    {
+      auto newVertex = new PHG4VtxPoint_t(&source);
+      newVertex->set_t(source.get_t() + delta_t);
+      const int key = rank_to_key(source.get_id(), minvtx, maxvtx);
+      m_g4truthinfo->AddVertex(key, newVertex);
+
+      /* embed flag is stored only for primary vertices, consistently with PHG4TruthEventAction */
+      if (source.get_id() > 0)
+      {
+        m_g4truthinfo->AddEmbededVtxId(key, new_embed_id);
+      }
+    }
+
+    for (const auto &source : event.particles)
+    {
+      auto dest = new PHG4Particle_t(&source);
+      const int key = rank_to_key(source.get_track_id(), mintrk, maxtrk);
+      m_g4truthinfo->AddParticle(key, dest);
+      dest->set_track_id(key);
+      dest->set_parent_id(rank_to_key(source.get_parent_id(), mintrk, maxtrk));
+      dest->set_primary_id(rank_to_key(source.get_primary_id(), mintrk, maxtrk));
+      dest->set_vtx_id(rank_to_key(source.get_vtx_id(), minvtx, maxvtx));
+
+      /* embed flag is stored only for primary tracks, consistently with PHG4TruthEventAction */
+      if (source.get_track_id() > 0)
+      {
+        m_g4truthinfo->AddEmbededTrkId(key, new_embed_id);
+      }
+    }
+  }
+
+  // copy g4hits
+  for (const auto &pair : m_g4hitscontainers)
+  {
+    if (!pair.second)
+    {
+      std::cout << "Fun4AllDstPileupMerger::copy_background_event - invalid destination container " << pair.first << std::endl;
+      continue;
+    }
+
+    const auto blockiter = event.g4hits.find(pair.first);
+    if (blockiter == event.g4hits.end())
+    {
+      std::cout << "Fun4AllDstPileupMerger::copy_background_event - invalid source container " << pair.first << std::endl;
+      continue;
+    }
+
+    // apply special cuts for selected detectors
+    const auto detiter = m_DetectorTiming.find(pair.first);
+    if (detiter != m_DetectorTiming.end())
+    {
+      if (delta_t < detiter->second.first || delta_t > detiter->second.second)
+      {
+        continue;
+      }
+    }
+
+    const auto &block = blockiter->second;
+    for (const auto &source : block.hits)
+    {
+      auto newHit = new PHG4Hit_t(&source);
+      newHit->set_t(0, source.get_t(0) + delta_t);
+      newHit->set_t(1, source.get_t(1) + delta_t);
+      newHit->set_trkid(rank_to_key(source.get_trkid(), mintrk, maxtrk));
+
+      // generates a new key, with no conflict with the hits from the 'main' event
+      pair.second->AddHit(newHit->get_detid(), newHit);
+    }
+
+    for (const auto layer : block.layers)
+    {
+      pair.second->AddLayer(layer);
+    }
+  }
+}
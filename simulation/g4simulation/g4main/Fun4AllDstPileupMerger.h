@@ -8,9 +8,17 @@
  * \author Hugo Pereira Da Costa <hugo.pereira-da-costa@cea.fr>
  */
 
+#include "PHG4Hitv1.h"
+#include "PHG4Particlev3.h"
+#include "PHG4VtxPointv1.h"
+
+#include <phhepmc/PHHepMCGenEvent.h>
+
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>  // for pair
+#include <vector>
 
 class PHCompositeNode;
 class PHG4HitContainer;
@@ -25,6 +33,35 @@ class PHHepMCGenEventMap;
 class Fun4AllDstPileupMerger final
 {
  public:
+  /*!
+   * background event decoded once from the DST nodes, so that it can be merged several times
+   * vertex and track ids are replaced by their rank in the merged event: primaries are numbered 1, 2, ...
+   * and secondaries -1, -2, ..., in the order in which they get inserted in the destination containers.
+   * Merging then only adds the destination container current max (min) index, instead of looking up
+   * the ids in a conversion map. Rank 0 is used for ids that could not be resolved
+   */
+  struct BackgroundEvent
+  {
+    //! hepmc event
+    std::unique_ptr<PHHepMCGenEvent> genevent;
+
+    //! vertices, primaries first
+    std::vector<PHG4VtxPointv1> vertices;
+
+    //! particles, primaries first
+    std::vector<PHG4Particlev3> particles;
+
+    //! g4hits and layers of one container
+    struct HitBlock
+    {
+      std::vector<PHG4Hitv1> hits;
+      std::vector<unsigned int> layers;
+    };
+
+    //! g4hits, per container name
+    std::map<std::string, HitBlock> g4hits;
+  };
+
   //! constructor
   Fun4AllDstPileupMerger() = default;
 
@@ -37,6 +74,12 @@ class Fun4AllDstPileupMerger final
   //! time-shift and copy content of source nodes to destination
   void copy_background_event(PHCompositeNode *, double delta_t) const;
 
+  //! decode content of source nodes into a standalone background event. Returns nullptr on failure
+  static std::unique_ptr<BackgroundEvent> decode_background_event(PHCompositeNode *);
+
+  //! time-shift and copy decoded background event to destination
+  void copy_background_event(const BackgroundEvent &, double delta_t) const;
+
   void copyDetectorActiveCrossings(const std::map<std::string, std::pair<double, double>> &dmap) { m_DetectorTiming = dmap; }
 
  private:
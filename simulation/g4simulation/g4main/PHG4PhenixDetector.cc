@@ -1,5 +1,6 @@
 #include "PHG4PhenixDetector.h"
 
+#include "G4TBMagneticFieldSetup.hh"
 #include "PHG4Detector.h"
 #include "PHG4DisplayAction.h"  // for PHG4DisplayAction
 #include "PHG4PhenixDisplayAction.h"
@@ -8,6 +9,7 @@
 
 #include <phool/recoConsts.h>
 
+#include <Geant4/G4AutoDelete.hh>
 #include <Geant4/G4Box.hh>
 #include <Geant4/G4GeometryManager.hh>
 #include <Geant4/G4LogicalVolume.hh>  // for G4LogicalVolume
@@ -19,6 +21,7 @@
 #include <Geant4/G4RegionStore.hh>
 #include <Geant4/G4SolidStore.hh>
 #include <Geant4/G4String.hh>  // for G4String
+#include <Geant4/G4Threading.hh>
 #include <Geant4/G4SystemOfUnits.hh>
 #include <Geant4/G4ThreeVector.hh>  // for G4ThreeVector
 #include <Geant4/G4Tubs.hh>
@@ -131,3 +134,15 @@ G4VPhysicalVolume *PHG4PhenixDetector::Construct()
 
   return physiWorld;
 }
+
+//_______________________________________________________________________________________________
+void PHG4PhenixDetector::ConstructSDandField()
+{
+  // field managers are thread local. The geometry and the field map are shared,
+  // each worker only gets its own G4 field, equation of motion and stepper
+  if (m_WorkerField && G4Threading::IsWorkerThread())
+  {
+    G4TBMagneticFieldSetup *fieldsetup = new G4TBMagneticFieldSetup(m_WorkerField);
+    G4AutoDelete::Register(fieldsetup);
+  }
+}
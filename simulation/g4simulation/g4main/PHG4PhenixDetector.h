@@ -11,6 +11,7 @@
 
 class G4LogicalVolume;
 class G4VPhysicalVolume;
+class PHField;
 class PHG4Detector;
 class PHG4PhenixDisplayAction;
 class PHG4Reco;
@@ -37,6 +38,12 @@ class PHG4PhenixDetector : public G4VUserDetectorConstruction
   //! this is called by geant to actually construct all detectors
   G4VPhysicalVolume* Construct() override;
 
+  //! called by geant on every thread after Construct(), sets up the field for worker threads
+  void ConstructSDandField() override;
+
+  //! field map shared by the worker threads. The master thread field is set up by PHG4Reco::InitField
+  void SetWorkerField(PHField* field) { m_WorkerField = field; }
+
   G4double GetWorldSizeX() const { return WorldSizeX; }
 
   G4double GetWorldSizeY() const { return WorldSizeY; }
@@ -55,6 +62,8 @@ class PHG4PhenixDetector : public G4VUserDetectorConstruction
 
   int m_Verbosity;
 
+  PHField* m_WorkerField = nullptr;
+
   //! list of detectors to be constructed
 
   std::list<PHG4Detector*> m_DetectorList;
@@ -36,6 +36,8 @@ void PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   map<int, PHG4VtxPoint*>::const_iterator vtxiter;
   multimap<int, PHG4Particle*>::const_iterator particle_iter;
   std::pair<std::map<int, PHG4VtxPoint*>::const_iterator, std::map<int, PHG4VtxPoint*>::const_iterator> vtxbegin_end = inEvent->GetVertices();
+  // counts input particles over all vertices, to pick the ones of this sub-event
+  int iparticle = 0;
 
   for (vtxiter = vtxbegin_end.first; vtxiter != vtxbegin_end.second; ++vtxiter)
   {
@@ -47,6 +49,10 @@ void PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
     pair<multimap<int, PHG4Particle*>::const_iterator, multimap<int, PHG4Particle*>::const_iterator> particlebegin_end = inEvent->GetParticles(vtxiter->first);
     for (particle_iter = particlebegin_end.first; particle_iter != particlebegin_end.second; ++particle_iter)
     {
+      if (m_NumSubEvents > 1 && (iparticle++ % m_NumSubEvents) != anEvent->GetEventID())
+      {
+        continue;
+      }
       // cout << "PHG4PrimaryGeneratorAction: dealing with" << endl;
       //  (particle_iter->second)->identify();
 
@@ -160,6 +166,12 @@ void PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
       }
     }
     //      vertex->Print();
+    if (m_NumSubEvents > 1 && vertex->GetNumberOfParticle() == 0)
+    {
+      // none of the particles of this vertex went into this sub-event
+      delete vertex;
+      continue;
+    }
     anEvent->AddPrimaryVertex(vertex);
   }
   return;
@@ -29,6 +29,10 @@ class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     inEvent = inevt;
   }
 
+  //! multithreaded running: split every input event into n Geant4 events (sub-events).
+  //! Geant4 event i gets every n-th input particle, starting with particle i
+  void SetNumSubEvents(const int n) { m_NumSubEvents = n; }
+
   //! Set/Get verbosity
   void Verbosity(const int val) { verbosity = val; }
   int Verbosity() const { return verbosity; }
@@ -39,6 +43,8 @@ class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
  private:
   //! temporary pointer to input event on node tree
   PHG4InEvent* inEvent;
+
+  int m_NumSubEvents = 1;
 };
 
 #endif  // PHG4PrimaryGeneratorAction_H__
@@ -11,10 +11,12 @@
 #include "PHG4PhenixSteppingAction.h"
 #include "PHG4PhenixTrackingAction.h"
 #include "PHG4PrimaryGeneratorAction.h"
+#include "PHG4SubEventMerger.h"
 #include "PHG4Subsystem.h"
 #include "PHG4TrackingAction.h"
 #include "PHG4UIsession.h"
 #include "PHG4Utils.h"
+#include "PHG4WorkerInitialization.h"
 
 #include <g4decayer/EDecayType.hh>
 #include <g4decayer/P6DExtDecayerPhysics.hh>
@@ -80,6 +82,9 @@
 #include <Geant4/G4UImessenger.hh>          // for G4UImessenger
 #include <Geant4/G4VModularPhysicsList.hh>  // for G4VModularPhysicsList
 #include <Geant4/G4Version.hh>
+#if G4VERSION_NUMBER >= 1070
+#include <Geant4/G4RunManagerFactory.hh>
+#endif
 #include <Geant4/G4VisExecutive.hh>
 #include <Geant4/G4VisManager.hh>  // for G4VisManager
 #include <Geant4/Randomize.hh>     // for G4Random
@@ -135,6 +140,10 @@ PHG4Reco::~PHG4Reco()
     m_SubsystemList.pop_back();
   }
   delete m_DisplayAction;
+  for (PHCompositeNode *node : m_SubEventNodes)
+  {
+    delete node;
+  }
 }
 
 //_________________________________________________________________
@@ -163,7 +172,28 @@ int PHG4Reco::Init(PHCompositeNode *topNode)
     uimanager->SetCoutDestination(m_UISession);
   }
 
+#if G4VERSION_NUMBER >= 1070
+  if (m_NumThreads > 1)
+  {
+    // falls back to the sequential run manager if geant was built without multithreading
+    m_RunManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Tasking, m_NumThreads);
+  }
+  else
+  {
+    m_RunManager = new G4RunManager();
+  }
+#else
+  if (m_NumThreads > 1)
+  {
+    std::cout << "PHG4Reco::Init - multithreading needs Geant4 10.7 or newer, running single threaded" << std::endl;
+  }
   m_RunManager = new G4RunManager();
+#endif
+  m_Multithreaded = (m_RunManager->GetRunManagerType() != G4RunManager::sequentialRM);
+  if (m_Multithreaded && Verbosity() > 0)
+  {
+    std::cout << "PHG4Reco::Init - running geant with " << m_NumThreads << " threads" << std::endl;
+  }
 
   DefineMaterials();
   // create physics processes
@@ -315,6 +345,7 @@ int PHG4Reco::InitField(PHCompositeNode *topNode)
   assert(phfield);
 
   m_Field = new G4TBMagneticFieldSetup(phfield);
+  m_PHField = phfield;
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
@@ -417,7 +448,7 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  if (not m_disableUserActions && !m_Multithreaded)
   {
     m_RunManager->SetUserAction(m_EventAction);
   }
@@ -437,7 +468,7 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  if (not m_disableUserActions && !m_Multithreaded)
   {
     m_RunManager->SetUserAction(m_StackingAction);
   }
@@ -458,7 +489,7 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  if (not m_disableUserActions && !m_Multithreaded)
   {
     m_RunManager->SetUserAction(m_SteppingAction);
   }
@@ -480,11 +511,16 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  if (not m_disableUserActions && !m_Multithreaded)
   {
     m_RunManager->SetUserAction(m_TrackingAction);
   }
 
+  if (m_Multithreaded)
+  {
+    InitWorkerThreads(topNode);
+  }
+
   // initialize
   m_RunManager->Initialize();
 
@@ -694,7 +730,21 @@ int PHG4Reco::process_event(PHCompositeNode *topNode)
               << "run one event :" << std::endl;
     ineve->identify();
   }
-  m_RunManager->BeamOn(1);
+  if (m_Multithreaded)
+  {
+    // one geant event per sub-event, the workers pick up the input event from the worker initialization
+    m_WorkerInitialization->SetInEvent(ineve);
+    m_RunManager->BeamOn(m_SubEventNodes.size());
+    m_SubEventMerger->reset();
+    for (PHCompositeNode *node : m_SubEventNodes)
+    {
+      m_SubEventMerger->merge_subevent(node);
+    }
+  }
+  else
+  {
+    m_RunManager->BeamOn(1);
+  }
 
   for (PHG4Subsystem *g4sub : m_SubsystemList)
   {
@@ -758,10 +808,45 @@ int PHG4Reco::setupInputEventNodeReader(PHCompositeNode *topNode)
   {
     m_GeneratorAction = new PHG4PrimaryGeneratorAction();
   }
-  m_RunManager->SetUserAction(m_GeneratorAction);
+  // worker threads get their own generator, see PHG4WorkerInitialization
+  if (!m_Multithreaded)
+  {
+    m_RunManager->SetUserAction(m_GeneratorAction);
+  }
   return 0;
 }
 
+int PHG4Reco::InitWorkerThreads(PHCompositeNode *topNode)
+{
+  // the worker threads need their own copy of every user action, subsystems which
+  // cannot provide them would silently not record anything
+  for (PHG4Subsystem *g4sub : m_SubsystemList)
+  {
+    if ((g4sub->GetEventAction() || g4sub->GetStackingAction() || g4sub->GetSteppingAction() || g4sub->GetTrackingAction()) &&
+        !g4sub->SupportsWorkerThreads())
+    {
+      std::cout << PHWHERE << " subsystem " << g4sub->Name() << " does not support multithreaded running" << std::endl;
+      std::cout << "run single threaded (PHG4Reco::set_threads(1))" << std::endl;
+      gSystem->Exit(1);
+      exit(1);
+    }
+  }
+
+  PHNodeIterator iter(topNode);
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  m_SubEventMerger = std::make_unique<PHG4SubEventMerger>();
+  m_SubEventMerger->load_nodes(dstNode);
+  for (int i = 0; i < m_NumThreads; i++)
+  {
+    m_SubEventNodes.push_back(m_SubEventMerger->create_subevent_node("G4SUBEVENT_" + std::to_string(i)));
+  }
+
+  m_Detector->SetWorkerField(m_PHField);
+  m_WorkerInitialization = new PHG4WorkerInitialization(m_SubsystemList, m_SubEventNodes, m_disableUserActions);
+  m_RunManager->SetUserInitialization(m_WorkerInitialization);
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
 void PHG4Reco::set_rapidity_coverage(const double eta)
 {
   m_EtaCoverage = eta;
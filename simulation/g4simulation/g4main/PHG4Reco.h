@@ -10,7 +10,9 @@
 #include <phfield/PHFieldConfig.h>
 
 #include <list>
+#include <memory>
 #include <string>  // for string
+#include <vector>
 
 // Forward declerations
 class G4RunManager;
@@ -19,6 +21,7 @@ class G4UImanager;
 class G4UImessenger;
 class G4VisManager;
 class PHCompositeNode;
+class PHField;
 class PHG4DisplayAction;
 class PHG4PhenixDetector;
 class PHG4PhenixEventAction;
@@ -26,8 +29,10 @@ class PHG4PhenixStackingAction;
 class PHG4PhenixSteppingAction;
 class PHG4PhenixTrackingAction;
 class PHG4PrimaryGeneratorAction;
+class PHG4SubEventMerger;
 class PHG4Subsystem;
 class PHG4UIsession;
+class PHG4WorkerInitialization;
 
 /*!
   \class   PHG4Reco
@@ -123,6 +128,15 @@ class PHG4Reco : public SubsysReco
   void SetWorldShape(const std::string &s) { m_WorldShape = s; }
   void SetWorldMaterial(const std::string &s) { m_WorldMaterial = s; }
   void SetPhysicsList(const std::string &s) { m_PhysicsList = s; }
+
+  //! run Geant4 with n worker threads (needs Geant4 built with multithreading)
+  /*!
+    every Fun4All event is split into n Geant4 events, each getting every n-th input particle.
+    They are simulated in parallel, sharing geometry, physics tables and field map, and merged
+    back in order. Results are reproducible for a given seed and number of threads.
+    All subsystems with user actions need to support this (PHG4Subsystem::SupportsWorkerThreads)
+  */
+  void set_threads(const int n) { m_NumThreads = n; }
   void set_rapidity_coverage(const double eta);
 
   int setupInputEventNodeReader(PHCompositeNode *);
@@ -149,6 +163,7 @@ class PHG4Reco : public SubsysReco
  private:
   static void g4guithread(void *ptr);
   int InitUImanager();
+  int InitWorkerThreads(PHCompositeNode *topNode);
   void DefineMaterials();
   void DefineRegions();
 
@@ -162,6 +177,20 @@ class PHG4Reco : public SubsysReco
   //! pointer to geant run manager
   G4RunManager *m_RunManager = nullptr;
 
+  //! number of geant worker threads, sequential run manager if 1
+  int m_NumThreads = 1;
+  bool m_Multithreaded = false;
+
+  //! field map, shared with the worker threads
+  PHField *m_PHField = nullptr;
+
+  //! builds the user actions of the worker threads (owned by the run manager)
+  PHG4WorkerInitialization *m_WorkerInitialization = nullptr;
+
+  //! one node per worker event, merged into the DST node after every event
+  std::vector<PHCompositeNode *> m_SubEventNodes;
+  std::unique_ptr<PHG4SubEventMerger> m_SubEventMerger;
+
   //! pointer to geant ui session
   PHG4UIsession *m_UISession = nullptr;
 
@@ -0,0 +1,270 @@
+#include "PHG4SubEventMerger.h"
+
+#include "PHG4Hit.h"  // for PHG4Hit
+#include "PHG4HitContainer.h"
+#include "PHG4Hitv1.h"
+#include "PHG4Particle.h"  // for PHG4Particle
+#include "PHG4Particlev3.h"
+#include "PHG4TruthInfoContainer.h"
+#include "PHG4VtxPoint.h"  // for PHG4VtxPoint
+#include "PHG4VtxPointv1.h"
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>    // for PHIODataNode
+#include <phool/PHNode.h>          // for PHNode
+#include <phool/PHNodeIterator.h>  // for PHNodeIterator
+#include <phool/PHNodeOperation.h>
+#include <phool/PHObject.h>  // for PHObject
+#include <phool/getClass.h>
+
+#include <TObject.h>
+
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+// convenient aliases for deep copying nodes
+namespace
+{
+  using PHG4Particle_t = PHG4Particlev3;
+  using PHG4VtxPoint_t = PHG4VtxPointv1;
+  using PHG4Hit_t = PHG4Hitv1;
+
+  //! utility class to find all PHG4Hit container nodes from the DST node
+  class FindG4HitContainer : public PHNodeOperation
+  {
+   public:
+    //! container map alias
+    using ContainerMap = std::map<std::string, PHG4HitContainer *>;
+
+    //! get container map
+    const ContainerMap &containers() const
+    {
+      return m_containers;
+    }
+
+   protected:
+    //! iterator action
+    void perform(PHNode *node) override
+    {
+      // check type name. Only load PHIODataNode
+      if (node->getType() != "PHIODataNode")
+      {
+        return;
+      }
+
+      // cast to IODataNode and check data
+      auto ionode = static_cast<PHIODataNode<TObject> *>(node);
+      auto data = dynamic_cast<PHG4HitContainer *>(ionode->getData());
+      if (data)
+      {
+        m_containers.insert(std::make_pair(node->getName(), data));
+      }
+    }
+
+   private:
+    //! container map
+    ContainerMap m_containers;
+  };
+
+}  // namespace
+
+//_____________________________________________________________________________
+void PHG4SubEventMerger::load_nodes(PHCompositeNode *dstNode)
+{
+  // find all G4Hit containers under dstNode
+  FindG4HitContainer nodeFinder;
+  PHNodeIterator(dstNode).forEach(nodeFinder);
+  m_g4hitscontainers = nodeFinder.containers();
+
+  // g4 truth info
+  m_g4truthinfo = findNode::getClass<PHG4TruthInfoContainer>(dstNode, "G4TruthInfo");
+}
+
+//_____________________________________________________________________________
+PHCompositeNode *PHG4SubEventMerger::create_subevent_node(const std::string &name) const
+{
+  // the user actions look for their nodes by name below the node they are given,
+  // so a flat DST node with containers of the same names is all they need
+  PHCompositeNode *topNode = new PHCompositeNode(name);
+  PHCompositeNode *dstNode = new PHCompositeNode("DST");
+  topNode->addNode(dstNode);
+  for (const auto &pair : m_g4hitscontainers)
+  {
+    // same name means same container id, which the truth event action uses to find the hits
+    PHG4HitContainer *hits = new PHG4HitContainer(pair.first);
+    const auto range = pair.second->getLayers();
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      hits->AddLayer(*iter);
+    }
+    dstNode->addNode(new PHIODataNode<PHObject>(hits, pair.first, "PHObject"));
+  }
+  if (m_g4truthinfo)
+  {
+    dstNode->addNode(new PHIODataNode<PHObject>(new PHG4TruthInfoContainer(), "G4TruthInfo", "PHObject"));
+  }
+  return topNode;
+}
+
+//_____________________________________________________________________________
+void PHG4SubEventMerger::merge_subevent(PHCompositeNode *subeventNode)
+{
+  // keep track of the correspondance between source index and destination index for vertices and tracks
+  using ConversionMap = std::map<int, int>;
+  ConversionMap vtxid_map;
+  ConversionMap trkid_map;
+
+  const auto container_truth = findNode::getClass<PHG4TruthInfoContainer>(subeventNode, "G4TruthInfo");
+  if (container_truth && m_g4truthinfo)
+  {
+    {
+      // primary vertices, shared with the other sub-events of this event
+      auto key = m_g4truthinfo->maxvtxindex();
+      const auto range = container_truth->GetPrimaryVtxRange();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        const auto &sourceVertex = iter->second;
+        const std::tuple<float, float, float, float> position(sourceVertex->get_x(), sourceVertex->get_y(), sourceVertex->get_z(), sourceVertex->get_t());
+        auto [vtxiter, inserted] = m_PrimaryVertexIds.insert(std::make_pair(position, key + 1));
+        if (inserted)
+        {
+          auto newVertex = new PHG4VtxPoint_t(sourceVertex);
+          newVertex->set_id(++key);
+          m_g4truthinfo->AddVertex(key, newVertex);
+        }
+        vtxid_map.insert(std::make_pair(sourceVertex->get_id(), vtxiter->second));
+      }
+    }
+
+    {
+      // secondary vertices
+      auto key = m_g4truthinfo->minvtxindex();
+      const auto range = container_truth->GetSecondaryVtxRange();
+
+      // loop from last to first to preserve order with respect to the original event
+      for (
+          auto iter = std::reverse_iterator<PHG4TruthInfoContainer::ConstVtxIterator>(range.second);
+          iter != std::reverse_iterator<PHG4TruthInfoContainer::ConstVtxIterator>(range.first);
+          ++iter)
+      {
+        const auto &sourceVertex = iter->second;
+        auto newVertex = new PHG4VtxPoint_t(sourceVertex);
+        newVertex->set_id(--key);
+        m_g4truthinfo->AddVertex(key, newVertex);
+        vtxid_map.insert(std::make_pair(sourceVertex->get_id(), key));
+      }
+    }
+
+    {
+      // primary particles
+      auto key = m_g4truthinfo->maxtrkindex();
+      const auto range = container_truth->GetPrimaryParticleRange();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        const auto &source = iter->second;
+        auto dest = new PHG4Particle_t(source);
+        m_g4truthinfo->AddParticle(++key, dest);
+        dest->set_track_id(key);
+        dest->set_primary_id(key);
+        dest->set_vtx_id(vtxid_map[source->get_vtx_id()]);
+        trkid_map.insert(std::make_pair(source->get_track_id(), key));
+      }
+    }
+
+    {
+      // secondary particles
+      auto key = m_g4truthinfo->mintrkindex();
+      const auto range = container_truth->GetSecondaryParticleRange();
+
+      // loop from last to first, so that for a given particle its parent has already been converted
+      for (
+          auto iter = std::reverse_iterator<PHG4TruthInfoContainer::ConstIterator>(range.second);
+          iter != std::reverse_iterator<PHG4TruthInfoContainer::ConstIterator>(range.first);
+          ++iter)
+      {
+        const auto &source = iter->second;
+        auto dest = new PHG4Particle_t(source);
+        m_g4truthinfo->AddParticle(--key, dest);
+        dest->set_track_id(key);
+
+        auto keyiter = trkid_map.find(source->get_parent_id());
+        if (keyiter != trkid_map.end())
+        {
+          dest->set_parent_id(keyiter->second);
+        }
+        else
+        {
+          std::cout << "PHG4SubEventMerger::merge_subevent - track id " << source->get_parent_id() << " not found in map" << std::endl;
+        }
+
+        keyiter = trkid_map.find(source->get_primary_id());
+        if (keyiter != trkid_map.end())
+        {
+          dest->set_primary_id(keyiter->second);
+        }
+        else
+        {
+          std::cout << "PHG4SubEventMerger::merge_subevent - track id " << source->get_primary_id() << " not found in map" << std::endl;
+        }
+
+        dest->set_vtx_id(vtxid_map[source->get_vtx_id()]);
+        trkid_map.insert(std::make_pair(source->get_track_id(), key));
+      }
+    }
+
+    // embed flags, as set by PHG4TruthEventAction for the primaries
+    const auto trkrange = container_truth->GetEmbeddedTrkIds();
+    for (auto iter = trkrange.first; iter != trkrange.second; ++iter)
+    {
+      const auto keyiter = trkid_map.find(iter->first);
+      if (keyiter != trkid_map.end())
+      {
+        m_g4truthinfo->AddEmbededTrkId(keyiter->second, iter->second);
+      }
+    }
+    const auto vtxrange = container_truth->GetEmbeddedVtxIds();
+    for (auto iter = vtxrange.first; iter != vtxrange.second; ++iter)
+    {
+      const auto keyiter = vtxid_map.find(iter->first);
+      if (keyiter != vtxid_map.end())
+      {
+        m_g4truthinfo->AddEmbededVtxId(keyiter->second, iter->second);
+      }
+    }
+    container_truth->Reset();
+  }
+
+  // copy g4hits
+  for (const auto &pair : m_g4hitscontainers)
+  {
+    auto container_hit = findNode::getClass<PHG4HitContainer>(subeventNode, pair.first);
+    if (!container_hit)
+    {
+      std::cout << "PHG4SubEventMerger::merge_subevent - invalid source container " << pair.first << std::endl;
+      continue;
+    }
+    const auto range = container_hit->getHits();
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      const auto &sourceHit = iter->second;
+      auto newHit = new PHG4Hit_t(sourceHit);
+
+      // update track id. Tracks leaving hits are flagged to be kept in the truth container,
+      // so this only misses for hits of tracks which have been removed on purpose
+      const auto keyiter = trkid_map.find(sourceHit->get_trkid());
+      if (keyiter != trkid_map.end())
+      {
+        newHit->set_trkid(keyiter->second);
+      }
+
+      // showers are not merged
+      newHit->set_shower_id(std::numeric_limits<int>::min());
+
+      // this will generate a new key for the hit, following the ones from the previous sub-events
+      pair.second->AddHit(newHit->get_detid(), newHit);
+    }
+    container_hit->Reset();
+  }
+}
@@ -0,0 +1,55 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4MAIN_PHG4SUBEVENTMERGER_H
+#define G4MAIN_PHG4SUBEVENTMERGER_H
+
+#include <map>
+#include <string>
+#include <tuple>
+
+class PHCompositeNode;
+class PHG4HitContainer;
+class PHG4TruthInfoContainer;
+
+/*!
+ * utility class used by PHG4Reco when running Geant4 multithreaded.
+ * Every Fun4All event is split into sub-events (one Geant4 event each), which are
+ * simulated on the worker threads into their own copies of the G4HIT and G4TruthInfo nodes.
+ * This class creates those copies and merges them back into the DST nodes, in sub-event order,
+ * with the track and vertex ids renumbered as if they came from a single Geant4 event.
+ * Like for pileup merging (Fun4AllDstPileupMerger), showers are not carried over
+ */
+class PHG4SubEventMerger final
+{
+ public:
+  //! constructor
+  PHG4SubEventMerger() = default;
+
+  //! destructor
+  ~PHG4SubEventMerger() = default;
+
+  //! load destination nodes from the DST node
+  void load_nodes(PHCompositeNode *);
+
+  //! create a new top node with empty copies of the destination nodes, to be filled by one sub-event
+  PHCompositeNode *create_subevent_node(const std::string &name) const;
+
+  //! start a new event. Primary vertices are only shared between sub-events of the same event
+  void reset() { m_PrimaryVertexIds.clear(); }
+
+  //! move content of a sub-event node to the destination and reset the sub-event
+  void merge_subevent(PHCompositeNode *);
+
+ private:
+  //! maps g4hit containers to node names
+  std::map<std::string, PHG4HitContainer *> m_g4hitscontainers;
+
+  //! truth information
+  PHG4TruthInfoContainer *m_g4truthinfo = nullptr;
+
+  //! primary vertices merged so far in this event, by position and time
+  /*! all sub-events see the same primary vertices, they must end up with a single id */
+  std::map<std::tuple<float, float, float, float>, int> m_PrimaryVertexIds;
+};
+
+#endif
@@ -19,6 +19,15 @@ class PHG4StackingAction;
 class PHG4SteppingAction;
 class PHG4TrackingAction;
 
+//! user actions of one subsystem for one Geant4 worker thread, see PHG4Subsystem::CreateWorkerActions()
+struct PHG4WorkerActions
+{
+  PHG4EventAction *EventAction = nullptr;
+  PHG4StackingAction *StackingAction = nullptr;
+  PHG4SteppingAction *SteppingAction = nullptr;
+  PHG4TrackingAction *TrackingAction = nullptr;
+};
+
 class PHG4Subsystem : public SubsysReco
 {
  public:
@@ -69,6 +78,14 @@ class PHG4Subsystem : public SubsysReco
 
   virtual PHG4StackingAction *GetStackingAction() const { return nullptr; }
 
+  //! multithreaded running (PHG4Reco::set_threads): every Geant4 worker thread needs its own
+  //! copy of the user actions. Subsystems which can make them return true and implement CreateWorkerActions()
+  virtual bool SupportsWorkerThreads() const { return false; }
+
+  //! create a new set of user actions for one worker thread. Called on the worker thread, after InitRun.
+  //! The actions are owned by the worker and get their node pointers through SetInterfacePointers()
+  virtual void CreateWorkerActions(PHG4WorkerActions & /*actions*/) {}
+
   void OverlapCheck(const bool chk = true) { overlapcheck = chk; }
 
   bool CheckOverlap() const { return overlapcheck; }
@@ -147,6 +147,14 @@ int PHG4TruthSubsystem::ResetEvent(PHCompositeNode* topNode)
   return 0;
 }
 
+//_______________________________________________________________________
+void PHG4TruthSubsystem::CreateWorkerActions(PHG4WorkerActions& actions)
+{
+  PHG4TruthEventAction* eventaction = new PHG4TruthEventAction();
+  actions.EventAction = eventaction;
+  actions.TrackingAction = new PHG4TruthTrackingAction(eventaction);
+}
+
 //_______________________________________________________________________
 PHG4EventAction* PHG4TruthSubsystem::GetEventAction() const
 {
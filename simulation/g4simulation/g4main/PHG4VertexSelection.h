@@ -27,6 +27,9 @@ class PHG4VertexSelection : public SubsysReco, public PHParameterInterface
   //! event processing
   int process_event(PHCompositeNode *topNode) override;
 
+  //! only uses the nodes under topNode, can run in several event slots at once
+  bool ThreadSafe() const override { return true; }
+
   //! parameters
   void SetDefaultParameters() override;
 
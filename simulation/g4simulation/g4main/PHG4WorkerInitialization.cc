@@ -0,0 +1,156 @@
+#include "PHG4WorkerInitialization.h"
+
+#include "PHG4EventAction.h"
+#include "PHG4PhenixEventAction.h"
+#include "PHG4PhenixStackingAction.h"
+#include "PHG4PhenixSteppingAction.h"
+#include "PHG4PhenixTrackingAction.h"
+#include "PHG4PrimaryGeneratorAction.h"
+#include "PHG4StackingAction.h"
+#include "PHG4SteppingAction.h"
+#include "PHG4Subsystem.h"
+#include "PHG4TrackingAction.h"
+
+#include <Geant4/G4AutoLock.hh>
+#include <Geant4/G4Event.hh>
+#include <Geant4/G4EventManager.hh>
+
+namespace
+{
+  // subsystem action constructors and the event action timer use shared singletons,
+  // so the workers are built one at a time
+  G4Mutex buildMutex = G4MUTEX_INITIALIZER;
+
+  //! primary generator which picks up the input event from the shared initialization
+  class WorkerGeneratorAction : public PHG4PrimaryGeneratorAction
+  {
+   public:
+    explicit WorkerGeneratorAction(const PHG4WorkerInitialization *init)
+      : m_Init(init)
+    {
+    }
+
+    void GeneratePrimaries(G4Event *anEvent) override
+    {
+      SetInEvent(m_Init->GetInEvent());
+      PHG4PrimaryGeneratorAction::GeneratePrimaries(anEvent);
+    }
+
+   private:
+    const PHG4WorkerInitialization *m_Init;
+  };
+
+  //! points the actions of the worker to the node of the sub-event it is about to simulate
+  class WorkerEventAction : public PHG4PhenixEventAction
+  {
+   public:
+    WorkerEventAction(const std::vector<PHCompositeNode *> &subeventnodes, const std::vector<PHG4WorkerActions> &actions)
+      : m_SubEventNodes(subeventnodes)
+      , m_Actions(actions)
+    {
+    }
+
+    void BeginOfEventAction(const G4Event *event) override
+    {
+      m_Node = m_SubEventNodes.at(event->GetEventID());
+      G4TrackingManager *trackingManager = G4EventManager::GetEventManager()->GetTrackingManager();
+      for (const PHG4WorkerActions &actions : m_Actions)
+      {
+        if (actions.EventAction)
+        {
+          actions.EventAction->SetInterfacePointers(m_Node);
+        }
+        if (actions.StackingAction)
+        {
+          actions.StackingAction->SetInterfacePointers(m_Node);
+        }
+        if (actions.SteppingAction)
+        {
+          actions.SteppingAction->SetInterfacePointers(m_Node);
+        }
+        if (actions.TrackingAction)
+        {
+          actions.TrackingAction->SetInterfacePointers(m_Node);
+          actions.TrackingAction->SetTrackingManagerPointer(trackingManager);
+        }
+      }
+      PHG4PhenixEventAction::BeginOfEventAction(event);
+    }
+
+    void EndOfEventAction(const G4Event *event) override
+    {
+      PHG4PhenixEventAction::EndOfEventAction(event);
+      // what PHG4Reco::ResetEvent does for the master actions, the next sub-event
+      // on this worker is independent of this one
+      for (const PHG4WorkerActions &actions : m_Actions)
+      {
+        if (actions.TrackingAction)
+        {
+          actions.TrackingAction->ResetEvent(m_Node);
+        }
+        if (actions.EventAction)
+        {
+          actions.EventAction->ResetEvent(m_Node);
+        }
+      }
+    }
+
+   private:
+    std::vector<PHCompositeNode *> m_SubEventNodes;
+    std::vector<PHG4WorkerActions> m_Actions;
+    PHCompositeNode *m_Node = nullptr;
+  };
+}  // namespace
+
+PHG4WorkerInitialization::PHG4WorkerInitialization(const std::list<PHG4Subsystem *> &subsystems, const std::vector<PHCompositeNode *> &subeventnodes, const bool disable_user_actions)
+  : m_SubsystemList(subsystems)
+  , m_SubEventNodes(subeventnodes)
+  , m_DisableUserActions(disable_user_actions)
+{
+}
+
+void PHG4WorkerInitialization::Build() const
+{
+  G4AutoLock lock(&buildMutex);
+
+  WorkerGeneratorAction *generator = new WorkerGeneratorAction(this);
+  generator->SetNumSubEvents(m_SubEventNodes.size());
+  SetUserAction(generator);
+
+  if (m_DisableUserActions)
+  {
+    return;
+  }
+
+  // the actions are owned by the geant run manager of this thread,
+  // the PHG4Phenix*Actions delete the subsystem actions registered with them
+  std::vector<PHG4WorkerActions> actions;
+  for (PHG4Subsystem *g4sub : m_SubsystemList)
+  {
+    PHG4WorkerActions subsysactions;
+    g4sub->CreateWorkerActions(subsysactions);
+    actions.push_back(subsysactions);
+  }
+
+  WorkerEventAction *eventaction = new WorkerEventAction(m_SubEventNodes, actions);
+  PHG4PhenixStackingAction *stackingaction = new PHG4PhenixStackingAction();
+  PHG4PhenixSteppingAction *steppingaction = new PHG4PhenixSteppingAction();
+  PHG4PhenixTrackingAction *trackingaction = new PHG4PhenixTrackingAction();
+  for (const PHG4WorkerActions &subsysactions : actions)
+  {
+    if (subsysactions.EventAction)
+    {
+      eventaction->AddAction(subsysactions.EventAction);
+    }
+    stackingaction->AddAction(subsysactions.StackingAction);
+    steppingaction->AddAction(subsysactions.SteppingAction);
+    if (subsysactions.TrackingAction)
+    {
+      trackingaction->AddAction(subsysactions.TrackingAction);
+    }
+  }
+  SetUserAction(eventaction);
+  SetUserAction(stackingaction);
+  SetUserAction(steppingaction);
+  SetUserAction(trackingaction);
+}
@@ -0,0 +1,42 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4MAIN_PHG4WORKERINITIALIZATION_H
+#define G4MAIN_PHG4WORKERINITIALIZATION_H
+
+#include <Geant4/G4VUserActionInitialization.hh>
+
+#include <list>
+#include <vector>
+
+class PHCompositeNode;
+class PHG4InEvent;
+class PHG4Subsystem;
+
+//! builds the user actions of the Geant4 worker threads when PHG4Reco runs multithreaded
+/*!
+  every worker gets its own primary generator and its own copy of the subsystem user actions
+  (PHG4Subsystem::CreateWorkerActions). Each Fun4All event is simulated as one Geant4 event per
+  sub-event node; before a worker runs Geant4 event i its actions are pointed to sub-event node i
+*/
+class PHG4WorkerInitialization : public G4VUserActionInitialization
+{
+ public:
+  PHG4WorkerInitialization(const std::list<PHG4Subsystem *> &subsystems, const std::vector<PHCompositeNode *> &subeventnodes, const bool disable_user_actions);
+
+  ~PHG4WorkerInitialization() override {}
+
+  //! called by geant once on every worker thread
+  void Build() const override;
+
+  //! input event of the Fun4All event being simulated, set by PHG4Reco before BeamOn
+  void SetInEvent(PHG4InEvent *inevt) { m_InEvent = inevt; }
+  PHG4InEvent *GetInEvent() const { return m_InEvent; }
+
+ private:
+  std::list<PHG4Subsystem *> m_SubsystemList;
+  std::vector<PHCompositeNode *> m_SubEventNodes;
+  PHG4InEvent *m_InEvent = nullptr;
+  bool m_DisableUserActions = false;
+};
+
+#endif
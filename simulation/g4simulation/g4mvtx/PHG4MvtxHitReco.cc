@@ -53,12 +53,14 @@
 
 #include <boost/format.hpp>
 
+#include <algorithm>
 #include <cassert>  // for assert
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <memory>  // for allocator_tra...
 #include <set>     // for vector
+#include <tuple>   // for tie
 #include <vector>  // for vector
 
 // New headers I added
@@ -207,6 +209,10 @@ int PHG4MvtxHitReco::InitRun(PHCompositeNode* topNode)
   makePixelMask(m_deadPixelMap, "MVTX_DeadPixelMap", "TotalDeadPixels");
   makePixelMask(m_hotPixelMap, "MVTX_HotPixelMap", "TotalHotPixels");
 
+  // sorted, for binary search in process_event
+  std::sort(m_deadPixelMap.begin(), m_deadPixelMap.end());
+  std::sort(m_hotPixelMap.begin(), m_hotPixelMap.end());
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -237,6 +243,21 @@ int PHG4MvtxHitReco::process_event(PHCompositeNode* topNode)
   auto hitTruthAssoc = findNode::getClass<TrkrHitTruthAssoc>(topNode, "TRKR_HITTRUTHASSOC");
   assert(hitTruthAssoc);
 
+  // fired pixels are buffered and inserted in the hitset container at the end of the event
+  // pixels already in the container (e.g. embedding) are marked as fired
+  m_pixel_hits.clear();
+  m_hit_assocs.clear();
+  m_fired_pixels.clear();
+  const auto existing_hitsets = trkrHitSetContainer->getHitSets(TrkrDefs::TrkrId::mvtxId);
+  for (auto hitsetiter = existing_hitsets.first; hitsetiter != existing_hitsets.second; ++hitsetiter)
+  {
+    const auto hit_range = hitsetiter->second->getHits();
+    for (auto hititer = hit_range.first; hititer != hit_range.second; ++hititer)
+    {
+      m_fired_pixels.insert(pixel_id(hitsetiter->first, hititer->first));
+    }
+  }
+
   // Generate strobe zero relative to trigger time
   double strobe_zero_tm_start = generate_strobe_zero_tm_start();
 
@@ -670,18 +691,14 @@ int PHG4MvtxHitReco::process_event(PHCompositeNode* topNode)
             strobe = 15;
           }
 
-          // We need to create the TrkrHitSet if not already made - each TrkrHitSet should correspond to a chip for the Mvtx
+          // each TrkrHitSet corresponds to a chip for the Mvtx
           TrkrDefs::hitsetkey hitsetkey = MvtxDefs::genHitSetKey(layer, stave_number, chip_number, strobe);
-          // Use existing hitset or add new one if needed
-          TrkrHitSetContainer::Iterator hitsetit = trkrHitSetContainer->findOrAddHitSet(hitsetkey);
 
           // generate the key for this hit
           TrkrDefs::hitkey hitkey = MvtxDefs::genHitKey(vzbin[i1], vxbin[i1]);
-          // See if this hit already exists
-          TrkrHit* hit = nullptr;
-          hit = hitsetit->second->getHit(hitkey);
 
-          if (hit)
+          // See if this hit already exists
+          if (m_fired_pixels.count(pixel_id(hitsetkey, hitkey)))
           {
             if (Verbosity() > 0)
             {
@@ -697,13 +714,11 @@ int PHG4MvtxHitReco::process_event(PHCompositeNode* topNode)
           double hitenergy = venergy[i1].first * TrkrDefs::MvtxEnergyScaleup;
           addtruthhitset(hitsetkey, hitkey, hitenergy);
 
-          if ((std::find(m_deadPixelMap.begin(), m_deadPixelMap.end(), std::make_pair(hitsetkeymask, hitkey)) == m_deadPixelMap.end()) && (std::find(m_hotPixelMap.begin(), m_hotPixelMap.end(), std::make_pair(hitsetkeymask, hitkey)) == m_hotPixelMap.end()))
+          if (!std::binary_search(m_deadPixelMap.begin(), m_deadPixelMap.end(), std::make_pair(hitsetkeymask, hitkey)) && !std::binary_search(m_hotPixelMap.begin(), m_hotPixelMap.end(), std::make_pair(hitsetkeymask, hitkey)))
           {
-            // create hit and insert in hitset
-            hit = new TrkrHitv2();
-
-            hit->addEnergy(hitenergy);
-            hitsetit->second->addHitSpecificKey(hitkey, hit);
+            // buffer the hit, the TrkrHit is created at the end of the event
+            m_fired_pixels.insert(pixel_id(hitsetkey, hitkey));
+            m_pixel_hits.push_back({hitsetkey, hitkey, hitenergy});
           }
           else
           {
@@ -714,7 +729,7 @@ int PHG4MvtxHitReco::process_event(PHCompositeNode* topNode)
 
           if (Verbosity() > 0)
           {
-            std::cout << "Layer: " << layer << ", Stave: " << (uint16_t) MvtxDefs::getStaveId(hitsetkey) << ", Chip: " << (uint16_t) MvtxDefs::getChipId(hitsetkey) << ", Row: " << (uint16_t) MvtxDefs::getRow(hitkey) << ", Col: " << (uint16_t) MvtxDefs::getCol(hitkey) << ", Strobe: " << (int) MvtxDefs::getStrobeId(hitsetkey) << ", added hit " << hitkey << " to hitset " << hitsetkey << " with energy " << hit->getEnergy() / TrkrDefs::MvtxEnergyScaleup << std::endl;
+            std::cout << "Layer: " << layer << ", Stave: " << (uint16_t) MvtxDefs::getStaveId(hitsetkey) << ", Chip: " << (uint16_t) MvtxDefs::getChipId(hitsetkey) << ", Row: " << (uint16_t) MvtxDefs::getRow(hitkey) << ", Col: " << (uint16_t) MvtxDefs::getCol(hitkey) << ", Strobe: " << (int) MvtxDefs::getStrobeId(hitsetkey) << ", added hit " << hitkey << " to hitset " << hitsetkey << " with energy " << hitenergy / TrkrDefs::MvtxEnergyScaleup << std::endl;
           }
 
           // now we update the TrkrHitTruthAssoc map - the map contains <hitsetkey, std::pair <hitkey, g4hitkey> >
@@ -724,13 +739,15 @@ int PHG4MvtxHitReco::process_event(PHCompositeNode* topNode)
           // we set the strobe ID to zero in the hitsetkey
           // we use the findOrAdd method to keep from adding identical entries
           TrkrDefs::hitsetkey bare_hitsetkey = zero_strobe_bits(hitsetkey);
-          hitTruthAssoc->findOrAddAssoc(bare_hitsetkey, hitkey, g4hit_it->first);
+          m_hit_assocs.push_back({bare_hitsetkey, hitkey, g4hit_it->first});
         }
       }  // end loop over hit cells
     }    // end loop over g4hits for this layer
 
   }  // end loop over layers
 
+  fill_hitsets(trkrHitSetContainer, hitTruthAssoc);
+
   // print the list of entries in the association table
   if (Verbosity() > 0)
   {
@@ -831,6 +848,36 @@ void PHG4MvtxHitReco::SetDefaultParameters()
   return;
 }
 
+void PHG4MvtxHitReco::fill_hitsets(TrkrHitSetContainer* trkrHitSetContainer, TrkrHitTruthAssoc* hitTruthAssoc)
+{
+  // hits are unique, sort them by hitset and hit key and create each hitset once
+  std::sort(m_pixel_hits.begin(), m_pixel_hits.end(), [](const PixelHit& lhs, const PixelHit& rhs)
+            { return std::tie(lhs.hitsetkey, lhs.hitkey) < std::tie(rhs.hitsetkey, rhs.hitkey); });
+
+  TrkrHitSet* hitset = nullptr;
+  for (const auto& pixel_hit : m_pixel_hits)
+  {
+    if (!hitset || hitset->getHitSetKey() != pixel_hit.hitsetkey)
+    {
+      hitset = trkrHitSetContainer->findOrAddHitSet(pixel_hit.hitsetkey)->second;
+    }
+
+    auto hit = new TrkrHitv2();
+    hit->addEnergy(pixel_hit.energy);
+    hitset->addHitSpecificKey(pixel_hit.hitkey, hit);
+  }
+
+  // the same g4hit fires the same pixel in every strobe replica, keep one association
+  std::sort(m_hit_assocs.begin(), m_hit_assocs.end(), [](const HitAssoc& lhs, const HitAssoc& rhs)
+            { return std::tie(lhs.hitsetkey, lhs.hitkey, lhs.g4hitkey) < std::tie(rhs.hitsetkey, rhs.hitkey, rhs.g4hitkey); });
+  const auto end = std::unique(m_hit_assocs.begin(), m_hit_assocs.end(), [](const HitAssoc& lhs, const HitAssoc& rhs)
+                               { return lhs.hitsetkey == rhs.hitsetkey && lhs.hitkey == rhs.hitkey && lhs.g4hitkey == rhs.g4hitkey; });
+  for (auto iter = m_hit_assocs.begin(); iter != end; ++iter)
+  {
+    hitTruthAssoc->findOrAddAssoc(iter->hitsetkey, iter->hitkey, iter->g4hitkey);
+  }
+}
+
 TrkrDefs::hitsetkey PHG4MvtxHitReco::zero_strobe_bits(TrkrDefs::hitsetkey hitsetkey)
 {
   unsigned int layer = TrkrDefs::getLayer(hitsetkey);
@@ -1,6 +1,8 @@
 #ifndef G4MVTX_PHG4MVTXHITRECO_H
 #define G4MVTX_PHG4MVTXHITRECO_H
 
+#include <g4main/PHG4HitDefs.h>
+
 #include <phparameter/PHParameterInterface.h>
 #include <trackbase/TrkrDefs.h>
 
@@ -11,6 +13,7 @@
 #include <map>
 #include <memory>  // for unique_ptr
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 typedef std::vector<std::pair<TrkrDefs::hitsetkey, TrkrDefs::hitkey>> hitMask;
@@ -21,6 +24,7 @@ class PHG4Hit;
 class PHG4TruthInfoContainer;
 class TrkrClusterContainer;
 class TrkrHitSetContainer;
+class TrkrHitTruthAssoc;
 class TrkrTruthTrack;
 class TrkrTruthTrackContainer;
 
@@ -64,6 +68,37 @@ class PHG4MvtxHitReco : public SubsysReco, public PHParameterInterface
 
   TrkrDefs::hitsetkey zero_strobe_bits(TrkrDefs::hitsetkey hitsetkey);
 
+  //! create the buffered hits and truth associations
+  void fill_hitsets(TrkrHitSetContainer*, TrkrHitTruthAssoc*);
+
+  //! unique pixel id from hitset and hit keys
+  static uint64_t pixel_id(TrkrDefs::hitsetkey hitsetkey, TrkrDefs::hitkey hitkey)
+  {
+    return (static_cast<uint64_t>(hitsetkey) << 32U) | hitkey;
+  }
+
+  //! fired pixel, buffered until the end of the event
+  struct PixelHit
+  {
+    TrkrDefs::hitsetkey hitsetkey;
+    TrkrDefs::hitkey hitkey;
+    double energy;
+  };
+
+  //! hit to g4hit association, buffered until the end of the event
+  struct HitAssoc
+  {
+    TrkrDefs::hitsetkey hitsetkey;
+    TrkrDefs::hitkey hitkey;
+    PHG4HitDefs::keytype g4hitkey;
+  };
+
+  std::vector<PixelHit> m_pixel_hits;
+  std::vector<HitAssoc> m_hit_assocs;
+
+  //! pixels with a hit in this event, as pixel_id
+  std::unordered_set<uint64_t> m_fired_pixels;
+
   std::string m_detector;
 
   double m_tmin;